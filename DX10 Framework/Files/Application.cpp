@@ -21,10 +21,46 @@ Application* Application::s_pApp = 0;
 // Global Variables
 FILE* g_file;
 
+// Command line modes that write a report in place of running the application
+static const TReportMode s_reportModes[] =
+{
+	{ "-mathbench", "MathBenchmark.txt", Benchmark_Math::Run },			// Compare the scalar and SIMD math
+	{ "-meshbench", "MeshBenchmark.txt", Benchmark_Mesh::Run },			// Compare the original and single pass mesh loaders
+	{ "-effectsbench", "EffectsBenchmark.txt", Benchmark_Effects::Run },	// Time the particle effects and burn a cloth into them
+	{ "-strandsbench", "StrandsBenchmark.txt", Benchmark_Strands::Run },	// Compare the cloth particles with the packed strand solver
+	{ "-clothbench", "ClothBenchmark.txt", Benchmark_Cloth::Run },		// Compare the position based and implicit cloth integrators
+	{ "-matrixtest", "MatrixTest.txt", Test_Matrix::Run }				// Check the SIMD matrices and quaternions against D3DX results
+};
+
 int WINAPI WinMain(HINSTANCE _hInstance, HINSTANCE _hPrevInstance, LPSTR _lpCmdLine, int _cmdShow)
 {
-	// Seed the random based on the time
-	srand((UINT)time(NULL));
+	// Seed every random stream based on the time
+	SetRandomSeed((UINT)time(NULL));
+
+	// Run as a headless cloth simulation server when asked to: -clothserver <channel name> <width> <height>
+	std::istringstream cmdLine(_lpCmdLine);
+	std::string mode;
+	if (cmdLine >> mode && mode == "-clothserver")
+	{
+		std::string channelName;
+		int width = 20;
+		int height = 20;
+		cmdLine >> channelName >> width >> height;
+
+		return (Physics_ClothServer::Run(channelName, width, height, CT_NONE) == true) ? 0 : 1;
+	}
+
+	// Write a report instead of running the application when asked to: <mode> <report file>
+	for (int i = 0; i < (int)(sizeof(s_reportModes) / sizeof(TReportMode)); i++)
+	{
+		if (mode == s_reportModes[i].Flag)
+		{
+			std::string reportPath = s_reportModes[i].DefaultReport;
+			cmdLine >> reportPath;
+
+			return (s_reportModes[i].Run(reportPath) == true) ? 0 : 1;
+		}
+	}
 
 	#ifdef _DEBUG
 		if (AllocConsole())
@@ -229,6 +265,41 @@ bool Application::Initialise_DX10(HINSTANCE _hInstance)
 	m_pCamera = new DX10_Camera_FirstPerson();
 	VALIDATE(m_pCamera->Initialise(m_pDX10_Renderer, _hInstance, m_hWnd));
 
+	m_pMeshRegistry = new DX10_MeshRegistry();
+	VALIDATE(m_pMeshRegistry->Initialise(m_pDX10_Renderer));
+
+	//--------------------------------------------------------------
+	// Load the Assets
+	//--------------------------------------------------------------
+
+	// Every file is read, decoded and compiled on the workers at once, so startup waits on the slowest asset instead of all of them in turn.
+	// The shaders, sprites and objects below then find their effects and textures already stored on the renderer
+	DX10_AssetLoader assetLoader;
+	VALIDATE(assetLoader.Initialise(m_pDX10_Renderer));
+	assetLoader.SetProgressCallback(LoadProgress, this);
+
+	assetLoader.RequestEffect("litTex.fx");
+	assetLoader.RequestEffect("Sprite.fx");
+	assetLoader.RequestEffect("ShadowMap.fx");
+	assetLoader.RequestEffect("Shadow.fx");
+	assetLoader.RequestEffect("ShadowSoft.fx");
+	assetLoader.RequestEffect("Blur.fx");
+
+	// Meshes are loaded unscaled and shared through the registry. The objects carry the scale in their world matrix
+	v3float unitScale = { 1.0f, 1.0f, 1.0f };
+	UINT floorMesh = assetLoader.RequestMesh(DX10_Mesh::GetFilePath(MT_FINITEPLANE), unitScale);
+	UINT sphereMesh = assetLoader.RequestMesh(DX10_Mesh::GetFilePath(MT_SPHERE), unitScale);
+	UINT capsuleMesh = assetLoader.RequestMesh(DX10_Mesh::GetFilePath(MT_CAPSULE), unitScale);
+	UINT pyramidMesh = assetLoader.RequestMesh(DX10_Mesh::GetFilePath(MT_PYRAMID), unitScale);
+
+	assetLoader.RequestTexture("defaultSpecular.dds");
+	assetLoader.RequestTexture("Cloth_Instructions_Left.png");
+	assetLoader.RequestTexture("Cloth_Instructions_Right.png");
+	assetLoader.RequestTexture("Dragon.png");
+	assetLoader.RequestTexture("WaterMap.png");
+
+	VALIDATE(assetLoader.Finish());
+
 	//--------------------------------------------------------------
 	// Create the Shaders
 	//--------------------------------------------------------------
@@ -255,17 +326,17 @@ bool Application::Initialise_DX10(HINSTANCE _hInstance)
 	// Create the Meshes
 	//--------------------------------------------------------------
 
-	m_pMesh_Floor = new DX10_Mesh();
-	VALIDATE(m_pMesh_Floor->Initialise(m_pDX10_Renderer, MT_FINITEPLANE, { 100.0f, 100.0f, 100.0f }));
+	m_pMesh_Floor = m_pMeshRegistry->Acquire(MT_FINITEPLANE, unitScale, assetLoader.GetMesh(floorMesh));
+	VALIDATE((m_pMesh_Floor != 0));
 
-	m_pMesh_Sphere = new DX10_Mesh();
-	VALIDATE(m_pMesh_Sphere->Initialise(m_pDX10_Renderer, MT_SPHERE, { 5.0f, 5.0f, 5.0f }));
+	m_pMesh_Sphere = m_pMeshRegistry->Acquire(MT_SPHERE, unitScale, assetLoader.GetMesh(sphereMesh));
+	VALIDATE((m_pMesh_Sphere != 0));
 
-	m_pMesh_Capsule = new DX10_Mesh();
-	VALIDATE(m_pMesh_Capsule->Initialise(m_pDX10_Renderer, MT_CAPSULE, { 3.0f, 3.0f, 3.0f }));
+	m_pMesh_Capsule = m_pMeshRegistry->Acquire(MT_CAPSULE, unitScale, assetLoader.GetMesh(capsuleMesh));
+	VALIDATE((m_pMesh_Capsule != 0));
 
-	m_pMesh_Pyramid = new DX10_Mesh();
-	VALIDATE(m_pMesh_Pyramid->Initialise(m_pDX10_Renderer, MT_PYRAMID, { 10.0f, 10.0f, 10.0f }));
+	m_pMesh_Pyramid = m_pMeshRegistry->Acquire(MT_PYRAMID, unitScale, assetLoader.GetMesh(pyramidMesh));
+	VALIDATE((m_pMesh_Pyramid != 0));
 
 	//--------------------------------------------------------------
 	// Create the sprites
@@ -305,18 +376,22 @@ bool Application::Initialise_DX10(HINSTANCE _hInstance)
 	m_pObj_Floor = new DX10_Obj_LitTex();
 	VALIDATE(m_pObj_Floor->Initialise(m_pDX10_Renderer, m_pMesh_Floor, m_pShader_LitTex, "Dragon.png"));
 	m_pObj_Floor->SetPosition({ 0.0f, 0.0f, 0.0f });
+	m_pObj_Floor->SetScale({ 100.0f, 100.0f, 100.0f });
 
 	m_pObj_Sphere = new DX10_Obj_LitTex();
 	VALIDATE(m_pObj_Sphere->Initialise(m_pDX10_Renderer, m_pMesh_Sphere, m_pShader_LitTex, "WaterMap.png"));
 	m_pObj_Sphere->SetPosition({ 0.0f, 4.0f, 7.0f });
+	m_pObj_Sphere->SetScale({ 5.0f, 5.0f, 5.0f });
 
 	m_pObj_Capsule = new DX10_Obj_LitTex();
 	VALIDATE(m_pObj_Capsule->Initialise(m_pDX10_Renderer, m_pMesh_Capsule, m_pShader_LitTex, "WaterMap.png"));
 	m_pObj_Capsule->SetPosition({ -10.0f, 4.0f, 6.0f });
+	m_pObj_Capsule->SetScale({ 3.0f, 3.0f, 3.0f });
 
 	m_pObj_Pyramid = new DX10_Obj_LitTex();
 	VALIDATE(m_pObj_Pyramid->Initialise(m_pDX10_Renderer, m_pMesh_Pyramid, m_pShader_LitTex, "WaterMap.png"));
 	m_pObj_Pyramid->SetPosition({ 10.0f, 4.0f, 7.0f });
+	m_pObj_Pyramid->SetScale({ 10.0f, 10.0f, 10.0f });
 
 	// Set the beginning ratios of the slider bars
 	//m_pSlider_WindSpeed->SetRatio(0.0f);
@@ -337,6 +412,20 @@ bool Application::Initialise_DX10(HINSTANCE _hInstance)
 	return true;
 }
 
+void Application::LoadProgress(UINT _finished, UINT _total, void* _pUserData)
+{
+	Application* pApp = (Application*)_pUserData;
+
+	// Show the progress in the title bar until the first frame
+	std::wostringstream title;
+	title << L"DX10 Framework";
+	if (_finished < _total)
+	{
+		title << L" - Loading " << _finished << L" / " << _total;
+	}
+	SetWindowText(pApp->m_hWnd, title.str().c_str());
+}
+
 Application::~Application()
 {
 }
@@ -366,10 +455,14 @@ void Application::ShutDown()
 		ReleasePtr(m_pShader_ShadowSoft);
 		ReleasePtr(m_pShader_Blur);
 		// Release the Meshes
-		ReleasePtr(m_pMesh_Floor);
-		ReleasePtr(m_pMesh_Sphere);
-		ReleasePtr(m_pMesh_Capsule);
-		ReleasePtr(m_pMesh_Pyramid);
+		if (m_pMeshRegistry != 0)
+		{
+			m_pMeshRegistry->Release(m_pMesh_Floor);
+			m_pMeshRegistry->Release(m_pMesh_Sphere);
+			m_pMeshRegistry->Release(m_pMesh_Capsule);
+			m_pMeshRegistry->Release(m_pMesh_Pyramid);
+		}
+		ReleasePtr(m_pMeshRegistry);
 		// Release the Sprites
 		ReleasePtr(m_pSprite_InstructionsLeft);
 		ReleasePtr(m_pSprite_InstructionsRight);
@@ -393,6 +486,9 @@ void Application::ShutDown()
 		m_pDX10_Renderer->ShutDown();
 		ReleasePtr(m_pDX10_Renderer);
 	}	
+
+	// Release the Profiler once nothing is left to be timed
+	Profiler::DestroyInstance();
 }
 
 void Application::ExecuteOneFrame()
@@ -414,6 +510,9 @@ void Application::ExecuteOneFrame()
 		}
 
 		Render();
+
+		// Every processed and rendered frame is one profiler frame
+		PROFILE_END_FRAME();
 		m_deltaTick = 0;
 		m_fps++;
 	}	
@@ -421,6 +520,14 @@ void Application::ExecuteOneFrame()
 	// Reset FPS counters
 	if (m_fpsTimer >= 1.0f)
 	{
+		if (m_pDX10_Renderer != 0)
+		{
+			// Show the frame rate and the triangles of the last frame, which fall as distant Meshes drop to lower levels of detail
+			std::wostringstream title;
+			title << L"DX10 Framework - FPS: " << m_fps << L" - Triangles: " << m_pDX10_Renderer->GetTrianglesDrawn();
+			SetWindowText(m_hWnd, title.str().c_str());
+		}
+
 		m_fpsTimer -= 1.0f;
 		m_fps = 0;
 	}
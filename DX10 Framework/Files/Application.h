@@ -33,10 +33,28 @@
 
 // Local Includes
 #include "Utility\Timer.h"
+#include "Utility\Profiler.h"
+#include "Utility\Benchmark_Cloth.h"
+#include "Utility\Benchmark_Math.h"
+#include "Utility\Benchmark_Mesh.h"
+#include "Utility\Benchmark_Effects.h"
+#include "Utility\Benchmark_Strands.h"
+#include "Utility\Test_Matrix.h"
 #include "DX10\DX10.h"
 #include "DX10\DX10\2D Objects\DX10_UI_Elements.h"
 #include "Physics\Physics_3D.h"
 
+/***********************
+* TReportMode: A command line mode that writes a report in place of running the Application
+* @author: Callan Moore
+********************/
+struct TReportMode
+{
+	const char* Flag;
+	const char* DefaultReport;
+	bool (*Run)(std::string _filePath);
+};
+
 class Application
 {
 public:
@@ -94,6 +112,16 @@ public:
 	********************/
 	bool Initialise_DX10(HINSTANCE _hInstance);
 
+	/***********************
+	* LoadProgress: Show how many assets have loaded while the Application starts
+	* @author: Callan Moore
+	* @parameter: _finished: The number of assets finished
+	* @parameter: _total: The number of assets requested
+	* @parameter: _pUserData: The Application
+	* @return: void
+	********************/
+	static void LoadProgress(UINT _finished, UINT _total, void* _pUserData);
+
 	/***********************
 	* ~CApplication: Default Destructor for Application class
 	* @author: Callan Moore
@@ -252,6 +280,7 @@ private:
 	DX10_Shader_Sprite* m_pShader_Sprite;
 
 	// Meshes
+	DX10_MeshRegistry* m_pMeshRegistry;
 	DX10_Mesh* m_pMesh_Floor;
 	DX10_Mesh* m_pMesh_Sphere;
 	DX10_Mesh* m_pMesh_Capsule;
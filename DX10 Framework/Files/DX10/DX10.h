@@ -60,5 +60,7 @@
 // Systems
 #include "DX10\Systems\TextureResource.h"
 #include "DX10\Systems\DX10_ShadowMap.h"
+#include "DX10\Systems\DX10_AssetLoader.h"
+#include "DX10\Systems\DX10_MeshRegistry.h"
 
 #endif	// __DX10_H__
\ No newline at end of file
@@ -20,6 +20,10 @@
 // Local Includes
 #include "../Meshes/DX10_Mesh.h"
 
+// Defines
+// Most pixels a lower level of detail may move the surface of a Mesh by before a higher level is drawn
+#define LOD_MAX_PIXEL_ERROR 1.0f
+
 class DX10_Obj_Generic
 {
 public:
@@ -39,6 +43,8 @@ public:
 	{
 		// Set initial position to origin point
 		m_pos = { 0, 0, 0 };
+		m_scale = { 1, 1, 1 };
+		m_lod = 0;
 
 		// Initialise Rotations to zero
 		m_rotation_Pitch = 0;
@@ -81,6 +87,7 @@ public:
 
 		// Calculate the new world matrix
 		CalcWorldMatrix();
+		SelectLod();
 
 		if (m_animating == true)
 		{
@@ -117,34 +124,43 @@ public:
 	********************/
 	virtual void CalcWorldMatrix()
 	{
-		// Matrices to make up the World Matrix
-		D3DXMATRIX matRotatePitch;
-		D3DXMATRIX matRotateYaw;
-		D3DXMATRIX matRotateRoll;
-		D3DXMATRIX matTranslation;
-
-		// Initialise each matrix to Identity
-		D3DXMatrixIdentity(&matRotatePitch);
-		D3DXMatrixIdentity(&matRotateYaw);
-		D3DXMatrixIdentity(&matRotateRoll);
-		D3DXMatrixIdentity(&matTranslation);
-
-		// Reset the Objects World Matrix for new Calculation
-		D3DXMatrixIdentity(&m_matWorld);
-
-		// Calculate a Rotation Matrices around the Pitch, Yaw and Roll axes
-		D3DXMatrixRotationX(&matRotatePitch, m_rotation_Pitch);
-		D3DXMatrixRotationY(&matRotateYaw, m_rotation_Yaw);
-		D3DXMatrixRotationZ(&matRotateRoll, m_rotation_Roll);
-
-		// Calculate the Full Rotation Matrix and store in the World Matrix
-		m_matWorld = matRotatePitch * matRotateYaw * matRotateRoll;
-
-		// Calculate a translation Matrix based on the Objects current position in world space
-		D3DXMatrixTranslation(&matTranslation, m_pos.x, m_pos.y, m_pos.z);
-
-		// Calculate the Objects World Matrix
-		m_matWorld *= matTranslation;
+		// Calculate the Full Rotation Matrix from the Pitch, Yaw and Roll axes, scaled first so shared unscaled Meshes take the Objects size
+		m4simd matWorld = MatrixScaling(v4simd(m_scale)) * MatrixRotationX(m_rotation_Pitch) * MatrixRotationY(m_rotation_Yaw) * MatrixRotationZ(m_rotation_Roll);
+
+		// Translation only fills the fourth row, so place the Objects current position in world space there
+		matWorld.r[3] = MatrixTranslation(v4simd(m_pos)).r[3];
+
+		// Store the Objects World Matrix
+		matWorld.Store(m_matWorld);
+	}
+
+	/***********************
+	* SelectLod: Choose the level of detail of the Mesh from how large its error is on screen, seen from the camera.
+	*	The camera passes its position to the Renderer each frame before the Objects are processed
+	* @author: Callan Moore
+	* @return: void
+	********************/
+	void SelectLod()
+	{
+		m_lod = 0;
+		if (m_pMesh->GetLodCount() <= 1)
+		{
+			return;
+		}
+
+		// Distance to the nearest point of the bounding sphere, so a camera inside the Mesh always sees the full detail
+		D3DXVECTOR3 eyePos = m_pRenderer->GetEyePos();
+		v3float toEye = { eyePos.x - m_pos.x, eyePos.y - m_pos.y, eyePos.z - m_pos.z };
+		float scale = max(max(fabs(m_scale.x), fabs(m_scale.y)), fabs(m_scale.z));
+		float distance = toEye.Magnitude() - (m_pMesh->GetBoundingRadius() * scale);
+		if (distance <= 0.0f)
+		{
+			return;
+		}
+
+		// The second diagonal of the projection is one over the tangent of half the vertical field of view
+		float pixelsPerUnit = (m_pRenderer->GetProjMatrix()->_22 * (float)m_pRenderer->GetHeight() * 0.5f) * scale / distance;
+		m_lod = m_pMesh->SelectLod(pixelsPerUnit, LOD_MAX_PIXEL_ERROR);
 	}
 
 	/***********************
@@ -153,6 +169,13 @@ public:
 	* @return: v3float: 3D position of the Objects center
 	********************/
 	v3float GetPosition() { return m_pos; };
+
+	/***********************
+	* GetScale: Retrieve the Scale of the Object
+	* @author: Callan Moore
+	* @return: v3float: Scale along each axis, applied on top of any scale baked into the Mesh
+	********************/
+	v3float GetScale() { return m_scale; };
 	
 	/***********************
 	* GetRotationPitch: Retrieve the Objects current rotation around the X axis
@@ -203,6 +226,15 @@ public:
 	* @return: void 
 	********************/
 	void SetPosition(v3float _pos) { m_pos = _pos; };
+
+	/***********************
+	* SetScale: Set the Scale of the object so one unscaled Mesh can be shared by objects of any size.
+	*	Keep the scale uniform, as the shaders transform normals by the world matrix
+	* @author: Callan Moore
+	* @parameter: _scale: Scale along each axis
+	* @return: void
+	********************/
+	void SetScale(v3float _scale) { m_scale = _scale; };
 	
 	/***********************
 	* SetRotationPitch: Set the rotation around the X axis
@@ -273,7 +305,7 @@ public:
 	********************/
 	void Draw()
 	{
-		m_pMesh->Render();
+		m_pMesh->Render(m_lod);
 	}
 
 	/***********************
@@ -297,6 +329,13 @@ public:
 	********************/
 	DX10_Mesh* GetMesh() { return m_pMesh; };
 
+	/***********************
+	* GetLod: Retrieve the level of detail the object is drawn with this frame
+	* @author: Callan Moore
+	* @return: UINT: The level of detail of the Mesh. Zero for the full Mesh
+	********************/
+	UINT GetLod() { return m_lod; };
+
 protected:
 	DX10_Renderer* m_pRenderer;
 	DX10_Mesh* m_pMesh;
@@ -305,6 +344,8 @@ protected:
 	float m_dt;
 
 	v3float m_pos;
+	v3float m_scale;
+	UINT m_lod;
 	float m_rotation_Pitch;
 	float m_rotation_Yaw;
 	float m_rotation_Roll;
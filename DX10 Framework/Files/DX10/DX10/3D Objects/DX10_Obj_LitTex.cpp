@@ -99,6 +99,7 @@ void DX10_Obj_LitTex::Render(eTech_LitTex _tech, D3DXPLANE _plane)
 
 	// Add the variables
 	litTex.pMesh = m_pMesh;
+	litTex.lod = m_lod;
 	litTex.pTexBase = (*m_pTextures)[m_texIndex];
 	litTex.plane = _plane;
 
@@ -75,17 +75,9 @@ void DX10_Camera_Debug::Process()
 	pos.x = m_position.x;
 	pos.y = m_position.y;
 	pos.z = m_position.z;
-	D3DXVECTOR3 target;
-	target.x = m_target.x;
-	target.y = m_target.y;
-	target.z = m_target.z;
-	D3DXVECTOR3 up;
-	up.x = m_up.x;
-	up.y = m_up.y;
-	up.z = m_up.z;
 
 	// Set the View Matrix
-	D3DXMatrixLookAtLH(&m_matView, &pos, &target, &up);
+	MatrixLookAtLH(v4simd(m_position), v4simd(m_target), v4simd(m_up)).Store(m_matView);
 		
 	//Get the render to calculate the view matrix and set the view port
 	m_pRenderer->SetViewMatrix(m_matView);
@@ -101,18 +93,12 @@ void DX10_Camera_Debug::Pitch(float _fDeg)
 		return;
 	}
 	
-	D3DXMATRIX D3DXRotation;
 	// Rotate around the cameras Right axis
-	D3DXVECTOR3 tempRight = D3DXVECTOR3(m_right.x, m_right.y, m_right.z);
-	D3DXMatrixRotationAxis(&D3DXRotation, &tempRight, (fRotInRads));
+	m4simd matRotation = MatrixRotationAxis(v4simd(m_right), fRotInRads);
 
 	// Calculate the new target and Up Vectors
-
-	D3DXVECTOR3 tempUp = D3DXVECTOR3(m_up.x, m_up.y, m_up.z);
-	D3DXVec3TransformNormal(&tempUp, &tempUp, &D3DXRotation);
-	
-	D3DXVECTOR3 tempLook = D3DXVECTOR3(m_look.x, m_look.y, m_look.z);
-	D3DXVec3TransformNormal(&tempLook, &tempLook, &D3DXRotation);
+	v3float tempUp = TransformNormal(matRotation, v4simd(m_up)).ToV3float();
+	v3float tempLook = TransformNormal(matRotation, v4simd(m_look)).ToV3float();
 	
 	// Check if we we can rotate
 	// Only Rotate if pitch does not go over max pitch
@@ -131,8 +117,8 @@ void DX10_Camera_Debug::Pitch(float _fDeg)
 
 	if (bRotate)
 	{
-		m_up = v3float(tempUp.x, tempUp.y, tempUp.z);
-		m_look = v3float(tempLook.x, tempLook.y, tempLook.z);
+		m_up = tempUp;
+		m_look = tempLook;
 	}
 }
 
@@ -146,20 +132,12 @@ void DX10_Camera_Debug::Yaw(float _fDeg)
 		return;
 	}
 
-	D3DXMATRIX D3DXRotation;
 	// Rotate around the cameras Up axis
-	D3DXVECTOR3 tempUp = D3DXVECTOR3(m_up.x, m_up.y, m_up.z);
-	D3DXMatrixRotationAxis(&D3DXRotation, &tempUp, (fRotInRads));
+	m4simd matRotation = MatrixRotationAxis(v4simd(m_up), fRotInRads);
 
 	// Calculate the new target and Right Vectors
-
-	D3DXVECTOR3 tempRight = D3DXVECTOR3(m_right.x, m_right.y, m_right.z);
-	D3DXVec3TransformNormal(&tempRight, &tempRight, &D3DXRotation);
-	m_right = v3float(tempRight.x, tempRight.y, tempRight.z);
-
-	D3DXVECTOR3 tempLook = D3DXVECTOR3(m_look.x, m_look.y, m_look.z);
-	D3DXVec3TransformNormal(&tempLook, &tempLook, &D3DXRotation);
-	m_look = v3float(tempLook.x, tempLook.y, tempLook.z);
+	m_right = TransformNormal(matRotation, v4simd(m_right)).ToV3float();
+	m_look = TransformNormal(matRotation, v4simd(m_look)).ToV3float();
 }
 
 void DX10_Camera_Debug::Roll(float _fDeg)
@@ -171,20 +149,12 @@ void DX10_Camera_Debug::Roll(float _fDeg)
 		return;
 	}
 
-	D3DXMATRIX D3DXRotation;
 	// Rotate around the cameras look axis
-	D3DXVECTOR3 tempLook = D3DXVECTOR3(m_look.x, m_look.y, m_look.z);
-	D3DXMatrixRotationAxis(&D3DXRotation, &tempLook, (fRotInRads));
+	m4simd matRotation = MatrixRotationAxis(v4simd(m_look), fRotInRads);
 
 	// Calculate the new up and Right Vectors
-
-	D3DXVECTOR3 tempRight = D3DXVECTOR3(m_right.x, m_right.y, m_right.z);
-	D3DXVec3TransformNormal(&tempRight, &tempRight, &D3DXRotation);
-	m_right = v3float(tempRight.x, tempRight.y, tempRight.z);
-
-	D3DXVECTOR3 tempUp = D3DXVECTOR3(m_up.x, m_up.y, m_up.z);
-	D3DXVec3TransformNormal(&tempUp, &tempUp, &D3DXRotation);
-	m_up = v3float(tempUp.x, tempUp.y, tempUp.z);
+	m_right = TransformNormal(matRotation, v4simd(m_right)).ToV3float();
+	m_up = TransformNormal(matRotation, v4simd(m_up)).ToV3float();
 
 }
 
@@ -75,18 +75,17 @@ void DX10_Camera_FirstPerson::Process(float _dt)
 	}
 
 	// Create a full rotation matrix
-	D3DXMatrixRotationYawPitchRoll(&m_rotationMatrix, m_yaw, m_pitch, 0);
-	D3DXVec3TransformCoord(&m_target, &m_defaultForward, &m_rotationMatrix);
-	D3DXVec3Normalize(&m_target, &m_target);
+	m4simd matRotation = MatrixRotationYawPitchRoll(m_yaw, m_pitch, 0);
+	matRotation.Store(m_rotationMatrix);
+	StoreFloat3(m_target, Normalised(TransformCoord(matRotation, LoadFloat3(m_defaultForward)), NA_EXACT));
 
 	// Calculate a Yaw rotation matrix
-	D3DXMATRIX RotateYTempMatrix;
-	D3DXMatrixRotationY(&RotateYTempMatrix, m_yaw);
+	m4simd matRotateY = MatrixRotationY(m_yaw);
 
 	// Update the Local camera Axis around the Y axis
-	D3DXVec3TransformNormal(&m_right, &m_defaultRight, &RotateYTempMatrix);
-	D3DXVec3TransformNormal(&m_up, &m_up, &RotateYTempMatrix);
-	D3DXVec3TransformNormal(&m_forward, &m_defaultForward, &RotateYTempMatrix);
+	StoreFloat3(m_right, TransformNormal(matRotateY, LoadFloat3(m_defaultRight)));
+	StoreFloat3(m_up, TransformNormal(matRotateY, LoadFloat3(m_up)));
+	StoreFloat3(m_forward, TransformNormal(matRotateY, LoadFloat3(m_defaultForward)));
 
 	// Adjust the position
 	m_position += m_moveStrafe * m_right * _dt;
@@ -104,7 +103,7 @@ void DX10_Camera_FirstPerson::Process(float _dt)
 	m_target = m_position + m_target;
 
 	// Create the View matrix
-	D3DXMatrixLookAtLH(&m_matView, &m_position, &m_target, &m_up);
+	MatrixLookAtLH(LoadFloat3(m_position), LoadFloat3(m_target), LoadFloat3(m_up)).Store(m_matView);
 
 	m_pRenderer->SetViewMatrix(m_matView);
 	m_pRenderer->SetEyePosition(m_position);
@@ -190,14 +189,12 @@ TCameraRay DX10_Camera_FirstPerson::GetRay(v2float _mousePos)
 	float pointX = _mousePos.x / projectionMatrix._11;
 	float pointY = _mousePos.y / projectionMatrix._22;
 
-	// Calculate the inverse of the view matrix
-	D3DXMATRIX invViewMatrix;
-	D3DXMatrixInverse(&invViewMatrix, NULL, &m_matView);
+	// Calculate the inverse of the view matrix. A view matrix is affine so the cheaper inverse applies
+	m4simd invViewMatrix;
+	MatrixInverseAffine(m4simd(m_matView), invViewMatrix);
 
 	// Calculate the direction of the ray using the inverse view matrix
-	camRay.Direction.x = (pointX * invViewMatrix._11) + (pointY * invViewMatrix._21) + invViewMatrix._31;
-	camRay.Direction.y = (pointX * invViewMatrix._12) + (pointY * invViewMatrix._22) + invViewMatrix._32;
-	camRay.Direction.z = (pointX * invViewMatrix._13) + (pointY * invViewMatrix._23) + invViewMatrix._33;
+	camRay.Direction = TransformNormal(invViewMatrix, v4simd(pointX, pointY, 1.0f)).ToV3float();
 
 	// Set the origin of the ray to the camera position
 	camRay.Origin = {m_position.x, m_position.y, m_position.z};
@@ -61,10 +61,10 @@ struct TCameraRay
 		// Calculate the a, b, and c coefficients of the discriminant
 		float a = Direction.Dot(Direction);
 		float b = Direction.Dot(Origin) * 2.0f;
-		float c = Origin.Dot(Origin) - pow(_sphereRad, 2);
+		float c = Origin.Dot(Origin) - (_sphereRad * _sphereRad);
 
 		// Calculate the discriminant and check the result
-		float discriminant = pow(b, 2) - (4 * a * c);
+		float discriminant = (b * b) - (4 * a * c);
 		if (discriminant < 0.0f)
 		{
 			// Discriminant is negative therefore the ray does not intersect the sphere
@@ -20,13 +20,14 @@ DX10_Renderer::DX10_Renderer()
 	m_pDX10Device = 0;
 	m_pDX10SwapChain = 0;
 	m_pRenderTargetView = 0;
+
+	m_primTopology = D3D10_PRIMITIVE_TOPOLOGY_UNDEFINED;
+	m_trianglesDrawn = 0;
+	m_trianglesLastFrame = 0;
 }
 
 bool DX10_Renderer::Initialise(int _clientWidth, int _clientHeight, HWND _hWND)
 {
-	// Seed time
-	srand((UINT)time(NULL));
-
 	// Save Window Variables
 	m_hWnd = _hWND;
 	m_windowedWidth = _clientWidth;
@@ -446,14 +447,7 @@ bool DX10_Renderer::BuildFX(std::string _fxFileName, std::string _techniqueName,
 	}
 	else
 	{
-		// Set the shader flags to enforce strictness
-		DWORD shaderFlags = D3D10_SHADER_ENABLE_STRICTNESS;
-		#if defined( DEBUG ) || defined( _DEBUG )
-			// Addition shader flags for information in DEBUG mode only
-			shaderFlags |= D3D10_SHADER_DEBUG;
-			shaderFlags |= D3D10_SHADER_SKIP_OPTIMIZATION;
-		#endif
-
+		DWORD shaderFlags = GetShaderFlags();
 		ID3D10Blob* compilationErrors;
 
 		// Add the directory path from the DX10Render file to the stored FX files
@@ -532,6 +526,33 @@ bool DX10_Renderer::BuildFX(std::string _fxFileName, std::string _techniqueName,
 	return true;
 }
 
+bool DX10_Renderer::AddFX(std::string _fxFileName, ID3D10Effect*& _prFX)
+{
+	std::pair<std::map<std::string, ID3D10Effect*>::iterator, bool> result;
+	result = m_fxFiles.insert(std::pair<std::string, ID3D10Effect*>(_fxFileName, _prFX));
+
+	// Effects file was already stored. Keep the stored one so techniques already retrieved stay valid
+	if (result.second == false)
+	{
+		ReleaseCOM(_prFX);
+		_prFX = result.first->second;
+	}
+	return true;
+}
+
+DWORD DX10_Renderer::GetShaderFlags()
+{
+	// Set the shader flags to enforce strictness
+	DWORD shaderFlags = D3D10_SHADER_ENABLE_STRICTNESS;
+	#if defined( DEBUG ) || defined( _DEBUG )
+		// Addition shader flags for information in DEBUG mode only
+		shaderFlags |= D3D10_SHADER_DEBUG;
+		shaderFlags |= D3D10_SHADER_SKIP_OPTIMIZATION;
+	#endif
+
+	return shaderFlags;
+}
+
 bool DX10_Renderer::CreateVertexLayout(D3D10_INPUT_ELEMENT_DESC* _vertexDesc, UINT _elementNum, ID3D10EffectTechnique* _pTech, ID3D10InputLayout*& _prVertexLayout, UINT _passNum)
 {
 	ID3D10InputLayout* pVertexLayout;
@@ -551,6 +572,22 @@ bool DX10_Renderer::CreateVertexLayout(D3D10_INPUT_ELEMENT_DESC* _vertexDesc, UI
 	return true;
 }
 
+void DX10_Renderer::DestroyBuffer(DX10_Buffer*& _prBuffer)
+{
+	std::map<UINT, DX10_Buffer*>::iterator iterBuffers = m_buffers.begin();
+	while (iterBuffers != m_buffers.end())
+	{
+		if (iterBuffers->second == _prBuffer)
+		{
+			ReleasePtr(iterBuffers->second);
+			m_buffers.erase(iterBuffers);
+			break;
+		}
+		iterBuffers++;
+	}
+	_prBuffer = 0;
+}
+
 bool DX10_Renderer::CreateTexture(std::string _texFileName, ID3D10ShaderResourceView*& _prTex)
 {
 	ID3D10ShaderResourceView* pTexture = 0;
@@ -583,9 +620,34 @@ bool DX10_Renderer::CreateTexture(std::string _texFileName, ID3D10ShaderResource
 	return true;
 }
 
+bool DX10_Renderer::AddTexture(std::string _texFileName, ID3D10ShaderResourceView*& _prTex)
+{
+	std::pair<std::map<std::string, ID3D10ShaderResourceView*>::iterator, bool> result;
+	result = m_textures.insert(std::pair<std::string, ID3D10ShaderResourceView*>(_texFileName, _prTex));
+
+	// Texture was already stored. Keep the stored one as objects may already hold it
+	if (result.second == false)
+	{
+		ReleaseCOM(_prTex);
+		_prTex = result.first->second;
+	}
+	return true;
+}
+
 void DX10_Renderer::RenderBuffer(DX10_Buffer* _buffer)
 {
 	_buffer->Render();
+
+	// Count the triangles submitted for the frame statistics
+	UINT drawCount = _buffer->GetDrawCount();
+	if (m_primTopology == D3D10_PRIMITIVE_TOPOLOGY_TRIANGLELIST)
+	{
+		m_trianglesDrawn += drawCount / 3;
+	}
+	else if (m_primTopology == D3D10_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP && drawCount >= 3)
+	{
+		m_trianglesDrawn += drawCount - 2;
+	}
 }
 
 void DX10_Renderer::StartRender()
@@ -600,6 +662,10 @@ void DX10_Renderer::StartRender()
 void DX10_Renderer::EndRender()
 {
 	m_pDX10SwapChain->Present(0, 0);
+
+	// Keep the count of the finished frame and start counting the next
+	m_trianglesLastFrame = m_trianglesDrawn;
+	m_trianglesDrawn = 0;
 }
 
 void DX10_Renderer::RestoreDefaultRenderStates()
@@ -610,224 +676,26 @@ void DX10_Renderer::RestoreDefaultRenderStates()
 	m_pDX10Device->RSSetState(m_pRasterizerState);
 }
 
-bool DX10_Renderer::ReadFileCounts(std::string _fileName, int& _rVertexCount, int& _rTexCount, int& _rNormalCount, int& _rPolygonCount)
-{
-	std::ifstream fin;
-	char input;
-
-	// Initialize the counts.
-	_rVertexCount = 0;
-	_rTexCount = 0;
-	_rNormalCount = 0;
-	_rPolygonCount = 0;
-
-	// Open the file.
-	fin.open(_fileName.c_str());
-
-	// Check if it was successful in opening the file.
-	if (fin.fail() == true)
-	{
-		return false;
-	}
-
-	// Read from the file and continue to read until the end of the file is reached.
-	fin.get(input);
-	while (!fin.eof())
-	{
-		// If the line starts with 'v' then count either the vertex, the texture coordinates, or the normal vector.
-		if (input == 'v')
-		{
-			fin.get(input);
-			if (input == ' ') { _rVertexCount++; }
-			if (input == 't') { _rTexCount++; }
-			if (input == 'n') { _rNormalCount++; }
-		}
-
-		// If the line starts with 'f' then increment the face count.
-		if (input == 'f')
-		{
-			fin.get(input);
-			if (input == ' ') { _rPolygonCount++; }
-		}
-
-		// Otherwise read in the remainder of the line.
-		while (input != '\n')
-		{
-			fin.get(input);
-		}
-
-		// Start reading the beginning of the next line.
-		fin.get(input);
-	}
-
-	// Close the file.
-	fin.close();
-
-	return true;
-}
-
 bool DX10_Renderer::LoadMeshObj(std::string _fileName, TVertexNormalUV*& _prVertexBuffer, DWORD*& _prIndexBuffer, int* _pVertexCount, int* _pIndexCount, v3float _scale)
 {
-	int vertexCount;
-	int texCount;
-	int normalCount;
-	int polygonCount;
-	ReadFileCounts(_fileName, vertexCount, texCount, normalCount, polygonCount);
-
-	v3float* pVertices;
-	v3float* pTexUVs;
-	v3float* pNormals;
-	PolygonType *pPolygons;
-	std::ifstream fin;
-	int vIndex;
-	int tIndex;
-	int nIndex;
-	char input;
-	char input2;
-	//ofstream fout;
-
-	// Initialize the four data structures.
-	pVertices = new v3float[vertexCount];
-	VALIDATE(pVertices);
-
-	pTexUVs = new v3float[texCount];
-	VALIDATE(pTexUVs);
-
-	pNormals = new v3float[normalCount];
-	VALIDATE(pNormals);
-
-	pPolygons = new PolygonType[polygonCount];
-	VALIDATE(pPolygons);
-
-	// Create and Initialize the indexes.
-	int vertexIndex = 0;
-	int texcoordIndex = 0;
-	int normalIndex = 0;
-	int faceIndex = 0;
-
-	// Open the file.
-	fin.open(_fileName.c_str());
-
-	// Check if it was successful in opening the file.
-	VALIDATE(!fin.fail());
-
-	// Read in the vertices, texture coordinates, and normals into the data structures.
-	// Important: Also convert to left hand coordinate system since Maya uses right hand coordinate system.
-	fin.get(input);
-	while (!fin.eof())
-	{
-		if (input == 'v')
-		{
-			fin.get(input);
-
-			// Read in the vertices.
-			if (input == ' ')
-			{
-				fin >> pVertices[vertexIndex].x >> pVertices[vertexIndex].y >> pVertices[vertexIndex].z;
-
-				// Invert the Z vertex to change to left hand system.
-				pVertices[vertexIndex].z = pVertices[vertexIndex].z * -1.0f;
-				vertexIndex++;
-			}
-
-			// Read in the texture uv coordinates.
-			if (input == 't')
-			{
-				fin >> pTexUVs[texcoordIndex].x >> pTexUVs[texcoordIndex].y;
-
-				// Invert the V texture coordinates to left hand system.
-				pTexUVs[texcoordIndex].y = 1.0f - pTexUVs[texcoordIndex].y;
-				texcoordIndex++;
-			}
-
-			// Read in the normals.
-			if (input == 'n')
-			{
-				fin >> pNormals[normalIndex].x >> pNormals[normalIndex].y >> pNormals[normalIndex].z;
-
-				// Invert the Z normal to change to left hand system.
-				pNormals[normalIndex].z = pNormals[normalIndex].z * -1.0f;
-				normalIndex++;
-			}
-		}
-
-		// Read in the faces.
-		if (input == 'f')
-		{
-			fin.get(input);
-			if (input == ' ')
-			{
-				// Read the face data in backwards to convert it to a left hand system from right hand system.
-				fin >> pPolygons[faceIndex].vIndex3 >> input2 >> pPolygons[faceIndex].tIndex3 >> input2 >> pPolygons[faceIndex].nIndex3
-					>> pPolygons[faceIndex].vIndex2 >> input2 >> pPolygons[faceIndex].tIndex2 >> input2 >> pPolygons[faceIndex].nIndex2
-					>> pPolygons[faceIndex].vIndex1 >> input2 >> pPolygons[faceIndex].tIndex1 >> input2 >> pPolygons[faceIndex].nIndex1;
-				faceIndex++;
-			}
-		}
-
-		// Read in the remainder of the line.
-		while (input != '\n')
-		{
-			fin.get(input);
-		}
-
-		// Start reading the beginning of the next line.
-		fin.get(input);
-	}
-
-	// Close the file.
-	fin.close();
-
-	TVertexNormalUV* pVertexBuffer = new TVertexNormalUV[polygonCount * 3];
-	DWORD* pIndexBuffer = new DWORD[polygonCount * 3];
-	int vertexBufferIndex = 0;
-	int indexBufferIndex = 0;
-	for (int i = 0; i < faceIndex; i++)
+	// Parse the whole file in a single pass
+	std::vector<TVertexNormalUV> vertices;
+	std::vector<DWORD> indices;
+	VALIDATE(DX10_ObjParser::Load(_fileName, _scale, vertices, indices));
+
+	// Copy into the arrays the mesh takes ownership of
+	TVertexNormalUV* pVertexBuffer = new TVertexNormalUV[vertices.size()];
+	DWORD* pIndexBuffer = new DWORD[indices.size()];
+	if (vertices.empty() == false)
 	{
-		// Converting to zero-index
-		vIndex = pPolygons[i].vIndex1 - 1;
-		tIndex = pPolygons[i].tIndex1 - 1;
-		nIndex = pPolygons[i].nIndex1 - 1;
-
-		pVertexBuffer[vertexBufferIndex++] = {  { pVertices[vIndex].x * _scale.x, pVertices[vIndex].y * _scale.y, pVertices[vIndex].z * _scale.z },
-												{ pNormals[nIndex].x, pNormals[nIndex].y, pNormals[nIndex].z },
-												{ pTexUVs[tIndex].x, pTexUVs[tIndex].y } };
-
-		pIndexBuffer[indexBufferIndex++] = (vertexBufferIndex - 1);
-
-		// Converting to zero-index
-		vIndex = pPolygons[i].vIndex2 - 1;
-		tIndex = pPolygons[i].tIndex2 - 1;
-		nIndex = pPolygons[i].nIndex2 - 1;
-
-		pVertexBuffer[vertexBufferIndex++] = {  { pVertices[vIndex].x * _scale.x, pVertices[vIndex].y * _scale.y, pVertices[vIndex].z * _scale.z },
-												{ pNormals[nIndex].x, pNormals[nIndex].y, pNormals[nIndex].z },
-												{ pTexUVs[tIndex].x, pTexUVs[tIndex].y } };
-
-		pIndexBuffer[indexBufferIndex++] = (vertexBufferIndex - 1);
-
-		// Converting to zero-index
-		vIndex = pPolygons[i].vIndex3 - 1;
-		tIndex = pPolygons[i].tIndex3 - 1;
-		nIndex = pPolygons[i].nIndex3 - 1;
-
-		pVertexBuffer[vertexBufferIndex++] = {  { pVertices[vIndex].x * _scale.x, pVertices[vIndex].y * _scale.y, pVertices[vIndex].z * _scale.z },
-												{ pNormals[nIndex].x, pNormals[nIndex].y, pNormals[nIndex].z },
-												{ pTexUVs[tIndex].x, pTexUVs[tIndex].y } };
-
-		pIndexBuffer[indexBufferIndex++] = (vertexBufferIndex - 1);
+		memcpy(pVertexBuffer, &vertices[0], vertices.size() * sizeof(TVertexNormalUV));
+		memcpy(pIndexBuffer, &indices[0], indices.size() * sizeof(DWORD));
 	}
 
-	// Release the four data structures.
-	ReleasePtrArray(pVertices);
-	ReleasePtrArray(pTexUVs);
-	ReleasePtrArray(pNormals);
-	ReleasePtrArray(pPolygons);
-
 	_prVertexBuffer = pVertexBuffer;
-	*_pVertexCount = vertexBufferIndex;
+	*_pVertexCount = (int)vertices.size();
 	_prIndexBuffer = pIndexBuffer;
-	*_pIndexCount = indexBufferIndex;
+	*_pIndexCount = (int)indices.size();
 
 	return true;
 }
@@ -859,17 +727,14 @@ void DX10_Renderer::ApplyRasterizerState(eRasterizerState _rs)
 void DX10_Renderer::ReflectLightsAcrossPlane(D3DXPLANE _plane)
 {
 	// Create a reflection matrix and reflect all active lights
-	D3DXMATRIX matReflect = CreateReflectionMatrix(_plane);
+	m4simd matReflect = MatrixReflect(v4simd(_plane.a, _plane.b, _plane.c, _plane.d));
 
 	std::map<std::string, TLight*>::iterator iterLights = m_mapLights.begin();
 	while (iterLights != m_mapLights.end())
 	{
-		D3DXVECTOR4 tempDirPow = iterLights->second->dir_spotPow;
-		D3DXVECTOR3 tempDir = { tempDirPow.x, tempDirPow.y, tempDirPow.z };
-		D3DXVec3TransformNormal(&tempDir, &tempDir, &matReflect);
-
-		tempDirPow = { tempDir.x, tempDir.y, tempDir.z, tempDirPow.w };
-		iterLights->second->dir_spotPow = tempDirPow;
+		// Reflect the direction and leave the spot power in W untouched
+		D3DXVECTOR4* pDirPow = &iterLights->second->dir_spotPow;
+		StoreFloat3(*pDirPow, TransformNormal(matReflect, LoadFloat3(*pDirPow)));
 
 		iterLights++;
 	}
@@ -947,6 +812,7 @@ TLight* DX10_Renderer::GetActiveLights()
 void DX10_Renderer::SetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY _primitiveType)
 {
 	m_pDX10Device->IASetPrimitiveTopology(_primitiveType);
+	m_primTopology = _primitiveType;
 }
 
 bool DX10_Renderer::SetInputLayout(ID3D10InputLayout* _pVertexLayout)
@@ -30,13 +30,7 @@
 #include "Systems/DX10_Buffer.h"
 #include "Systems/TextureResource.h"
 #include "Systems/DX10_ShadowMap.h"
-
-struct PolygonType
-{
-	int vIndex1, vIndex2, vIndex3;
-	int tIndex1, tIndex2, tIndex3;
-	int nIndex1, nIndex2, nIndex3;
-};
+#include "Systems/DX10_ObjParser.h"
 
 class DX10_Renderer
 {
@@ -125,6 +119,22 @@ public:
 	********************/
 	bool BuildFX(std::string _fxFileName, std::string _technique, ID3D10Effect*& _prFX, ID3D10EffectTechnique*& _prTech);
 
+	/***********************
+	* AddFX: Store an Effects file created elsewhere so BuildFX finds it instead of compiling it again
+	* @author: Callan Moore
+	* @Parameter: _fxFileName: Name of the Effects file
+	* @Parameter: _prFX: The created Effect. Released and replaced with the stored Effect if the file is already stored
+	* @return: bool: Successful or not
+	********************/
+	bool AddFX(std::string _fxFileName, ID3D10Effect*& _prFX);
+
+	/***********************
+	* GetShaderFlags: Retrieve the flags every Effects file is compiled with
+	* @author: Callan Moore
+	* @return: DWORD: The shader flags
+	********************/
+	static DWORD GetShaderFlags();
+
 	/***********************
 	* CreateVertexLayout: Create the Vertex Layout for an Object
 	* @author: Callan Moore
@@ -172,6 +182,14 @@ public:
 		}
 	}
 
+	/***********************
+	* DestroyBuffer: Release a Buffer created by the Renderer before the Renderer shuts down
+	* @author: Callan Moore
+	* @parameter: _prBuffer: The Buffer to release. Set to zero
+	* @return: void
+	********************/
+	void DestroyBuffer(DX10_Buffer*& _prBuffer);
+
 	/***********************
 	* CreateTexture: Create a Texture from a file and store it on the Renderer
 	* @author: Callan Moore
@@ -181,6 +199,15 @@ public:
 	********************/
 	bool CreateTexture(std::string _texFileName, ID3D10ShaderResourceView*& _prTex);
 
+	/***********************
+	* AddTexture: Store a Texture created elsewhere so CreateTexture finds it instead of loading it again
+	* @author: Callan Moore
+	* @parameter: _texFileName: The filename of the texture
+	* @parameter: _prTex: The created Texture. Released and replaced with the stored Texture if the file is already stored
+	* @return: bool: Successful or not
+	********************/
+	bool AddTexture(std::string _texFileName, ID3D10ShaderResourceView*& _prTex);
+
 	/***********************
 	* RenderBuffer: Renders an Buffer to the screen
 	* @author: Callan Moore
@@ -211,19 +238,7 @@ public:
 	void RestoreDefaultRenderStates();
 	
 	/***********************
-	* ReadFileCounts: Reads and counts all the vertices, texture coords, normals and polygons in the mesh file
-	* @author: Callan Moore
-	* @parameter: filename: The file name of the mesh with file path
-	* @parameter: _rVertexCount: Storage variable to hold the vertex count
-	* @parameter: _rTexCount: Storage variable to hold the texture coordinate count
-	* @parameter: _rNormalCount: Storage variable to hold the normals count
-	* @parameter: _rPolygonCount: Storage variable to hold the polygon count
-	* @return: bool: Successful or not
-	********************/
-	bool ReadFileCounts(std::string  filename, int& _rVertexCount, int& _rTexCount, int& _rNormalCount, int& _rPolygonCount);
-	
-	/***********************
-	* LoadMeshObj: Load in a Mesh Object from a file
+	* LoadMeshObj: Load in a Mesh Object from a file in a single pass over the memory mapped file
 	* @author: Callan Moore
 	* @parameter: _fileName: The file name of the mesh with file path
 	* @parameter: _prVertexBuffer: Storage variable to hold the created Vertex buffer
@@ -320,6 +335,13 @@ public:
 	********************/
 	void CalcProjMatrix();
 	
+	/***********************
+	* GetDevice: Retrieve the DX10 Device
+	* @author: Callan Moore
+	* @return: ID3D10Device*: The DX10 Device
+	********************/
+	ID3D10Device* GetDevice() { return m_pDX10Device; };
+
 	/***********************
 	* GetViewMatrix: Retrieve the View Matrix
 	* @author: Callan Moore
@@ -376,6 +398,13 @@ public:
 	********************/
 	int GetHeight() { return m_clientHeight; };
 
+	/***********************
+	* GetTrianglesDrawn: Retrieve the number of triangles the last frame submitted through RenderBuffer, shadow passes included
+	* @author: Callan Moore
+	* @return: UINT: The number of triangles
+	********************/
+	UINT GetTrianglesDrawn() { return m_trianglesLastFrame; };
+
 	/***********************
 	* IsFullscreen: Retrieve the current full screen state
 	* @author: Juran Griffith
@@ -425,6 +454,11 @@ private:
 	D3DXMATRIX m_matOrtho;
 	D3DXVECTOR3 m_eyePos;
 
+	// Frame statistics
+	D3D_PRIMITIVE_TOPOLOGY m_primTopology;
+	UINT m_trianglesDrawn;
+	UINT m_trianglesLastFrame;
+
 	// DX10 Variables
 	ID3D10Device*    m_pDX10Device;
 	IDXGISwapChain*  m_pDX10SwapChain;
@@ -20,6 +20,10 @@
 // Library Includes
 #include <d3dx10.h>
 
+// Defines
+// Largest magnitude a half precision float can hold
+#define HALF_MAX 65504.0f
+
 // Enumerators
 enum eVertexType
 {
@@ -27,7 +31,9 @@ enum eVertexType
 	VT_COLOR,
 	VT_UV,
 	VT_COLOR_UV,
-	VT_NORMAL_UV
+	VT_NORMAL_UV,
+	VT_HALF_COLOR,
+	VT_COMPACT_NORMAL_UV
 };
 
 /***********************
@@ -81,4 +87,121 @@ struct TVertexNormalUV
 	v2float		uv;
 };
 
+/***********************
+* TVertexHalfColor: Compact Vertex with a half precision Position and an RGBA8 Color. 12 bytes instead of the 28 of TVertexColor
+* @author: Callan Moore
+********************/
+struct TVertexHalfColor
+{
+	D3DXFLOAT16 pos[4];
+	UINT		color;
+};
+
+/***********************
+* TVertexCompactNormalUV: Compact Vertex with an Octahedral encoded Normal and half precision UVs. 20 bytes instead of the 32 of TVertexNormalUV
+* @author: Callan Moore
+********************/
+struct TVertexCompactNormalUV
+{
+	D3DXVECTOR3 pos;
+	short		normal[2];
+	D3DXFLOAT16 uv[2];
+};
+
+/***********************
+* PackColorRGBA8: Pack a color into four bytes in the order of DXGI_FORMAT_R8G8B8A8_UNORM
+* @author: Callan Moore
+* @parameter: _color: The color to pack
+* @return: UINT: The packed color
+********************/
+inline UINT PackColorRGBA8(const D3DXCOLOR& _color)
+{
+	UINT red = (UINT)(min(max(_color.r, 0.0f), 1.0f) * 255.0f + 0.5f);
+	UINT green = (UINT)(min(max(_color.g, 0.0f), 1.0f) * 255.0f + 0.5f);
+	UINT blue = (UINT)(min(max(_color.b, 0.0f), 1.0f) * 255.0f + 0.5f);
+	UINT alpha = (UINT)(min(max(_color.a, 0.0f), 1.0f) * 255.0f + 0.5f);
+
+	return red | (green << 8) | (blue << 16) | (alpha << 24);
+}
+
+/***********************
+* PackHalf: Convert a float to half precision, clamped to the range a half can hold instead of overflowing to infinity
+* @author: Callan Moore
+* @parameter: _value: The value to convert
+* @return: D3DXFLOAT16: The half precision value
+********************/
+inline D3DXFLOAT16 PackHalf(float _value)
+{
+	return D3DXFLOAT16(min(max(_value, -HALF_MAX), HALF_MAX));
+}
+
+/***********************
+* CalcPackOrigin: Calculate the centre of the bounds of a set of Color Vertices. Packing positions relative to it keeps them
+*	as small as the set itself, so half precision loses no more than it would for a set at the world origin
+* @author: Callan Moore
+* @parameter: _pVertices: The vertices
+* @parameter: _count: The number of vertices
+* @return: D3DXVECTOR3: The centre of the bounds. The world origin if there are no vertices
+********************/
+inline D3DXVECTOR3 CalcPackOrigin(const TVertexColor* _pVertices, int _count)
+{
+	if (_count <= 0)
+	{
+		return D3DXVECTOR3(0.0f, 0.0f, 0.0f);
+	}
+
+	D3DXVECTOR3 lowest = _pVertices[0].pos;
+	D3DXVECTOR3 highest = _pVertices[0].pos;
+	for (int i = 1; i < _count; i++)
+	{
+		D3DXVec3Minimize(&lowest, &lowest, &_pVertices[i].pos);
+		D3DXVec3Maximize(&highest, &highest, &_pVertices[i].pos);
+	}
+
+	return (lowest + highest) * 0.5f;
+}
+
+/***********************
+* PackVertexHalfColor: Pack a Color Vertex into the compact half precision format used on the GPU
+* @author: Callan Moore
+* @parameter: _vertex: The vertex to pack
+* @parameter: _origin: The point the packed position is relative to. Added back by the world matrix when drawn
+* @parameter: _prPacked: Storage for the packed vertex
+* @return: void
+********************/
+inline void PackVertexHalfColor(const TVertexColor& _vertex, const D3DXVECTOR3& _origin, TVertexHalfColor& _prPacked)
+{
+	_prPacked.pos[0] = PackHalf(_vertex.pos.x - _origin.x);
+	_prPacked.pos[1] = PackHalf(_vertex.pos.y - _origin.y);
+	_prPacked.pos[2] = PackHalf(_vertex.pos.z - _origin.z);
+	_prPacked.pos[3] = D3DXFLOAT16(1.0f);
+	_prPacked.color = PackColorRGBA8(_vertex.color);
+}
+
+/***********************
+* EncodeOctahedral: Encode a unit normal onto the two components of an octahedron for DXGI_FORMAT_R16G16_SNORM
+* @author: Callan Moore
+* @parameter: _normal: The normal to encode
+* @parameter: _pOut: Storage for the two encoded components
+* @return: void
+********************/
+inline void EncodeOctahedral(const D3DXVECTOR3& _normal, short* _pOut)
+{
+	float sum = fabs(_normal.x) + fabs(_normal.y) + fabs(_normal.z);
+	float u = (sum > 0.0f) ? (_normal.x / sum) : 0.0f;
+	float v = (sum > 0.0f) ? (_normal.y / sum) : 0.0f;
+
+	if (_normal.z < 0.0f)
+	{
+		// Fold the lower half of the octahedron over the upper half
+		float foldedU = (1.0f - fabs(v)) * ((u >= 0.0f) ? 1.0f : -1.0f);
+		float foldedV = (1.0f - fabs(u)) * ((v >= 0.0f) ? 1.0f : -1.0f);
+		u = foldedU;
+		v = foldedV;
+	}
+
+	_pOut[0] = (short)(u * 32767.0f + ((u >= 0.0f) ? 0.5f : -0.5f));
+	_pOut[1] = (short)(v * 32767.0f + ((v >= 0.0f) ? 0.5f : -0.5f));
+}
+
 #endif // __DX10_VERTEX_H__
\ No newline at end of file
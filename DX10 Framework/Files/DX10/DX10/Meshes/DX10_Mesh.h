@@ -19,6 +19,7 @@
 
 // Local Includes
 #include "../DX10_Renderer.h"
+#include "../Systems/DX10_MeshCache.h"
 
 // Enumerators
 /***********************
@@ -48,6 +49,19 @@ public:
 	DX10_Mesh() 
 	{
 		m_initialisedDS = false;
+		m_terrainGeneration = 0;
+		m_vertexType = VT_NORMAL_UV;
+		m_boundingRadius = 0.0f;
+		m_packOrigin = D3DXVECTOR3(0.0f, 0.0f, 0.0f);
+
+		// Initialise pointers to NULL
+		m_pBuffer = 0;
+		m_pVertexBuffer = 0;
+		m_pVertexBufferCloth = 0;
+		m_pIndexBuffer = 0;
+		m_pWriteCornerIndices = 0;
+		m_pReadCornerIndices = 0;
+		m_pVertexCalculated = 0;
 	}
 
 	/***********************
@@ -74,7 +88,24 @@ public:
 	********************/
 	bool Initialise(DX10_Renderer* _pRenderer, eMeshType _meshType, v3float _scale)
 	{
-		if (_pRenderer == 0)
+		// Load the Mesh File through its binary cache, which is built on the first load
+		DX10_MeshCache cache;
+		VALIDATE(cache.Initialise(GetFilePath(_meshType), _scale));
+
+		return Initialise(_pRenderer, &cache, _scale);
+	}
+
+	/***********************
+	* Initialise: Initialise a new mesh from a mesh cache that is already loaded, such as one from the asset loader
+	* @author: Callan Moore
+	* @parameter: _pRenderer: The renderer for the mesh
+	* @parameter: _pCache: The loaded mesh cache. Only needed until this returns
+	* @parameter: _scale: 3D scalar the mesh was loaded with
+	* @return: bool: Successful or not
+	********************/
+	bool Initialise(DX10_Renderer* _pRenderer, DX10_MeshCache* _pCache, v3float _scale)
+	{
+		if (_pRenderer == 0 || _pCache == 0)
 		{
 			return false;
 		}
@@ -83,34 +114,48 @@ public:
 		m_pRenderer = _pRenderer;
 		m_scale = _scale;
 		m_primTopology = D3D10_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+		m_vertexType = VT_NORMAL_UV;
 		int stride = sizeof(TVertexNormalUV);
+		m_vertexCount = (int)_pCache->GetVertexCount();
+		m_indexCount = (int)_pCache->GetIndexCount();
 	
-		// Load the Mesh File
-		std::string fileName = GetFilePath(_meshType);
-		VALIDATE(m_pRenderer->LoadMeshObj(fileName, m_pVertexBuffer, m_pIndexBuffer, &m_vertexCount, &m_indexCount, m_scale));
-	
-		// Create the buffer
-		VALIDATE(m_pRenderer->CreateBuffer(m_pVertexBuffer, m_pIndexBuffer, m_vertexCount, m_indexCount, stride, m_pBuffer, D3D10_USAGE_DYNAMIC, D3D10_USAGE_DEFAULT));
+		// Create the buffer straight from the mapped cache. The mesh keeps no copy of the vertices
+		if (_pCache->GetIndexStride() == sizeof(WORD))
+		{
+			VALIDATE(m_pRenderer->CreateBuffer(_pCache->GetVertices(), (const WORD*)_pCache->GetIndices(), m_vertexCount, m_indexCount, stride, m_pBuffer, D3D10_USAGE_DYNAMIC, D3D10_USAGE_DEFAULT));
+		}
+		else
+		{
+			VALIDATE(m_pRenderer->CreateBuffer(_pCache->GetVertices(), (const DWORD*)_pCache->GetIndices(), m_vertexCount, m_indexCount, stride, m_pBuffer, D3D10_USAGE_DYNAMIC, D3D10_USAGE_DEFAULT));
+		}
+
+		// The index buffer holds every level of detail, so each draw picks its range
+		m_lods = _pCache->GetLods();
+
+		// Sphere around the origin of the Mesh that holds the whole bounding box
+		v3float boundsMin = _pCache->GetBoundsMin();
+		v3float boundsMax = _pCache->GetBoundsMax();
+		v3float farCorner = { max(fabs(boundsMin.x), fabs(boundsMax.x)), max(fabs(boundsMin.y), fabs(boundsMax.y)), max(fabs(boundsMin.z), fabs(boundsMax.z)) };
+		m_boundingRadius = farCorner.Magnitude();
 	
 		return true;
 	}
 	
 	/***********************
-	* InitialiseCloth: Initialise a Mesh to be used as a cloth
+	* InitialiseCloth: Initialise a Mesh to be used as a cloth. The GPU copy of the vertices is packed as TVertexHalfColor
 	* @author: Callan Moore
 	* @parameter: _pRenderer: The renderer for the mesh
 	* @parameter: _pVertices: The Vertices list
 	* @parameter: _pIndices: The Indices list
 	* @parameter: _vertexCount: The number of vertices
 	* @parameter: _indexCount: The number of indices
-	* @parameter: _stride: The stride of the vertices
 	* @parameter: _topology: The topology to be used
 	* @parameter: _vertexUsage: The usage flag for creating the vertex buffer
 	* @parameter: _indexUsage: The usage flag for creating the index buffer
 	* @return: bool: Successful or not
 	********************/
-	template<typename TIndices, typename TVertices>
-	bool InitialiseCloth(DX10_Renderer* _pRenderer, TVertices* _pVertices, TIndices* _pIndices, UINT _vertexCount, UINT _indexCount, UINT _stride, D3D10_PRIMITIVE_TOPOLOGY _topology, D3D10_USAGE _vertexUsage = D3D10_USAGE_IMMUTABLE, D3D10_USAGE _indexUsage = D3D10_USAGE_IMMUTABLE)
+	template<typename TIndices>
+	bool InitialiseCloth(DX10_Renderer* _pRenderer, TVertexColor* _pVertices, TIndices* _pIndices, UINT _vertexCount, UINT _indexCount, D3D10_PRIMITIVE_TOPOLOGY _topology, D3D10_USAGE _vertexUsage = D3D10_USAGE_IMMUTABLE, D3D10_USAGE _indexUsage = D3D10_USAGE_IMMUTABLE)
 	{
 		if (_pRenderer == 0 || _pVertices == 0 || _pIndices == 0)
 		{
@@ -119,14 +164,58 @@ public:
 
 		m_pRenderer = _pRenderer;
 		m_primTopology = _topology;
-		int stride = _stride;
+		m_vertexType = VT_HALF_COLOR;
+		int stride = sizeof(TVertexHalfColor);
 		m_indexCount = _indexCount;
 		m_vertexCount = _vertexCount;
 		m_pVertexBufferCloth = _pVertices;
 		m_pIndexBuffer = _pIndices;
 
+		// Pack the starting vertices to create the buffer with
+		TVertexHalfColor* pPacked = new TVertexHalfColor[m_vertexCount];
+		PackVerticesCloth(pPacked);
+
 		// Create the buffer
-		VALIDATE(m_pRenderer->CreateBuffer(m_pVertexBufferCloth, m_pIndexBuffer, m_vertexCount, m_indexCount, stride, m_pBuffer, _vertexUsage, _indexUsage));
+		bool created = m_pRenderer->CreateBuffer(pPacked, m_pIndexBuffer, m_vertexCount, m_indexCount, stride, m_pBuffer, _vertexUsage, _indexUsage);
+		ReleasePtrArray(pPacked);
+		VALIDATE(created);
+
+		return true;
+	}
+
+	/***********************
+	* InitialisePacked: Initialise a Mesh with no vertices of its own that is written with already packed TVertexHalfColor vertices
+	* @author: Callan Moore
+	* @parameter: _pRenderer: The renderer for the mesh
+	* @parameter: _vertexCount: The number of vertices
+	* @parameter: _indexCount: The number of indices
+	* @parameter: _topology: The topology to be used
+	* @return: bool: Successful or not
+	********************/
+	bool InitialisePacked(DX10_Renderer* _pRenderer, UINT _vertexCount, UINT _indexCount, D3D10_PRIMITIVE_TOPOLOGY _topology)
+	{
+		if (_pRenderer == 0)
+		{
+			return false;
+		}
+
+		m_pRenderer = _pRenderer;
+		m_primTopology = _topology;
+		m_vertexType = VT_HALF_COLOR;
+		int stride = sizeof(TVertexHalfColor);
+		m_indexCount = _indexCount;
+		m_vertexCount = _vertexCount;
+
+		// Create the buffer empty until the first vertices are written
+		TVertexHalfColor* pVertices = new TVertexHalfColor[m_vertexCount];
+		DWORD* pIndices = new DWORD[m_indexCount];
+		memset(pVertices, 0, sizeof(TVertexHalfColor) * m_vertexCount);
+		memset(pIndices, 0, sizeof(DWORD) * m_indexCount);
+
+		bool created = m_pRenderer->CreateBuffer(pVertices, pIndices, m_vertexCount, m_indexCount, stride, m_pBuffer, D3D10_USAGE_DYNAMIC, D3D10_USAGE_DYNAMIC);
+		ReleasePtrArray(pVertices);
+		ReleasePtrArray(pIndices);
+		VALIDATE(created);
 
 		return true;
 	}
@@ -149,11 +238,12 @@ public:
 		m_pRenderer = _pRenderer;
 		m_scale = _scale;
 		m_primTopology = D3D10_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP;
+		m_vertexType = VT_COMPACT_NORMAL_UV;
 		m_size = _size;
 
 		m_vertexCount = (int)pow(_size, 2);
 		m_pVertexBuffer = new TVertexNormalUV[m_vertexCount];
-		int stride = sizeof(TVertexNormalUV);
+		int stride = sizeof(TVertexCompactNormalUV);
 	
 		for (int i = 0; i < m_vertexCount; i++)
 		{
@@ -205,8 +295,14 @@ public:
 			}
 		}
 
+		// Pack the starting vertices to create the buffer with
+		TVertexCompactNormalUV* pPacked = new TVertexCompactNormalUV[m_vertexCount];
+		PackVertices(pPacked);
+
 		// Create the buffer
-		VALIDATE(m_pRenderer->CreateBuffer(m_pVertexBuffer, m_pIndexBuffer, m_vertexCount, m_indexCount, stride, m_pBuffer, D3D10_USAGE_DYNAMIC, D3D10_USAGE_DEFAULT));
+		bool created = m_pRenderer->CreateBuffer(pPacked, m_pIndexBuffer, m_vertexCount, m_indexCount, stride, m_pBuffer, D3D10_USAGE_DYNAMIC, D3D10_USAGE_DEFAULT);
+		ReleasePtrArray(pPacked);
+		VALIDATE(created);
 
 		return true;
 	}
@@ -214,12 +310,50 @@ public:
 	/***********************
 	* Render: Render the Mesh
 	* @author: Callan Moore
+	* @parameter: _lod: The level of detail to draw. Zero for the full Mesh. Clamped to the lowest level the Mesh has
 	* @return: void
 	********************/
-	virtual void Render()
+	virtual void Render(UINT _lod = 0)
 	{
+		if (m_lods.empty() == false)
+		{
+			const TMeshLod& rLod = m_lods[min(_lod, (UINT)m_lods.size() - 1)];
+			m_pBuffer->SetDrawRange(rLod.IndexStart, rLod.IndexCount);
+		}
 		m_pRenderer->RenderBuffer(m_pBuffer);
 	}
+
+	/***********************
+	* SelectLod: Choose the lowest level of detail whose error stays under a number of pixels on screen
+	* @author: Callan Moore
+	* @parameter: _pixelsPerUnit: The size on screen, in pixels, of one unit of the Mesh at the distance it is drawn
+	* @parameter: _maxPixelError: Most pixels the surface may move by
+	* @return: UINT: The level of detail. Zero for the full Mesh
+	********************/
+	UINT SelectLod(float _pixelsPerUnit, float _maxPixelError)
+	{
+		for (UINT i = (UINT)m_lods.size(); i > 1; i--)
+		{
+			if (m_lods[i - 1].Error * _pixelsPerUnit <= _maxPixelError)
+			{
+				return (i - 1);
+			}
+		}
+		return 0;
+	}
+
+	/***********************
+	* ReleaseBuffer: Release the GPU buffer of the Mesh straight away instead of when the Renderer shuts down
+	* @author: Callan Moore
+	* @return: void
+	********************/
+	void ReleaseBuffer()
+	{
+		if (m_pBuffer != 0)
+		{
+			m_pRenderer->DestroyBuffer(m_pBuffer);
+		}
+	}
 	
 	/***********************
 	* GetFilePath: Retrieve the file path of the mesh type
@@ -227,7 +361,7 @@ public:
 	* @parameter: _meshType: The type of mesh to retrieve the file path for
 	* @return: std::string: File path
 	********************/
-	std::string GetFilePath(eMeshType _meshType)
+	static std::string GetFilePath(eMeshType _meshType)
 	{
 		switch (_meshType)
 		{
@@ -287,12 +421,62 @@ public:
 	********************/
 	D3D_PRIMITIVE_TOPOLOGY GetPrimTopology() { return m_primTopology; };
 
+	/***********************
+	* GetLodCount: Retrieve the number of levels of detail
+	* @author: Callan Moore
+	* @return: UINT: The number of levels, the full Mesh included. Zero for Meshes not loaded from a file
+	********************/
+	UINT GetLodCount() { return (UINT)m_lods.size(); };
+
+	/***********************
+	* GetBoundingRadius: Retrieve the radius of a sphere around the origin of the Mesh that holds every vertex
+	* @author: Callan Moore
+	* @return: float: The radius. Zero for Meshes not loaded from a file
+	********************/
+	float GetBoundingRadius() { return m_boundingRadius; };
+
+	/***********************
+	* GetPackOrigin: Retrieve the point the half precision positions in the GPU buffer are relative to
+	* @author: Callan Moore
+	* @return: D3DXVECTOR3: The origin. The world origin for Meshes that are not packed relative to their bounds
+	********************/
+	D3DXVECTOR3 GetPackOrigin() { return m_packOrigin; };
+
+	/***********************
+	* SetPackOrigin: Set the point the half precision positions in the GPU buffer are relative to, for vertices packed elsewhere
+	* @author: Callan Moore
+	* @parameter: _origin: The origin
+	* @return: void
+	********************/
+	void SetPackOrigin(D3DXVECTOR3 _origin) { m_packOrigin = _origin; };
+
+	/***********************
+	* GetBuffer: Retrieve the GPU buffer of the Mesh
+	* @author: Callan Moore
+	* @return: DX10_Buffer*: The Vertex and Index Buffers
+	********************/
+	DX10_Buffer* GetBuffer() { return m_pBuffer; };
+
+	/***********************
+	* GetVertexType: Retrieve the type of the vertices in the GPU buffer of the Mesh
+	* @author: Callan Moore
+	* @return: eVertexType: The Vertex Type
+	********************/
+	eVertexType GetVertexType() { return m_vertexType; };
+
 	/***********************
 	* GetScale: Gets the Scale of the Mesh
 	* @author: Jc Fowles
 	* @return: float: The Scale of the Mesh
 	********************/
 	v3float GetScale(){ return m_scale; };
+
+	/***********************
+	* GetSize: Retrieve the number of vertices along each side of a Plane mesh
+	* @author: Callan Moore
+	* @return: int: The vertices along each side
+	********************/
+	int GetSize() { return m_size; };
 	
 	/***********************
 	* GetVertexBuffer: Retrieve the Vertex Buffer of the Mesh
@@ -346,6 +530,9 @@ public:
 
 		// Calculate the maximum amount of iterations based on the size
 		m_iterationsLeft = (int)(log((float)m_size - 1.0f) / log(2.0f));
+
+		// Each generation draws its own values so regenerating after a reset gives a new terrain
+		m_terrainGeneration++;
 	}
 
 	/***********************
@@ -375,6 +562,9 @@ public:
 			// Calculate the roughness factor
 			float roughness = ((1.0f / (iters)) * (((float)m_size - 1.0f) / 2.0f) * m_scale.y) * 0.90f;
 
+			// The generation fills the high half of the random index and the vertex the low half
+			UINT64 generationIndex = (UINT64)m_terrainGeneration << 32;
+
 			for (int i = 0; i < squares; i++)
 			{
 				// Read the next four corners from the Read Vector
@@ -399,7 +589,7 @@ public:
 				//Check if the Left middle position of the square has already been calculated
 				if (m_pVertexCalculated[left] == false)
 				{
-					float random = (float)(rand() % 1000 - 500) / 500;
+					float random = RandomRange(GetRandomSeed(), RS_TERRAIN, generationIndex + left, -1.0f, 1.0f);
 					float modifier = random * roughness;
 
 					m_pVertexBuffer[left].pos.y += (m_pVertexBuffer[topLeft].pos.y + m_pVertexBuffer[topRight].pos.y) / 2 + modifier;
@@ -408,7 +598,7 @@ public:
 				//Check if the top middle position of the square has already been calculated
 				if (m_pVertexCalculated[top] == false)
 				{
-					float random = (float)(rand() % 1000 - 500) / 500;
+					float random = RandomRange(GetRandomSeed(), RS_TERRAIN, generationIndex + top, -1.0f, 1.0f);
 					float modifier = random * roughness;
 
 					m_pVertexBuffer[top].pos.y += (m_pVertexBuffer[topLeft].pos.y + m_pVertexBuffer[bottomLeft].pos.y) / 2 + modifier;
@@ -417,7 +607,7 @@ public:
 				//Check if the right middle position of the square has already been calculated
 				if (m_pVertexCalculated[right] == false)
 				{
-					float random = (float)(rand() % 1000 - 500) / 500;
+					float random = RandomRange(GetRandomSeed(), RS_TERRAIN, generationIndex + right, -1.0f, 1.0f);
 					float modifier = random * roughness;
 
 					m_pVertexBuffer[right].pos.y += (m_pVertexBuffer[bottomLeft].pos.y + m_pVertexBuffer[bottomRight].pos.y) / 2 + modifier;
@@ -426,16 +616,13 @@ public:
 				//Check if the bottom middle position of the square has already been calculated
 				if (m_pVertexCalculated[bottom] == false)
 				{
-					float random = (float)(rand() % 1000 - 500) / 500;
+					float random = RandomRange(GetRandomSeed(), RS_TERRAIN, generationIndex + bottom, -1.0f, 1.0f);
 					float modifier = random * roughness;
 
 					m_pVertexBuffer[bottom].pos.y += (m_pVertexBuffer[topRight].pos.y + m_pVertexBuffer[bottomRight].pos.y) / 2 + modifier;
 					m_pVertexCalculated[bottom] = true;
 				}
 
-				// Update the Buffer to reflect the changes
-				UpdateBuffer();
-
 				// Add all new points to Write Vector
 				// New Square One
 				m_pWriteCornerIndices->push_back(topLeft);
@@ -461,6 +648,10 @@ public:
 				m_pWriteCornerIndices->push_back(right);
 				m_pWriteCornerIndices->push_back(bottomRight);
 			}
+
+			// Update the Buffer once all the squares of this step are calculated
+			UpdateBuffer();
+
 			// Swap read and write vectors
 			ReleasePtr(m_pReadCornerIndices);
 			m_pReadCornerIndices = m_pWriteCornerIndices;
@@ -493,8 +684,16 @@ public:
 		// Lock the memory
 		pVertexBuff->Map(D3D10_MAP_WRITE_DISCARD, 0, (void**)&verticesPtr);
 
-		//Copy the new Vertex Buffer into the pointer to the GPU Vertex Buffer
-		memcpy(verticesPtr, (void*)m_pVertexBuffer, sizeof(TVertexNormalUV) * m_vertexCount);
+		if (m_vertexType == VT_COMPACT_NORMAL_UV)
+		{
+			// Pack the Vertex Buffer straight into the GPU Vertex Buffer
+			PackVertices((TVertexCompactNormalUV*)verticesPtr);
+		}
+		else
+		{
+			//Copy the new Vertex Buffer into the pointer to the GPU Vertex Buffer
+			memcpy(verticesPtr, (void*)m_pVertexBuffer, sizeof(TVertexNormalUV) * m_vertexCount);
+		}
 
 		// Unlock the memory
 		pVertexBuff->Unmap();
@@ -503,9 +702,10 @@ public:
 	/***********************
 	* UpdateBufferCloth: Update the Meshes Vertex buffer for Cloth for the GPU
 	* @author: Callan Moore
+	* @parameter: _updateIndices: Whether the indices have changed and need to be uploaded as well
 	* @return: void
 	********************/
-	void UpdateBufferCloth()
+	void UpdateBufferCloth(bool _updateIndices = true)
 	{
 		// Retrieve the current Vertex Buffer used by the GPU
 		ID3D10Buffer* pVertexBuff = m_pBuffer->GetVertexBuffer();
@@ -514,12 +714,18 @@ public:
 		// Lock the memory
 		pVertexBuff->Map(D3D10_MAP_WRITE_DISCARD, 0, (void**)&verticesPtr);
 
-		//Copy the new Vertex Buffer into the pointer to the GPU Vertex Buffer
-		memcpy(verticesPtr, (void*)m_pVertexBufferCloth, sizeof(TVertexColor) * m_vertexCount);
+		// Pack the Vertex Buffer straight into the GPU Vertex Buffer
+		PackVerticesCloth((TVertexHalfColor*)verticesPtr);
 
 		// Unlock the memory
 		pVertexBuff->Unmap();
 
+		if (_updateIndices == false)
+		{
+			// The index buffer on the GPU is still current
+			return;
+		}
+
 		// Retrieve the current Index Buffer used by the GPU
 		ID3D10Buffer* pIndexBuff = m_pBuffer->GetIndexBuffer();
 		void* indicesPtr;
@@ -534,6 +740,61 @@ public:
 		pIndexBuff->Unmap();
 	}
 
+	/***********************
+	* MapVertexBuffer: Lock the GPU Vertex Buffer to be rewritten. Its previous contents are discarded
+	* @author: Callan Moore
+	* @return: void*: The memory to write the vertices to
+	********************/
+	void* MapVertexBuffer()
+	{
+		void* verticesPtr = 0;
+		m_pBuffer->GetVertexBuffer()->Map(D3D10_MAP_WRITE_DISCARD, 0, &verticesPtr);
+		return verticesPtr;
+	}
+
+	/***********************
+	* UnmapVertexBuffer: Unlock the GPU Vertex Buffer
+	* @author: Callan Moore
+	* @return: void
+	********************/
+	void UnmapVertexBuffer() { m_pBuffer->GetVertexBuffer()->Unmap(); };
+
+	/***********************
+	* MapIndexBuffer: Lock the GPU Index Buffer to be rewritten. Its previous contents are discarded
+	* @author: Callan Moore
+	* @return: void*: The memory to write the indices to
+	********************/
+	void* MapIndexBuffer()
+	{
+		void* indicesPtr = 0;
+		m_pBuffer->GetIndexBuffer()->Map(D3D10_MAP_WRITE_DISCARD, 0, &indicesPtr);
+		return indicesPtr;
+	}
+
+	/***********************
+	* UnmapIndexBuffer: Unlock the GPU Index Buffer
+	* @author: Callan Moore
+	* @return: void
+	********************/
+	void UnmapIndexBuffer() { m_pBuffer->GetIndexBuffer()->Unmap(); };
+
+	/***********************
+	* SetDrawCount: Set how many indices, or vertices for a mesh without indices, are rendered
+	* @author: Callan Moore
+	* @parameter: _drawCount: The number to render
+	* @return: void
+	********************/
+	void SetDrawCount(UINT _drawCount) { m_pBuffer->SetDrawCount(_drawCount); };
+
+	/***********************
+	* SetDrawRange: Set a range of indices, or vertices for a mesh without indices, to render
+	* @author: Callan Moore
+	* @parameter: _drawStart: The first to render
+	* @parameter: _drawCount: The number to render
+	* @return: void
+	********************/
+	void SetDrawRange(UINT _drawStart, UINT _drawCount) { m_pBuffer->SetDrawRange(_drawStart, _drawCount); };
+
 	/***********************
 	* ResetPlane: Reset a plane mesh to default values
 	* @author: Callan Moore
@@ -701,10 +962,11 @@ public:
 			}
 		}
 
-		// Normalise each normal collection and store on the Vertices
+		// Normalise each normal collection four at a time and store on the Vertices
+		BatchNormalise((v3float*)normalBuffer, (v3float*)normalBuffer, m_vertexCount, NA_REFINED);
 		for (int i = 0; i < m_vertexCount; i++)
 		{
-			D3DXVec3Normalize(&m_pVertexBuffer[i].normal, &normalBuffer[i]);
+			m_pVertexBuffer[i].normal = normalBuffer[i];
 		}
 
 		// Update the Meshes buffer to reflect changes
@@ -712,13 +974,52 @@ public:
 		ReleasePtrArray(normalBuffer);
 	}
 
+private:
+
+	/***********************
+	* PackVertices: Pack the Vertex Buffer into the compact format used on the GPU
+	* @author: Callan Moore
+	* @parameter: _pOut: Storage for the packed vertices
+	* @return: void
+	********************/
+	void PackVertices(TVertexCompactNormalUV* _pOut)
+	{
+		for (int i = 0; i < m_vertexCount; i++)
+		{
+			_pOut[i].pos = m_pVertexBuffer[i].pos;
+			EncodeOctahedral(m_pVertexBuffer[i].normal, _pOut[i].normal);
+			_pOut[i].uv[0] = D3DXFLOAT16(m_pVertexBuffer[i].uv.x);
+			_pOut[i].uv[1] = D3DXFLOAT16(m_pVertexBuffer[i].uv.y);
+		}
+	}
+
+	/***********************
+	* PackVerticesCloth: Pack the Vertex Buffer for Cloth into the compact format used on the GPU
+	* @author: Callan Moore
+	* @parameter: _pOut: Storage for the packed vertices
+	* @return: void
+	********************/
+	void PackVerticesCloth(TVertexHalfColor* _pOut)
+	{
+		// Positions are packed relative to the centre of the cloth so their precision does not depend on where the cloth is
+		m_packOrigin = CalcPackOrigin(m_pVertexBufferCloth, m_vertexCount);
+		for (int i = 0; i < m_vertexCount; i++)
+		{
+			PackVertexHalfColor(m_pVertexBufferCloth[i], m_packOrigin, _pOut[i]);
+		}
+	}
+
 private:
 	DX10_Renderer* m_pRenderer;
 	DX10_Buffer* m_pBuffer;
 	D3D_PRIMITIVE_TOPOLOGY m_primTopology;
+	eVertexType m_vertexType;
 	v3float m_scale;
 	int m_vertexCount;
 	int m_indexCount;
+	std::vector<TMeshLod> m_lods;
+	float m_boundingRadius;
+	D3DXVECTOR3 m_packOrigin;
 
 	TVertexNormalUV* m_pVertexBuffer;
 	TVertexColor* m_pVertexBufferCloth;
@@ -729,6 +1030,7 @@ private:
 	bool* m_pVertexCalculated;
 	bool m_initialisedDS;
 	int m_iterationsLeft;
+	UINT m_terrainGeneration;
 };
 
 #endif	// __DX10_MESH_GENERIC_H__
@@ -109,7 +109,11 @@ public:
 			m_pCurrentTech->GetDesc(&techDesc);
 			for (UINT p = 0; p < techDesc.Passes; ++p)
 			{
-				D3DXMATRIX matWorld = *_cloth.pMatWorld;
+				// Move the packed positions back from the origin they are relative to before the world transform
+				D3DXVECTOR3 packOrigin = _cloth.pMesh->GetPackOrigin();
+				D3DXMATRIX matPackOrigin;
+				D3DXMatrixTranslation(&matPackOrigin, packOrigin.x, packOrigin.y, packOrigin.z);
+				D3DXMATRIX matWorld = matPackOrigin * *_cloth.pMatWorld;
 				m_pMatWorld->SetMatrix((float*)&matWorld);
 
 				// Apply the variables and send them to the GPU
@@ -169,11 +173,11 @@ private:
 	********************/
 	bool CreateVertexLayout()
 	{
-		// Vertex Desc for a basic vertex with Normals and UV coordinates
+		// Vertex Desc for a compact vertex with a half precision Position and RGBA8 Color (TVertexHalfColor)
 		D3D10_INPUT_ELEMENT_DESC vertexDesc[] =
 		{
-			{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D10_INPUT_PER_VERTEX_DATA, 0 },
-			{ "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, D3D10_APPEND_ALIGNED_ELEMENT, D3D10_INPUT_PER_VERTEX_DATA, 0 }
+			{ "POSITION", 0, DXGI_FORMAT_R16G16B16A16_FLOAT, 0, 0, D3D10_INPUT_PER_VERTEX_DATA, 0 },
+			{ "COLOR", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 0, D3D10_APPEND_ALIGNED_ELEMENT, D3D10_INPUT_PER_VERTEX_DATA, 0 }
 		};
 		UINT elementNum = sizeof(vertexDesc) / sizeof(vertexDesc[0]);
 
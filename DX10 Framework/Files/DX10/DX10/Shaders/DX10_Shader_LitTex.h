@@ -29,6 +29,7 @@
 struct TLitTex
 {
 	DX10_Mesh* pMesh;
+	UINT lod = 0;
 	D3DXMATRIX* pMatWorld;
 	D3DXMATRIX* pMatReflectedView;
 	ID3D10ShaderResourceView* pTexBase;
@@ -45,7 +46,8 @@ enum eTech_LitTex
 	TECH_LITTEX_REFRACT,
 	TECH_LITTEX_REFLECT,
 	TECH_LITTEX_STAR,
-	TECH_LITTEX_NOCULL
+	TECH_LITTEX_NOCULL,
+	TECH_LITTEX_COMPACT
 };
 
 class DX10_Shader_LitTex
@@ -108,6 +110,12 @@ public:
 	********************/
 	void Render(TLitTex _litTex, eTech_LitTex _eTech = TECH_LITTEX_STANDARD)
 	{
+		if (_litTex.pMesh->GetVertexType() == VT_COMPACT_NORMAL_UV)
+		{
+			// Compact vertices (such as terrain) can only be read by the compact technique
+			_eTech = TECH_LITTEX_COMPACT;
+		}
+
 		// Load the correct Technique onto the Current pointers
 		SetCurrentPtrs(_eTech);
 
@@ -156,7 +164,7 @@ public:
 				m_pCurrentTech->GetPassByIndex(p)->Apply(0);
 
 				// Render the Objects Mesh using the loaded technique
-				_litTex.pMesh->Render();
+				_litTex.pMesh->Render(_litTex.lod);
 			}
 		}
 
@@ -180,6 +188,7 @@ private:
 		VALIDATE(m_pDX10_Renderer->BuildFX("litTex.fx", "ReflectTech", m_pFX, m_pTech_Reflect));
 		VALIDATE(m_pDX10_Renderer->BuildFX("litTex.fx", "StarTech", m_pFX, m_pTech_Star));
 		VALIDATE(m_pDX10_Renderer->BuildFX("litTex.fx", "NoCullTech", m_pFX, m_pTech_NoCull));
+		VALIDATE(m_pDX10_Renderer->BuildFX("litTex.fx", "CompactTech", m_pFX, m_pTech_Compact));
 
 		return true;
 	}
@@ -251,6 +260,17 @@ private:
 		m_pDX10_Renderer->CreateVertexLayout(vertexDesc, elementNum, m_pTech_Star, m_pVertexLayout_Star);
 		m_pDX10_Renderer->CreateVertexLayout(vertexDesc, elementNum, m_pTech_NoCull, m_pVertexLayout_NoCull);
 
+		// Vertex Desc for a compact vertex with an Octahedral Normal and half precision UV coordinates (TVertexCompactNormalUV)
+		D3D10_INPUT_ELEMENT_DESC compactVertexDesc[] =
+		{
+			{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D10_INPUT_PER_VERTEX_DATA, 0 },
+			{ "NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0, 12, D3D10_INPUT_PER_VERTEX_DATA, 0 },
+			{ "TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, 16, D3D10_INPUT_PER_VERTEX_DATA, 0 }
+		};
+		UINT compactElementNum = sizeof(compactVertexDesc) / sizeof(compactVertexDesc[0]);
+
+		m_pDX10_Renderer->CreateVertexLayout(compactVertexDesc, compactElementNum, m_pTech_Compact, m_pVertexLayout_Compact);
+
 		return true;
 	}
 
@@ -304,6 +324,12 @@ private:
 			m_pCurrentTech = m_pTech_NoCull;
 		}
 		break;
+		case TECH_LITTEX_COMPACT:
+		{
+			m_pCurrentVertexLayout = m_pVertexLayout_Compact;
+			m_pCurrentTech = m_pTech_Compact;
+		}
+		break;
 		default:
 		{
 			m_pCurrentVertexLayout = 0;
@@ -325,6 +351,7 @@ private:
 	ID3D10InputLayout* m_pVertexLayout_Reflect;
 	ID3D10InputLayout* m_pVertexLayout_Star;
 	ID3D10InputLayout* m_pVertexLayout_NoCull;
+	ID3D10InputLayout* m_pVertexLayout_Compact;
 
 	ID3D10EffectTechnique* m_pCurrentTech;
 	ID3D10EffectTechnique* m_pTech_Standard;
@@ -334,6 +361,7 @@ private:
 	ID3D10EffectTechnique* m_pTech_Reflect;
 	ID3D10EffectTechnique* m_pTech_Star;
 	ID3D10EffectTechnique* m_pTech_NoCull;
+	ID3D10EffectTechnique* m_pTech_Compact;
 
 	DX10_Renderer*						m_pDX10_Renderer;
 
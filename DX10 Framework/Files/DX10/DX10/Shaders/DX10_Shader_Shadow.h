@@ -81,7 +81,10 @@ public:
 	********************/
 	void Render(DX10_Obj_Generic* _pObj, TLight* _pLight, D3DXMATRIX _matLightView, DX10_ShadowMap* _pShadowMap)
 	{
-		m_pDX10_Renderer->SetInputLayout(m_pVertexLayout_Standard);
+		// Compact vertices (such as terrain) can only be read by the compact technique
+		bool compact = (_pObj->GetMesh()->GetVertexType() == VT_COMPACT_NORMAL_UV);
+		ID3D10EffectTechnique* pTech = (compact == true) ? m_pTech_Compact : m_pTech_Standard;
+		m_pDX10_Renderer->SetInputLayout((compact == true) ? m_pVertexLayout_Compact : m_pVertexLayout_Standard);
 
 		m_pShadowMap->SetResource(_pShadowMap->GetShaderResourceView());
 
@@ -90,7 +93,7 @@ public:
 		D3DXMatrixIdentity(&matTex);
 
 		D3D10_TECHNIQUE_DESC techDesc;
-		m_pTech_Standard->GetDesc(&techDesc);
+		pTech->GetDesc(&techDesc);
 
 		for (UINT i = 0; i < techDesc.Passes; ++i)
 		{
@@ -110,8 +113,8 @@ public:
 			D3DXVECTOR3 lightPos = { _pLight->pos_range.x, _pLight->pos_range.y, _pLight->pos_range.z };
 			m_pPos_Light->SetFloatVector((float*)&lightPos);
 
-			m_pTech_Standard->GetPassByIndex(i)->Apply(0);
-			_pObj->GetMesh()->Render();
+			pTech->GetPassByIndex(i)->Apply(0);
+			_pObj->GetMesh()->Render(_pObj->GetLod());
 		}
 	}
 
@@ -125,6 +128,7 @@ private:
 	bool BuildFX()
 	{
 		VALIDATE(m_pDX10_Renderer->BuildFX("Shadow.fx", "BlackWhiteShadowTech", m_pFX, m_pTech_Standard));
+		VALIDATE(m_pDX10_Renderer->BuildFX("Shadow.fx", "BlackWhiteShadowCompactTech", m_pFX, m_pTech_Compact));
 
 		return true;
 	}
@@ -192,6 +196,17 @@ private:
 
 		m_pDX10_Renderer->CreateVertexLayout(vertexDesc, elementNum, m_pTech_Standard, m_pVertexLayout_Standard);
 
+		// Vertex Desc for a compact vertex with an Octahedral Normal and half precision UV coordinates (TVertexCompactNormalUV)
+		D3D10_INPUT_ELEMENT_DESC compactVertexDesc[] =
+		{
+			{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D10_INPUT_PER_VERTEX_DATA, 0 },
+			{ "NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0, 12, D3D10_INPUT_PER_VERTEX_DATA, 0 },
+			{ "TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, 16, D3D10_INPUT_PER_VERTEX_DATA, 0 }
+		};
+		UINT compactElementNum = sizeof(compactVertexDesc) / sizeof(compactVertexDesc[0]);
+
+		m_pDX10_Renderer->CreateVertexLayout(compactVertexDesc, compactElementNum, m_pTech_Compact, m_pVertexLayout_Compact);
+
 		return true;
 	}
 
@@ -201,7 +216,9 @@ private:
 	ID3D10ShaderResourceView*			m_pSpecularTex;
 
 	ID3D10InputLayout*					m_pVertexLayout_Standard;
+	ID3D10InputLayout*					m_pVertexLayout_Compact;
 	ID3D10EffectTechnique*				m_pTech_Standard;
+	ID3D10EffectTechnique*				m_pTech_Compact;
 
 	ID3D10EffectMatrixVariable* m_pMatWVP_Light;
 	ID3D10EffectMatrixVariable* m_pMatWVP_Object;
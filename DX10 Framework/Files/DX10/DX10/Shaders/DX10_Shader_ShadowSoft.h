@@ -80,10 +80,13 @@ public:
 	********************/
 	void Render(DX10_Obj_Generic* _pObj, DX10_ShadowMap* _pShadowMap1 , DX10_ShadowMap* _pShadowMap2)
 	{
-		m_pDX10_Renderer->SetInputLayout(m_pVertexLayout_Standard);
+		// Compact vertices (such as terrain) can only be read by the compact technique
+		bool compact = (_pObj->GetMesh()->GetVertexType() == VT_COMPACT_NORMAL_UV);
+		ID3D10EffectTechnique* pTech = (compact == true) ? m_pTech_Compact : m_pTech_Standard;
+		m_pDX10_Renderer->SetInputLayout((compact == true) ? m_pVertexLayout_Compact : m_pVertexLayout_Standard);
 
 		D3D10_TECHNIQUE_DESC techDesc;
-		m_pTech_Standard->GetDesc(&techDesc);
+		pTech->GetDesc(&techDesc);
 
 		for (UINT i = 0; i < techDesc.Passes; ++i)
 		{
@@ -100,12 +103,12 @@ public:
 			m_pLights->SetRawValue(m_pDX10_Renderer->GetActiveLights(), 0, lightCount * sizeof(TLight));
 			m_pLightCount->SetInt(lightCount);
 
-			m_pTech_Standard->GetPassByIndex(i)->Apply(0);
-			_pObj->GetMesh()->Render();
+			pTech->GetPassByIndex(i)->Apply(0);
+			_pObj->GetMesh()->Render(_pObj->GetLod());
 
 			m_pShadowTex1->SetResource(NULL);
 			m_pShadowTex2->SetResource(NULL);
-			m_pTech_Standard->GetPassByIndex(i)->Apply(0);
+			pTech->GetPassByIndex(i)->Apply(0);
 		}
 	}
 
@@ -119,6 +122,7 @@ private:
 	bool BuildFX()
 	{
 		VALIDATE(m_pDX10_Renderer->BuildFX("ShadowSoft.fx", "SoftShadowTech", m_pFX, m_pTech_Standard));
+		VALIDATE(m_pDX10_Renderer->BuildFX("ShadowSoft.fx", "SoftShadowCompactTech", m_pFX, m_pTech_Compact));
 
 		return true;
 	}
@@ -174,6 +178,17 @@ private:
 
 		m_pDX10_Renderer->CreateVertexLayout(vertexDesc, elementNum, m_pTech_Standard, m_pVertexLayout_Standard);
 
+		// Vertex Desc for a compact vertex with an Octahedral Normal and half precision UV coordinates (TVertexCompactNormalUV)
+		D3D10_INPUT_ELEMENT_DESC compactVertexDesc[] =
+		{
+			{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D10_INPUT_PER_VERTEX_DATA, 0 },
+			{ "NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0, 12, D3D10_INPUT_PER_VERTEX_DATA, 0 },
+			{ "TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, 16, D3D10_INPUT_PER_VERTEX_DATA, 0 }
+		};
+		UINT compactElementNum = sizeof(compactVertexDesc) / sizeof(compactVertexDesc[0]);
+
+		m_pDX10_Renderer->CreateVertexLayout(compactVertexDesc, compactElementNum, m_pTech_Compact, m_pVertexLayout_Compact);
+
 		return true;
 	}
 
@@ -183,7 +198,9 @@ private:
 	ID3D10ShaderResourceView*			m_pSpecularTex;
 
 	ID3D10InputLayout*					m_pVertexLayout_Standard;
+	ID3D10InputLayout*					m_pVertexLayout_Compact;
 	ID3D10EffectTechnique*				m_pTech_Standard;
+	ID3D10EffectTechnique*				m_pTech_Compact;
 
 	ID3D10EffectMatrixVariable* m_pMatWorld;
 	ID3D10EffectMatrixVariable* m_pMatView;
@@ -43,7 +43,8 @@ struct TWater
 ********************/
 enum eTech_Water
 {
-	TECH_WATER_STANDARD
+	TECH_WATER_STANDARD,
+	TECH_WATER_COMPACT
 };
 
 class DX10_Shader_Water
@@ -102,6 +103,12 @@ public:
 	********************/
 	void Render(TWater _water, eTech_Water _eTech)
 	{
+		if (_water.pMesh->GetVertexType() == VT_COMPACT_NORMAL_UV)
+		{
+			// Compact vertices (such as terrain) can only be read by the compact technique
+			_eTech = TECH_WATER_COMPACT;
+		}
+
 		// Load the correct Technique onto the Current pointers
 		SetCurrentPtrs(_eTech);
 
@@ -155,6 +162,7 @@ private:
 	bool BuildFX()
 	{
 		VALIDATE(m_pDX10_Renderer->BuildFX("Water.fx", "StandardTech", m_pFX, m_pTech_Standard));
+		VALIDATE(m_pDX10_Renderer->BuildFX("Water.fx", "CompactTech", m_pFX, m_pTech_Compact));
 
 		return true;
 	}
@@ -212,6 +220,17 @@ private:
 
 		m_pDX10_Renderer->CreateVertexLayout(vertexDesc, elementNum, m_pTech_Standard, m_pVertexLayout_Standard);
 
+		// Vertex Desc for a compact vertex with an Octahedral Normal and half precision UV coordinates (TVertexCompactNormalUV)
+		D3D10_INPUT_ELEMENT_DESC compactVertexDesc[] =
+		{
+			{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D10_INPUT_PER_VERTEX_DATA, 0 },
+			{ "NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0, 12, D3D10_INPUT_PER_VERTEX_DATA, 0 },
+			{ "TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, 16, D3D10_INPUT_PER_VERTEX_DATA, 0 }
+		};
+		UINT compactElementNum = sizeof(compactVertexDesc) / sizeof(compactVertexDesc[0]);
+
+		m_pDX10_Renderer->CreateVertexLayout(compactVertexDesc, compactElementNum, m_pTech_Compact, m_pVertexLayout_Compact);
+
 		return true;
 	}
 
@@ -231,6 +250,12 @@ private:
 			m_pCurrentTech = m_pTech_Standard;
 		}
 		break;
+		case TECH_WATER_COMPACT:
+		{
+			m_pCurrentVertexLayout = m_pVertexLayout_Compact;
+			m_pCurrentTech = m_pTech_Compact;
+		}
+		break;
 		default:
 		{
 			m_pCurrentVertexLayout = 0;
@@ -247,9 +272,11 @@ private:
 
 	ID3D10InputLayout* m_pCurrentVertexLayout;
 	ID3D10InputLayout* m_pVertexLayout_Standard;
+	ID3D10InputLayout* m_pVertexLayout_Compact;
 
 	ID3D10EffectTechnique* m_pCurrentTech;
 	ID3D10EffectTechnique* m_pTech_Standard;
+	ID3D10EffectTechnique* m_pTech_Compact;
 
 	ID3D10EffectMatrixVariable*			m_pMatProj;
 
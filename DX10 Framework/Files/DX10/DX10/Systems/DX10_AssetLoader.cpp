@@ -0,0 +1,365 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : DX10_AssetLoader.cpp
+* Description : Loads meshes, textures and effects on worker threads and creates their device objects on the render thread
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// This Include
+#include "DX10_AssetLoader.h"
+
+DX10_AssetLoader::DX10_AssetLoader()
+{
+	m_pRenderer = 0;
+	m_finishedCount = 0;
+	m_shuttingDown = false;
+	m_progressCallback = 0;
+	m_pProgressUserData = 0;
+}
+
+DX10_AssetLoader::~DX10_AssetLoader()
+{
+	// Stop the workers. Requests still queued are never started
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_shuttingDown = true;
+	}
+	m_queueReady.notify_all();
+	for (UINT i = 0; i < m_threads.size(); i++)
+	{
+		m_threads[i].join();
+	}
+
+	// Textures and effects that were created belong to the renderer. Meshes belong to the loader
+	for (UINT i = 0; i < m_requests.size(); i++)
+	{
+		ReleaseRequest(m_requests[i]);
+		ReleasePtr(m_requests[i]->pMesh);
+		ReleasePtr(m_requests[i]);
+	}
+}
+
+bool DX10_AssetLoader::Initialise(DX10_Renderer* _pRenderer)
+{
+	if (_pRenderer == 0)
+	{
+		return false;
+	}
+	m_pRenderer = _pRenderer;
+
+	// The render thread waits on the workers while they load, so every core is given a worker
+	int threadCount = min(ASSET_LOADER_MAX_THREADS, max(1, (int)std::thread::hardware_concurrency()));
+	for (int i = 0; i < threadCount; i++)
+	{
+		m_threads.push_back(std::thread(&DX10_AssetLoader::WorkerLoop, this));
+	}
+
+	return true;
+}
+
+UINT DX10_AssetLoader::RequestMesh(std::string _fileName, v3float _scale)
+{
+	TAssetRequest* pRequest = NewRequest(AT_MESH, _fileName);
+	pRequest->Scale = _scale;
+	pRequest->pMesh = new DX10_MeshCache();
+
+	return Queue(pRequest);
+}
+
+UINT DX10_AssetLoader::RequestTexture(std::string _texFileName)
+{
+	TAssetRequest* pRequest = NewRequest(AT_TEXTURE, _texFileName);
+
+	// The loader and processor only hold the file name and device until a worker uses them
+	std::string filePath = TEXTUREFILEPATH + _texFileName;
+	if (FAILED(D3DX10CreateAsyncFileLoaderA(filePath.c_str(), &pRequest->pLoader))
+		|| FAILED(D3DX10CreateAsyncShaderResourceViewProcessor(m_pRenderer->GetDevice(), 0, &pRequest->pProcessor)))
+	{
+		pRequest->State = AS_FAILED;
+	}
+
+	return Queue(pRequest);
+}
+
+UINT DX10_AssetLoader::RequestEffect(std::string _fxFileName)
+{
+	TAssetRequest* pRequest = NewRequest(AT_EFFECT, _fxFileName);
+
+	// The same path and flags as DX10_Renderer::BuildFX, so the effect matches one built there
+	std::string fxfilePath = "Resources/FX/" + _fxFileName;
+	if (FAILED(D3DX10CreateAsyncFileLoaderA(fxfilePath.c_str(), &pRequest->pLoader))
+		|| FAILED(D3DX10CreateAsyncEffectCreateProcessor(fxfilePath.c_str(), 0, 0, "fx_4_0", DX10_Renderer::GetShaderFlags(), 0,
+			m_pRenderer->GetDevice(), 0, 0, &pRequest->pProcessor)))
+	{
+		pRequest->State = AS_FAILED;
+	}
+
+	return Queue(pRequest);
+}
+
+void DX10_AssetLoader::SetProgressCallback(AssetProgressCallback _callback, void* _pUserData)
+{
+	m_progressCallback = _callback;
+	m_pProgressUserData = _pUserData;
+}
+
+bool DX10_AssetLoader::Update()
+{
+	std::vector<TAssetRequest*> processed;
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		processed.swap(m_processed);
+	}
+
+	// Device objects are only ever created here so the device is never used from two threads
+	for (UINT i = 0; i < processed.size(); i++)
+	{
+		bool created = (processed[i]->State == AS_PROCESSED && CreateRequest(processed[i]) == true);
+		ReleaseRequest(processed[i]);
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			processed[i]->State = (created == true) ? AS_CREATED : AS_FAILED;
+		}
+
+		m_finishedCount++;
+		if (m_progressCallback != 0)
+		{
+			m_progressCallback(m_finishedCount, (UINT)m_requests.size(), m_pProgressUserData);
+		}
+	}
+
+	return (m_finishedCount == m_requests.size());
+}
+
+bool DX10_AssetLoader::Wait(UINT _handle)
+{
+	if (_handle >= m_requests.size())
+	{
+		return false;
+	}
+
+	while (true)
+	{
+		Update();
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		eAssetState state = m_requests[_handle]->State;
+		if (state == AS_CREATED || state == AS_FAILED)
+		{
+			return (state == AS_CREATED);
+		}
+
+		// Sleep until a worker hands over another asset
+		m_processedReady.wait(lock, [this] { return (m_processed.empty() == false); });
+	}
+}
+
+bool DX10_AssetLoader::Finish()
+{
+	while (Update() == false)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_processedReady.wait(lock, [this] { return (m_processed.empty() == false); });
+	}
+
+	bool allCreated = true;
+	for (UINT i = 0; i < m_requests.size(); i++)
+	{
+		allCreated &= (m_requests[i]->State == AS_CREATED);
+	}
+	return allCreated;
+}
+
+eAssetState DX10_AssetLoader::GetState(UINT _handle)
+{
+	if (_handle >= m_requests.size())
+	{
+		return AS_FAILED;
+	}
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	return m_requests[_handle]->State;
+}
+
+DX10_MeshCache* DX10_AssetLoader::GetMesh(UINT _handle)
+{
+	if (IsReady(_handle) == false || m_requests[_handle]->Type != AT_MESH)
+	{
+		return 0;
+	}
+	return m_requests[_handle]->pMesh;
+}
+
+ID3D10ShaderResourceView* DX10_AssetLoader::GetTexture(UINT _handle)
+{
+	if (IsReady(_handle) == false || m_requests[_handle]->Type != AT_TEXTURE)
+	{
+		return 0;
+	}
+	return m_requests[_handle]->pTexture;
+}
+
+ID3D10Effect* DX10_AssetLoader::GetEffect(UINT _handle)
+{
+	if (IsReady(_handle) == false || m_requests[_handle]->Type != AT_EFFECT)
+	{
+		return 0;
+	}
+	return m_requests[_handle]->pEffect;
+}
+
+// Private Functions
+
+TAssetRequest* DX10_AssetLoader::NewRequest(eAssetType _type, std::string _fileName)
+{
+	TAssetRequest* pRequest = new TAssetRequest();
+	pRequest->Type = _type;
+	pRequest->State = AS_QUEUED;
+	pRequest->FileName = _fileName;
+	pRequest->Scale = { 1.0f, 1.0f, 1.0f };
+	pRequest->pMesh = 0;
+	pRequest->pLoader = 0;
+	pRequest->pProcessor = 0;
+	pRequest->pTexture = 0;
+	pRequest->pEffect = 0;
+
+	return pRequest;
+}
+
+UINT DX10_AssetLoader::Queue(TAssetRequest* _pRequest)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	// Two requests for the same asset share one load
+	for (UINT i = 0; i < m_requests.size(); i++)
+	{
+		TAssetRequest* pExisting = m_requests[i];
+		if (pExisting->Type == _pRequest->Type && pExisting->FileName == _pRequest->FileName
+			&& (_pRequest->Type != AT_MESH || memcmp(&pExisting->Scale, &_pRequest->Scale, sizeof(v3float)) == 0))
+		{
+			ReleaseRequest(_pRequest);
+			ReleasePtr(_pRequest->pMesh);
+			ReleasePtr(_pRequest);
+			return i;
+		}
+	}
+
+	UINT handle = (UINT)m_requests.size();
+	m_requests.push_back(_pRequest);
+	if (_pRequest->State == AS_FAILED)
+	{
+		// Nothing to load. The render thread still reports it so the progress reaches the total
+		m_processed.push_back(_pRequest);
+		m_processedReady.notify_all();
+	}
+	else
+	{
+		m_queue.push_back(_pRequest);
+		m_queueReady.notify_one();
+	}
+
+	return handle;
+}
+
+void DX10_AssetLoader::WorkerLoop()
+{
+	// Image decoding goes through WIC, which needs COM on the thread that decodes
+	HRESULT comResult = CoInitializeEx(0, COINIT_MULTITHREADED);
+
+	while (true)
+	{
+		TAssetRequest* pRequest = 0;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_queueReady.wait(lock, [this] { return (m_shuttingDown == true || m_queue.empty() == false); });
+			if (m_shuttingDown == true)
+			{
+				break;
+			}
+			pRequest = m_queue.front();
+			m_queue.pop_front();
+			pRequest->State = AS_LOADING;
+		}
+
+		bool loaded = LoadRequest(pRequest);
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			pRequest->State = (loaded == true) ? AS_PROCESSED : AS_FAILED;
+			m_processed.push_back(pRequest);
+		}
+		m_processedReady.notify_all();
+	}
+
+	if (SUCCEEDED(comResult))
+	{
+		CoUninitialize();
+	}
+}
+
+bool DX10_AssetLoader::LoadRequest(TAssetRequest* _pRequest)
+{
+	if (_pRequest->Type == AT_MESH)
+	{
+		return _pRequest->pMesh->Initialise(_pRequest->FileName, _pRequest->Scale);
+	}
+
+	// Read the file, then decode the image or compile the effect
+	void* pData = 0;
+	SIZE_T dataSize = 0;
+	if (FAILED(_pRequest->pLoader->Load())
+		|| FAILED(_pRequest->pLoader->Decompress(&pData, &dataSize))
+		|| FAILED(_pRequest->pProcessor->Process(pData, dataSize)))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+bool DX10_AssetLoader::CreateRequest(TAssetRequest* _pRequest)
+{
+	switch (_pRequest->Type)
+	{
+		case AT_MESH:
+		{
+			// The vertex and index buffers are created when the mesh is initialised from the cache
+			return true;
+		}
+		break;
+		case AT_TEXTURE:
+		{
+			VALIDATEHR(_pRequest->pProcessor->CreateDeviceObject((void**)&_pRequest->pTexture));
+			return m_pRenderer->AddTexture(_pRequest->FileName, _pRequest->pTexture);
+		}
+		break;
+		case AT_EFFECT:
+		{
+			VALIDATEHR(_pRequest->pProcessor->CreateDeviceObject((void**)&_pRequest->pEffect));
+			return m_pRenderer->AddFX(_pRequest->FileName, _pRequest->pEffect);
+		}
+		break;
+		default: return false;
+	}	// End Switch
+}
+
+void DX10_AssetLoader::ReleaseRequest(TAssetRequest* _pRequest)
+{
+	if (_pRequest->pLoader != 0)
+	{
+		_pRequest->pLoader->Destroy();
+		_pRequest->pLoader = 0;
+	}
+	if (_pRequest->pProcessor != 0)
+	{
+		_pRequest->pProcessor->Destroy();
+		_pRequest->pProcessor = 0;
+	}
+}
@@ -0,0 +1,280 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : DX10_AssetLoader.h
+* Description : Loads meshes, textures and effects on worker threads and creates their device objects on the render thread
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// Inclusion Guards
+#pragma once
+#ifndef __DX10_ASSETLOADER_H__
+#define __DX10_ASSETLOADER_H__
+
+// Local Includes
+#include "../DX10_Renderer.h"
+#include "DX10_MeshCache.h"
+
+// Library Includes
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+// Defines
+// Most worker threads the loader starts, however many cores there are
+#define ASSET_LOADER_MAX_THREADS 8
+
+// Enumerators
+/***********************
+* eAssetType: The kinds of asset the loader can load
+* @author: Callan Moore
+********************/
+enum eAssetType
+{
+	AT_MESH,
+	AT_TEXTURE,
+	AT_EFFECT
+};
+
+/***********************
+* eAssetState: How far through loading an asset is
+* @author: Callan Moore
+********************/
+enum eAssetState
+{
+	AS_QUEUED,
+	AS_LOADING,
+	AS_PROCESSED,
+	AS_CREATED,
+	AS_FAILED
+};
+
+/***********************
+* AssetProgressCallback: Called on the render thread each time an asset finishes, whether it loaded or failed
+* @author: Callan Moore
+* @parameter: _finished: The number of assets finished
+* @parameter: _total: The number of assets requested
+* @parameter: _pUserData: The user data given with the callback
+* @return: void
+********************/
+typedef void(*AssetProgressCallback)(UINT _finished, UINT _total, void* _pUserData);
+
+/***********************
+* TAssetRequest: A single asset and everything needed to load it
+* @author: Callan Moore
+********************/
+struct TAssetRequest
+{
+	eAssetType Type;
+	eAssetState State;
+	std::string FileName;
+	v3float Scale;
+
+	// Meshes are read into their cache on a worker and need no device object
+	DX10_MeshCache* pMesh;
+
+	// Textures and effects are read, decoded or compiled on a worker. The processor creates the device object on the render thread
+	ID3DX10DataLoader* pLoader;
+	ID3DX10DataProcessor* pProcessor;
+	ID3D10ShaderResourceView* pTexture;
+	ID3D10Effect* pEffect;
+};
+
+class DX10_AssetLoader
+{
+public:
+	/***********************
+	* DX10_AssetLoader: Default Constructor for Asset Loader class
+	* @author: Callan Moore
+	********************/
+	DX10_AssetLoader();
+
+	/***********************
+	* ~DX10_AssetLoader: Default Destructor for Asset Loader class. Waits for the workers and releases anything not taken by the renderer
+	* @author: Callan Moore
+	********************/
+	~DX10_AssetLoader();
+
+	/***********************
+	* Initialise: Start the worker threads
+	* @author: Callan Moore
+	* @parameter: _pRenderer: The renderer the textures and effects are stored on
+	* @return: bool: Successful or not
+	********************/
+	bool Initialise(DX10_Renderer* _pRenderer);
+
+	/***********************
+	* RequestMesh: Queue a mesh file to be loaded into its cache. Requests are made from the render thread
+	* @author: Callan Moore
+	* @parameter: _fileName: The file name of the mesh with file path
+	* @parameter: _scale: The scale to load the mesh with
+	* @return: UINT: Handle to the request. The same mesh at the same scale returns the same handle
+	********************/
+	UINT RequestMesh(std::string _fileName, v3float _scale);
+
+	/***********************
+	* RequestTexture: Queue a texture to be loaded and stored on the renderer under its file name
+	* @author: Callan Moore
+	* @parameter: _texFileName: The filename of the texture
+	* @return: UINT: Handle to the request. The same texture returns the same handle
+	********************/
+	UINT RequestTexture(std::string _texFileName);
+
+	/***********************
+	* RequestEffect: Queue an effects file to be compiled and stored on the renderer under its file name
+	* @author: Callan Moore
+	* @parameter: _fxFileName: Name of the Effects file
+	* @return: UINT: Handle to the request. The same effects file returns the same handle
+	********************/
+	UINT RequestEffect(std::string _fxFileName);
+
+	/***********************
+	* SetProgressCallback: Set the function called each time an asset finishes
+	* @author: Callan Moore
+	* @parameter: _callback: The function to call. Zero for none
+	* @parameter: _pUserData: Passed back to the function
+	* @return: void
+	********************/
+	void SetProgressCallback(AssetProgressCallback _callback, void* _pUserData);
+
+	/***********************
+	* Update: Create the device objects of every asset the workers have finished with. Must be called on the render thread
+	* @author: Callan Moore
+	* @return: bool: True once every requested asset is finished
+	********************/
+	bool Update();
+
+	/***********************
+	* Wait: Update until a single asset is finished
+	* @author: Callan Moore
+	* @parameter: _handle: Handle to the request
+	* @return: bool: True if the asset loaded
+	********************/
+	bool Wait(UINT _handle);
+
+	/***********************
+	* Finish: Update until every requested asset is finished
+	* @author: Callan Moore
+	* @return: bool: True if every asset loaded
+	********************/
+	bool Finish();
+
+	/***********************
+	* GetState: Retrieve how far through loading an asset is
+	* @author: Callan Moore
+	* @parameter: _handle: Handle to the request
+	* @return: eAssetState: The state of the asset. AS_FAILED for an unknown handle
+	********************/
+	eAssetState GetState(UINT _handle);
+
+	/***********************
+	* IsReady: Whether an asset has loaded and can be used
+	* @author: Callan Moore
+	* @parameter: _handle: Handle to the request
+	* @return: bool: True if the asset has loaded
+	********************/
+	bool IsReady(UINT _handle) { return (GetState(_handle) == AS_CREATED); };
+
+	/***********************
+	* GetMesh: Retrieve a loaded mesh
+	* @author: Callan Moore
+	* @parameter: _handle: Handle to the mesh request
+	* @return: DX10_MeshCache*: The mesh cache, owned by the loader. Zero if the mesh is not ready
+	********************/
+	DX10_MeshCache* GetMesh(UINT _handle);
+
+	/***********************
+	* GetTexture: Retrieve a loaded texture
+	* @author: Callan Moore
+	* @parameter: _handle: Handle to the texture request
+	* @return: ID3D10ShaderResourceView*: The texture, owned by the renderer. Zero if the texture is not ready
+	********************/
+	ID3D10ShaderResourceView* GetTexture(UINT _handle);
+
+	/***********************
+	* GetEffect: Retrieve a compiled effects file
+	* @author: Callan Moore
+	* @parameter: _handle: Handle to the effect request
+	* @return: ID3D10Effect*: The effect, owned by the renderer. Zero if the effect is not ready
+	********************/
+	ID3D10Effect* GetEffect(UINT _handle);
+
+private:
+
+	/***********************
+	* NewRequest: Create a request with nothing loaded yet
+	* @author: Callan Moore
+	* @parameter: _type: The kind of asset
+	* @parameter: _fileName: The file name of the asset
+	* @return: TAssetRequest*: The new request
+	********************/
+	TAssetRequest* NewRequest(eAssetType _type, std::string _fileName);
+
+	/***********************
+	* Queue: Add a request and wake a worker for it, unless the same asset was already requested
+	* @author: Callan Moore
+	* @parameter: _pRequest: The request. Deleted if the asset was already requested
+	* @return: UINT: Handle to the request
+	********************/
+	UINT Queue(TAssetRequest* _pRequest);
+
+	/***********************
+	* WorkerLoop: Take requests off the queue and load them until the loader shuts down
+	* @author: Callan Moore
+	* @return: void
+	********************/
+	void WorkerLoop();
+
+	/***********************
+	* LoadRequest: Read and process an asset on a worker thread. Nothing here touches the device
+	* @author: Callan Moore
+	* @parameter: _pRequest: The request to load
+	* @return: bool: Successful or not
+	********************/
+	bool LoadRequest(TAssetRequest* _pRequest);
+
+	/***********************
+	* CreateRequest: Create the device object of a processed asset on the render thread
+	* @author: Callan Moore
+	* @parameter: _pRequest: The request to create
+	* @return: bool: Successful or not
+	********************/
+	bool CreateRequest(TAssetRequest* _pRequest);
+
+	/***********************
+	* ReleaseRequest: Release the loader and processor of a request
+	* @author: Callan Moore
+	* @parameter: _pRequest: The request
+	* @return: void
+	********************/
+	void ReleaseRequest(TAssetRequest* _pRequest);
+
+private:
+	DX10_Renderer* m_pRenderer;
+
+	// Every request in the order it was made. The handle is the index
+	std::vector<TAssetRequest*> m_requests;
+	UINT m_finishedCount;
+
+	// Requests waiting for a worker and requests waiting for the render thread
+	std::deque<TAssetRequest*> m_queue;
+	std::vector<TAssetRequest*> m_processed;
+
+	std::vector<std::thread> m_threads;
+	std::mutex m_mutex;
+	std::condition_variable m_queueReady;
+	std::condition_variable m_processedReady;
+	bool m_shuttingDown;
+
+	AssetProgressCallback m_progressCallback;
+	void* m_pProgressUserData;
+};
+
+#endif	// __DX10_ASSETLOADER_H__
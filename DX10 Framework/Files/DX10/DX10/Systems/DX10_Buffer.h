@@ -31,6 +31,12 @@ public:
 	DX10_Buffer(ID3D10Device* _pDX10Device)
 	{
 		m_pDX10Device = _pDX10Device;
+
+		// Initialise pointers to NULL
+		m_pVertexBuffer = 0;
+		m_pIndexBuffer = 0;
+		m_vertexBytes = 0;
+		m_indexBytes = 0;
 	}
 
 	/***********************
@@ -62,6 +68,8 @@ public:
 	{
 		m_vertexCount = _vertCount;
 		m_indexCount = _indexCount;
+		m_drawCount = (m_indexCount != 0) ? m_indexCount : m_vertexCount;
+		m_drawStart = 0;
 		m_stride = _stride;
 
 		D3D10_BUFFER_DESC vertexBufferDesc;
@@ -80,6 +88,7 @@ public:
 			ReleaseCOM(m_pVertexBuffer);
 			return false;
 		}
+		m_vertexBytes = vertexBufferDesc.ByteWidth;
 
 		if (m_indexCount != 0)
 		{
@@ -101,6 +110,7 @@ public:
 				ReleaseCOM(m_pIndexBuffer);
 				return false;
 			}
+			m_indexBytes = indexBufferDesc.ByteWidth;
 		}
 		else
 		{
@@ -119,10 +129,51 @@ public:
 	{
 		UINT offset = 0;
 		m_pDX10Device->IASetVertexBuffers(0, 1, &m_pVertexBuffer, &m_stride, &offset);
-		m_pDX10Device->IASetIndexBuffer(m_pIndexBuffer, m_indexFormat, 0);
-		m_pDX10Device->DrawIndexed(m_indexCount, 0, 0);
+
+		if (m_pIndexBuffer != 0)
+		{
+			m_pDX10Device->IASetIndexBuffer(m_pIndexBuffer, m_indexFormat, 0);
+			m_pDX10Device->DrawIndexed(m_drawCount, m_drawStart, 0);
+		}
+		else
+		{
+			// Buffers without indices draw the vertices in order
+			m_pDX10Device->Draw(m_drawCount, m_drawStart);
+		}
+	}
+
+	/***********************
+	* SetDrawCount: Set how many indices, or vertices when there are no indices, are drawn from the start of the Buffer
+	* @author: Callan Moore
+	* @parameter: _drawCount: The number to draw. Clamped to the size of the Buffer
+	* @return: void
+	********************/
+	void SetDrawCount(UINT _drawCount)
+	{
+		SetDrawRange(0, _drawCount);
+	}
+
+	/***********************
+	* SetDrawRange: Set a range of indices, or vertices when there are no indices, to draw, such as one level of detail of a Mesh
+	* @author: Callan Moore
+	* @parameter: _drawStart: The first to draw
+	* @parameter: _drawCount: The number to draw. Clamped to the size of the Buffer
+	* @return: void
+	********************/
+	void SetDrawRange(UINT _drawStart, UINT _drawCount)
+	{
+		UINT size = (m_indexCount != 0) ? m_indexCount : m_vertexCount;
+		m_drawStart = min(_drawStart, size);
+		m_drawCount = min(_drawCount, size - m_drawStart);
 	}
 
+	/***********************
+	* GetDrawCount: Retrieve how many indices, or vertices when there are no indices, are drawn
+	* @author: Callan Moore
+	* @return: UINT: The number drawn
+	********************/
+	UINT GetDrawCount() { return m_drawCount; };
+
 	/***********************
 	* GetVertexBuffer: Retrieve the Vertex Buffer
 	* @author: Callan Moore
@@ -143,6 +194,34 @@ public:
 		return m_pIndexBuffer;
 	}
 
+	/***********************
+	* GetVertexCount: Retrieve the number of Vertices in the Buffer
+	* @author: Callan Moore
+	* @return: UINT: The number of Vertices
+	********************/
+	UINT GetVertexCount() { return m_vertexCount; };
+
+	/***********************
+	* GetIndexCount: Retrieve the number of Indices in the Buffer
+	* @author: Callan Moore
+	* @return: UINT: The number of Indices
+	********************/
+	UINT GetIndexCount() { return m_indexCount; };
+
+	/***********************
+	* GetVertexBytes: Retrieve the size of the Vertex Buffer in video memory
+	* @author: Callan Moore
+	* @return: UINT: The size in bytes
+	********************/
+	UINT GetVertexBytes() { return m_vertexBytes; };
+
+	/***********************
+	* GetIndexBytes: Retrieve the size of the Index Buffer in video memory
+	* @author: Callan Moore
+	* @return: UINT: The size in bytes. Zero if the Buffer has no indices
+	********************/
+	UINT GetIndexBytes() { return m_indexBytes; };
+
 private:
 	ID3D10Device* m_pDX10Device;
 	ID3D10Buffer* m_pVertexBuffer;
@@ -152,7 +231,11 @@ private:
 
 	UINT m_vertexCount;
 	UINT m_indexCount;
+	UINT m_drawStart;
+	UINT m_drawCount;
 	UINT m_stride;
+	UINT m_vertexBytes;
+	UINT m_indexBytes;
 };
 #endif	// __DX10_BUFFER_H__
 
@@ -0,0 +1,372 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : DX10_MeshCache.cpp
+* Description : Binary cache of a loaded OBJ mesh that is memory mapped on later loads instead of parsing the text again
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// This Include
+#include "DX10_MeshCache.h"
+
+// Library Includes
+#include <cstddef>
+#include <iomanip>
+#include <sstream>
+
+DX10_MeshCache::DX10_MeshCache()
+{
+	m_hFile = INVALID_HANDLE_VALUE;
+	m_hMapping = 0;
+	m_pData = 0;
+
+	m_pVertices = 0;
+	m_pIndices = 0;
+	m_vertexCount = 0;
+	m_indexCount = 0;
+	m_indexStride = sizeof(DWORD);
+	m_boundsMin = { 0.0f, 0.0f, 0.0f };
+	m_boundsMax = { 0.0f, 0.0f, 0.0f };
+}
+
+DX10_MeshCache::~DX10_MeshCache()
+{
+	Unmap();
+}
+
+bool DX10_MeshCache::Initialise(std::string _fileName, v3float _scale)
+{
+	std::string cacheName = GetCachePath(_fileName, _scale);
+
+	WIN32_FILE_ATTRIBUTE_DATA sourceData;
+	if (GetFileAttributesExA(_fileName.c_str(), GetFileExInfoStandard, &sourceData) == FALSE)
+	{
+		// A cache without its mesh file can not be checked so it is used as it is
+		return MapCache(cacheName, _scale);
+	}
+	unsigned __int64 sourceSize = ((unsigned __int64)sourceData.nFileSizeHigh << 32) | sourceData.nFileSizeLow;
+	unsigned __int64 sourceWriteTime = ((unsigned __int64)sourceData.ftLastWriteTime.dwHighDateTime << 32) | sourceData.ftLastWriteTime.dwLowDateTime;
+
+	// The mesh file is unchanged if it has the same size and write time as when the cache was built
+	bool sizeMatches = false;
+	unsigned __int64 cachedHash = 0;
+	if (MapCache(cacheName, _scale) == true)
+	{
+		const TMeshCacheHeader* pHeader = (const TMeshCacheHeader*)m_pData;
+		if (pHeader->SourceSize == sourceSize && pHeader->SourceWriteTime == sourceWriteTime)
+		{
+			return true;
+		}
+
+		// Copying or checking out a file changes its write time without changing it, so the hash decides
+		sizeMatches = (pHeader->SourceSize == sourceSize);
+		cachedHash = pHeader->SourceHash;
+		Unmap();
+	}
+	if (sourceSize == 0)
+	{
+		// An empty file can not be mapped and holds no mesh
+		return false;
+	}
+
+	// Map the mesh file to hash it and, if the cache is out of date, parse it
+	HANDLE sourceFile = CreateFileA(_fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (sourceFile == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	HANDLE sourceMapping = CreateFileMappingA(sourceFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	const BYTE* pSource = (sourceMapping != NULL) ? (const BYTE*)MapViewOfFile(sourceMapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+	if (pSource == NULL)
+	{
+		if (sourceMapping != NULL)
+		{
+			CloseHandle(sourceMapping);
+		}
+		CloseHandle(sourceFile);
+		return false;
+	}
+
+	unsigned __int64 sourceHash = HashBytes(pSource, (size_t)sourceSize);
+	bool parsed = true;
+	if (sizeMatches == false || sourceHash != cachedHash)
+	{
+		parsed = DX10_ObjParser::Parse((const char*)pSource, (size_t)sourceSize, _scale, m_vertices, m_indices);
+	}
+	UnmapViewOfFile(pSource);
+	CloseHandle(sourceMapping);
+	CloseHandle(sourceFile);
+
+	if (sizeMatches == true && sourceHash == cachedHash)
+	{
+		// Store the new write time so the next load does not hash the file again
+		UpdateWriteTime(cacheName, sourceWriteTime);
+		return MapCache(cacheName, _scale);
+	}
+	if (parsed == false || m_vertices.empty() == true)
+	{
+		m_vertices.clear();
+		m_indices.clear();
+		return false;
+	}
+
+	// Reorder for the vertex cache, overdraw and vertex fetch once here rather than on every load
+	DX10_MeshOptimiser::Optimise(m_vertices, m_indices);
+
+	// Bounds of the scaled vertices
+	m_boundsMin = { m_vertices[0].pos.x, m_vertices[0].pos.y, m_vertices[0].pos.z };
+	m_boundsMax = m_boundsMin;
+	for (UINT i = 1; i < m_vertices.size(); i++)
+	{
+		m_boundsMin = { min(m_boundsMin.x, m_vertices[i].pos.x), min(m_boundsMin.y, m_vertices[i].pos.y), min(m_boundsMin.z, m_vertices[i].pos.z) };
+		m_boundsMax = { max(m_boundsMax.x, m_vertices[i].pos.x), max(m_boundsMax.y, m_vertices[i].pos.y), max(m_boundsMax.z, m_vertices[i].pos.z) };
+	}
+
+	// The levels of detail share the vertices and follow the full mesh in the index blob
+	DX10_MeshSimplifier::BuildLods(m_vertices, m_indices, m_lods);
+
+	TMeshCacheHeader header;
+	memset(&header, 0, sizeof(header));
+	header.SourceSize = sourceSize;
+	header.SourceWriteTime = sourceWriteTime;
+	header.SourceHash = sourceHash;
+	header.Scale[0] = _scale.x;
+	header.Scale[1] = _scale.y;
+	header.Scale[2] = _scale.z;
+	header.BoundsMin[0] = m_boundsMin.x;
+	header.BoundsMin[1] = m_boundsMin.y;
+	header.BoundsMin[2] = m_boundsMin.z;
+	header.BoundsMax[0] = m_boundsMax.x;
+	header.BoundsMax[1] = m_boundsMax.y;
+	header.BoundsMax[2] = m_boundsMax.z;
+	header.LodCount = (UINT)m_lods.size();
+	for (UINT i = 0; i < m_lods.size(); i++)
+	{
+		header.Lods[i] = m_lods[i];
+	}
+
+	// Halve the index blob when every index fits in 16 bits
+	const void* pIndices = (m_indices.empty() == true) ? 0 : &m_indices[0];
+	UINT indexStride = sizeof(DWORD);
+	if (m_indices.empty() == false && DX10_ObjParser::ShortenIndices(m_indices, (UINT)m_vertices.size(), m_shortIndices) == true)
+	{
+		std::vector<DWORD>().swap(m_indices);
+		pIndices = &m_shortIndices[0];
+		indexStride = sizeof(WORD);
+	}
+	UINT indexCount = (UINT)((indexStride == sizeof(WORD)) ? m_shortIndices.size() : m_indices.size());
+
+	if (WriteCache(cacheName, header, m_vertices, pIndices, indexCount, indexStride) == true && MapCache(cacheName, _scale) == true)
+	{
+		// The mesh is read from the cache from now on
+		std::vector<TVertexNormalUV>().swap(m_vertices);
+		std::vector<DWORD>().swap(m_indices);
+		std::vector<WORD>().swap(m_shortIndices);
+		return true;
+	}
+
+	// The cache could not be written, so keep the parsed mesh for this load
+	m_pVertices = &m_vertices[0];
+	m_pIndices = pIndices;
+	m_vertexCount = (UINT)m_vertices.size();
+	m_indexCount = indexCount;
+	m_indexStride = indexStride;
+	m_lods.assign(header.Lods, header.Lods + header.LodCount);
+	return true;
+}
+
+std::string DX10_MeshCache::GetCachePath(std::string _fileName, v3float _scale)
+{
+	float scale[3] = { _scale.x, _scale.y, _scale.z };
+	UINT scaleHash = (UINT)HashBytes((const BYTE*)scale, sizeof(scale));
+
+	std::ostringstream cacheName;
+	cacheName << _fileName << "." << std::hex << std::setw(8) << std::setfill('0') << scaleHash << MESH_CACHE_EXTENSION;
+	return cacheName.str();
+}
+
+// Private Functions
+
+bool DX10_MeshCache::MapCache(std::string _cacheName, v3float _scale)
+{
+	Unmap();
+
+	m_hFile = CreateFileA(_cacheName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (m_hFile == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (GetFileSizeEx(m_hFile, &fileSize) == FALSE || (unsigned __int64)fileSize.QuadPart < sizeof(TMeshCacheHeader))
+	{
+		// File is too small to be a cache
+		Unmap();
+		return false;
+	}
+
+	m_hMapping = CreateFileMappingA(m_hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (m_hMapping != NULL)
+	{
+		m_pData = (const BYTE*)MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0);
+	}
+	if (m_pData == 0)
+	{
+		Unmap();
+		return false;
+	}
+
+	// Validate the header against the file and the scale
+	const TMeshCacheHeader* pHeader = (const TMeshCacheHeader*)m_pData;
+	float scale[3] = { _scale.x, _scale.y, _scale.z };
+	unsigned __int64 verticesEnd = (unsigned __int64)pHeader->VertexOffset + ((unsigned __int64)pHeader->VertexCount * sizeof(TVertexNormalUV));
+	unsigned __int64 indicesEnd = (unsigned __int64)pHeader->IndexOffset + ((unsigned __int64)pHeader->IndexCount * pHeader->IndexStride);
+	if (pHeader->Magic[0] != 'M' || pHeader->Magic[1] != 'S' || pHeader->Magic[2] != 'H' || pHeader->Magic[3] != 'C'
+		|| pHeader->Version != MESH_CACHE_VERSION || pHeader->VertexStride != sizeof(TVertexNormalUV)
+		|| (pHeader->IndexStride != sizeof(DWORD) && (pHeader->IndexStride != sizeof(WORD) || pHeader->VertexCount > OBJ_SHORT_INDEX_LIMIT))
+		|| memcmp(pHeader->Scale, scale, sizeof(scale)) != 0 || pHeader->VertexCount == 0
+		|| pHeader->VertexOffset < sizeof(TMeshCacheHeader) || pHeader->VertexOffset != AlignOffset(pHeader->VertexOffset)
+		|| pHeader->IndexOffset < verticesEnd || pHeader->IndexOffset != AlignOffset(pHeader->IndexOffset)
+		|| indicesEnd > (unsigned __int64)fileSize.QuadPart || pHeader->LodCount == 0 || pHeader->LodCount > MESH_LOD_MAX)
+	{
+		// Not a cache file, an older version or built at another scale
+		Unmap();
+		return false;
+	}
+
+	m_pVertices = (const TVertexNormalUV*)(m_pData + pHeader->VertexOffset);
+	m_pIndices = (pHeader->IndexCount == 0) ? 0 : (m_pData + pHeader->IndexOffset);
+	m_vertexCount = pHeader->VertexCount;
+	m_indexCount = pHeader->IndexCount;
+	m_indexStride = pHeader->IndexStride;
+	m_boundsMin = { pHeader->BoundsMin[0], pHeader->BoundsMin[1], pHeader->BoundsMin[2] };
+	m_boundsMax = { pHeader->BoundsMax[0], pHeader->BoundsMax[1], pHeader->BoundsMax[2] };
+
+	m_lods.assign(pHeader->Lods, pHeader->Lods + pHeader->LodCount);
+	for (UINT i = 0; i < m_lods.size(); i++)
+	{
+		if ((unsigned __int64)m_lods[i].IndexStart + m_lods[i].IndexCount > m_indexCount)
+		{
+			// A level reaches past the index blob
+			Unmap();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void DX10_MeshCache::Unmap()
+{
+	if (m_pData != 0)
+	{
+		UnmapViewOfFile(m_pData);
+		m_pData = 0;
+	}
+	if (m_hMapping != 0)
+	{
+		CloseHandle(m_hMapping);
+		m_hMapping = 0;
+	}
+	if (m_hFile != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(m_hFile);
+		m_hFile = INVALID_HANDLE_VALUE;
+	}
+
+	m_pVertices = 0;
+	m_pIndices = 0;
+	m_vertexCount = 0;
+	m_indexCount = 0;
+	m_indexStride = sizeof(DWORD);
+	m_lods.clear();
+}
+
+bool DX10_MeshCache::UpdateWriteTime(std::string _cacheName, unsigned __int64 _writeTime)
+{
+	HANDLE file = CreateFileA(_cacheName.c_str(), GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	DWORD written = 0;
+	bool result = (SetFilePointer(file, offsetof(TMeshCacheHeader, SourceWriteTime), NULL, FILE_BEGIN) != INVALID_SET_FILE_POINTER
+		&& WriteFile(file, &_writeTime, sizeof(_writeTime), &written, NULL) != FALSE && written == sizeof(_writeTime));
+
+	CloseHandle(file);
+	return result;
+}
+
+bool DX10_MeshCache::WriteCache(std::string _cacheName, TMeshCacheHeader _header, const std::vector<TVertexNormalUV>& _rVertices, const void* _pIndices, UINT _indexCount, UINT _indexStride)
+{
+	unsigned __int64 verticesSize = (unsigned __int64)_rVertices.size() * sizeof(TVertexNormalUV);
+	unsigned __int64 indicesSize = (unsigned __int64)_indexCount * _indexStride;
+	if (verticesSize + indicesSize + (MESH_CACHE_ALIGNMENT * 2) + sizeof(TMeshCacheHeader) > 0xFFFFFFFF)
+	{
+		// Offsets are stored in 32 bits
+		return false;
+	}
+
+	_header.Magic[0] = 'M';
+	_header.Magic[1] = 'S';
+	_header.Magic[2] = 'H';
+	_header.Magic[3] = 'C';
+	_header.Version = MESH_CACHE_VERSION;
+	_header.VertexStride = sizeof(TVertexNormalUV);
+	_header.IndexStride = _indexStride;
+	_header.VertexCount = (UINT)_rVertices.size();
+	_header.IndexCount = _indexCount;
+	_header.VertexOffset = AlignOffset(sizeof(TMeshCacheHeader));
+	_header.IndexOffset = AlignOffset(_header.VertexOffset + (UINT)verticesSize);
+
+	// Write to a temporary file so a failed write never leaves a broken cache behind
+	std::string tempName = _cacheName + ".tmp";
+	HANDLE file = CreateFileA(tempName.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	BYTE padding[MESH_CACHE_ALIGNMENT];
+	memset(padding, 0, sizeof(padding));
+	DWORD headerPadding = _header.VertexOffset - sizeof(TMeshCacheHeader);
+	DWORD vertexPadding = _header.IndexOffset - (_header.VertexOffset + (UINT)verticesSize);
+	DWORD written = 0;
+	bool result = (WriteFile(file, &_header, sizeof(_header), &written, NULL) != FALSE && written == sizeof(_header));
+	result = result && (WriteFile(file, padding, headerPadding, &written, NULL) != FALSE && written == headerPadding);
+	result = result && (WriteFile(file, &_rVertices[0], (DWORD)verticesSize, &written, NULL) != FALSE && written == (DWORD)verticesSize);
+	result = result && (WriteFile(file, padding, vertexPadding, &written, NULL) != FALSE && written == vertexPadding);
+	if (_indexCount != 0)
+	{
+		result = result && (WriteFile(file, _pIndices, (DWORD)indicesSize, &written, NULL) != FALSE && written == (DWORD)indicesSize);
+	}
+	CloseHandle(file);
+
+	// Replace the old cache with the finished file
+	if (result == false || MoveFileExA(tempName.c_str(), _cacheName.c_str(), MOVEFILE_REPLACE_EXISTING) == FALSE)
+	{
+		DeleteFileA(tempName.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+unsigned __int64 DX10_MeshCache::HashBytes(const BYTE* _pData, size_t _size)
+{
+	unsigned __int64 hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < _size; i++)
+	{
+		hash ^= _pData[i];
+		hash *= 1099511628211ULL;
+	}
+
+	return hash;
+}
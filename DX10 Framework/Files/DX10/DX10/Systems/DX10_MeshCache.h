@@ -0,0 +1,238 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : DX10_MeshCache.h
+* Description : Binary cache of a loaded OBJ mesh that is memory mapped on later loads instead of parsing the text again
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// Inclusion Guards
+#pragma once
+#ifndef __DX10_MESHCACHE_H__
+#define __DX10_MESHCACHE_H__
+
+// Local Includes
+#include "DX10_MeshOptimiser.h"
+#include "DX10_MeshSimplifier.h"
+#include "DX10_ObjParser.h"
+
+// Defines
+#define MESH_CACHE_VERSION 4
+// Extension added to the mesh file name, after the hash of the scale, to name its cache
+#define MESH_CACHE_EXTENSION ".meshcache"
+// Alignment of the vertex and index blobs within the cache file
+#define MESH_CACHE_ALIGNMENT 16
+
+/***********************
+* TMeshCacheHeader: Header at the start of a mesh cache file. The vertex and index blobs follow it
+* @author: Callan Moore
+********************/
+struct TMeshCacheHeader
+{
+	char Magic[4];
+	UINT Version;
+
+	// The source file the cache was built from. The write time is checked first and the hash only when it differs
+	unsigned __int64 SourceSize;
+	unsigned __int64 SourceWriteTime;
+	unsigned __int64 SourceHash;
+
+	// Indices are 16 bit when the vertex count allows it
+	UINT VertexStride;
+	UINT IndexStride;
+	UINT VertexCount;
+	UINT IndexCount;
+	UINT VertexOffset;
+	UINT IndexOffset;
+
+	// The scale the vertices were loaded with and their bounds after scaling
+	float Scale[3];
+	float BoundsMin[3];
+	float BoundsMax[3];
+
+	// Levels of detail, the full mesh first. Each is a range of the index blob
+	UINT LodCount;
+	TMeshLod Lods[MESH_LOD_MAX];
+};
+
+class DX10_MeshCache
+{
+public:
+	/***********************
+	* DX10_MeshCache: Default Constructor for Mesh Cache class
+	* @author: Callan Moore
+	********************/
+	DX10_MeshCache();
+
+	/***********************
+	* ~DX10_MeshCache: Default Destructor for Mesh Cache class. Unmaps the cache file
+	* @author: Callan Moore
+	********************/
+	~DX10_MeshCache();
+
+	/***********************
+	* Initialise: Map the cache of a mesh file, building it from the mesh file first if it is missing or out of date.
+	*	Building optimises the triangle and vertex order and simplifies the levels of detail, so it only runs once for each version of the mesh file
+	* @author: Callan Moore
+	* @parameter: _fileName: The file name of the mesh with file path
+	* @parameter: _scale: The scale to load the mesh with. Each scale has its own cache
+	* @return: bool: Successful or not
+	********************/
+	bool Initialise(std::string _fileName, v3float _scale);
+
+	/***********************
+	* GetCachePath: Retrieve the file name of the cache for a mesh file at a scale
+	* @author: Callan Moore
+	* @parameter: _fileName: The file name of the mesh with file path
+	* @parameter: _scale: The scale the mesh is loaded with
+	* @return: std::string: The file name of the cache
+	********************/
+	static std::string GetCachePath(std::string _fileName, v3float _scale);
+
+	/***********************
+	* GetVertices: Retrieve the welded vertices in the order the triangles first use them
+	* @author: Callan Moore
+	* @return: const TVertexNormalUV*: The vertices. Valid until the cache is destroyed
+	********************/
+	const TVertexNormalUV* GetVertices() { return m_pVertices; };
+
+	/***********************
+	* GetIndices: Retrieve the indices of every level of detail. Three per triangle, in vertex cache order
+	* @author: Callan Moore
+	* @return: const void*: The indices, WORDs or DWORDs depending on the index stride. Valid until the cache is destroyed
+	********************/
+	const void* GetIndices() { return m_pIndices; };
+
+	/***********************
+	* GetIndexStride: Retrieve the size of each index
+	* @author: Callan Moore
+	* @return: UINT: sizeof(WORD) if the vertex count allows 16 bit indices, otherwise sizeof(DWORD)
+	********************/
+	UINT GetIndexStride() { return m_indexStride; };
+
+	/***********************
+	* GetVertexCount: Retrieve the number of vertices
+	* @author: Callan Moore
+	* @return: UINT: The number of vertices
+	********************/
+	UINT GetVertexCount() { return m_vertexCount; };
+
+	/***********************
+	* GetIndexCount: Retrieve the number of indices
+	* @author: Callan Moore
+	* @return: UINT: The number of indices of every level of detail together
+	********************/
+	UINT GetIndexCount() { return m_indexCount; };
+
+	/***********************
+	* GetLods: Retrieve the levels of detail
+	* @author: Callan Moore
+	* @return: const std::vector<TMeshLod>&: The levels, the full mesh first. Meshes too small to simplify only have the full mesh
+	********************/
+	const std::vector<TMeshLod>& GetLods() { return m_lods; };
+
+	/***********************
+	* GetBoundsMin: Retrieve the lowest corner of the box around the vertices
+	* @author: Callan Moore
+	* @return: v3float: The lowest corner
+	********************/
+	v3float GetBoundsMin() { return m_boundsMin; };
+
+	/***********************
+	* GetBoundsMax: Retrieve the highest corner of the box around the vertices
+	* @author: Callan Moore
+	* @return: v3float: The highest corner
+	********************/
+	v3float GetBoundsMax() { return m_boundsMax; };
+
+	/***********************
+	* IsMapped: Whether the mesh is read straight from the cache file or is held in memory because the cache could not be written
+	* @author: Callan Moore
+	* @return: bool: True if the cache file is mapped
+	********************/
+	bool IsMapped() { return (m_pData != 0); };
+
+private:
+
+	/***********************
+	* MapCache: Map a cache file and check its header describes a mesh loaded at the scale
+	* @author: Callan Moore
+	* @parameter: _cacheName: The file name of the cache
+	* @parameter: _scale: The scale the mesh is loaded with
+	* @return: bool: False if the file is missing or is not a cache for the scale
+	********************/
+	bool MapCache(std::string _cacheName, v3float _scale);
+
+	/***********************
+	* Unmap: Unmap the cache file and close its handles
+	* @author: Callan Moore
+	* @return: void
+	********************/
+	void Unmap();
+
+	/***********************
+	* UpdateWriteTime: Store a new source write time in the header of a cache file that is not mapped
+	* @author: Callan Moore
+	* @parameter: _cacheName: The file name of the cache
+	* @parameter: _writeTime: The write time of the source file
+	* @return: bool: Successful or not
+	********************/
+	bool UpdateWriteTime(std::string _cacheName, unsigned __int64 _writeTime);
+
+	/***********************
+	* WriteCache: Write a new cache file, replacing any old cache only once it is complete
+	* @author: Callan Moore
+	* @parameter: _cacheName: The file name of the cache
+	* @parameter: _header: The header of the cache. The offsets, counts and bounds are filled in
+	* @parameter: _rVertices: The vertices
+	* @parameter: _pIndices: The indices
+	* @parameter: _indexCount: The number of indices
+	* @parameter: _indexStride: The size of each index
+	* @return: bool: Successful or not
+	********************/
+	bool WriteCache(std::string _cacheName, TMeshCacheHeader _header, const std::vector<TVertexNormalUV>& _rVertices, const void* _pIndices, UINT _indexCount, UINT _indexStride);
+
+	/***********************
+	* HashBytes: Calculate the 64 bit FNV-1a hash of a block of memory
+	* @author: Callan Moore
+	* @parameter: _pData: The memory to hash
+	* @parameter: _size: The number of bytes
+	* @return: unsigned __int64: The hash
+	********************/
+	static unsigned __int64 HashBytes(const BYTE* _pData, size_t _size);
+
+	/***********************
+	* AlignOffset: Round an offset up to the alignment of the blobs
+	* @author: Callan Moore
+	* @parameter: _offset: The offset
+	* @return: UINT: The aligned offset
+	********************/
+	static UINT AlignOffset(UINT _offset) { return (_offset + (MESH_CACHE_ALIGNMENT - 1)) & ~(UINT)(MESH_CACHE_ALIGNMENT - 1); };
+
+private:
+	HANDLE m_hFile;
+	HANDLE m_hMapping;
+	const BYTE* m_pData;
+
+	const TVertexNormalUV* m_pVertices;
+	const void* m_pIndices;
+	UINT m_vertexCount;
+	UINT m_indexCount;
+	UINT m_indexStride;
+	v3float m_boundsMin;
+	v3float m_boundsMax;
+	std::vector<TMeshLod> m_lods;
+
+	// The parsed mesh, only kept when the cache file could not be written
+	std::vector<TVertexNormalUV> m_vertices;
+	std::vector<DWORD> m_indices;
+	std::vector<WORD> m_shortIndices;
+};
+
+#endif	// __DX10_MESHCACHE_H__
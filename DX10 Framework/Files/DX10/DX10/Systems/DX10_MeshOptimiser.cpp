@@ -0,0 +1,380 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : DX10_MeshOptimiser.cpp
+* Description : Reorders the triangles and vertices of an indexed mesh for the post transform vertex cache, overdraw and vertex fetch
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// This Include
+#include "DX10_MeshOptimiser.h"
+
+// Library Includes
+#include <algorithm>
+
+// Marks a vertex that is not in the cache, or a triangle that is not chosen yet
+#define OPTIMISER_NONE 0xFFFFFFFF
+
+/***********************
+* TOverdrawCluster: A run of triangles drawn together, sorted by how far it faces out from the middle of the mesh
+* @author: Callan Moore
+********************/
+struct TOverdrawCluster
+{
+	UINT FirstTriangle;
+	UINT TriangleCount;
+	float SortKey;
+
+	/***********************
+	* operator<: Clusters facing furthest out are drawn first
+	* @author: Callan Moore
+	* @parameter: _rCluster: The cluster to compare to
+	* @return: bool: True if this cluster is drawn before the other
+	********************/
+	bool operator<(const TOverdrawCluster& _rCluster) const { return SortKey > _rCluster.SortKey; };
+};
+
+void DX10_MeshOptimiser::Optimise(std::vector<TVertexNormalUV>& _prVertices, std::vector<DWORD>& _prIndices)
+{
+	OptimiseVertexCache(_prIndices, (UINT)_prVertices.size());
+	OptimiseOverdraw(_prVertices, _prIndices, VERTEX_CACHE_OVERDRAW_THRESHOLD);
+	OptimiseVertexFetch(_prVertices, _prIndices);
+}
+
+void DX10_MeshOptimiser::OptimiseVertexCache(std::vector<DWORD>& _prIndices, UINT _vertexCount)
+{
+	UINT triangleCount = (UINT)_prIndices.size() / 3;
+	if (triangleCount < 2)
+	{
+		return;
+	}
+
+	// Score of every cache position and count of remaining triangles, looked up instead of calling pow for every vertex
+	float scores[VERTEX_CACHE_SIZE + 1][VERTEX_CACHE_MAX_VALENCE + 1];
+	for (int position = -1; position < VERTEX_CACHE_SIZE; position++)
+	{
+		for (UINT valence = 0; valence <= VERTEX_CACHE_MAX_VALENCE; valence++)
+		{
+			scores[position + 1][valence] = CalcVertexScore(position, valence);
+		}
+	}
+
+	// Lists of the triangles using each vertex. The triangles not drawn yet are kept at the front of each list
+	std::vector<UINT> remaining(_vertexCount, 0);
+	for (UINT i = 0; i < triangleCount * 3; i++)
+	{
+		remaining[_prIndices[i]]++;
+	}
+	std::vector<UINT> firstTriangle(_vertexCount + 1, 0);
+	for (UINT vertex = 0; vertex < _vertexCount; vertex++)
+	{
+		firstTriangle[vertex + 1] = firstTriangle[vertex] + remaining[vertex];
+	}
+	std::vector<UINT> vertexTriangles(triangleCount * 3);
+	std::vector<UINT> fill(firstTriangle.begin(), firstTriangle.end() - 1);
+	for (UINT i = 0; i < triangleCount * 3; i++)
+	{
+		vertexTriangles[fill[_prIndices[i]]++] = i / 3;
+	}
+
+	// Starting scores with an empty cache
+	std::vector<int> cachePosition(_vertexCount, -1);
+	std::vector<float> vertexScores(_vertexCount);
+	for (UINT vertex = 0; vertex < _vertexCount; vertex++)
+	{
+		vertexScores[vertex] = scores[0][min(remaining[vertex], (UINT)VERTEX_CACHE_MAX_VALENCE)];
+	}
+	std::vector<float> triangleScores(triangleCount);
+	std::vector<BYTE> drawn(triangleCount, 0);
+	UINT bestTriangle = 0;
+	for (UINT triangle = 0; triangle < triangleCount; triangle++)
+	{
+		triangleScores[triangle] = vertexScores[_prIndices[triangle * 3]] + vertexScores[_prIndices[triangle * 3 + 1]] + vertexScores[_prIndices[triangle * 3 + 2]];
+		if (triangleScores[triangle] > triangleScores[bestTriangle])
+		{
+			bestTriangle = triangle;
+		}
+	}
+
+	std::vector<DWORD> ordered;
+	ordered.reserve(triangleCount * 3);
+	UINT cache[VERTEX_CACHE_SIZE + 3];
+	UINT cacheCount = 0;
+	UINT scanCursor = 0;
+
+	for (UINT drawCount = 0; drawCount < triangleCount; drawCount++)
+	{
+		if (bestTriangle == OPTIMISER_NONE)
+		{
+			// Nothing in the cache has triangles left, so start again from the next triangle not drawn
+			while (drawn[scanCursor] != 0)
+			{
+				scanCursor++;
+			}
+			bestTriangle = scanCursor;
+		}
+
+		drawn[bestTriangle] = 1;
+		const DWORD* pTriangle = &_prIndices[bestTriangle * 3];
+		ordered.push_back(pTriangle[0]);
+		ordered.push_back(pTriangle[1]);
+		ordered.push_back(pTriangle[2]);
+
+		// Move the triangle out of the not drawn part of each of its vertex lists
+		for (int corner = 0; corner < 3; corner++)
+		{
+			UINT vertex = pTriangle[corner];
+			UINT* pList = &vertexTriangles[firstTriangle[vertex]];
+			for (UINT i = 0; i < remaining[vertex]; i++)
+			{
+				if (pList[i] == bestTriangle)
+				{
+					std::swap(pList[i], pList[remaining[vertex] - 1]);
+					remaining[vertex]--;
+					break;
+				}
+			}
+		}
+
+		// The triangle's vertices move to the front of the cache, pushing the rest down
+		UINT newCache[VERTEX_CACHE_SIZE + 3];
+		UINT newCount = 0;
+		for (int corner = 0; corner < 3; corner++)
+		{
+			if (std::find(newCache, newCache + newCount, pTriangle[corner]) == newCache + newCount)
+			{
+				newCache[newCount++] = pTriangle[corner];
+			}
+		}
+		for (UINT i = 0; i < cacheCount; i++)
+		{
+			if (cache[i] != pTriangle[0] && cache[i] != pTriangle[1] && cache[i] != pTriangle[2])
+			{
+				newCache[newCount++] = cache[i];
+			}
+		}
+
+		// Rescore every vertex that moved, including those pushed out, and pass the change on to their triangles
+		for (UINT i = 0; i < newCount; i++)
+		{
+			UINT vertex = newCache[i];
+			cachePosition[vertex] = (i < VERTEX_CACHE_SIZE) ? (int)i : -1;
+			float score = scores[cachePosition[vertex] + 1][min(remaining[vertex], (UINT)VERTEX_CACHE_MAX_VALENCE)];
+			float change = score - vertexScores[vertex];
+			vertexScores[vertex] = score;
+
+			const UINT* pList = &vertexTriangles[firstTriangle[vertex]];
+			for (UINT triangle = 0; triangle < remaining[vertex]; triangle++)
+			{
+				triangleScores[pList[triangle]] += change;
+			}
+		}
+
+		// The next triangle is the best one using a vertex still in the cache
+		cacheCount = min(newCount, (UINT)VERTEX_CACHE_SIZE);
+		bestTriangle = OPTIMISER_NONE;
+		float bestScore = 0.0f;
+		for (UINT i = 0; i < cacheCount; i++)
+		{
+			UINT vertex = newCache[i];
+			cache[i] = vertex;
+
+			const UINT* pList = &vertexTriangles[firstTriangle[vertex]];
+			for (UINT triangle = 0; triangle < remaining[vertex]; triangle++)
+			{
+				if (triangleScores[pList[triangle]] > bestScore)
+				{
+					bestScore = triangleScores[pList[triangle]];
+					bestTriangle = pList[triangle];
+				}
+			}
+		}
+	}
+
+	// Small meshes can already be in a better order than the greedy one
+	if (SimulateVertexCache(ordered, _vertexCount).ACMR < SimulateVertexCache(_prIndices, _vertexCount).ACMR)
+	{
+		_prIndices.swap(ordered);
+	}
+}
+
+void DX10_MeshOptimiser::OptimiseOverdraw(const std::vector<TVertexNormalUV>& _rVertices, std::vector<DWORD>& _prIndices, float _threshold)
+{
+	UINT triangleCount = (UINT)_prIndices.size() / 3;
+	UINT vertexCount = (UINT)_rVertices.size();
+	if (triangleCount < 2)
+	{
+		return;
+	}
+
+	// Each cut can cost up to a full cache of misses, so clusters are kept long enough to stay within the threshold
+	float cacheACMR = SimulateVertexCache(_prIndices, vertexCount).ACMR;
+	float allowedRise = (_threshold - 1.0f) * cacheACMR;
+	if (allowedRise <= 0.0f)
+	{
+		return;
+	}
+	UINT minClusterSize = (UINT)((float)VERTEX_CACHE_FIFO_SIZE / allowedRise) + 1;
+
+	// Split the order into clusters. A triangle that misses on all three vertices already starts from a cold cache so is always a cut
+	std::vector<TOverdrawCluster> clusters;
+	std::vector<UINT> cacheTime(vertexCount, OPTIMISER_NONE);
+	UINT misses = 0;
+	UINT clusterStart = 0;
+	for (UINT triangle = 0; triangle < triangleCount; triangle++)
+	{
+		UINT triangleMisses = 0;
+		for (int corner = 0; corner < 3; corner++)
+		{
+			UINT vertex = _prIndices[triangle * 3 + corner];
+			if (cacheTime[vertex] == OPTIMISER_NONE || misses - cacheTime[vertex] >= VERTEX_CACHE_FIFO_SIZE)
+			{
+				cacheTime[vertex] = misses++;
+				triangleMisses++;
+			}
+		}
+
+		if (triangle > clusterStart && (triangleMisses == 3 || triangle - clusterStart >= minClusterSize))
+		{
+			TOverdrawCluster cluster = { clusterStart, triangle - clusterStart, 0.0f };
+			clusters.push_back(cluster);
+			clusterStart = triangle;
+		}
+	}
+	TOverdrawCluster lastCluster = { clusterStart, triangleCount - clusterStart, 0.0f };
+	clusters.push_back(lastCluster);
+	if (clusters.size() < 2)
+	{
+		return;
+	}
+
+	// Area weighted centre and normal of every cluster and of the whole mesh
+	std::vector<v3float> clusterCentres(clusters.size());
+	std::vector<v3float> clusterNormals(clusters.size());
+	v3float meshCentre = { 0.0f, 0.0f, 0.0f };
+	float meshArea = 0.0f;
+	for (UINT i = 0; i < clusters.size(); i++)
+	{
+		v3float centre = { 0.0f, 0.0f, 0.0f };
+		v3float normal = { 0.0f, 0.0f, 0.0f };
+		float area = 0.0f;
+		for (UINT triangle = clusters[i].FirstTriangle; triangle < clusters[i].FirstTriangle + clusters[i].TriangleCount; triangle++)
+		{
+			const D3DXVECTOR3& rPosA = _rVertices[_prIndices[triangle * 3]].pos;
+			const D3DXVECTOR3& rPosB = _rVertices[_prIndices[triangle * 3 + 1]].pos;
+			const D3DXVECTOR3& rPosC = _rVertices[_prIndices[triangle * 3 + 2]].pos;
+			v3float posA = { rPosA.x, rPosA.y, rPosA.z };
+			v3float posB = { rPosB.x, rPosB.y, rPosB.z };
+			v3float posC = { rPosC.x, rPosC.y, rPosC.z };
+
+			// The cross product is twice the area in length
+			v3float cross = (posB - posA).Cross(posC - posA);
+			float triangleArea = cross.Magnitude();
+			centre += (posA + posB + posC) * (triangleArea / 3.0f);
+			normal += cross;
+			area += triangleArea;
+		}
+
+		meshCentre += centre;
+		meshArea += area;
+		clusterCentres[i] = (area > 0.0f) ? centre / area : centre;
+		clusterNormals[i] = normal.Normalise();
+	}
+	if (meshArea > 0.0f)
+	{
+		meshCentre = meshCentre / meshArea;
+	}
+
+	for (UINT i = 0; i < clusters.size(); i++)
+	{
+		clusters[i].SortKey = (clusterCentres[i] - meshCentre).Dot(clusterNormals[i]);
+	}
+	std::stable_sort(clusters.begin(), clusters.end());
+
+	std::vector<DWORD> ordered;
+	ordered.reserve(_prIndices.size());
+	for (UINT i = 0; i < clusters.size(); i++)
+	{
+		ordered.insert(ordered.end(), _prIndices.begin() + clusters[i].FirstTriangle * 3, _prIndices.begin() + (clusters[i].FirstTriangle + clusters[i].TriangleCount) * 3);
+	}
+
+	// Keep the vertex cache order if the cuts cost more than allowed
+	if (SimulateVertexCache(ordered, vertexCount).ACMR <= cacheACMR * _threshold)
+	{
+		_prIndices.swap(ordered);
+	}
+}
+
+void DX10_MeshOptimiser::OptimiseVertexFetch(std::vector<TVertexNormalUV>& _prVertices, std::vector<DWORD>& _prIndices)
+{
+	std::vector<UINT> remap(_prVertices.size(), OPTIMISER_NONE);
+	std::vector<TVertexNormalUV> ordered;
+	ordered.reserve(_prVertices.size());
+
+	for (UINT i = 0; i < _prIndices.size(); i++)
+	{
+		DWORD& rIndex = _prIndices[i];
+		if (remap[rIndex] == OPTIMISER_NONE)
+		{
+			remap[rIndex] = (UINT)ordered.size();
+			ordered.push_back(_prVertices[rIndex]);
+		}
+		rIndex = remap[rIndex];
+	}
+
+	_prVertices.swap(ordered);
+}
+
+TVertexCacheStats DX10_MeshOptimiser::SimulateVertexCache(const std::vector<DWORD>& _rIndices, UINT _vertexCount)
+{
+	// A vertex is still in the FIFO if fewer than a cache of misses have happened since it was added
+	std::vector<UINT> cacheTime(_vertexCount, OPTIMISER_NONE);
+	UINT misses = 0;
+	for (UINT i = 0; i < _rIndices.size(); i++)
+	{
+		UINT vertex = _rIndices[i];
+		if (cacheTime[vertex] == OPTIMISER_NONE || misses - cacheTime[vertex] >= VERTEX_CACHE_FIFO_SIZE)
+		{
+			cacheTime[vertex] = misses++;
+		}
+	}
+
+	TVertexCacheStats stats;
+	stats.ACMR = (_rIndices.size() >= 3) ? (float)misses / (float)(_rIndices.size() / 3) : 0.0f;
+	stats.ATVR = (_vertexCount > 0) ? (float)misses / (float)_vertexCount : 0.0f;
+	return stats;
+}
+
+// Private Functions
+
+float DX10_MeshOptimiser::CalcVertexScore(int _cachePosition, UINT _remaining)
+{
+	if (_remaining == 0)
+	{
+		// No triangles left to draw
+		return -1.0f;
+	}
+
+	float score = 0.0f;
+	if (_cachePosition >= 0)
+	{
+		if (_cachePosition < 3)
+		{
+			// Used by the last triangle
+			score = VERTEX_CACHE_LAST_TRIANGLE_SCORE;
+		}
+		else
+		{
+			float scaler = 1.0f / (float)(VERTEX_CACHE_SIZE - 3);
+			score = pow(1.0f - ((float)(_cachePosition - 3) * scaler), VERTEX_CACHE_DECAY_POWER);
+		}
+	}
+
+	return score + (VERTEX_CACHE_VALENCE_SCALE * pow((float)_remaining, -VERTEX_CACHE_VALENCE_POWER));
+}
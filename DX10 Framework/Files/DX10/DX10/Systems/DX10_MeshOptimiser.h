@@ -0,0 +1,121 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : DX10_MeshOptimiser.h
+* Description : Reorders the triangles and vertices of an indexed mesh for the post transform vertex cache, overdraw and vertex fetch
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// Inclusion Guards
+#pragma once
+#ifndef __DX10_MESHOPTIMISER_H__
+#define __DX10_MESHOPTIMISER_H__
+
+// Local Includes
+#include "../DX10_Utilities.h"
+#include "../DX10_Vertex.h"
+
+// Library Includes
+#include <vector>
+
+// Defines
+// Size of the LRU cache the triangle order is scored against
+#define VERTEX_CACHE_SIZE 32
+// Size of the FIFO cache used to measure an order. Smaller than the scoring cache to match older hardware
+#define VERTEX_CACHE_FIFO_SIZE 16
+// Score of a vertex used by the last triangle. Lower than the next slots so the same edge is not reused straight away
+#define VERTEX_CACHE_LAST_TRIANGLE_SCORE 0.75f
+// How quickly the score falls the further down the cache a vertex is
+#define VERTEX_CACHE_DECAY_POWER 1.5f
+// Boost for vertices with few triangles left so they are finished off before they leave the cache
+#define VERTEX_CACHE_VALENCE_SCALE 2.0f
+#define VERTEX_CACHE_VALENCE_POWER 0.5f
+// Largest count of remaining triangles with its own valence score. Higher counts share the last score
+#define VERTEX_CACHE_MAX_VALENCE 64
+// Most the overdraw order may raise the ACMR by, as a multiple of the vertex cache order
+#define VERTEX_CACHE_OVERDRAW_THRESHOLD 1.05f
+
+/***********************
+* TVertexCacheStats: Result of running an index buffer through the simulated FIFO vertex cache
+* @author: Callan Moore
+********************/
+struct TVertexCacheStats
+{
+	// Average cache miss ratio. Vertices transformed per triangle, from 3.0 with no reuse down to about 0.5
+	float ACMR;
+
+	// Average transform to vertex ratio. Vertices transformed per vertex in the mesh, 1.0 at best
+	float ATVR;
+};
+
+class DX10_MeshOptimiser
+{
+public:
+	/***********************
+	* Optimise: Run every optimisation on a mesh. Vertex cache order, then overdraw order, then vertex fetch order
+	* @author: Callan Moore
+	* @parameter: _prVertices: The vertices. Reordered to the order they are first used
+	* @parameter: _prIndices: The triangle list indices. Reordered and renumbered
+	* @return: void
+	********************/
+	static void Optimise(std::vector<TVertexNormalUV>& _prVertices, std::vector<DWORD>& _prIndices);
+
+	/***********************
+	* OptimiseVertexCache: Reorder the triangles so vertices are reused while they are still in the post transform cache.
+	*	A linear time greedy order that scores vertices by their position in an LRU cache and their remaining triangles
+	* @author: Callan Moore
+	* @parameter: _prIndices: The triangle list indices. Each triangle keeps its winding
+	* @parameter: _vertexCount: The number of vertices the indices refer to
+	* @return: void
+	********************/
+	static void OptimiseVertexCache(std::vector<DWORD>& _prIndices, UINT _vertexCount);
+
+	/***********************
+	* OptimiseOverdraw: Split a vertex cache order into clusters and draw the clusters facing out from the middle of the mesh first,
+	*	so they hide the ones behind them. Kept only if the ACMR stays within the threshold of the vertex cache order
+	* @author: Callan Moore
+	* @parameter: _rVertices: The vertices
+	* @parameter: _prIndices: The triangle list indices, already in vertex cache order
+	* @parameter: _threshold: Most the ACMR may rise by, as a multiple of the vertex cache order
+	* @return: void
+	********************/
+	static void OptimiseOverdraw(const std::vector<TVertexNormalUV>& _rVertices, std::vector<DWORD>& _prIndices, float _threshold);
+
+	/***********************
+	* OptimiseVertexFetch: Renumber the vertices in the order the triangles first use them so vertex reads walk forward through memory.
+	*	Vertices no triangle uses are dropped
+	* @author: Callan Moore
+	* @parameter: _prVertices: The vertices
+	* @parameter: _prIndices: The triangle list indices
+	* @return: void
+	********************/
+	static void OptimiseVertexFetch(std::vector<TVertexNormalUV>& _prVertices, std::vector<DWORD>& _prIndices);
+
+	/***********************
+	* SimulateVertexCache: Count the vertex transforms of an index buffer through a FIFO post transform cache
+	* @author: Callan Moore
+	* @parameter: _rIndices: The triangle list indices
+	* @parameter: _vertexCount: The number of vertices the indices refer to
+	* @return: TVertexCacheStats: The cache miss and transform ratios
+	********************/
+	static TVertexCacheStats SimulateVertexCache(const std::vector<DWORD>& _rIndices, UINT _vertexCount);
+
+private:
+
+	/***********************
+	* CalcVertexScore: Calculate how much a vertex wants its triangles drawn next
+	* @author: Callan Moore
+	* @parameter: _cachePosition: The position of the vertex in the LRU cache. Negative if it is not in the cache
+	* @parameter: _remaining: The number of triangles using the vertex that are not drawn yet
+	* @return: float: The score. Higher is drawn sooner
+	********************/
+	static float CalcVertexScore(int _cachePosition, UINT _remaining);
+};
+
+#endif	// __DX10_MESHOPTIMISER_H__
@@ -0,0 +1,127 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : DX10_MeshRegistry.cpp
+* Description : Reference counted store of file meshes so objects using the same mesh at the same scale share one GPU buffer
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// This Include
+#include "DX10_MeshRegistry.h"
+
+DX10_MeshRegistry::DX10_MeshRegistry()
+{
+	m_pRenderer = 0;
+}
+
+DX10_MeshRegistry::~DX10_MeshRegistry()
+{
+	for (UINT i = 0; i < m_meshes.size(); i++)
+	{
+		m_meshes[i].pMesh->ReleaseBuffer();
+		ReleasePtr(m_meshes[i].pMesh);
+	}
+}
+
+bool DX10_MeshRegistry::Initialise(DX10_Renderer* _pRenderer)
+{
+	if (_pRenderer == 0)
+	{
+		return false;
+	}
+	m_pRenderer = _pRenderer;
+
+	return true;
+}
+
+DX10_Mesh* DX10_MeshRegistry::Acquire(eMeshType _meshType, v3float _scale, DX10_MeshCache* _pCache)
+{
+	return Acquire(DX10_Mesh::GetFilePath(_meshType), _scale, _pCache);
+}
+
+DX10_Mesh* DX10_MeshRegistry::Acquire(std::string _fileName, v3float _scale, DX10_MeshCache* _pCache)
+{
+	// The scale must match exactly as it is baked into the vertices
+	for (UINT i = 0; i < m_meshes.size(); i++)
+	{
+		if (m_meshes[i].FileName == _fileName && memcmp(&m_meshes[i].Scale, &_scale, sizeof(v3float)) == 0)
+		{
+			m_meshes[i].References++;
+			return m_meshes[i].pMesh;
+		}
+	}
+
+	// First request for the mesh at this scale. Load it unless it was loaded already
+	DX10_MeshCache cache;
+	if (_pCache == 0)
+	{
+		if (cache.Initialise(_fileName, _scale) == false)
+		{
+			return 0;
+		}
+		_pCache = &cache;
+	}
+
+	DX10_Mesh* pMesh = new DX10_Mesh();
+	if (pMesh->Initialise(m_pRenderer, _pCache, _scale) == false)
+	{
+		ReleasePtr(pMesh);
+		return 0;
+	}
+
+	TMeshEntry entry;
+	entry.FileName = _fileName;
+	entry.Scale = _scale;
+	entry.References = 1;
+	entry.pMesh = pMesh;
+	m_meshes.push_back(entry);
+
+	return pMesh;
+}
+
+void DX10_MeshRegistry::Release(DX10_Mesh*& _prMesh)
+{
+	for (UINT i = 0; i < m_meshes.size(); i++)
+	{
+		if (m_meshes[i].pMesh == _prMesh)
+		{
+			m_meshes[i].References--;
+			if (m_meshes[i].References == 0)
+			{
+				m_meshes[i].pMesh->ReleaseBuffer();
+				ReleasePtr(m_meshes[i].pMesh);
+				m_meshes.erase(m_meshes.begin() + i);
+			}
+			break;
+		}
+	}
+	_prMesh = 0;
+}
+
+std::vector<TMeshStats> DX10_MeshRegistry::GetStats()
+{
+	std::vector<TMeshStats> stats;
+	for (UINT i = 0; i < m_meshes.size(); i++)
+	{
+		DX10_Buffer* pBuffer = m_meshes[i].pMesh->GetBuffer();
+
+		TMeshStats meshStats;
+		meshStats.FileName = m_meshes[i].FileName;
+		meshStats.Scale = m_meshes[i].Scale;
+		meshStats.References = m_meshes[i].References;
+		meshStats.VertexCount = pBuffer->GetVertexCount();
+		meshStats.IndexCount = pBuffer->GetIndexCount();
+		meshStats.VertexBytes = pBuffer->GetVertexBytes();
+		meshStats.IndexBytes = pBuffer->GetIndexBytes();
+		meshStats.SavedBytes = (meshStats.References - 1) * (meshStats.VertexBytes + meshStats.IndexBytes);
+		stats.push_back(meshStats);
+	}
+
+	return stats;
+}
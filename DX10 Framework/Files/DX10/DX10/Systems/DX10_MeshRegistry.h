@@ -0,0 +1,118 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : DX10_MeshRegistry.h
+* Description : Reference counted store of file meshes so objects using the same mesh at the same scale share one GPU buffer
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// Inclusion Guards
+#pragma once
+#ifndef __DX10_MESHREGISTRY_H__
+#define __DX10_MESHREGISTRY_H__
+
+// Local Includes
+#include "../Meshes/DX10_Mesh.h"
+
+/***********************
+* TMeshStats: Memory used by a mesh in the registry
+* @author: Callan Moore
+********************/
+struct TMeshStats
+{
+	std::string FileName;
+	v3float Scale;
+	UINT References;
+	UINT VertexCount;
+	UINT IndexCount;
+
+	// Size of the GPU buffers. File meshes keep no copy of their vertices in system memory
+	UINT VertexBytes;
+	UINT IndexBytes;
+
+	// Bytes a separate copy for every reference beyond the first would have used
+	UINT SavedBytes;
+};
+
+/***********************
+* TMeshEntry: A shared mesh and the number of objects holding it
+* @author: Callan Moore
+********************/
+struct TMeshEntry
+{
+	std::string FileName;
+	v3float Scale;
+	UINT References;
+	DX10_Mesh* pMesh;
+};
+
+class DX10_MeshRegistry
+{
+public:
+	/***********************
+	* DX10_MeshRegistry: Default Constructor for Mesh Registry class
+	* @author: Callan Moore
+	********************/
+	DX10_MeshRegistry();
+
+	/***********************
+	* ~DX10_MeshRegistry: Default Destructor for Mesh Registry class. Deletes any meshes still held
+	* @author: Callan Moore
+	********************/
+	~DX10_MeshRegistry();
+
+	/***********************
+	* Initialise: Initialise the Mesh Registry
+	* @author: Callan Moore
+	* @parameter: _pRenderer: The renderer the meshes are created on
+	* @return: bool: Successful or not
+	********************/
+	bool Initialise(DX10_Renderer* _pRenderer);
+
+	/***********************
+	* Acquire: Retrieve the shared mesh of a mesh type at a scale, creating it on the first request
+	* @author: Callan Moore
+	* @parameter: _meshType: The type of mesh
+	* @parameter: _scale: The scale baked into the vertices. Pass a scale of one and scale the object instead to share the mesh between sizes
+	* @parameter: _pCache: The mesh already loaded at the scale, such as one from the asset loader. Zero to load it here
+	* @return: DX10_Mesh*: The shared mesh. Zero if it could not be created
+	********************/
+	DX10_Mesh* Acquire(eMeshType _meshType, v3float _scale, DX10_MeshCache* _pCache = 0);
+
+	/***********************
+	* Acquire: Retrieve the shared mesh of a mesh file at a scale, creating it on the first request
+	* @author: Callan Moore
+	* @parameter: _fileName: The file name of the mesh with file path
+	* @parameter: _scale: The scale baked into the vertices
+	* @parameter: _pCache: The mesh already loaded at the scale. Zero to load it here
+	* @return: DX10_Mesh*: The shared mesh. Zero if it could not be created
+	********************/
+	DX10_Mesh* Acquire(std::string _fileName, v3float _scale, DX10_MeshCache* _pCache = 0);
+
+	/***********************
+	* Release: Give up a reference to a shared mesh. The mesh and its GPU buffer are released with the last reference
+	* @author: Callan Moore
+	* @parameter: _prMesh: The mesh returned by Acquire. Set to zero
+	* @return: void
+	********************/
+	void Release(DX10_Mesh*& _prMesh);
+
+	/***********************
+	* GetStats: Retrieve the memory used by every mesh in the registry
+	* @author: Callan Moore
+	* @return: std::vector<TMeshStats>: One entry per shared mesh
+	********************/
+	std::vector<TMeshStats> GetStats();
+
+private:
+	DX10_Renderer* m_pRenderer;
+	std::vector<TMeshEntry> m_meshes;
+};
+
+#endif	// __DX10_MESHREGISTRY_H__
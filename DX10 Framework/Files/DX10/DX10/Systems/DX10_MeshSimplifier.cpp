@@ -0,0 +1,422 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : DX10_MeshSimplifier.cpp
+* Description : Builds lower levels of detail of an indexed mesh by collapsing edges in order of their quadric error
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// This Include
+#include "DX10_MeshSimplifier.h"
+
+// Library Includes
+#include <algorithm>
+#include <cfloat>
+
+/***********************
+* TEdgeCollapse: Moving every vertex at one position onto a neighbouring position, and the error it adds
+* @author: Callan Moore
+********************/
+struct TEdgeCollapse
+{
+	UINT From;
+	UINT To;
+	double Error;
+
+	bool operator<(const TEdgeCollapse& _rOther) const { return (Error < _rOther.Error); };
+};
+
+/***********************
+* TPositionLess: Orders vertices by position so vertices split by a seam sort next to each other
+* @author: Callan Moore
+********************/
+struct TPositionLess
+{
+	const std::vector<TVertexNormalUV>* pVertices;
+
+	bool operator()(UINT _a, UINT _b) const
+	{
+		const D3DXVECTOR3& rPosA = (*pVertices)[_a].pos;
+		const D3DXVECTOR3& rPosB = (*pVertices)[_b].pos;
+		if (rPosA.x != rPosB.x) { return (rPosA.x < rPosB.x); }
+		if (rPosA.y != rPosB.y) { return (rPosA.y < rPosB.y); }
+		if (rPosA.z != rPosB.z) { return (rPosA.z < rPosB.z); }
+		return (_a < _b);
+	}
+};
+
+void DX10_MeshSimplifier::BuildLods(const std::vector<TVertexNormalUV>& _rVertices, std::vector<DWORD>& _prIndices, std::vector<TMeshLod>& _prLods)
+{
+	_prLods.clear();
+
+	TMeshLod lod;
+	lod.IndexStart = 0;
+	lod.IndexCount = (UINT)_prIndices.size();
+	lod.Error = 0.0f;
+	_prLods.push_back(lod);
+
+	UINT triangleCount = (UINT)_prIndices.size() / 3;
+	if (triangleCount < MESH_LOD_MIN_TRIANGLES)
+	{
+		return;
+	}
+
+	// Simplify from the full mesh each time so the error of every level is measured against the full mesh
+	float ratios[MESH_LOD_MAX - 1] = MESH_LOD_RATIOS;
+	std::vector<DWORD> fullIndices = _prIndices;
+	std::vector<DWORD> lodIndices;
+	for (UINT i = 0; i < MESH_LOD_MAX - 1; i++)
+	{
+		UINT targetIndexCount = (UINT)((float)triangleCount * ratios[i]) * 3;
+		float error = Simplify(_rVertices, fullIndices, targetIndexCount, lodIndices);
+		if (lodIndices.empty() == true || (float)lodIndices.size() > (float)_prLods.back().IndexCount * MESH_LOD_MIN_REDUCTION)
+		{
+			// Borders and seams stop the mesh getting any smaller
+			break;
+		}
+		DX10_MeshOptimiser::OptimiseVertexCache(lodIndices, (UINT)_rVertices.size());
+
+		lod.IndexStart = (UINT)_prIndices.size();
+		lod.IndexCount = (UINT)lodIndices.size();
+		lod.Error = error;
+		_prIndices.insert(_prIndices.end(), lodIndices.begin(), lodIndices.end());
+		_prLods.push_back(lod);
+	}
+}
+
+float DX10_MeshSimplifier::Simplify(const std::vector<TVertexNormalUV>& _rVertices, const std::vector<DWORD>& _rIndices, UINT _targetIndexCount, std::vector<DWORD>& _prResult)
+{
+	UINT vertexCount = (UINT)_rVertices.size();
+	_prResult.clear();
+
+	// Vertices at the same position move together. Each position is known by the first vertex at it
+	std::vector<UINT> order(vertexCount);
+	for (UINT i = 0; i < vertexCount; i++)
+	{
+		order[i] = i;
+	}
+	TPositionLess positionLess;
+	positionLess.pVertices = &_rVertices;
+	std::sort(order.begin(), order.end(), positionLess);
+
+	std::vector<UINT> position(vertexCount);
+	for (UINT i = 0; i < vertexCount; i++)
+	{
+		bool samePosition = (i > 0 && _rVertices[order[i]].pos == _rVertices[order[i - 1]].pos);
+		position[order[i]] = (samePosition == true) ? position[order[i - 1]] : order[i];
+	}
+
+	// Triangles that are already degenerate are dropped
+	for (UINT i = 0; i + 2 < _rIndices.size(); i += 3)
+	{
+		UINT a = position[_rIndices[i]];
+		UINT b = position[_rIndices[i + 1]];
+		UINT c = position[_rIndices[i + 2]];
+		if (a != b && b != c && c != a)
+		{
+			_prResult.push_back(_rIndices[i]);
+			_prResult.push_back(_rIndices[i + 1]);
+			_prResult.push_back(_rIndices[i + 2]);
+		}
+	}
+
+	// Every position starts with the planes of the triangles around it
+	TQuadric emptyQuadric;
+	memset(&emptyQuadric, 0, sizeof(emptyQuadric));
+	std::vector<TQuadric> quadrics(vertexCount, emptyQuadric);
+	for (UINT i = 0; i < _prResult.size(); i += 3)
+	{
+		const D3DXVECTOR3& rPosA = _rVertices[_prResult[i]].pos;
+		const D3DXVECTOR3& rPosB = _rVertices[_prResult[i + 1]].pos;
+		const D3DXVECTOR3& rPosC = _rVertices[_prResult[i + 2]].pos;
+		v3float posA = { rPosA.x, rPosA.y, rPosA.z };
+		v3float posB = { rPosB.x, rPosB.y, rPosB.z };
+		v3float posC = { rPosC.x, rPosC.y, rPosC.z };
+
+		// The cross product is twice the area in length
+		v3float cross = (posB - posA).Cross(posC - posA);
+		float doubleArea = cross.Magnitude();
+		if (doubleArea == 0.0f)
+		{
+			continue;
+		}
+		v3float normal = cross / doubleArea;
+		float distance = -normal.Dot(posA);
+		for (UINT corner = 0; corner < 3; corner++)
+		{
+			AddPlane(quadrics[position[_prResult[i + corner]]], normal, distance, doubleArea * 0.5f);
+		}
+	}
+
+	// Positions on an open border, or on an edge shared by more than two triangles, are locked so the outline keeps its shape
+	std::vector<unsigned __int64> edges;
+	for (UINT i = 0; i < _prResult.size(); i += 3)
+	{
+		for (UINT corner = 0; corner < 3; corner++)
+		{
+			unsigned __int64 from = position[_prResult[i + corner]];
+			unsigned __int64 to = position[_prResult[i + (corner + 1) % 3]];
+			edges.push_back((from << 32) | to);
+		}
+	}
+	std::sort(edges.begin(), edges.end());
+	std::vector<bool> locked(vertexCount, false);
+	for (UINT i = 0; i < edges.size(); i++)
+	{
+		unsigned __int64 reverse = (edges[i] << 32) | (edges[i] >> 32);
+		size_t uses = (std::upper_bound(edges.begin(), edges.end(), edges[i]) - std::lower_bound(edges.begin(), edges.end(), edges[i]))
+			+ (std::upper_bound(edges.begin(), edges.end(), reverse) - std::lower_bound(edges.begin(), edges.end(), reverse));
+		if (uses != 2)
+		{
+			locked[(UINT)(edges[i] >> 32)] = true;
+			locked[(UINT)(edges[i] & 0xFFFFFFFF)] = true;
+		}
+	}
+
+	std::vector<UINT> firstTriangle(vertexCount + 1);
+	std::vector<UINT> triangles;
+	std::vector<TEdgeCollapse> collapses;
+	std::vector<bool> touched(vertexCount);
+	std::vector<std::pair<UINT, UINT>> remap;
+	double maxError = 0.0;
+	UINT targetTriangles = _targetIndexCount / 3;
+	UINT triangleCount = (UINT)_prResult.size() / 3;
+
+	// Each pass collapses the cheapest edges it can. A collapse changes the triangles around it, so no position near one
+	// is used again until the next pass
+	while (triangleCount > targetTriangles)
+	{
+		// The triangles around each position
+		std::fill(firstTriangle.begin(), firstTriangle.end(), 0);
+		for (UINT i = 0; i < _prResult.size(); i++)
+		{
+			firstTriangle[position[_prResult[i]] + 1]++;
+		}
+		for (UINT i = 0; i < vertexCount; i++)
+		{
+			firstTriangle[i + 1] += firstTriangle[i];
+		}
+		triangles.resize(_prResult.size());
+		std::vector<UINT> fill(firstTriangle.begin(), firstTriangle.end() - 1);
+		for (UINT i = 0; i < _prResult.size(); i++)
+		{
+			triangles[fill[position[_prResult[i]]]++] = i / 3;
+		}
+
+		// Each edge collapses in whichever direction adds the least error. Edges inside the mesh are seen from both of their
+		// triangles, so they are only taken in the direction that goes up
+		collapses.clear();
+		for (UINT i = 0; i < _prResult.size(); i++)
+		{
+			UINT a = position[_prResult[i]];
+			UINT b = position[_prResult[(i % 3 == 2) ? i - 2 : i + 1]];
+			if (a > b || (locked[a] == true && locked[b] == true))
+			{
+				continue;
+			}
+
+			double errorAB = (locked[a] == true) ? DBL_MAX : CalcError(quadrics[a], quadrics[b], _rVertices[b].pos);
+			double errorBA = (locked[b] == true) ? DBL_MAX : CalcError(quadrics[a], quadrics[b], _rVertices[a].pos);
+			TEdgeCollapse collapse;
+			collapse.From = (errorAB <= errorBA) ? a : b;
+			collapse.To = (errorAB <= errorBA) ? b : a;
+			collapse.Error = (errorAB <= errorBA) ? errorAB : errorBA;
+			collapses.push_back(collapse);
+		}
+		std::sort(collapses.begin(), collapses.end());
+
+		// Most collapses remove two triangles
+		UINT collapseGoal = (triangleCount - targetTriangles) / 2 + 1;
+		UINT collapseCount = 0;
+		std::fill(touched.begin(), touched.end(), false);
+		for (UINT i = 0; i < collapses.size() && collapseCount < collapseGoal; i++)
+		{
+			UINT from = collapses[i].From;
+			UINT to = collapses[i].To;
+			if (touched[from] == true || touched[to] == true)
+			{
+				continue;
+			}
+
+			// Every vertex at the position moves onto a vertex across the edge that shares a triangle with it, so texture
+			// coordinates and normals stay on their side of a seam. A vertex with no such partner, or two, can not move
+			remap.clear();
+			bool valid = true;
+			for (UINT triangle = firstTriangle[from]; triangle < firstTriangle[from + 1] && valid == true; triangle++)
+			{
+				const DWORD* pCorners = &_prResult[triangles[triangle] * 3];
+				UINT fromCorner = (position[pCorners[0]] == from) ? 0 : ((position[pCorners[1]] == from) ? 1 : 2);
+				UINT toCorner = 3;
+				for (UINT corner = 0; corner < 3; corner++)
+				{
+					if (position[pCorners[corner]] == to)
+					{
+						toCorner = corner;
+					}
+				}
+				if (toCorner == 3)
+				{
+					continue;
+				}
+
+				bool found = false;
+				for (UINT j = 0; j < remap.size(); j++)
+				{
+					if (remap[j].first == pCorners[fromCorner])
+					{
+						found = true;
+						valid = (remap[j].second == pCorners[toCorner]);
+					}
+				}
+				if (found == false)
+				{
+					remap.push_back(std::pair<UINT, UINT>(pCorners[fromCorner], pCorners[toCorner]));
+				}
+			}
+
+			// No triangle that is kept may be left without a partner or be flipped over
+			const D3DXVECTOR3& rTo = _rVertices[to].pos;
+			v3float toPos = { rTo.x, rTo.y, rTo.z };
+			for (UINT triangle = firstTriangle[from]; triangle < firstTriangle[from + 1] && valid == true; triangle++)
+			{
+				const DWORD* pCorners = &_prResult[triangles[triangle] * 3];
+				UINT fromCorner = (position[pCorners[0]] == from) ? 0 : ((position[pCorners[1]] == from) ? 1 : 2);
+				if (position[pCorners[0]] == to || position[pCorners[1]] == to || position[pCorners[2]] == to)
+				{
+					continue;
+				}
+
+				bool found = false;
+				for (UINT j = 0; j < remap.size(); j++)
+				{
+					found |= (remap[j].first == pCorners[fromCorner]);
+				}
+
+				const D3DXVECTOR3& rPosA = _rVertices[pCorners[fromCorner]].pos;
+				const D3DXVECTOR3& rPosB = _rVertices[pCorners[(fromCorner + 1) % 3]].pos;
+				const D3DXVECTOR3& rPosC = _rVertices[pCorners[(fromCorner + 2) % 3]].pos;
+				v3float posA = { rPosA.x, rPosA.y, rPosA.z };
+				v3float posB = { rPosB.x, rPosB.y, rPosB.z };
+				v3float posC = { rPosC.x, rPosC.y, rPosC.z };
+				v3float before = (posB - posA).Cross(posC - posA);
+				v3float after = (posB - toPos).Cross(posC - toPos);
+				valid = (found == true && before.Dot(after) > 0.0f);
+			}
+			if (valid == false)
+			{
+				continue;
+			}
+
+			// Move the vertices. The triangles across the edge become degenerate and are removed after the pass
+			for (UINT triangle = firstTriangle[from]; triangle < firstTriangle[from + 1]; triangle++)
+			{
+				DWORD* pCorners = &_prResult[triangles[triangle] * 3];
+				for (UINT corner = 0; corner < 3; corner++)
+				{
+					touched[position[pCorners[corner]]] = true;
+					for (UINT j = 0; j < remap.size(); j++)
+					{
+						if (remap[j].first == pCorners[corner])
+						{
+							pCorners[corner] = remap[j].second;
+							break;
+						}
+					}
+				}
+			}
+			AddQuadric(quadrics[to], quadrics[from]);
+			maxError = max(maxError, collapses[i].Error);
+			collapseCount++;
+		}
+
+		if (collapseCount == 0)
+		{
+			// Nothing left can collapse
+			break;
+		}
+
+		UINT kept = 0;
+		for (UINT i = 0; i < _prResult.size(); i += 3)
+		{
+			UINT a = position[_prResult[i]];
+			UINT b = position[_prResult[i + 1]];
+			UINT c = position[_prResult[i + 2]];
+			if (a != b && b != c && c != a)
+			{
+				_prResult[kept++] = _prResult[i];
+				_prResult[kept++] = _prResult[i + 1];
+				_prResult[kept++] = _prResult[i + 2];
+			}
+		}
+		_prResult.resize(kept);
+		triangleCount = kept / 3;
+	}
+
+	return (float)sqrt(maxError);
+}
+
+// Private Functions
+
+void DX10_MeshSimplifier::AddPlane(TQuadric& _prQuadric, v3float _normal, float _distance, float _weight)
+{
+	double x = _normal.x;
+	double y = _normal.y;
+	double z = _normal.z;
+	double d = _distance;
+	double w = _weight;
+
+	_prQuadric.XX += w * x * x;
+	_prQuadric.XY += w * x * y;
+	_prQuadric.XZ += w * x * z;
+	_prQuadric.XD += w * x * d;
+	_prQuadric.YY += w * y * y;
+	_prQuadric.YZ += w * y * z;
+	_prQuadric.YD += w * y * d;
+	_prQuadric.ZZ += w * z * z;
+	_prQuadric.ZD += w * z * d;
+	_prQuadric.DD += w * d * d;
+	_prQuadric.Weight += w;
+}
+
+void DX10_MeshSimplifier::AddQuadric(TQuadric& _prQuadric, const TQuadric& _rOther)
+{
+	_prQuadric.XX += _rOther.XX;
+	_prQuadric.XY += _rOther.XY;
+	_prQuadric.XZ += _rOther.XZ;
+	_prQuadric.XD += _rOther.XD;
+	_prQuadric.YY += _rOther.YY;
+	_prQuadric.YZ += _rOther.YZ;
+	_prQuadric.YD += _rOther.YD;
+	_prQuadric.ZZ += _rOther.ZZ;
+	_prQuadric.ZD += _rOther.ZD;
+	_prQuadric.DD += _rOther.DD;
+	_prQuadric.Weight += _rOther.Weight;
+}
+
+double DX10_MeshSimplifier::CalcError(const TQuadric& _rQuadricA, const TQuadric& _rQuadricB, const D3DXVECTOR3& _pos)
+{
+	double x = _pos.x;
+	double y = _pos.y;
+	double z = _pos.z;
+
+	// Expand (n.p + d)^2 summed over the planes of both quadrics
+	double error = 0.0;
+	const TQuadric* pQuadrics[2] = { &_rQuadricA, &_rQuadricB };
+	for (UINT i = 0; i < 2; i++)
+	{
+		const TQuadric& rQ = *pQuadrics[i];
+		error += rQ.XX * x * x + rQ.YY * y * y + rQ.ZZ * z * z
+			+ 2.0 * (rQ.XY * x * y + rQ.XZ * x * z + rQ.YZ * y * z)
+			+ 2.0 * (rQ.XD * x + rQ.YD * y + rQ.ZD * z)
+			+ rQ.DD;
+	}
+
+	double weight = _rQuadricA.Weight + _rQuadricB.Weight;
+	return (weight > 0.0) ? max(error, 0.0) / weight : 0.0;
+}
@@ -0,0 +1,119 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : DX10_MeshSimplifier.h
+* Description : Builds lower levels of detail of an indexed mesh by collapsing edges in order of their quadric error
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// Inclusion Guards
+#pragma once
+#ifndef __DX10_MESHSIMPLIFIER_H__
+#define __DX10_MESHSIMPLIFIER_H__
+
+// Local Includes
+#include "DX10_MeshOptimiser.h"
+
+// Defines
+// Most levels of detail a mesh holds, the full mesh included
+#define MESH_LOD_MAX 4
+// Triangles kept by each level after the full mesh, as a fraction of the full mesh
+#define MESH_LOD_RATIOS { 0.5f, 0.25f, 0.1f }
+// Meshes with fewer triangles than this are only drawn at full detail
+#define MESH_LOD_MIN_TRIANGLES 64
+// Most triangles a level may keep, as a fraction of the level before. A level the simplifier can not reduce further is dropped
+#define MESH_LOD_MIN_REDUCTION 0.8f
+
+/***********************
+* TMeshLod: A level of detail. A range of the index buffer drawn with the vertices of the full mesh
+* @author: Callan Moore
+********************/
+struct TMeshLod
+{
+	UINT IndexStart;
+	UINT IndexCount;
+
+	// How far, in mesh units, the surface of the level may be from the full mesh. Zero for the full mesh
+	float Error;
+};
+
+/***********************
+* TQuadric: Sum of the squared distances to a set of planes, weighted by the area of the triangles the planes came from
+* @author: Callan Moore
+********************/
+struct TQuadric
+{
+	double XX, XY, XZ, XD;
+	double YY, YZ, YD;
+	double ZZ, ZD;
+	double DD;
+	double Weight;
+};
+
+class DX10_MeshSimplifier
+{
+public:
+	/***********************
+	* BuildLods: Append the levels of detail of a mesh to its index list. Each level is simplified from the full mesh
+	*	and put in vertex cache order. Levels that can not be reduced enough are left out
+	* @author: Callan Moore
+	* @parameter: _rVertices: The vertices, shared by every level
+	* @parameter: _prIndices: The triangle list indices of the full mesh. The indices of each level are added on the end
+	* @parameter: _prLods: Storage for the levels, the full mesh first
+	* @return: void
+	********************/
+	static void BuildLods(const std::vector<TVertexNormalUV>& _rVertices, std::vector<DWORD>& _prIndices, std::vector<TMeshLod>& _prLods);
+
+	/***********************
+	* Simplify: Collapse edges of a mesh, cheapest first, until it has no more than a number of indices or nothing more can collapse.
+	*	A vertex moves onto a neighbour so no new vertices are made. Vertices on open borders stay where they are, a vertex on a
+	*	seam only moves along the seam, and collapses that would flip a triangle over are skipped
+	* @author: Callan Moore
+	* @parameter: _rVertices: The vertices
+	* @parameter: _rIndices: The triangle list indices
+	* @parameter: _targetIndexCount: The number of indices to reduce to
+	* @parameter: _prResult: Storage for the simplified indices
+	* @return: float: How far, in mesh units, the simplified surface may be from the original
+	********************/
+	static float Simplify(const std::vector<TVertexNormalUV>& _rVertices, const std::vector<DWORD>& _rIndices, UINT _targetIndexCount, std::vector<DWORD>& _prResult);
+
+private:
+
+	/***********************
+	* AddPlane: Add the plane of a triangle to a quadric
+	* @author: Callan Moore
+	* @parameter: _prQuadric: The quadric
+	* @parameter: _normal: The unit normal of the plane
+	* @parameter: _distance: The plane constant, so a point p is on the plane when _normal.p + _distance is zero
+	* @parameter: _weight: The area of the triangle
+	* @return: void
+	********************/
+	static void AddPlane(TQuadric& _prQuadric, v3float _normal, float _distance, float _weight);
+
+	/***********************
+	* AddQuadric: Add one quadric to another
+	* @author: Callan Moore
+	* @parameter: _prQuadric: The quadric added to
+	* @parameter: _rOther: The quadric to add
+	* @return: void
+	********************/
+	static void AddQuadric(TQuadric& _prQuadric, const TQuadric& _rOther);
+
+	/***********************
+	* CalcError: Calculate the area weighted mean of the squared distances from a point to the planes of two quadrics
+	* @author: Callan Moore
+	* @parameter: _rQuadricA: The first quadric
+	* @parameter: _rQuadricB: The second quadric
+	* @parameter: _pos: The point
+	* @return: double: The mean squared distance
+	********************/
+	static double CalcError(const TQuadric& _rQuadricA, const TQuadric& _rQuadricB, const D3DXVECTOR3& _pos);
+};
+
+#endif	// __DX10_MESHSIMPLIFIER_H__
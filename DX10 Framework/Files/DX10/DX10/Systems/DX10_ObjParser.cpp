@@ -0,0 +1,414 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : DX10_ObjParser.cpp
+* Description : Single pass OBJ mesh parser that reads a memory mapped file and welds the corners into an indexed mesh
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// This Include
+#include "DX10_ObjParser.h"
+
+// Powers of ten that are exact in a double. The float fast path only uses the first eleven, which are exact in a float
+static const double s_powersOfTen[23] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+bool DX10_ObjParser::Load(std::string _fileName, v3float _scale, std::vector<TVertexNormalUV>& _prVertices, std::vector<DWORD>& _prIndices)
+{
+	// Open the file.
+	HANDLE file = CreateFileA(_fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	// An empty file can not be mapped and holds no mesh
+	LARGE_INTEGER fileSize;
+	if (GetFileSizeEx(file, &fileSize) == FALSE || fileSize.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	// Map the whole file so it is read straight from the file cache without copying
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping == NULL)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	const char* pText = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	bool result = false;
+	if (pText != NULL)
+	{
+		result = Parse(pText, (size_t)fileSize.QuadPart, _scale, _prVertices, _prIndices);
+		UnmapViewOfFile(pText);
+	}
+
+	CloseHandle(mapping);
+	CloseHandle(file);
+	return result;
+}
+
+bool DX10_ObjParser::Parse(const char* _pText, size_t _length, v3float _scale, std::vector<TVertexNormalUV>& _prVertices, std::vector<DWORD>& _prIndices)
+{
+	// The buffers grow as lines are read. Reserving from the file size avoids most of the regrowth
+	size_t lineEstimate = (_length / OBJ_BYTES_PER_LINE) + 1;
+	std::vector<v3float> vertices;
+	std::vector<v2float> texUVs;
+	std::vector<v3float> normals;
+	vertices.reserve(lineEstimate / 4);
+	texUVs.reserve(lineEstimate / 4);
+	normals.reserve(lineEstimate / 4);
+	_prVertices.clear();
+	_prIndices.clear();
+
+	// Faces refer to the arrays above by index so they are built once everything is read
+	std::vector<int> faces;
+	faces.reserve(lineEstimate);
+
+	// Read in the vertices, texture coordinates, and normals into the data structures.
+	// Important: Also convert to left hand coordinate system since Maya uses right hand coordinate system.
+	const char* pCursor = _pText;
+	const char* pEnd = _pText + _length;
+	while (pCursor < pEnd)
+	{
+		const char* pLineEnd = (const char*)memchr(pCursor, '\n', pEnd - pCursor);
+		if (pLineEnd == NULL)
+		{
+			pLineEnd = pEnd;
+		}
+
+		if (pLineEnd - pCursor >= 2)
+		{
+			char type = pCursor[0];
+			char subType = pCursor[1];
+			const char* pRead = pCursor + 2;
+
+			if (type == 'v' && subType == ' ')
+			{
+				// Read in the vertices. Invert the Z vertex to change to left hand system.
+				v3float vertex;
+				if (ScanFloat(pRead, pLineEnd, vertex.x) == false || ScanFloat(pRead, pLineEnd, vertex.y) == false || ScanFloat(pRead, pLineEnd, vertex.z) == false)
+				{
+					return false;
+				}
+				vertex.z = vertex.z * -1.0f;
+				vertices.push_back(vertex);
+			}
+			else if (type == 'v' && subType == 't')
+			{
+				// Read in the texture uv coordinates. Invert the V texture coordinates to left hand system.
+				v2float texUV;
+				if (ScanFloat(pRead, pLineEnd, texUV.x) == false || ScanFloat(pRead, pLineEnd, texUV.y) == false)
+				{
+					return false;
+				}
+				texUV.y = 1.0f - texUV.y;
+				texUVs.push_back(texUV);
+			}
+			else if (type == 'v' && subType == 'n')
+			{
+				// Read in the normals. Invert the Z normal to change to left hand system.
+				v3float normal;
+				if (ScanFloat(pRead, pLineEnd, normal.x) == false || ScanFloat(pRead, pLineEnd, normal.y) == false || ScanFloat(pRead, pLineEnd, normal.z) == false)
+				{
+					return false;
+				}
+				normal.z = normal.z * -1.0f;
+				normals.push_back(normal);
+			}
+			else if (type == 'f' && subType == ' ')
+			{
+				// Read the face data in as vertex/uv/normal triples
+				int face[9];
+				for (int corner = 0; corner < 3; corner++)
+				{
+					if (ScanInt(pRead, pLineEnd, face[corner * 3]) == false
+						|| ScanSeparator(pRead, pLineEnd, '/') == false
+						|| ScanInt(pRead, pLineEnd, face[corner * 3 + 1]) == false
+						|| ScanSeparator(pRead, pLineEnd, '/') == false
+						|| ScanInt(pRead, pLineEnd, face[corner * 3 + 2]) == false)
+					{
+						return false;
+					}
+				}
+
+				// Store the corners backwards to convert it to a left hand system from right hand system.
+				for (int corner = 2; corner >= 0; corner--)
+				{
+					faces.push_back(face[corner * 3]);
+					faces.push_back(face[corner * 3 + 1]);
+					faces.push_back(face[corner * 3 + 2]);
+				}
+			}
+		}
+
+		// Start reading the beginning of the next line.
+		pCursor = pLineEnd + 1;
+	}
+
+	// Build one vertex for every corner of every face
+	std::vector<TVertexNormalUV> corners(faces.size() / 3);
+	for (size_t i = 0; i < corners.size(); i++)
+	{
+		// Converting to zero-index
+		int vIndex = faces[i * 3] - 1;
+		int tIndex = faces[i * 3 + 1] - 1;
+		int nIndex = faces[i * 3 + 2] - 1;
+		if (vIndex < 0 || vIndex >= (int)vertices.size() || tIndex < 0 || tIndex >= (int)texUVs.size() || nIndex < 0 || nIndex >= (int)normals.size())
+		{
+			// The face refers to data that is not in the file
+			return false;
+		}
+
+		corners[i] = {	{ vertices[vIndex].x * _scale.x, vertices[vIndex].y * _scale.y, vertices[vIndex].z * _scale.z },
+						{ normals[nIndex].x, normals[nIndex].y, normals[nIndex].z },
+						{ texUVs[tIndex].x, texUVs[tIndex].y } };
+	}
+
+	// Corners shared between faces become a single vertex
+	Weld(corners, _prVertices, _prIndices);
+
+	return true;
+}
+
+void DX10_ObjParser::Weld(const std::vector<TVertexNormalUV>& _rCorners, std::vector<TVertexNormalUV>& _prVertices, std::vector<DWORD>& _prIndices)
+{
+	_prVertices.clear();
+	_prIndices.resize(_rCorners.size());
+
+	// Open addressing table of vertex indices, kept under half full so probes stay short
+	UINT tableSize = 16;
+	while (tableSize < _rCorners.size() * 2)
+	{
+		tableSize <<= 1;
+	}
+	UINT tableMask = tableSize - 1;
+	std::vector<UINT> table(tableSize, OBJ_WELD_EMPTY);
+
+	for (size_t i = 0; i < _rCorners.size(); i++)
+	{
+		const TVertexNormalUV& rCorner = _rCorners[i];
+		UINT slot = HashVertex(rCorner) & tableMask;
+		while (table[slot] != OBJ_WELD_EMPTY && memcmp(&_prVertices[table[slot]], &rCorner, sizeof(TVertexNormalUV)) != 0)
+		{
+			slot = (slot + 1) & tableMask;
+		}
+
+		if (table[slot] == OBJ_WELD_EMPTY)
+		{
+			// First time this vertex is seen
+			table[slot] = (UINT)_prVertices.size();
+			_prVertices.push_back(rCorner);
+		}
+		_prIndices[i] = table[slot];
+	}
+}
+
+bool DX10_ObjParser::ShortenIndices(const std::vector<DWORD>& _rIndices, UINT _vertexCount, std::vector<WORD>& _prShortIndices)
+{
+	if (_vertexCount > OBJ_SHORT_INDEX_LIMIT)
+	{
+		return false;
+	}
+
+	_prShortIndices.resize(_rIndices.size());
+	for (size_t i = 0; i < _rIndices.size(); i++)
+	{
+		_prShortIndices[i] = (WORD)_rIndices[i];
+	}
+
+	return true;
+}
+
+// Private Functions
+
+UINT DX10_ObjParser::HashVertex(const TVertexNormalUV& _rVertex)
+{
+	UINT words[sizeof(TVertexNormalUV) / sizeof(UINT)];
+	memcpy(words, &_rVertex, sizeof(words));
+
+	UINT hash = 0;
+	for (UINT i = 0; i < sizeof(words) / sizeof(UINT); i++)
+	{
+		hash = (hash * 31) + words[i];
+	}
+
+	// Mix the bits so nearby values spread across the table
+	hash ^= hash >> 16;
+	hash *= 0x85EBCA6B;
+	hash ^= hash >> 13;
+	hash *= 0xC2B2AE35;
+	hash ^= hash >> 16;
+	return hash;
+}
+
+bool DX10_ObjParser::ScanFloat(const char*& _prCursor, const char* _pEnd, float& _prValue)
+{
+	const char* pRead = _prCursor;
+	while (pRead < _pEnd && (*pRead == ' ' || *pRead == '\t'))
+	{
+		pRead++;
+	}
+	const char* pStart = pRead;
+
+	bool negative = false;
+	if (pRead < _pEnd && (*pRead == '-' || *pRead == '+'))
+	{
+		negative = (*pRead == '-');
+		pRead++;
+	}
+
+	// Gather up to 19 significant digits, which always fit in 64 bits. Later digits only move the exponent
+	UINT64 mantissa = 0;
+	int significantDigits = 0;
+	int exponent = 0;
+	bool anyDigits = false;
+	bool truncated = false;
+	while (pRead < _pEnd && *pRead >= '0' && *pRead <= '9')
+	{
+		if (significantDigits < 19)
+		{
+			mantissa = (mantissa * 10) + (*pRead - '0');
+			significantDigits += (mantissa != 0) ? 1 : 0;
+		}
+		else
+		{
+			exponent++;
+			truncated = truncated || (*pRead != '0');
+		}
+		anyDigits = true;
+		pRead++;
+	}
+	if (pRead < _pEnd && *pRead == '.')
+	{
+		pRead++;
+		while (pRead < _pEnd && *pRead >= '0' && *pRead <= '9')
+		{
+			if (significantDigits < 19)
+			{
+				mantissa = (mantissa * 10) + (*pRead - '0');
+				significantDigits += (mantissa != 0) ? 1 : 0;
+				exponent--;
+			}
+			else
+			{
+				truncated = truncated || (*pRead != '0');
+			}
+			anyDigits = true;
+			pRead++;
+		}
+	}
+	if (anyDigits == false)
+	{
+		return false;
+	}
+
+	// Optional exponent. Only taken if digits follow, like stream extraction
+	if (pRead < _pEnd && (*pRead == 'e' || *pRead == 'E'))
+	{
+		const char* pExponent = pRead + 1;
+		bool negativeExponent = false;
+		if (pExponent < _pEnd && (*pExponent == '-' || *pExponent == '+'))
+		{
+			negativeExponent = (*pExponent == '-');
+			pExponent++;
+		}
+		if (pExponent < _pEnd && *pExponent >= '0' && *pExponent <= '9')
+		{
+			int exponentValue = 0;
+			while (pExponent < _pEnd && *pExponent >= '0' && *pExponent <= '9')
+			{
+				exponentValue = min(exponentValue * 10 + (*pExponent - '0'), 100000);
+				pExponent++;
+			}
+			exponent += (negativeExponent == true) ? -exponentValue : exponentValue;
+			pRead = pExponent;
+		}
+	}
+
+	float value;
+	if (truncated == false && mantissa <= (1 << 24) && exponent >= -10 && exponent <= 10)
+	{
+		// Both parts are exact floats so a single float operation gives the correctly rounded result
+		value = (float)mantissa;
+		value = (exponent < 0) ? value / (float)s_powersOfTen[-exponent] : value * (float)s_powersOfTen[exponent];
+	}
+	else if (truncated == false && mantissa <= ((UINT64)1 << 53) && exponent >= -22 && exponent <= 22)
+	{
+		// Both parts are exact doubles so the double is correctly rounded before narrowing to a float
+		double wide = (double)mantissa;
+		wide = (exponent < 0) ? wide / s_powersOfTen[-exponent] : wide * s_powersOfTen[exponent];
+		value = (float)wide;
+	}
+	else
+	{
+		// Long or extreme numbers are rare enough to hand to the C library
+		char buffer[64];
+		size_t length = min((size_t)(pRead - pStart), sizeof(buffer) - 1);
+		memcpy(buffer, pStart, length);
+		buffer[length] = 0;
+		_prValue = (float)strtod(buffer, NULL);
+		_prCursor = pRead;
+		return true;
+	}
+
+	_prValue = (negative == true) ? -value : value;
+	_prCursor = pRead;
+	return true;
+}
+
+bool DX10_ObjParser::ScanInt(const char*& _prCursor, const char* _pEnd, int& _prValue)
+{
+	const char* pRead = _prCursor;
+	while (pRead < _pEnd && (*pRead == ' ' || *pRead == '\t'))
+	{
+		pRead++;
+	}
+
+	bool negative = false;
+	if (pRead < _pEnd && (*pRead == '-' || *pRead == '+'))
+	{
+		negative = (*pRead == '-');
+		pRead++;
+	}
+	if (pRead >= _pEnd || *pRead < '0' || *pRead > '9')
+	{
+		return false;
+	}
+
+	int value = 0;
+	while (pRead < _pEnd && *pRead >= '0' && *pRead <= '9')
+	{
+		value = (value * 10) + (*pRead - '0');
+		pRead++;
+	}
+
+	_prValue = (negative == true) ? -value : value;
+	_prCursor = pRead;
+	return true;
+}
+
+bool DX10_ObjParser::ScanSeparator(const char*& _prCursor, const char* _pEnd, char _separator)
+{
+	const char* pRead = _prCursor;
+	while (pRead < _pEnd && (*pRead == ' ' || *pRead == '\t'))
+	{
+		pRead++;
+	}
+	if (pRead >= _pEnd || *pRead != _separator)
+	{
+		return false;
+	}
+
+	_prCursor = pRead + 1;
+	return true;
+}
@@ -0,0 +1,122 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : DX10_ObjParser.h
+* Description : Single pass OBJ mesh parser that reads a memory mapped file and welds the corners into an indexed mesh
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// Inclusion Guards
+#pragma once
+#ifndef __DX10_OBJPARSER_H__
+#define __DX10_OBJPARSER_H__
+
+// Local Includes
+#include "../DX10_Utilities.h"
+#include "../DX10_Vertex.h"
+
+// Library Includes
+#include <vector>
+
+// Defines
+// Rough number of bytes in each line of a mesh file, used to reserve the buffers before parsing
+#define OBJ_BYTES_PER_LINE 32
+// Largest vertex count that can use 16 bit indices. The last value is left unused as it cuts strips
+#define OBJ_SHORT_INDEX_LIMIT 0xFFFF
+// Value of an empty slot in the welding table
+#define OBJ_WELD_EMPTY 0xFFFFFFFF
+
+class DX10_ObjParser
+{
+public:
+	/***********************
+	* Load: Memory map an OBJ file and parse it into an indexed triangle list. Converts to a left hand system like the original loader
+	* @author: Callan Moore
+	* @parameter: _fileName: The file name of the mesh with file path
+	* @parameter: _scale: The scale to load the mesh with
+	* @parameter: _prVertices: Storage variable for the welded vertices
+	* @parameter: _prIndices: Storage variable for the indices. Three per triangle
+	* @return: bool: Successful or not
+	********************/
+	static bool Load(std::string _fileName, v3float _scale, std::vector<TVertexNormalUV>& _prVertices, std::vector<DWORD>& _prIndices);
+
+	/***********************
+	* Parse: Parse the text of an OBJ file that is already in memory. The text does not need to be null terminated
+	* @author: Callan Moore
+	* @parameter: _pText: The text of the file
+	* @parameter: _length: The number of characters in the text
+	* @parameter: _scale: The scale to load the mesh with
+	* @parameter: _prVertices: Storage variable for the welded vertices
+	* @parameter: _prIndices: Storage variable for the indices. Three per triangle
+	* @return: bool: False if the text is malformed
+	********************/
+	static bool Parse(const char* _pText, size_t _length, v3float _scale, std::vector<TVertexNormalUV>& _prVertices, std::vector<DWORD>& _prIndices);
+
+	/***********************
+	* Weld: Merge the corners that have an identical position, normal and uv into one vertex
+	* @author: Callan Moore
+	* @parameter: _rCorners: The corners of the triangles. Three per triangle
+	* @parameter: _prVertices: Storage variable for the welded vertices, in the order they are first used
+	* @parameter: _prIndices: Storage variable for the indices. One per corner
+	* @return: void
+	********************/
+	static void Weld(const std::vector<TVertexNormalUV>& _rCorners, std::vector<TVertexNormalUV>& _prVertices, std::vector<DWORD>& _prIndices);
+
+	/***********************
+	* ShortenIndices: Convert indices to 16 bits if the vertex count allows it
+	* @author: Callan Moore
+	* @parameter: _rIndices: The indices
+	* @parameter: _vertexCount: The number of vertices the indices refer to
+	* @parameter: _prShortIndices: Storage variable for the 16 bit indices
+	* @return: bool: False if there are too many vertices for 16 bit indices
+	********************/
+	static bool ShortenIndices(const std::vector<DWORD>& _rIndices, UINT _vertexCount, std::vector<WORD>& _prShortIndices);
+
+private:
+
+	/***********************
+	* HashVertex: Calculate a hash of the bits of a vertex
+	* @author: Callan Moore
+	* @parameter: _rVertex: The vertex
+	* @return: UINT: The hash
+	********************/
+	static UINT HashVertex(const TVertexNormalUV& _rVertex);
+
+	/***********************
+	* ScanFloat: Read a decimal number after any spaces and move the cursor past it. Rounds the same as stream extraction
+	* @author: Callan Moore
+	* @parameter: _prCursor: The position to read from. Moved to the end of the number
+	* @parameter: _pEnd: The end of the line, never read past
+	* @parameter: _prValue: Storage variable for the number
+	* @return: bool: False if there is no number
+	********************/
+	static bool ScanFloat(const char*& _prCursor, const char* _pEnd, float& _prValue);
+
+	/***********************
+	* ScanInt: Read a whole number after any spaces and move the cursor past it
+	* @author: Callan Moore
+	* @parameter: _prCursor: The position to read from. Moved to the end of the number
+	* @parameter: _pEnd: The end of the line, never read past
+	* @parameter: _prValue: Storage variable for the number
+	* @return: bool: False if there is no number
+	********************/
+	static bool ScanInt(const char*& _prCursor, const char* _pEnd, int& _prValue);
+
+	/***********************
+	* ScanSeparator: Read a single character after any spaces and move the cursor past it
+	* @author: Callan Moore
+	* @parameter: _prCursor: The position to read from. Moved past the character
+	* @parameter: _pEnd: The end of the line, never read past
+	* @parameter: _separator: The character expected
+	* @return: bool: False if the next character is not the separator
+	********************/
+	static bool ScanSeparator(const char*& _prCursor, const char* _pEnd, char _separator);
+};
+
+#endif	// __DX10_OBJPARSER_H__
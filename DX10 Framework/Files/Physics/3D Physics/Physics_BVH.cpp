@@ -0,0 +1,279 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Physics_BVH.cpp
+* Description : Bounding Volume Hierarchy over the triangles of a cloth surface
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// This Include
+#include "Physics_BVH.h"
+
+// Library Includes
+#include <algorithm>
+
+Physics_BVH::Physics_BVH()
+{
+	// Initialise pointers to NULL
+	m_pParticles = 0;
+}
+
+Physics_BVH::~Physics_BVH()
+{
+}
+
+bool Physics_BVH::Initialise(Physics_Particle* _pParticles, std::vector<TBVHTriangle>& _triangles, float _thickness)
+{
+	if (_pParticles == 0 || _triangles.size() == 0)
+	{
+		// Nothing to build the hierarchy over
+		return false;
+	}
+
+	// Assign member variables
+	m_pParticles = _pParticles;
+	m_triangles = _triangles;
+	m_thickness = _thickness;
+	m_maxLeafSize = 4;
+
+	// A binary tree with single triangle leaves has less than double the nodes of triangles
+	m_nodes.clear();
+	m_nodes.reserve(m_triangles.size() * 2);
+
+	// Build the tree top down from the current positions
+	BuildNode(0, (int)m_triangles.size());
+	Refit();
+
+	return true;
+}
+
+void Physics_BVH::Refit()
+{
+	// Children are always stored after their parent so a reverse sweep visits them first
+	for (int i = (int)m_nodes.size() - 1; i >= 0; i--)
+	{
+		TBVHNode* pNode = &m_nodes[i];
+
+		if (pNode->TriangleCount > 0)
+		{
+			// Leaf node. Bound all the triangles it holds
+			pNode->Bounds.Reset();
+			for (int j = 0; j < pNode->TriangleCount; j++)
+			{
+				pNode->Bounds.Expand(CalcTriangleBounds(pNode->FirstTriangle + j));
+			}
+			pNode->Bounds.Inflate(m_thickness);
+		}
+		else
+		{
+			// Internal node. Union of the two children
+			pNode->Bounds = m_nodes[i + 1].Bounds;
+			pNode->Bounds.Expand(m_nodes[pNode->RightChild].Bounds);
+		}
+	}
+}
+
+void Physics_BVH::Query(const TAABB& _box, std::vector<UINT>& _prTriangles)
+{
+	_prTriangles.clear();
+	if (m_nodes.size() == 0)
+	{
+		return;
+	}
+
+	// Traverse the tree with an explicit stack
+	m_stack.clear();
+	m_stack.push_back(0);
+	while (m_stack.empty() == false)
+	{
+		int nodeIndex = m_stack.back();
+		m_stack.pop_back();
+		TBVHNode* pNode = &m_nodes[nodeIndex];
+
+		if (pNode->Bounds.Overlaps(_box) == false)
+		{
+			// Nothing under this node can overlap
+			continue;
+		}
+
+		if (pNode->TriangleCount > 0)
+		{
+			// Leaf node. Return all triangles that individually overlap
+			for (int i = 0; i < pNode->TriangleCount; i++)
+			{
+				UINT triIndex = (UINT)(pNode->FirstTriangle + i);
+				TAABB triBounds = CalcTriangleBounds(triIndex);
+				triBounds.Inflate(m_thickness);
+
+				if (triBounds.Overlaps(_box) == true)
+				{
+					_prTriangles.push_back(triIndex);
+				}
+			}
+		}
+		else
+		{
+			// Internal node. Visit both children
+			m_stack.push_back(pNode->RightChild);
+			m_stack.push_back(nodeIndex + 1);
+		}
+	}
+}
+
+int Physics_BVH::Raycast(v3float _origin, v3float _direction, float& _prDistance)
+{
+	int nearestTriangle = -1;
+	_prDistance = FLT_MAX;
+	if (m_nodes.size() == 0)
+	{
+		return nearestTriangle;
+	}
+
+	// Division by a zero component gives infinity, which the slab test handles
+	v3float invDirection = { 1.0f / _direction.x, 1.0f / _direction.y, 1.0f / _direction.z };
+
+	// Traverse the tree with an explicit stack, skipping nodes beyond the nearest hit so far
+	m_stack.clear();
+	m_stack.push_back(0);
+	while (m_stack.empty() == false)
+	{
+		int nodeIndex = m_stack.back();
+		m_stack.pop_back();
+		TBVHNode* pNode = &m_nodes[nodeIndex];
+
+		if (pNode->Bounds.RayHits(_origin, invDirection, _prDistance) == false)
+		{
+			// Nothing under this node can be hit any closer
+			continue;
+		}
+
+		if (pNode->TriangleCount > 0)
+		{
+			// Leaf node. Test the triangles in packets of four
+			for (int first = 0; first < pNode->TriangleCount; first += 4)
+			{
+				int lanes = min(pNode->TriangleCount - first, 4);
+				TTrianglePacket tris;
+				for (int lane = 0; lane < lanes; lane++)
+				{
+					TBVHTriangle* pTriangle = &m_triangles[pNode->FirstTriangle + first + lane];
+					tris.Set(lane, *m_pParticles[pTriangle->Indices[0]].GetPosition(), *m_pParticles[pTriangle->Indices[1]].GetPosition(), *m_pParticles[pTriangle->Indices[2]].GetPosition());
+				}
+				tris.Pad(lanes);
+
+				__m128 distances;
+				int hitMask = RayIntersectTriangles(_origin, _direction, tris, distances);
+				if (hitMask == 0)
+				{
+					continue;
+				}
+
+				SIMD_ALIGN float hitDistances[4];
+				_mm_store_ps(hitDistances, distances);
+				for (int lane = 0; lane < lanes; lane++)
+				{
+					if ((hitMask & (1 << lane)) != 0 && hitDistances[lane] < _prDistance)
+					{
+						_prDistance = hitDistances[lane];
+						nearestTriangle = pNode->FirstTriangle + first + lane;
+					}
+				}
+			}
+		}
+		else
+		{
+			// Internal node. Visit both children
+			m_stack.push_back(pNode->RightChild);
+			m_stack.push_back(nodeIndex + 1);
+		}
+	}
+
+	return nearestTriangle;
+}
+
+void Physics_BVH::BuildNode(int _first, int _count)
+{
+	int nodeIndex = (int)m_nodes.size();
+	m_nodes.push_back(TBVHNode());
+	m_nodes[nodeIndex].RightChild = -1;
+	m_nodes[nodeIndex].FirstTriangle = _first;
+	m_nodes[nodeIndex].TriangleCount = _count;
+
+	if (_count <= m_maxLeafSize)
+	{
+		// Small enough to be a leaf
+		return;
+	}
+
+	// Bound the centroids of the range to find the longest axis
+	TAABB centroidBounds;
+	centroidBounds.Reset();
+	for (int i = _first; i < _first + _count; i++)
+	{
+		centroidBounds.Expand(CalcTriangleCentroid(i));
+	}
+
+	v3float extent = centroidBounds.Max - centroidBounds.Min;
+	int axis = 0;
+	if (extent.y > extent.x && extent.y >= extent.z)
+	{
+		axis = 1;
+	}
+	else if (extent.z > extent.x && extent.z > extent.y)
+	{
+		axis = 2;
+	}
+
+	// Partition the range around the median centroid on the chosen axis
+	int half = _count / 2;
+	Physics_Particle* pParticles = m_pParticles;
+	std::nth_element(m_triangles.begin() + _first, m_triangles.begin() + _first + half, m_triangles.begin() + _first + _count,
+		[pParticles, axis](const TBVHTriangle& _triA, const TBVHTriangle& _triB)
+		{
+			float centreA = 0.0f;
+			float centreB = 0.0f;
+			for (int i = 0; i < 3; i++)
+			{
+				centreA += (&pParticles[_triA.Indices[i]].GetPosition()->x)[axis];
+				centreB += (&pParticles[_triB.Indices[i]].GetPosition()->x)[axis];
+			}
+			return centreA < centreB;
+		});
+
+	// Build the left child directly after this node then the right child
+	m_nodes[nodeIndex].TriangleCount = 0;
+	BuildNode(_first, half);
+	m_nodes[nodeIndex].RightChild = (int)m_nodes.size();
+	BuildNode(_first + half, _count - half);
+}
+
+TAABB Physics_BVH::CalcTriangleBounds(UINT _index)
+{
+	TBVHTriangle* pTriangle = &m_triangles[_index];
+
+	TAABB bounds;
+	bounds.Reset();
+	for (int i = 0; i < 3; i++)
+	{
+		bounds.Expand(*m_pParticles[pTriangle->Indices[i]].GetPosition());
+	}
+
+	return bounds;
+}
+
+v3float Physics_BVH::CalcTriangleCentroid(UINT _index)
+{
+	TBVHTriangle* pTriangle = &m_triangles[_index];
+
+	v3float centroid = *m_pParticles[pTriangle->Indices[0]].GetPosition();
+	centroid += *m_pParticles[pTriangle->Indices[1]].GetPosition();
+	centroid += *m_pParticles[pTriangle->Indices[2]].GetPosition();
+
+	return (centroid / 3.0f);
+}
@@ -0,0 +1,263 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Physics_BVH.h
+* Description : Bounding Volume Hierarchy over the triangles of a cloth surface
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// Inclusion Guards
+#pragma once
+#ifndef __PHYSICS_BVH_H__
+#define __PHYSICS_BVH_H__
+
+// Local Includes
+#include "Physics_Particle.h"
+
+// Library Includes
+#include <float.h>
+
+/***********************
+* TAABB: Axis aligned bounding box
+* @author: Callan Moore
+********************/
+struct TAABB
+{
+	v3float Min;
+	v3float Max;
+
+	/***********************
+	* Reset: Reset the box to be empty so that any expansion will define it
+	* @author: Callan Moore
+	* @return: void
+	********************/
+	void Reset()
+	{
+		Min = { FLT_MAX, FLT_MAX, FLT_MAX };
+		Max = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+	}
+
+	/***********************
+	* Expand: Expand the box to contain the input point
+	* @author: Callan Moore
+	* @parameter: _point: The point to contain
+	* @return: void
+	********************/
+	void Expand(const v3float& _point)
+	{
+		if (_point.x < Min.x) Min.x = _point.x;
+		if (_point.y < Min.y) Min.y = _point.y;
+		if (_point.z < Min.z) Min.z = _point.z;
+		if (_point.x > Max.x) Max.x = _point.x;
+		if (_point.y > Max.y) Max.y = _point.y;
+		if (_point.z > Max.z) Max.z = _point.z;
+	}
+
+	/***********************
+	* Expand: Expand the box to contain another box
+	* @author: Callan Moore
+	* @parameter: _box: The box to contain
+	* @return: void
+	********************/
+	void Expand(const TAABB& _box)
+	{
+		Expand(_box.Min);
+		Expand(_box.Max);
+	}
+
+	/***********************
+	* Inflate: Grow the box by a margin on every side
+	* @author: Callan Moore
+	* @parameter: _margin: The distance to grow each side by
+	* @return: void
+	********************/
+	void Inflate(float _margin)
+	{
+		Min = Min - _margin;
+		Max = Max + _margin;
+	}
+
+	/***********************
+	* Overlaps: Check if this box overlaps another box
+	* @author: Callan Moore
+	* @parameter: _box: The box to check against
+	* @return: bool: True if the boxes overlap
+	********************/
+	bool Overlaps(const TAABB& _box) const
+	{
+		return (Min.x <= _box.Max.x && Max.x >= _box.Min.x
+			&& Min.y <= _box.Max.y && Max.y >= _box.Min.y
+			&& Min.z <= _box.Max.z && Max.z >= _box.Min.z);
+	}
+
+	/***********************
+	* RayHits: Check if a ray enters the box before a maximum distance using the slab test
+	* @author: Callan Moore
+	* @parameter: _origin: The origin of the ray
+	* @parameter: _invDirection: One over each component of the ray direction
+	* @parameter: _maxDistance: The furthest distance along the ray to accept, in multiples of the direction
+	* @return: bool: True if the ray hits the box within the distance
+	********************/
+	bool RayHits(const v3float& _origin, const v3float& _invDirection, float _maxDistance) const
+	{
+		float nearX = (Min.x - _origin.x) * _invDirection.x;
+		float farX = (Max.x - _origin.x) * _invDirection.x;
+		float nearY = (Min.y - _origin.y) * _invDirection.y;
+		float farY = (Max.y - _origin.y) * _invDirection.y;
+		float nearZ = (Min.z - _origin.z) * _invDirection.z;
+		float farZ = (Max.z - _origin.z) * _invDirection.z;
+
+		float enter = max(max(min(nearX, farX), min(nearY, farY)), max(min(nearZ, farZ), 0.0f));
+		float exit = min(min(max(nearX, farX), max(nearY, farY)), min(max(nearZ, farZ), _maxDistance));
+		return (enter <= exit);
+	}
+};
+
+/***********************
+* TBVHTriangle: A triangle of the cloth surface defined by three particle indices
+* @author: Callan Moore
+********************/
+struct TBVHTriangle
+{
+	UINT Indices[3];
+
+	// Bit flags for the edges (0-1, 1-2, 2-0) that this triangle is responsible for testing
+	UINT OwnedEdges;
+};
+
+/***********************
+* TBVHNode: A node of the BVH. Nodes are stored depth first so the left child is always the next node
+* @author: Callan Moore
+********************/
+struct TBVHNode
+{
+	TAABB Bounds;
+	int RightChild;
+	int FirstTriangle;
+	int TriangleCount;
+};
+
+class Physics_BVH
+{
+public:
+	/***********************
+	* Physics_BVH: Default Constructor for Physics BVH class
+	* @author: Callan Moore
+	********************/
+	Physics_BVH();
+
+	/***********************
+	* ~Physics_BVH: Default Destructor for Physics BVH class
+	* @author: Callan Moore
+	********************/
+	~Physics_BVH();
+
+	/***********************
+	* Initialise: Build the hierarchy over the input triangles
+	* @author: Callan Moore
+	* @parameter: _pParticles: The particles the triangle indices refer to
+	* @parameter: _triangles: The triangles that make up the surface
+	* @parameter: _thickness: The margin to inflate every leaf by
+	* @return: bool: Successful or not
+	********************/
+	bool Initialise(Physics_Particle* _pParticles, std::vector<TBVHTriangle>& _triangles, float _thickness);
+
+	/***********************
+	* Refit: Recalculate all bounding boxes from the current particle positions without changing the tree structure
+	* @author: Callan Moore
+	* @return: void
+	********************/
+	void Refit();
+
+	/***********************
+	* Query: Find all triangles whose bounds overlap the input box
+	* @author: Callan Moore
+	* @parameter: _box: The box to query with
+	* @parameter: _prTriangles: Storage variable for the indices of the overlapping triangles
+	* @return: void
+	********************/
+	void Query(const TAABB& _box, std::vector<UINT>& _prTriangles);
+
+	/***********************
+	* Raycast: Find the nearest triangle hit by a ray. Leaf triangles are tested four at a time
+	* @author: Callan Moore
+	* @parameter: _origin: The origin of the ray
+	* @parameter: _direction: The direction of the ray
+	* @parameter: _prDistance: Storage variable for the distance along the ray to the hit, in multiples of the direction
+	* @return: int: Index of the triangle hit, or -1 if the ray hits nothing
+	********************/
+	int Raycast(v3float _origin, v3float _direction, float& _prDistance);
+
+	/***********************
+	* GetTriangle: Retrieve the triangle at the input index
+	* @author: Callan Moore
+	* @parameter: _index: Index of the triangle
+	* @return: TBVHTriangle*: Pointer to the triangle
+	********************/
+	TBVHTriangle* GetTriangle(UINT _index) { return &m_triangles[_index]; };
+
+	/***********************
+	* GetTriangleCount: Retrieve the number of triangles in the hierarchy
+	* @author: Callan Moore
+	* @return: UINT: The triangle count
+	********************/
+	UINT GetTriangleCount() { return (UINT)m_triangles.size(); };
+
+	/***********************
+	* GetParticles: Retrieve the particles the triangles refer to
+	* @author: Callan Moore
+	* @return: Physics_Particle*: Pointer to the first particle
+	********************/
+	Physics_Particle* GetParticles() { return m_pParticles; };
+
+	/***********************
+	* GetThickness: Retrieve the margin the leaves are inflated by
+	* @author: Callan Moore
+	* @return: float: The thickness
+	********************/
+	float GetThickness() { return m_thickness; };
+
+private:
+
+	/***********************
+	* BuildNode: Recursively build a node over a range of the triangles, splitting at the median of the longest axis
+	* @author: Callan Moore
+	* @parameter: _first: Index of the first triangle in the range
+	* @parameter: _count: Number of triangles in the range
+	* @return: void
+	********************/
+	void BuildNode(int _first, int _count);
+
+	/***********************
+	* CalcTriangleBounds: Calculate the bounds of a triangle from the current particle positions
+	* @author: Callan Moore
+	* @parameter: _index: Index of the triangle
+	* @return: TAABB: The bounding box of the triangle
+	********************/
+	TAABB CalcTriangleBounds(UINT _index);
+
+	/***********************
+	* CalcTriangleCentroid: Calculate the centre point of a triangle from the current particle positions
+	* @author: Callan Moore
+	* @parameter: _index: Index of the triangle
+	* @return: v3float: The centre of the triangle
+	********************/
+	v3float CalcTriangleCentroid(UINT _index);
+
+private:
+	Physics_Particle* m_pParticles;
+	std::vector<TBVHTriangle> m_triangles;
+	std::vector<TBVHNode> m_nodes;
+	std::vector<int> m_stack;
+
+	float m_thickness;
+	int m_maxLeafSize;
+};
+
+#endif	// __PHYSICS_BVH_H__
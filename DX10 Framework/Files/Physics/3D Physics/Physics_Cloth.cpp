@@ -17,24 +17,43 @@
 
 Physics_Cloth::Physics_Cloth()
 {
+	// Initialise pointers to NULL
+	m_pMesh = 0;
+	m_pParticles = 0;
+	m_pVertices = 0;
+	m_pIndices = 0;
+	m_pBVH = 0;
+	m_pImplicitSolver = 0;
+	m_pHeightfield = 0;
+	m_pEffects = 0;
 }
 
 Physics_Cloth::~Physics_Cloth()
 {
-	// Release allocated memory
-	ReleasePtr(m_pMesh);
+	// Release allocated memory. The mesh owns the vertices and indices when there is one
+	if (m_pMesh != 0)
+	{
+		ReleasePtr(m_pMesh);
+	}
+	else
+	{
+		ReleasePtrArray(m_pVertices);
+		ReleasePtrArray(m_pIndices);
+	}
 	ReleasePtrArray(m_pParticles);
+	ReleasePtr(m_pBVH);
+	ReleasePtr(m_pImplicitSolver);
 }
 
 bool Physics_Cloth::Initialise(DX10_Renderer* _pRenderer, DX10_Shader_Cloth* _pShader, int _width, int _height, float _damping, float _timeStep)
 {
-	if (_pRenderer == 0 || _pShader == 0)
+	if (_pRenderer != 0 && _pShader == 0)
 	{
 		// Pointer is NULL, initialization failed
 		return false;
 	}
 
-	// Assign member variables
+	// Assign member variables. A NULL renderer runs the cloth headless without a mesh
 	BaseInitialise();
 	m_pRenderer = _pRenderer;
 	m_pShader = _pShader;
@@ -52,13 +71,42 @@ bool Physics_Cloth::Initialise(DX10_Renderer* _pRenderer, DX10_Shader_Cloth* _pS
 	m_minHooks = 2;
 	m_maxHooks = m_maxWidth;
 
-	m_selfCollisionRad = 0.85f;
+	// Thickness of the cloth surface used for the triangle collisions
+	m_selfCollisionRad = 0.3f;
 
 	m_constraintIterations = 3;
+	m_continuousCollision = true;
+	m_substeps = 1;
+	m_selfCollisionInterval = 1;
+	m_stepCount = 0;
+	m_sleeping = false;
+	m_sleepVelocity = 0.0f;
+	m_sleepFrames = 30;
+	m_stillFrames = 0;
+	m_lastCollisionType = CT_NONE;
+	m_integrator = IT_VERLET;
+	// Adaptive iterations are opt in so the cloth keeps its fixed iteration count until toggled
+	m_adaptiveIterations = false;
+	m_minConstraintIterations = 1;
+	m_maxConstraintIterations = 8;
+	m_residualTolerance = 0.01f;
+	// Chebyshev acceleration is opt in so the baseline solver is unchanged. Benchmark_Cloth compares it with the plain sweeps
+	m_chebyshevEnabled = false;
+	m_spectralRadius = 0.6f;
+	m_chebyshevOmega = 1.0f;
+	m_indicesVersion = 0;
+	m_uploadedIndicesVersion = 0;
+	m_tethersEnabled = true;
+	m_tethersDirty = false;
+	m_tetherSlack = 1.1f;
 	m_breakModifier = 2.4f;
 	m_windSpeed = 1.0f;
 	m_initialisedParticles = false;
 	m_burnTime = 1.5f;
+	m_emberRate = 10.0f;
+	m_emberCarry = 0.0f;
+	m_igniteEmbers = 6;
+	m_destroySmoke = 4;
 	m_complexWeave = true;
 
 	m_maxBlastRadius = 25.0f;
@@ -77,96 +125,326 @@ void Physics_Cloth::Process(eCollisionType _collisionType)
 	// Adding Gravity
 	AddForce({ 0.0f, -9.81f, 0.0f }, FT_GENERIC, false);
 
-	TVertexColor* pVertexBuffer = m_pMesh->GetVertexBufferCloth();
-	DWORD* pIndices = m_pMesh->GetIndexBuffer();
+	TVertexColor* pVertexBuffer = m_pVertices;
+	DWORD* pIndices = m_pIndices;
 
-	// Process each Particle
-	for (int i = 0; i < m_particleCount; i++)
+	// A change of collision object can disturb a resting cloth
+	if (_collisionType != m_lastCollisionType)
+	{
+		m_lastCollisionType = _collisionType;
+		Wake();
+	}
+
+	if (m_sleeping == true)
+	{
+		// The cloth is at rest. Discard the forces of this step without simulating
+		for (int i = 0; i < m_particleCount; i++)
+		{
+			m_pParticles[i].ResetAcceleration();
+		}
+
+		return;
+	}
+
+	// Keep the forces of this step so that every substep feels them
+	if (m_substeps > 1)
+	{
+		for (int i = 0; i < m_particleCount; i++)
+		{
+			m_substepAccelerations[i] = m_pParticles[i].GetAcceleration();
+		}
+	}
+
+	for (int step = 0; step < m_substeps; step++)
 	{
-		m_pParticles[i].Process();
+		if (step > 0)
+		{
+			for (int i = 0; i < m_particleCount; i++)
+			{
+				m_pParticles[i].AddForce(m_substepAccelerations[i] * m_pParticles[i].GetMass());
+			}
+		}
+
+		Simulate(_collisionType, pIndices);
+		m_stepCount++;
 	}
 
-	// Calculate each constraint multiple times
-	for (int i = 0; i < m_constraintIterations; i++)
+	// Cycle through all constraints and check their burning status
 	{
+		PROFILE_SCOPE("Cloth.BurnDown");
 		for (int j = 0; j < (int)m_contraints.size(); j++)
 		{
-			if (m_contraints[j].SatisfyConstraint() == false)
+			Physics_Particle* pIgnitedParticle = 0;
+			switch (m_contraints[j].BurnDown(m_timeStep, pIgnitedParticle))
 			{
-				// Constraint is broken. Stop drawing the line
+			case IA_IGNITEPARTICLE:
+			{
+				// The constraint burnt long enough to ignite the particle on the other end
+				IgniteConnectedConstraints(pIgnitedParticle);
+				if (pIgnitedParticle != 0)
+				{
+					EmitBurnEffect(m_emberEmitter, *pIgnitedParticle->GetPosition(), m_igniteEmbers);
+				}
+			}
+			break;
+			case IA_DESTROYCONSTRAINT:
+			{
+				// The constraint burnt long enough to be destroyed
+				v3float midPoint = (*m_contraints[j].GetParticleA()->GetPosition() + *m_contraints[j].GetParticleB()->GetPosition()) / 2.0f;
+				EmitBurnEffect(m_smokeEmitter, midPoint, m_destroySmoke);
 				pIndices[(j * 2) + 1] = pIndices[j * 2] = 0;
+				m_tethersDirty = true;
+				m_indicesVersion++;
+				PROFILE_COUNT("Cloth.ConstraintsBroken", 1);
+			}
+			break;
+			case IA_NOACTION: // Fall Through
+			default: break;
+			}	// End Switch
+
+			if (m_pEffects != 0 && m_contraints[j].GetBurningState() == true)
+			{
+				// Burning constraints shed embers at a steady rate. The fraction left over carries on to the next constraint
+				m_emberCarry += m_emberRate * m_timeStep;
+				if (m_emberCarry >= 1.0f)
+				{
+					int embers = (int)m_emberCarry;
+					m_emberCarry -= (float)embers;
+					v3float midPoint = (*m_contraints[j].GetParticleA()->GetPosition() + *m_contraints[j].GetParticleB()->GetPosition()) / 2.0f;
+					EmitBurnEffect(m_emberEmitter, midPoint, embers);
+				}
 			}
 		}
+	}
+
+	// Check if the cloth has come to rest
+	UpdateSleepState();
+
+	// Update the vertex for each Particle
+	{
+		PROFILE_SCOPE("Cloth.VertexWrite");
+		for (int i = 0; i < m_particleCount; i++)
+		{
+			pVertexBuffer[i].pos.x = m_pParticles[i].GetPosition()->x;
+			pVertexBuffer[i].pos.y = m_pParticles[i].GetPosition()->y;
+			pVertexBuffer[i].pos.z = m_pParticles[i].GetPosition()->z;
+		}
+	}
+
+	// Update the Buffer
+	if (m_pMesh != 0)
+	{
+		PROFILE_SCOPE("Cloth.UpdateBuffer");
+		bool indicesChanged = (m_uploadedIndicesVersion != m_indicesVersion);
+		m_pMesh->UpdateBufferCloth(indicesChanged);
+		PROFILE_COUNT("Cloth.BytesUploaded", sizeof(TVertexHalfColor) * m_particleCount + ((indicesChanged == true) ? sizeof(DWORD) * m_indexCount : 0));
+		m_uploadedIndicesVersion = m_indicesVersion;
+	}
+}
+
+void Physics_Cloth::Simulate(eCollisionType _collisionType, DWORD* _pIndices)
+{
+	// Process each Particle. The implicit integrator moves the particles itself
+	{
+		PROFILE_SCOPE("Cloth.Integrate");
+		for (int i = 0; i < m_particleCount; i++)
+		{
+			m_pParticles[i].Process(m_integrator == IT_VERLET);
+		}
+	}
+
+	{
+		PROFILE_SCOPE("Cloth.Tethers");
+
+		// Release any hooks that have burnt away
+		for (int i = (int)m_hookedParticles.size() - 1; i >= 0; i--)
+		{
+			if (m_hookedParticles[i]->GetActiveState() == false)
+			{
+				UnhookParticle(m_hookedParticles[i]);
+			}
+		}
+
+		// Constraints destroyed last step may have cut particles off from their hooks
+		if (m_tethersDirty == true)
+		{
+			CalculateTethers();
+		}
+	}
+
+	if (m_integrator == IT_IMPLICIT)
+	{
+		PROFILE_SCOPE("Cloth.ImplicitStep");
+
+		// Break any constraints stretched past breaking point
+		for (int j = 0; j < (int)m_contraints.size(); j++)
+		{
+			if (m_contraints[j].CheckBreak() == true)
+			{
+				// Constraint is broken. Stop drawing the line
+				_pIndices[(j * 2) + 1] = _pIndices[j * 2] = 0;
+				m_tethersDirty = true;
+				m_indicesVersion++;
+				PROFILE_COUNT("Cloth.ConstraintsBroken", 1);
+			}
+		}
+
+		// Integrate the whole cloth in one implicit step then resolve the tethers and collisions
+		m_pImplicitSolver->Step(m_damping);
+		SatisfyTethers();
+		ProcessCollisions(_collisionType);
+	}
+	else
+	{
+		// Project the constraints on the verlet integrated positions
+		SolveConstraints(_collisionType, _pIndices);
+	}
+}
+
+void Physics_Cloth::SolveConstraints(eCollisionType _collisionType, DWORD* _pIndices)
+{
+	// Calculate each constraint multiple times. Adaptive iterations stop once the violation is within tolerance
+	int iterationLimit = (m_adaptiveIterations == true) ? m_maxConstraintIterations : m_constraintIterations;
+	bool accelerate = m_chebyshevEnabled;
+	float lastUpdate = 0.0f;
+	for (int i = 0; i < iterationLimit; i++)
+	{
+		if (accelerate == true)
+		{
+			// Store the iterate the constraint sweep starts from
+			StoreIterate();
+		}
+
+		// Track the violation of the constraints found by this sweep
+		float maxViolation = 0.0f;
+		float sumViolationSquared = 0.0f;
+		int activeConstraints = 0;
+
+		{
+			PROFILE_SCOPE("Cloth.Constraints");
+			for (int j = 0; j < (int)m_contraints.size(); j++)
+			{
+				float violation = 0.0f;
+				if (m_contraints[j].SatisfyConstraint(violation) == false)
+				{
+					// Constraint is broken. Stop drawing the line
+					_pIndices[(j * 2) + 1] = _pIndices[j * 2] = 0;
+					m_tethersDirty = true;
+					m_indicesVersion++;
+					PROFILE_COUNT("Cloth.ConstraintsBroken", 1);
+				}
+				else
+				{
+					maxViolation = max(maxViolation, violation);
+					sumViolationSquared += violation * violation;
+					activeConstraints++;
+				}
+			}
+			PROFILE_COUNT("Cloth.ConstraintsSatisfied", activeConstraints);
+		}
+
+		if (accelerate == true)
+		{
+			// Over relax the constraint sweep. Stops accelerating for this step if it starts to diverge.
+			// Done before the tethers and collisions so the extrapolation can not push particles back past them
+			accelerate = ChebyshevAccelerate(i, lastUpdate);
+		}
+
+		// Stop any particles stretching further from their hook than the cloth could reach
+		{
+			PROFILE_SCOPE("Cloth.Tethers");
+			SatisfyTethers();
+		}
 	
-		// Calculate the collisions with object, if any
+		// Calculate the collisions with objects and the cloth itself
+		ProcessCollisions(_collisionType);
+
+		// Record the solver metrics for this step
+		m_solverMetrics.Iterations = i + 1;
+		m_solverMetrics.MaxResidual = maxViolation;
+		m_solverMetrics.RMSResidual = (activeConstraints > 0) ? sqrt(sumViolationSquared / activeConstraints) : 0.0f;
+		if (i == 0)
+		{
+			m_solverMetrics.InitialMaxResidual = maxViolation;
+		}
+
+		// Stop early once the cloth is within tolerance
+		if (m_adaptiveIterations == true && (i + 1) >= m_minConstraintIterations && maxViolation < m_residualTolerance)
+		{
+			break;
+		}
+	}
+}
+
+void Physics_Cloth::ProcessCollisions(eCollisionType _collisionType)
+{
+	// Calculate the collisions with object, if any
+	{
+		PROFILE_SCOPE("Cloth.Collision.Object");
 		switch (_collisionType)
 		{
 			case CT_SPHERE:
 			{
-				SphereCollision({ 0.0f, 0.0f, 7.0f }, 5.0f);
+				if (m_continuousCollision == true)
+				{
+					SweptSphereCollision(COLLIDER_SPHERE_CENTRE, COLLIDER_SPHERE_RADIUS);
+				}
+				SphereCollision(COLLIDER_SPHERE_CENTRE, COLLIDER_SPHERE_RADIUS);
 			}
 			break;
 			case CT_CAPSULE:
 			{
-				CapsuleCollision({ 0.0f, -3.0f, 6.0f }, { 0.0f, 3.0f, 6.0f }, 3.0f);
+				if (m_continuousCollision == true)
+				{
+					SweptCapsuleCollision(COLLIDER_CAPSULE_CENTRE_A, COLLIDER_CAPSULE_CENTRE_B, COLLIDER_CAPSULE_RADIUS);
+				}
+				CapsuleCollision(COLLIDER_CAPSULE_CENTRE_A, COLLIDER_CAPSULE_CENTRE_B, COLLIDER_CAPSULE_RADIUS);
 			}
 			break;
 			case CT_PYRAMID:
 			{
 				// Hard coded points for the pyramid to use
-				v3float _pyraPointA = { 0.0f, 0.408248f * 10.0f, 0.0f + 7.0f };
-				v3float _pyraPointB = { 0.5f * 10.0f, -0.408248f * 10.0f, -0.288675f * 10.0f + 7.0f };
-				v3float _pyraPointC = { 0.0f, -0.408248f * 10.0f, 0.577350f * 10.0f + 7.0f };
-				v3float _pyraPointD = { -0.5f * 10.0f, -0.408248f * 10.0f, -0.288675f * 10.0f + 7.0f };
+				v3float _pyraPointA = COLLIDER_PYRAMID_POINT_A;
+				v3float _pyraPointB = COLLIDER_PYRAMID_POINT_B;
+				v3float _pyraPointC = COLLIDER_PYRAMID_POINT_C;
+				v3float _pyraPointD = COLLIDER_PYRAMID_POINT_D;
 
+				if (m_continuousCollision == true)
+				{
+					SweptPyramidCollision(_pyraPointA, _pyraPointB, _pyraPointC, _pyraPointD);
+				}
 				PyramidCollision(_pyraPointA, _pyraPointB, _pyraPointC, _pyraPointD);
 			}
 			default: break;
 		}
-
-		// Calculate the permanent collisions
-		FloorCollision(-20.0f);
-		CollisionsWithSelf();
 	}
 
-	// Cycle through all constraints and check their burning status
-	for (int j = 0; j < (int)m_contraints.size(); j++)
+	// Calculate the permanent collisions
 	{
-		Physics_Particle* pIgnitedParticle = 0;
-		switch (m_contraints[j].BurnDown(m_timeStep, pIgnitedParticle))
-		{
-		case IA_IGNITEPARTICLE:
-		{
-			// The constraint burnt long enough to ignite the particle on the other end
-			IgniteConnectedConstraints(pIgnitedParticle);
-		}
-		break;
-		case IA_DESTROYCONSTRAINT:
-		{
-			// The constraint burnt long enough to be destroyed
-			pIndices[(j * 2) + 1] = pIndices[j * 2] = 0;
-		}
-		break;
-		case IA_NOACTION: // Fall Through
-		default: break;
-		}	// End Switch
+		PROFILE_SCOPE("Cloth.Collision.Floor");
+		FloorCollision(COLLIDER_FLOOR_HEIGHT);
 	}
-
-	// Update the vertex for each Particle
-	for (int i = 0; i < m_particleCount; i++)
+	if (m_pHeightfield != 0)
 	{
-		pVertexBuffer[i].pos.x = m_pParticles[i].GetPosition()->x;
-		pVertexBuffer[i].pos.y = m_pParticles[i].GetPosition()->y;
-		pVertexBuffer[i].pos.z = m_pParticles[i].GetPosition()->z;
+		PROFILE_SCOPE("Cloth.Collision.Terrain");
+		HeightfieldCollision();
+	}
+	if (m_stepCount % m_selfCollisionInterval == 0)
+	{
+		PROFILE_SCOPE("Cloth.Collision.Self");
+		CollisionsWithSelf();
 	}
-
-	// Update the Buffer
-	m_pMesh->UpdateBufferCloth();
 }
 
 void Physics_Cloth::Render()
 {
 	// Create the struct to hold the cloth rendering variables
+	if (m_pMesh == 0)
+	{
+		// Headless cloth has nothing to render
+		return;
+	}
+
 	TCloth cloth;
 	cloth.pMatWorld = &m_matWorld;
 	cloth.pMesh = m_pMesh;
@@ -177,6 +455,12 @@ void Physics_Cloth::Render()
 
 void Physics_Cloth::AddForce(v3float _force, eForceType _forceType, bool _selected)
 {
+	// Wind and forces on selected particles disturb a resting cloth. Constant forces like gravity do not
+	if ((_forceType == FT_WIND && m_windSpeed > 0.0f) || _selected == true)
+	{
+		Wake();
+	}
+
 	switch (_forceType)
 	{
 	case FT_GENERIC: // Adds the same generic force to each particle
@@ -213,6 +497,9 @@ void Physics_Cloth::AddForce(v3float _force, eForceType _forceType, bool _select
 
 void Physics_Cloth::ReleaseCloth()
 {
+	// Changes made by the user disturb a resting cloth
+	Wake();
+
 	// Cycle through and release all pinned particles
 	std::vector<Physics_Particle*>::iterator pinnedIter;
 	for (pinnedIter = m_hookedParticles.begin(); pinnedIter != m_hookedParticles.end(); pinnedIter++)
@@ -229,12 +516,17 @@ void Physics_Cloth::ReleaseCloth()
 		}
 	}
 
-	// Clear the entire list of pinned particles
+	// Clear the entire list of pinned particles and the tethers to them
 	m_hookedParticles.clear();
+	m_tetherHooks.assign(m_tetherHooks.size(), -1);
+	m_tetherLengths.assign(m_tetherLengths.size(), FLT_MAX);
 }
 
 void Physics_Cloth::MoveHooks(bool _closer)
 {
+	// Changes made by the user disturb a resting cloth
+	Wake();
+
 	// Check that there are hooked particles
 	if (m_hookedParticles.empty() == false)
 	{
@@ -260,6 +552,8 @@ void Physics_Cloth::MoveHooks(bool _closer)
 			// Set the Particle back to static
 			m_hookedParticles[i]->SetStaticState(true);
 		}
+
+		// The tethers are measured along the rest mesh and read the hook positions every step so they remain valid
 	}
 }
 
@@ -267,6 +561,67 @@ void Physics_Cloth::HookParticle(Physics_Particle* _particle)
 {
 	_particle->SetStaticState(true);
 	m_hookedParticles.push_back(_particle);
+
+	// Tether the particles that are closer to the new hook than their current one
+	int hookIndex = (int)_particle->GetParticleID();
+	m_tetherHooks[hookIndex] = hookIndex;
+	m_tetherLengths[hookIndex] = 0.0f;
+
+	std::vector<int> seeds(1, hookIndex);
+	PropagateTethers(seeds);
+}
+
+void Physics_Cloth::UnhookParticle(Physics_Particle* _particle)
+{
+	std::vector<Physics_Particle*>::iterator hookIter = std::find(m_hookedParticles.begin(), m_hookedParticles.end(), _particle);
+	if (hookIter == m_hookedParticles.end())
+	{
+		// Particle is not hooked
+		return;
+	}
+
+	m_hookedParticles.erase(hookIter);
+	Wake();
+	_particle->SetStaticState(false);
+
+	if (_particle->GetActiveState() == true)
+	{
+		if (_particle->GetIgnitedState() == true)
+		{
+			m_pVertices[_particle->GetParticleID()].color = d3dxColors::Red;
+		}
+		else
+		{
+			m_pVertices[_particle->GetParticleID()].color = d3dxColors::White;
+		}
+	}
+
+	// Detach all particles that were tethered to the released hook
+	int hookIndex = (int)_particle->GetParticleID();
+	std::vector<int> detached;
+	for (int i = 0; i < m_particleCount; i++)
+	{
+		if (m_tetherHooks[i] == hookIndex)
+		{
+			m_tetherHooks[i] = -1;
+			m_tetherLengths[i] = FLT_MAX;
+			detached.push_back(i);
+		}
+	}
+
+	// Grow the remaining hooks tethers back into the detached region from its border
+	std::vector<int> seeds;
+	for (int i = 0; i < (int)detached.size(); i++)
+	{
+		for (int j = m_tetherNeighbourStart[detached[i]]; j < m_tetherNeighbourStart[detached[i] + 1]; j++)
+		{
+			if (m_tetherHooks[m_tetherNeighbours[j]] != -1)
+			{
+				seeds.push_back(m_tetherNeighbours[j]);
+			}
+		}
+	}
+	PropagateTethers(seeds);
 }
 
 bool Physics_Cloth::ResetCloth()
@@ -279,7 +634,16 @@ bool Physics_Cloth::ResetCloth()
 
 	if (m_initialisedParticles == false)
 	{
-		ReleasePtr(m_pMesh);
+		// The mesh owns the vertices and indices when there is one
+		if (m_pMesh != 0)
+		{
+			ReleasePtr(m_pMesh);
+		}
+		else
+		{
+			ReleasePtrArray(m_pVertices);
+			ReleasePtrArray(m_pIndices);
+		}
 		ReleasePtrArray(m_pParticles);
 
 		// Create memory for all the particles
@@ -299,6 +663,17 @@ bool Physics_Cloth::ResetCloth()
 		// Create the indices buffer with the amount of calculated constraints
 		m_indexCount = (immediateConstraintCount + secondaryConstraintCount) * 2;
 		m_pIndices = new DWORD[m_indexCount];
+
+		// Create storage for the iterates used by the Chebyshev acceleration
+		m_iteratePrevious.assign(m_particleCount, v3float());
+		m_iterateCurrent.assign(m_particleCount, v3float());
+
+		// Create storage for the forces repeated over each substep
+		m_substepAccelerations.assign(m_particleCount, v3float());
+
+		// Create the untethered storage for the long range attachments
+		m_tetherHooks.assign(m_particleCount, -1);
+		m_tetherLengths.assign(m_particleCount, FLT_MAX);
 	}
 	
 	// Cycle through all the particles
@@ -317,7 +692,7 @@ bool Physics_Cloth::ResetCloth()
 			{
 				// First time. Initialise			
 				m_pVertices[index] = { { pos.x, pos.y, pos.z }, d3dxColors::White };
-				VALIDATE(m_pParticles[index].Initialise(index, &m_pVertices[index], pos, m_timeStep, m_damping));
+				VALIDATE(m_pParticles[index].Initialise(index, &m_pVertices[index], pos, m_timeStep / m_substeps, m_damping));
 			}
 			else
 			{
@@ -418,11 +793,24 @@ bool Physics_Cloth::ResetCloth()
 		}
 	}
 	
+	// Prepare the implicit solver for the new constraints
+	if (m_pImplicitSolver == 0)
+	{
+		m_pImplicitSolver = new Physics_ImplicitSolver();
+	}
+	VALIDATE(m_pImplicitSolver->Initialise(m_pParticles, m_particleCount, &m_contraints, m_timeStep / m_substeps));
+
 	if (m_initialisedParticles == false)
 	{
-		// Create a new Cloth Mesh
-		m_pMesh = new DX10_Mesh();
-		VALIDATE(m_pMesh->InitialiseCloth(m_pRenderer, m_pVertices, m_pIndices, m_particleCount, m_indexCount, sizeof(TVertexColor), D3D10_PRIMITIVE_TOPOLOGY_LINELIST, D3D10_USAGE_DYNAMIC, D3D10_USAGE_DYNAMIC));
+		// Build the triangle hierarchy over the new particles
+		VALIDATE(BuildBVH());
+
+		if (m_pRenderer != 0)
+		{
+			// Create a new Cloth Mesh
+			m_pMesh = new DX10_Mesh();
+			VALIDATE(m_pMesh->InitialiseCloth(m_pRenderer, m_pVertices, m_pIndices, m_particleCount, m_indexCount, D3D10_PRIMITIVE_TOPOLOGY_LINELIST, D3D10_USAGE_DYNAMIC, D3D10_USAGE_DYNAMIC));
+		}
 	}
 
 	// Create the hooks and pin the cloth
@@ -483,6 +871,9 @@ void Physics_Cloth::ResizeHooks(float _ratio)
 
 void Physics_Cloth::CreateHooks()
 {
+	// Tethers are measured along the constraints of the cloth at rest
+	BuildTetherGraph();
+
 	// Move the particles closer together make it look more like a curtain
 	for (int i = 0; i < (m_particlesWidthCount - 1) / 2; i++)
 	{
@@ -528,6 +919,32 @@ void Physics_Cloth::FloorCollision(float _floorPos)
 			// Push the particles up if they are under the floor
 			float line = abs(m_pParticles[i].GetPosition()->y - (_floorPos));
 			m_pParticles[i].SetPosition(*m_pParticles[i].GetPosition() + (up * line), true);
+			PROFILE_COUNT("Cloth.CollisionsResolved", 1);
+		}
+	}
+}
+
+void Physics_Cloth::HeightfieldCollision()
+{
+	// Cycle through all particles
+	for (int i = 0; i < m_particleCount; i++)
+	{
+		float height;
+		v3float normal;
+		v3float* pPosition = m_pParticles[i].GetPosition();
+		if (m_pHeightfield->Sample(pPosition->x, pPosition->z, height, normal) == false)
+		{
+			// Particle is not above the terrain
+			continue;
+		}
+
+		// Check if the particle is below the terrain
+		if (pPosition->y < height)
+		{
+			// Push the particle out along the terrain normal so it ends up back on the surface
+			float depth = (height - pPosition->y) * normal.y;
+			m_pParticles[i].SetPosition(*pPosition + (normal * depth), true);
+			PROFILE_COUNT("Cloth.CollisionsResolved", 1);
 		}
 	}
 }
@@ -546,6 +963,7 @@ void Physics_Cloth::SphereCollision(v3float _center, float _sphereRadius)
 		{
 			// The particle is in the sphere. Push it out using the shortest path possible
 			m_pParticles[i].Move(line.Normalise() * (_sphereRadius - distanceApart));
+			PROFILE_COUNT("Cloth.CollisionsResolved", 1);
 		}
 	}
 }
@@ -559,7 +977,7 @@ void  Physics_Cloth::CapsuleCollision(v3float _sphereCentre1, v3float _sphereCen
 
 		// Calculate the line within the capsule (sphere centre to sphere centre)
 		v3float capsuleLine = _sphereCentre2 - _sphereCentre1;
-		float capsuleLineLengthSq = pow(capsuleLine.Magnitude(), 2.0f);
+		float capsuleLineLengthSq = capsuleLine.Dot(capsuleLine);
 
 		// Calculate the line between the capsule and particle and project that onto the capsule line
 		v3float capsuleToParticle = particlePos - _sphereCentre1;
@@ -588,84 +1006,182 @@ void  Physics_Cloth::CapsuleCollision(v3float _sphereCentre1, v3float _sphereCen
 
 void Physics_Cloth::PyramidCollision(v3float _pyraPointA, v3float _pyraPointB, v3float _pyraPointC, v3float _pyraPointD)
 {
+	// Pack the four faces of the pyramid once so each particle tests them all together
+	TTrianglePacket faces;
+	faces.Set(0, _pyraPointA, _pyraPointB, _pyraPointC);
+	faces.Set(1, _pyraPointA, _pyraPointC, _pyraPointD);
+	faces.Set(2, _pyraPointA, _pyraPointD, _pyraPointB);
+	faces.Set(3, _pyraPointB, _pyraPointD, _pyraPointC);
+
 	// Cycle through all particles
 	for (int i = 0; i < m_particleCount; i++)
 	{
 		v3float particlePos = *m_pParticles[i].GetPosition();
 
-		// Starts the closest point as the position of the particle and the closest distance to infinity
-		v3float closestPt = particlePos;
-		float closestDist = FLT_MAX;
+		// Calculate the closest point over all four faces
+		v3float closestPt;
+		float closestDistSq = NearestPointOnTriangles(particlePos, faces, closestPt);
 
-		// Declare extra variables
-		v3float closestTriPoint;
-		float dist;
+		// If the point is outside all planes then the point is within the bounds of the pyramid
+		if (PointOutsideOfPlanes(particlePos, faces) == 0xF)
+		{
+			// Move the particle outside the pyramid using the closest point 
+			closestPt = closestPt + ((closestPt - particlePos).Normalise() * COLLIDER_PYRAMID_MARGIN);
+			m_pParticles[i].SetPosition(closestPt, true);
+			PROFILE_COUNT("Cloth.CollisionsResolved", 1);
+		}
+		else if (closestDistSq < COLLIDER_PYRAMID_MARGIN * COLLIDER_PYRAMID_MARGIN)
+		{
+			// Particle is not inside the pyramid but is too close to it. Move the particle a small distance from the pyramid
+			closestPt = closestPt + ((particlePos - closestPt).Normalise() * COLLIDER_PYRAMID_MARGIN);
+			m_pParticles[i].SetPosition(closestPt, true);
+			PROFILE_COUNT("Cloth.CollisionsResolved", 1);
+		}
+	}
+}
 
-		// Calculate the closest point on the first triangle and compare
-		closestTriPoint = ClosestPointOnTriangle(particlePos, _pyraPointA, _pyraPointB, _pyraPointC);
-		dist = pow((particlePos - closestTriPoint).Magnitude(), 2);
-		if (dist < closestDist)
+void Physics_Cloth::SweptSphereCollision(v3float _center, float _sphereRadius)
+{
+	float time;
+	v3float normal;
+
+	// Cycle through all the particles
+	for (int i = 0; i < m_particleCount; i++)
+	{
+		// Sweep the movement of the particle this step against the sphere
+		if (SegmentSphereFirstHit(*m_pParticles[i].GetPreviousPosition(), *m_pParticles[i].GetPosition(), _center, _sphereRadius, time, normal) == true)
 		{
-			// Save the new closest point and distance
-			closestDist = dist;
-			closestPt = closestTriPoint;
+			ResolveSweptHit(&m_pParticles[i], time, normal);
 		}
+	}
+}
+
+void Physics_Cloth::SweptCapsuleCollision(v3float _sphereCentre1, v3float _sphereCentre2, float _capsuleRadius)
+{
+	float time;
+	v3float normal;
 
-		// Calculate the closest point on the second triangle and compare
-		closestTriPoint = ClosestPointOnTriangle(particlePos, _pyraPointA, _pyraPointC, _pyraPointD);
-		dist = pow((particlePos - closestTriPoint).Magnitude(), 2);
-		if (dist < closestDist)
+	// Cycle through all the particles
+	for (int i = 0; i < m_particleCount; i++)
+	{
+		// Sweep the movement of the particle this step against the capsule
+		if (SegmentCapsuleFirstHit(*m_pParticles[i].GetPreviousPosition(), *m_pParticles[i].GetPosition(), _sphereCentre1, _sphereCentre2, _capsuleRadius, time, normal) == true)
 		{
-			// Save the new closest point and distance
-			closestDist = dist;
-			closestPt = closestTriPoint;
+			ResolveSweptHit(&m_pParticles[i], time, normal);
 		}
+	}
+}
+
+void Physics_Cloth::SweptPyramidCollision(v3float _pyraPointA, v3float _pyraPointB, v3float _pyraPointC, v3float _pyraPointD)
+{
+	float time;
+	v3float normal;
 
-		// Calculate the closest point on the third triangle and compare
-		closestTriPoint = ClosestPointOnTriangle(particlePos, _pyraPointA, _pyraPointD, _pyraPointB);
-		dist = pow((particlePos - closestTriPoint).Magnitude(), 2);
-		if (dist < closestDist)
+	// Cycle through all the particles
+	for (int i = 0; i < m_particleCount; i++)
+	{
+		// Sweep the movement of the particle this step against the pyramid grown by the same distance the pyramid collision keeps particles away
+		if (SegmentTetrahedronFirstHit(*m_pParticles[i].GetPreviousPosition(), *m_pParticles[i].GetPosition(), _pyraPointA, _pyraPointB, _pyraPointC, _pyraPointD, COLLIDER_PYRAMID_MARGIN, time, normal) == true)
 		{
-			// Save the new closest point and distance
-			closestDist = dist;
-			closestPt = closestTriPoint;
+			ResolveSweptHit(&m_pParticles[i], time, normal);
 		}
+	}
+}
+
+void Physics_Cloth::ResolveSweptHit(Physics_Particle* _pParticle, float _time, v3float _normal)
+{
+	v3float start = *_pParticle->GetPreviousPosition();
+	v3float end = *_pParticle->GetPosition();
+
+	// Stop slightly outside the surface so the particle is not seen as inside it
+	v3float contact = start + ((end - start) * _time) + (_normal * 0.01f);
+
+	// Keep the rest of the movement along the surface but remove any movement into it
+	v3float remaining = end - contact;
+	float intoSurface = remaining.Dot(_normal);
+	if (intoSurface < 0.0f)
+	{
+		remaining = remaining - (_normal * intoSurface);
+	}
+
+	_pParticle->Move((contact + remaining) - end);
+	PROFILE_COUNT("Cloth.CollisionsResolved", 1);
+}
+
+void Physics_Cloth::SetQuality(TClothQuality _quality)
+{
+	// The iteration count is the fixed count and the limit of the adaptive iterations
+	m_constraintIterations = max(_quality.ConstraintIterations, 1);
+	m_maxConstraintIterations = m_constraintIterations;
+	m_minConstraintIterations = min(m_minConstraintIterations, m_maxConstraintIterations);
+
+	m_selfCollisionInterval = max(_quality.SelfCollisionInterval, 1);
+	m_sleepVelocity = max(_quality.SleepVelocity, 0.0f);
 
-		// Calculate the closest point on the fourth triangle and compare
-		closestTriPoint = ClosestPointOnTriangle(particlePos, _pyraPointB, _pyraPointD, _pyraPointC);
-		dist = pow((particlePos - closestTriPoint).Magnitude(), 2);
-		if (dist < closestDist)
+	int substeps = max(_quality.Substeps, 1);
+	if (substeps != m_substeps)
+	{
+		// Split the time step evenly over the substeps
+		m_substeps = substeps;
+		float substepTime = m_timeStep / m_substeps;
+		for (int i = 0; i < m_particleCount; i++)
 		{
-			// Save the new closest point and distance
-			closestDist = dist;
-			closestPt = closestTriPoint;
+			m_pParticles[i].SetTimeStep(substepTime);
 		}
+		m_pImplicitSolver->SetTimeStep(substepTime);
+	}
+}
 
-		// If the point is outside all planes then the point is within the bounds of the pyramid
-		if (	(PointOutsideOfPlane(particlePos, _pyraPointA, _pyraPointB, _pyraPointC) == true)
-			&&	(PointOutsideOfPlane(particlePos, _pyraPointA, _pyraPointC, _pyraPointD) == true)
-			&&	(PointOutsideOfPlane(particlePos, _pyraPointA, _pyraPointD, _pyraPointB) == true)
-			&&	(PointOutsideOfPlane(particlePos, _pyraPointB, _pyraPointD, _pyraPointC) == true))
+TClothQuality Physics_Cloth::GetQuality()
+{
+	TClothQuality quality;
+	quality.ConstraintIterations = (m_adaptiveIterations == true) ? m_maxConstraintIterations : m_constraintIterations;
+	quality.Substeps = m_substeps;
+	quality.SelfCollisionInterval = m_selfCollisionInterval;
+	quality.SleepVelocity = m_sleepVelocity;
+
+	return quality;
+}
+
+void Physics_Cloth::UpdateSleepState()
+{
+	// Find the largest movement of any free particle over the last substep
+	float maxMovementSq = 0.0f;
+	for (int i = 0; i < m_particleCount; i++)
+	{
+		if (m_pParticles[i].GetActiveState() == false)
 		{
-			// Move the particle outside the pyramid using the closest point 
-			closestPt = closestPt + ((closestPt - particlePos).Normalise() * 0.5f);
-			m_pParticles[i].SetPosition(closestPt, true);
+			continue;
 		}
-		else
+
+		if (m_pParticles[i].GetIgnitedState() == true)
 		{
-			// Particle is not inside the pyramid
-			v3float diff = particlePos - closestPt;
-			dist = diff.Magnitude();
-			
-			// check if the particle is too close to the pyramid
-			if (dist < 0.5f)
-			{
-				// Move the particle a small distance from the pyramid
-				closestPt = closestPt + ((particlePos - closestPt).Normalise() * 0.5f);
-				m_pParticles[i].SetPosition(closestPt, true);
-			}
+			// A burning cloth is never at rest
+			m_stillFrames = 0;
+			return;
+		}
+
+		if (m_pParticles[i].GetStaticState() == false)
+		{
+			v3float movement = *m_pParticles[i].GetPosition() - *m_pParticles[i].GetPreviousPosition();
+			maxMovementSq = max(maxMovementSq, movement.Dot(movement));
+		}
+	}
+
+	// Sleep once the cloth has stayed slower than the sleep velocity for enough frames in a row
+	float sleepMovement = m_sleepVelocity * (m_timeStep / m_substeps);
+	if (maxMovementSq < sleepMovement * sleepMovement)
+	{
+		m_stillFrames++;
+		if (m_stillFrames >= m_sleepFrames)
+		{
+			m_sleeping = true;
 		}
 	}
+	else
+	{
+		m_stillFrames = 0;
+	}
 }
 
 void Physics_Cloth::UpdateWindSpeed(float _ratio)
@@ -676,6 +1192,9 @@ void Physics_Cloth::UpdateWindSpeed(float _ratio)
 
 void Physics_Cloth::Ignite(TCameraRay _camRay, float _selectRadius)
 {
+	// Changes made by the user disturb a resting cloth
+	Wake();
+
 	// Select the particles that intersect with the ray
 	SelectParticles(_camRay, _selectRadius);
 
@@ -689,6 +1208,9 @@ void Physics_Cloth::Ignite(TCameraRay _camRay, float _selectRadius)
 
 void Physics_Cloth::Cut(TCameraRay _camRay, float _selectRadius)
 {
+	// Changes made by the user disturb a resting cloth
+	Wake();
+
 	// Select the particles that intersect with the ray
 	SelectParticles(_camRay, _selectRadius);
 
@@ -702,6 +1224,9 @@ void Physics_Cloth::Cut(TCameraRay _camRay, float _selectRadius)
 
 void Physics_Cloth::Manipulate(TCameraRay _camRay, float _selectRadius, bool _firstCast)
 {
+	// Changes made by the user disturb a resting cloth
+	Wake();
+
 	// Check if this is the first cast
 	if (_firstCast == true)
 	{
@@ -731,70 +1256,80 @@ void Physics_Cloth::SelectParticles(TCameraRay _camRay, float _selectRadius)
 	// Release all selected particles before selecting new ones
 	ReleaseSelected();
 
-	// Cycle through all particles
+	// Each particles world matrix is the cloths world matrix followed by a translation to the particle.
+	// Its inverse undoes the translation then applies the inverse of the cloths world matrix, which is the same for every particle
+	m4simd invWorldMatrix;
+	if (MatrixInverseAffine(m4simd(m_matWorld), invWorldMatrix) == false)
+	{
+		// A collapsed world matrix has nothing to select
+		return;
+	}
+
+	// The translation does not move a direction, so the transformed ray direction is shared by every particle
+	v3float rayDirection = Normalised(TransformNormal(invWorldMatrix, v4simd(_camRay.Direction)), NA_EXACT).ToV3float();
+	v4simd rayOrigin(_camRay.Origin);
+
+	// Cycle through all particles, testing the rays of four particles at once
+	v3float particleOrigins[4];
 	for (int i = 0; i < m_particleCount; i++)
 	{
-		 // Calculate the world matrix for the current particle
-		D3DXMATRIX particleWorldMatrix;
-		D3DXMatrixTranslation(&particleWorldMatrix, m_pParticles[i].GetPosition()->x, m_pParticles[i].GetPosition()->y, m_pParticles[i].GetPosition()->z);
-		D3DXMatrixMultiply(&particleWorldMatrix, &m_matWorld, &particleWorldMatrix);
-
-		// Calculate the inverse of the particles world matrix
-		D3DXMATRIX invWorldMatrix;
-		D3DXMatrixInverse(&invWorldMatrix, NULL, &particleWorldMatrix);
-
-		// Convert the camRay variables into D3DXVECTOR3
-		D3DXVECTOR3 rayOrigin = { _camRay.Origin.x, _camRay.Origin.y, _camRay.Origin.z };
-		D3DXVECTOR3 rayDirection = { _camRay.Direction.x, _camRay.Direction.y, _camRay.Direction.z };
-
-		// Transform the ray by the inverse world matrix
-		D3DXVec3TransformCoord(&rayOrigin, &rayOrigin, &invWorldMatrix);
-		D3DXVec3TransformNormal(&rayDirection, &rayDirection, &invWorldMatrix);
-
-		// Convert the D3DXVECTOR3 back into a camera ray struct
-		TCameraRay TransformedRay({ rayOrigin.x, rayOrigin.y, rayOrigin.z }, { rayDirection.x, rayDirection.y, rayDirection.z });
-		TransformedRay.Direction.Normalise();
-
-		// Test particle with the transformed ray
-		bool intersect = TransformedRay.RaySphereIntersect(_selectRadius);
-
-		// Check if the particle intersected
-		if (intersect == true)
-		{
-			// Set the select state for the particle to true and push it onto the vector
-			m_pParticles[i].SetSelectedState(true);
-			m_selectedParticles.push_back(&m_pParticles[i]);
-		}
-
-		//// Calculate the world matrix for the current particle
-		//D3DXMATRIX translationMatrix;
-		//D3DXMATRIX transWorldMatrix;
-		//D3DXMatrixTranslation(&translationMatrix, m_pParticles[i].GetPosition()->x, m_pParticles[i].GetPosition()->y, m_pParticles[i].GetPosition()->z);
-		//D3DXMatrixMultiply(&transWorldMatrix, &m_matWorld, &translationMatrix);
-		//
-		//// Get the Inverse of the Translated World Matrix
-		//D3DXMATRIX invWorldMatrix;
-		//D3DXMatrixInverse(&invWorldMatrix, NULL, &transWorldMatrix);
-		//
-		//// Transform the Ray Origin and the Ray Direction from View Space to World Space
-		//D3DXVECTOR3 Origin = { _camRay.Origin.x, _camRay.Origin.y, _camRay.Origin.z };
-		//D3DXVECTOR3 Direction = { _camRay.Direction.x, _camRay.Direction.y, _camRay.Direction.z };
-		//D3DXVECTOR3  tmpRayDirection, tmpRayOrigin;
-		//D3DXVec3TransformCoord(&tmpRayOrigin, &Origin, &invWorldMatrix);
-		//D3DXVec3TransformNormal(&tmpRayDirection, &Direction, &invWorldMatrix);
-		//TCameraRay TransformedRay({ tmpRayOrigin.x, tmpRayOrigin.y, tmpRayOrigin.z }, { tmpRayDirection.x, tmpRayDirection.y, tmpRayDirection.z });
-		//TransformedRay.Direction.Normalise();
-		//
-		//// Test each 
-		//bool intersect = TransformedRay.RaySphereIntersect(_selectRadius);
-		//
-		//// Check if the particle intersected
-		//if (intersect == true)
-		//{
-		//	// Set the select state for the particle to true and push it onto the vector
-		//	m_pParticles[i].SetSelectedState(true);
-		//	m_selectedParticles.push_back(&m_pParticles[i]);
-		//}
+		// Transform the ray origin by the inverse of the particles world matrix
+		int lane = i % 4;
+		particleOrigins[lane] = TransformCoord(invWorldMatrix, rayOrigin - v4simd(*m_pParticles[i].GetPosition())).ToV3float();
+		if (lane != 3 && i != m_particleCount - 1)
+		{
+			continue;
+		}
+
+		// Repeat the last origin in any unused lanes
+		for (int unused = lane + 1; unused < 4; unused++)
+		{
+			particleOrigins[unused] = particleOrigins[lane];
+		}
+
+		// Test the particles with the transformed rays
+		int intersectMask = RaySpheresIntersect(particleOrigins, rayDirection, _selectRadius);
+		for (int hit = 0; hit <= lane; hit++)
+		{
+			// Check if the particle intersected
+			if ((intersectMask & (1 << hit)) != 0)
+			{
+				// Set the select state for the particle to true and push it onto the vector
+				Physics_Particle* pParticle = &m_pParticles[i - lane + hit];
+				pParticle->SetSelectedState(true);
+				m_selectedParticles.push_back(pParticle);
+			}
+		}
+	}
+
+	if (m_selectedParticles.empty() == true && m_pBVH != 0)
+	{
+		// The ray passed between the particles, so pick the surface instead. Bring the hierarchy up to the current positions first
+		m_pBVH->Refit();
+		v3float localOrigin = TransformCoord(invWorldMatrix, rayOrigin).ToV3float();
+		float distance;
+		int triangleIndex = m_pBVH->Raycast(localOrigin, rayDirection, distance);
+		if (triangleIndex >= 0 && TriangleActive(m_pBVH->GetTriangle(triangleIndex)) == true)
+		{
+			// Select the corner of the triangle nearest to where the ray hit it
+			TBVHTriangle* pTriangle = m_pBVH->GetTriangle(triangleIndex);
+			v3float hitPoint = localOrigin + (rayDirection * distance);
+			Physics_Particle* pNearest = 0;
+			float nearestDistSq = FLT_MAX;
+			for (int corner = 0; corner < 3; corner++)
+			{
+				Physics_Particle* pParticle = &m_pParticles[pTriangle->Indices[corner]];
+				v3float toHit = hitPoint - *pParticle->GetPosition();
+				float distSq = toHit.Dot(toHit);
+				if (distSq < nearestDistSq)
+				{
+					nearestDistSq = distSq;
+					pNearest = pParticle;
+				}
+			}
+			pNearest->SetSelectedState(true);
+			m_selectedParticles.push_back(pNearest);
+		}
 	}
 }
 
@@ -822,6 +1357,7 @@ bool Physics_Cloth::MakeConstraint(int _particleIndexA, int _particleIndexB, boo
 	// Add indices to the index array to draw them
 	m_pIndices[m_nextIndex++] = _particleIndexA;
 	m_pIndices[m_nextIndex++] = _particleIndexB;
+	m_indicesVersion++;
 	return true;
 }
 
@@ -878,8 +1414,8 @@ void Physics_Cloth::IgniteConnectedConstraints(Physics_Particle* _pParticle)
 		// Ensure the particle has not already been ignited
 		if (_pParticle->GetIgnitedState() == false)
 		{
-			// Calculate a variable burn time for each particle individually
-			float modifier = 1 + (float)((rand() % 80) - 40) / 100.0f;
+			// Calculate a variable burn time for each particle individually. Drawn by particle index so the order of ignition does not change it
+			float modifier = RandomRange(GetRandomSeed(), RS_BURN, (UINT64)(_pParticle - m_pParticles), 0.6f, 1.4f);
 			float modifiedBurnTime = m_burnTime * modifier;
 
 			// Ignite the Particle
@@ -900,50 +1436,527 @@ void Physics_Cloth::IgniteConnectedConstraints(Physics_Particle* _pParticle)
 	}
 }
 
+void Physics_Cloth::EmitBurnEffect(int _emitter, v3float _localPos, int _count)
+{
+	if (m_pEffects == 0)
+	{
+		// No effects to spawn into
+		return;
+	}
+
+	// The effects are simulated in world space
+	v3float worldPos = TransformCoord(m4simd(m_matWorld), v4simd(_localPos)).ToV3float();
+	m_pEffects->Emit(_emitter, worldPos, _count);
+}
+
 void Physics_Cloth::CollisionsWithSelf()
 {
+	// Update the hierarchy to the current particle positions
+	m_pBVH->Refit();
+
+	// Stop particles passing through faces and edges passing through edges
+	PointTriangleCollisions(this);
+	EdgeEdgeCollisions(this);
+}
+
+void Physics_Cloth::CollisionsWithCloth(Physics_Cloth* _pOther)
+{
+	if (_pOther == 0 || _pOther == this || m_pBVH == 0 || _pOther->m_pBVH == 0)
+	{
+		// No valid cloth to collide with
+		return;
+	}
+
+	if (m_sleeping == true && _pOther->m_sleeping == true)
+	{
+		// Neither cloth is moving so there can be no new collisions
+		return;
+	}
+	Wake();
+	_pOther->Wake();
+
+	// Update both hierarchies to the current particle positions
+	m_pBVH->Refit();
+	_pOther->m_pBVH->Refit();
+
+	// Collide the particles of each cloth with the faces of the other
+	PointTriangleCollisions(_pOther);
+	_pOther->PointTriangleCollisions(this);
+
+	// Edge pairs are symmetric so only need to be collided once
+	EdgeEdgeCollisions(_pOther);
+}
+
+bool Physics_Cloth::BuildBVH()
+{
+	std::vector<TBVHTriangle> triangles;
+	triangles.reserve((m_particlesWidthCount - 1) * (m_particlesHeightCount - 1) * 2);
+
+	// Split each grid square into two triangles with the same winding as the wind calculation
+	for (int col = 0; col < m_particlesWidthCount - 1; col++)
+	{
+		for (int row = 0; row < m_particlesHeightCount - 1; row++)
+		{
+			TBVHTriangle triangle;
+
+			// Lower triangle owns its left edge, and its bottom edge on the last row
+			triangle.Indices[0] = GetParticleIndex(col + 1, row + 1);
+			triangle.Indices[1] = GetParticleIndex(col, row + 1);
+			triangle.Indices[2] = GetParticleIndex(col, row);
+			triangle.OwnedEdges = (1 << 1);
+			if (row == m_particlesHeightCount - 2)
+			{
+				triangle.OwnedEdges |= (1 << 0);
+			}
+			triangles.push_back(triangle);
+
+			// Upper triangle owns its top edge and the diagonal, and its right edge on the last column
+			triangle.Indices[0] = GetParticleIndex(col, row);
+			triangle.Indices[1] = GetParticleIndex(col + 1, row);
+			triangle.Indices[2] = GetParticleIndex(col + 1, row + 1);
+			triangle.OwnedEdges = (1 << 0) | (1 << 2);
+			if (col == m_particlesWidthCount - 2)
+			{
+				triangle.OwnedEdges |= (1 << 1);
+			}
+			triangles.push_back(triangle);
+		}
+	}
+
+	// Create the hierarchy over the triangles
+	ReleasePtr(m_pBVH);
+	m_pBVH = new Physics_BVH();
+	VALIDATE(m_pBVH->Initialise(m_pParticles, triangles, m_selfCollisionRad));
+
+	return true;
+}
+
+void Physics_Cloth::PointTriangleCollisions(Physics_Cloth* _pTarget)
+{
+	Physics_BVH* pTargetBVH = _pTarget->m_pBVH;
+	Physics_Particle* pTargetParticles = pTargetBVH->GetParticles();
+	float thickness = pTargetBVH->GetThickness();
+	bool self = (_pTarget == this);
+
 	// Cycle through all particles
 	for (int i = 0; i < m_particleCount; i++)
 	{
-		if (m_pParticles[i].GetActiveState() == true)
+		Physics_Particle* pParticle = &m_pParticles[i];
+		if (pParticle->GetActiveState() == false)
 		{
-			// Cycle through all particles that are after the i'th particle
-			for (int j = i + 1; j < m_particleCount; j++)
+			continue;
+		}
+
+		// Find all triangles within the thickness of the particle
+		TAABB pointBox;
+		pointBox.Min = pointBox.Max = *pParticle->GetPosition();
+		pTargetBVH->Query(pointBox, m_collisionTriangles);
+
+		// Test the candidate triangles four at a time
+		UINT candidate = 0;
+		while (candidate < m_collisionTriangles.size())
+		{
+			TBVHTriangle* pPacket[4];
+			TTrianglePacket tris;
+			int lanes = 0;
+			while (lanes < 4 && candidate < m_collisionTriangles.size())
 			{
-				if (m_pParticles[j].GetActiveState() == true)
+				TBVHTriangle* pTriangle = pTargetBVH->GetTriangle(m_collisionTriangles[candidate++]);
+
+				// A particle can not collide with a triangle it is part of
+				if (self == true && (pTriangle->Indices[0] == (UINT)i || pTriangle->Indices[1] == (UINT)i || pTriangle->Indices[2] == (UINT)i))
+				{
+					continue;
+				}
+
+				if (_pTarget->TriangleActive(pTriangle) == false)
 				{
-					// Calculate the line between the particles
-					v3float line = *m_pParticles[j].GetPosition() - *m_pParticles[i].GetPosition();
-					float distanceApart = line.Magnitude();
+					continue;
+				}
+
+				pPacket[lanes] = pTriangle;
+				tris.Set(lanes, *pTargetParticles[pTriangle->Indices[0]].GetPosition(), *pTargetParticles[pTriangle->Indices[1]].GetPosition(), *pTargetParticles[pTriangle->Indices[2]].GetPosition());
+				lanes++;
+			}
 
-					// Check if the distance apart is less than the self collision radius
-					if (distanceApart < m_selfCollisionRad)
+			if (lanes == 0)
+			{
+				break;
+			}
+			tris.Pad(lanes);
+
+			// Calculate the closest point on every triangle of the packet at once
+			__m128 closestX;
+			__m128 closestY;
+			__m128 closestZ;
+			ClosestPointOnTriangles(*pParticle->GetPosition(), tris, closestX, closestY, closestZ);
+			SIMD_ALIGN float packetX[4];
+			SIMD_ALIGN float packetY[4];
+			SIMD_ALIGN float packetZ[4];
+			_mm_store_ps(packetX, closestX);
+			_mm_store_ps(packetY, closestY);
+			_mm_store_ps(packetZ, closestZ);
+
+			bool moved = false;
+			for (int lane = 0; lane < lanes; lane++)
+			{
+				TBVHTriangle* pTriangle = pPacket[lane];
+				Physics_Particle* pTriParticleA = &pTargetParticles[pTriangle->Indices[0]];
+				Physics_Particle* pTriParticleB = &pTargetParticles[pTriangle->Indices[1]];
+				Physics_Particle* pTriParticleC = &pTargetParticles[pTriangle->Indices[2]];
+
+				// Once a collision has moved particles the packet is stale so the rest of it is recalculated one at a time
+				v3float closestPoint;
+				if (moved == false)
+				{
+					closestPoint = v3float(packetX[lane], packetY[lane], packetZ[lane]);
+				}
+				else
+				{
+					closestPoint = ClosestPointOnTriangle(*pParticle->GetPosition(), *pTriParticleA->GetPosition(), *pTriParticleB->GetPosition(), *pTriParticleC->GetPosition());
+				}
+
+				// Calculate the line between the particle and the closest point on the triangle
+				v3float line = *pParticle->GetPosition() - closestPoint;
+				float distanceApart = line.Magnitude();
+
+				// Check if the particle is within the thickness of the triangle
+				if (distanceApart < thickness)
+				{
+					// Push out along the line, or the face normal if the particle is on the triangle
+					v3float direction;
+					if (distanceApart > 0.0001f)
+					{
+						direction = line / distanceApart;
+					}
+					else
 					{
-						// Push the Particles apart with equal force in opposite directions
-						m_pParticles[j].Move((line.Normalise() * (m_selfCollisionRad - distanceApart)) / 2.0f);
-						m_pParticles[i].Move((line.Normalise() * (m_selfCollisionRad - distanceApart)) / -2.0f);
+						direction = CalcTriangleNormal(pTriParticleA, pTriParticleB, pTriParticleC).Normalise();
+					}
 
-						if (distanceApart < 0.6f)
+					// Push the particle and the triangle apart with equal force in opposite directions
+					v3float correction = direction * ((thickness - distanceApart) / 2.0f);
+					pParticle->Move(correction);
+					pTriParticleA->Move(-correction);
+					pTriParticleB->Move(-correction);
+					pTriParticleC->Move(-correction);
+					moved = true;
+					PROFILE_COUNT("Cloth.CollisionsResolved", 1);
+
+					// Spread fire between touching parts of the cloth
+					if (pParticle->GetIgnitedState() == true)
+					{
+						_pTarget->IgniteConnectedConstraints(pTriParticleA);
+						_pTarget->IgniteConnectedConstraints(pTriParticleB);
+						_pTarget->IgniteConnectedConstraints(pTriParticleC);
+					}
+					else if (pTriParticleA->GetIgnitedState() == true || pTriParticleB->GetIgnitedState() == true || pTriParticleC->GetIgnitedState() == true)
+					{
+						IgniteConnectedConstraints(pParticle);
+					}
+				}
+			}
+		}
+	}
+}
+
+void Physics_Cloth::EdgeEdgeCollisions(Physics_Cloth* _pTarget)
+{
+	Physics_BVH* pTargetBVH = _pTarget->m_pBVH;
+	Physics_Particle* pTargetParticles = pTargetBVH->GetParticles();
+	float thickness = pTargetBVH->GetThickness();
+	bool self = (_pTarget == this);
+
+	// Cycle through every edge of the cloth once using the edges each triangle owns
+	for (UINT triA = 0; triA < m_pBVH->GetTriangleCount(); triA++)
+	{
+		TBVHTriangle* pTriangleA = m_pBVH->GetTriangle(triA);
+		if (TriangleActive(pTriangleA) == false)
+		{
+			continue;
+		}
+
+		for (UINT edgeA = 0; edgeA < 3; edgeA++)
+		{
+			if ((pTriangleA->OwnedEdges & (1 << edgeA)) == 0)
+			{
+				continue;
+			}
+
+			UINT indexA0 = pTriangleA->Indices[edgeA];
+			UINT indexA1 = pTriangleA->Indices[(edgeA + 1) % 3];
+			Physics_Particle* pParticleA0 = &m_pParticles[indexA0];
+			Physics_Particle* pParticleA1 = &m_pParticles[indexA1];
+
+			// Find all triangles within the thickness of the edge
+			TAABB edgeBox;
+			edgeBox.Reset();
+			edgeBox.Expand(*pParticleA0->GetPosition());
+			edgeBox.Expand(*pParticleA1->GetPosition());
+			pTargetBVH->Query(edgeBox, m_collisionTriangles);
+
+			for (UINT i = 0; i < m_collisionTriangles.size(); i++)
+			{
+				UINT triB = m_collisionTriangles[i];
+				TBVHTriangle* pTriangleB = pTargetBVH->GetTriangle(triB);
+				if (_pTarget->TriangleActive(pTriangleB) == false)
+				{
+					continue;
+				}
+
+				for (UINT edgeB = 0; edgeB < 3; edgeB++)
+				{
+					if ((pTriangleB->OwnedEdges & (1 << edgeB)) == 0)
+					{
+						continue;
+					}
+
+					UINT indexB0 = pTriangleB->Indices[edgeB];
+					UINT indexB1 = pTriangleB->Indices[(edgeB + 1) % 3];
+
+					if (self == true)
+					{
+						// Only test each pair of edges once and skip edges that share a particle
+						if ((triB * 3 + edgeB) <= (triA * 3 + edgeA)
+							|| indexB0 == indexA0 || indexB0 == indexA1 || indexB1 == indexA0 || indexB1 == indexA1)
 						{
-							if (m_pParticles[j].GetIgnitedState() == true)
-							{
-								IgniteConnectedConstraints(&m_pParticles[i]);
-							}
-
-							if (m_pParticles[i].GetIgnitedState() == true)
-							{
-								IgniteConnectedConstraints(&m_pParticles[j]);
-							}
+							continue;
 						}
 					}
+
+					Physics_Particle* pParticleB0 = &pTargetParticles[indexB0];
+					Physics_Particle* pParticleB1 = &pTargetParticles[indexB1];
+
+					// Calculate the closest points between the two edges
+					v3float closestA;
+					v3float closestB;
+					float distanceApart = ClosestPointsBetweenSegments(*pParticleA0->GetPosition(), *pParticleA1->GetPosition(),
+						*pParticleB0->GetPosition(), *pParticleB1->GetPosition(), closestA, closestB);
+
+					// Check if the edges are within the thickness of each other
+					if (distanceApart < thickness && distanceApart > 0.0001f)
+					{
+						// Push the edges apart with equal force in opposite directions
+						v3float correction = ((closestA - closestB) / distanceApart) * ((thickness - distanceApart) / 2.0f);
+						pParticleA0->Move(correction);
+						pParticleA1->Move(correction);
+						pParticleB0->Move(-correction);
+						pParticleB1->Move(-correction);
+						PROFILE_COUNT("Cloth.CollisionsResolved", 1);
+					}
 				}
 			}
 		}
 	}
 }
 
+void Physics_Cloth::StoreIterate()
+{
+	// Cycle through all the particles
+	for (int i = 0; i < m_particleCount; i++)
+	{
+		m_iteratePrevious[i] = m_iterateCurrent[i];
+		m_iterateCurrent[i] = *m_pParticles[i].GetPosition();
+	}
+}
+
+bool Physics_Cloth::ChebyshevAccelerate(int _iteration, float& _prLastUpdate)
+{
+	// Measure how far the constraint sweep moved the particles
+	float update = 0.0f;
+	for (int i = 0; i < m_particleCount; i++)
+	{
+		v3float movement = *m_pParticles[i].GetPosition() - m_iterateCurrent[i];
+		update += movement.Dot(movement);
+	}
+	update = sqrt(update);
+
+	if (_iteration == 1 && _prLastUpdate > 0.0f)
+	{
+		// The ratio of the first two plain sweeps approximates the spectral radius. Smooth it over time
+		float ratio = min(update / _prLastUpdate, 0.95f);
+		m_spectralRadius = (m_spectralRadius * 0.9f) + (ratio * 0.1f);
+	}
+	else if (_iteration > 1 && update > _prLastUpdate)
+	{
+		// The sweeps are diverging so the estimate is too high. Fall back to plain sweeps for this step
+		m_spectralRadius *= 0.8f;
+		m_chebyshevOmega = 1.0f;
+		_prLastUpdate = update;
+		return false;
+	}
+	_prLastUpdate = update;
+
+	// Calculate the relaxation weight for this iteration
+	float radiusSquared = m_spectralRadius * m_spectralRadius;
+	if (_iteration == 0)
+	{
+		m_chebyshevOmega = 1.0f;
+	}
+	else if (_iteration == 1)
+	{
+		m_chebyshevOmega = 2.0f / (2.0f - radiusSquared);
+	}
+	else
+	{
+		m_chebyshevOmega = 4.0f / (4.0f - radiusSquared * m_chebyshevOmega);
+	}
+
+	if (m_chebyshevOmega != 1.0f)
+	{
+		// Extrapolate each particle from the iterate before last through the current position
+		for (int i = 0; i < m_particleCount; i++)
+		{
+			v3float pos = *m_pParticles[i].GetPosition();
+			v3float accelerated = (pos - m_iteratePrevious[i]) * m_chebyshevOmega + m_iteratePrevious[i];
+			m_pParticles[i].Move(accelerated - pos);
+		}
+	}
+
+	return true;
+}
+
+void Physics_Cloth::CalculateTethers()
+{
+	BuildTetherGraph();
+
+	// Untether every particle
+	m_tetherHooks.assign(m_particleCount, -1);
+	m_tetherLengths.assign(m_particleCount, FLT_MAX);
+
+	// Spread out from all the hooks at once so each particle finds its nearest hook
+	std::vector<int> seeds;
+	for (int i = 0; i < (int)m_hookedParticles.size(); i++)
+	{
+		int hookIndex = (int)m_hookedParticles[i]->GetParticleID();
+		m_tetherHooks[hookIndex] = hookIndex;
+		m_tetherLengths[hookIndex] = 0.0f;
+		seeds.push_back(hookIndex);
+	}
+	PropagateTethers(seeds);
+
+	m_tethersDirty = false;
+}
+
+void Physics_Cloth::BuildTetherGraph()
+{
+	// Count the intact immediate constraints on each particle
+	m_tetherNeighbourStart.assign(m_particleCount + 1, 0);
+	for (int i = 0; i < (int)m_contraints.size(); i++)
+	{
+		Physics_Constraint* pConstraint = &m_contraints[i];
+		if (pConstraint->GetImmediate() == true && pConstraint->GetActiveState() == true)
+		{
+			m_tetherNeighbourStart[pConstraint->GetParticleA()->GetParticleID() + 1]++;
+			m_tetherNeighbourStart[pConstraint->GetParticleB()->GetParticleID() + 1]++;
+		}
+	}
+
+	// Convert the counts into the starting offset of each particles neighbours
+	for (int i = 0; i < m_particleCount; i++)
+	{
+		m_tetherNeighbourStart[i + 1] += m_tetherNeighbourStart[i];
+	}
+
+	// Store the neighbours of each particle with the rest distance to them
+	int edgeCount = m_tetherNeighbourStart[m_particleCount];
+	m_tetherNeighbours.resize(edgeCount);
+	m_tetherNeighbourDistances.resize(edgeCount);
+	std::vector<int> fill(m_tetherNeighbourStart.begin(), m_tetherNeighbourStart.end() - 1);
+	for (int i = 0; i < (int)m_contraints.size(); i++)
+	{
+		Physics_Constraint* pConstraint = &m_contraints[i];
+		if (pConstraint->GetImmediate() == true && pConstraint->GetActiveState() == true)
+		{
+			int indexA = (int)pConstraint->GetParticleA()->GetParticleID();
+			int indexB = (int)pConstraint->GetParticleB()->GetParticleID();
+
+			m_tetherNeighbours[fill[indexA]] = indexB;
+			m_tetherNeighbourDistances[fill[indexA]++] = pConstraint->GetRestDistance();
+			m_tetherNeighbours[fill[indexB]] = indexA;
+			m_tetherNeighbourDistances[fill[indexB]++] = pConstraint->GetRestDistance();
+		}
+	}
+}
+
+void Physics_Cloth::PropagateTethers(std::vector<int>& _seeds)
+{
+	// Dijkstra search from the seeds. Only particles whose distance improves are revisited
+	std::priority_queue<std::pair<float, int>, std::vector<std::pair<float, int>>, std::greater<std::pair<float, int>>> openList;
+	for (int i = 0; i < (int)_seeds.size(); i++)
+	{
+		openList.push(std::make_pair(m_tetherLengths[_seeds[i]], _seeds[i]));
+	}
+
+	while (openList.empty() == false)
+	{
+		float distance = openList.top().first;
+		int index = openList.top().second;
+		openList.pop();
+
+		if (distance > m_tetherLengths[index])
+		{
+			// A shorter path to this particle has already been expanded
+			continue;
+		}
+
+		for (int i = m_tetherNeighbourStart[index]; i < m_tetherNeighbourStart[index + 1]; i++)
+		{
+			int neighbour = m_tetherNeighbours[i];
+			float neighbourDistance = distance + m_tetherNeighbourDistances[i];
+
+			if (neighbourDistance < m_tetherLengths[neighbour])
+			{
+				// Tether the neighbour to the same hook through this particle
+				m_tetherLengths[neighbour] = neighbourDistance;
+				m_tetherHooks[neighbour] = m_tetherHooks[index];
+				openList.push(std::make_pair(neighbourDistance, neighbour));
+			}
+		}
+	}
+}
+
+void Physics_Cloth::SatisfyTethers()
+{
+	if (m_tethersEnabled == false || m_hookedParticles.empty() == true)
+	{
+		// No tethers to satisfy
+		return;
+	}
+
+	for (int i = 0; i < m_particleCount; i++)
+	{
+		int hookIndex = m_tetherHooks[i];
+		if (hookIndex == -1 || m_pParticles[i].GetStaticState() == true || m_pParticles[i].GetActiveState() == false)
+		{
+			// Particle is not tethered or can not move
+			continue;
+		}
+
+		// The tether only pulls when the particle is further from the hook than its length allows
+		v3float hookToParticle = *m_pParticles[i].GetPosition() - *m_pParticles[hookIndex].GetPosition();
+		float distance = hookToParticle.Magnitude();
+		float maxDistance = m_tetherLengths[i] * m_tetherSlack;
+
+		if (distance > maxDistance)
+		{
+			m_pParticles[i].Move(hookToParticle * ((maxDistance - distance) / distance));
+		}
+	}
+}
+
+bool Physics_Cloth::TriangleActive(TBVHTriangle* _pTriangle)
+{
+	return (m_pParticles[_pTriangle->Indices[0]].GetActiveState() == true
+		&& m_pParticles[_pTriangle->Indices[1]].GetActiveState() == true
+		&& m_pParticles[_pTriangle->Indices[2]].GetActiveState() == true);
+}
+
 void Physics_Cloth::Explode(float _ratio)
 {
+	// Changes made by the user disturb a resting cloth
+	Wake();
+
 	v3float center = { 0, 0, 0 };
 	m_blastRadius = m_maxBlastRadius * _ratio;
 
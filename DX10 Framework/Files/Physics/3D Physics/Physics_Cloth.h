@@ -20,6 +20,30 @@
 // Local Includes
 #include "../../DX10/DX10.h"
 #include "Physics_Constraint.h"
+#include "Physics_BVH.h"
+#include "Physics_ImplicitSolver.h"
+#include "Physics_Heightfield.h"
+#include "Physics_Effects.h"
+#include "../../Utility/Profiler.h"
+
+// Library Includes
+#include <algorithm>
+#include <queue>
+#include <functional>
+
+// Defines
+// The collision objects shared by the cloth and the strands
+#define COLLIDER_SPHERE_CENTRE v3float(0.0f, 0.0f, 7.0f)
+#define COLLIDER_SPHERE_RADIUS 5.0f
+#define COLLIDER_CAPSULE_CENTRE_A v3float(0.0f, -3.0f, 6.0f)
+#define COLLIDER_CAPSULE_CENTRE_B v3float(0.0f, 3.0f, 6.0f)
+#define COLLIDER_CAPSULE_RADIUS 3.0f
+#define COLLIDER_PYRAMID_POINT_A v3float(0.0f, 0.408248f * 10.0f, 0.0f + 7.0f)
+#define COLLIDER_PYRAMID_POINT_B v3float(0.5f * 10.0f, -0.408248f * 10.0f, -0.288675f * 10.0f + 7.0f)
+#define COLLIDER_PYRAMID_POINT_C v3float(0.0f, -0.408248f * 10.0f, 0.577350f * 10.0f + 7.0f)
+#define COLLIDER_PYRAMID_POINT_D v3float(-0.5f * 10.0f, -0.408248f * 10.0f, -0.288675f * 10.0f + 7.0f)
+#define COLLIDER_PYRAMID_MARGIN 0.5f
+#define COLLIDER_FLOOR_HEIGHT -20.0f
 
 // Enumerators
 /***********************
@@ -44,6 +68,52 @@ enum eCollisionType
 	CT_PYRAMID
 };
 
+/***********************
+* eIntegratorType: Enum for the different integrators that can move the Cloth
+* @author: Callan Moore
+********************/
+enum eIntegratorType
+{
+	IT_VERLET,
+	IT_IMPLICIT
+};
+
+/***********************
+* TSolverMetrics: Metrics of the constraint solve for a single step of the Cloth
+* @author: Callan Moore
+********************/
+struct TSolverMetrics
+{
+	int Iterations;
+	float InitialMaxResidual;
+	float MaxResidual;
+	float RMSResidual;
+
+	/***********************
+	* TSolverMetrics: Default constructor for the TSolverMetrics struct
+	* @author: Callan Moore
+	********************/
+	TSolverMetrics()
+	{
+		Iterations = 0;
+		InitialMaxResidual = 0.0f;
+		MaxResidual = 0.0f;
+		RMSResidual = 0.0f;
+	}
+};
+
+/***********************
+* TClothQuality: Settings of the Cloth that trade simulation quality for processing time
+* @author: Callan Moore
+********************/
+struct TClothQuality
+{
+	int ConstraintIterations;
+	int Substeps;
+	int SelfCollisionInterval;
+	float SleepVelocity;
+};
+
 class Physics_Cloth
 	: public DX10_Obj_Generic
 {
@@ -63,7 +133,7 @@ public:
 	/***********************
 	* Initialise: Initialise the Physics Cloth for use
 	* @author: Callan Moore
-	* @parameter: _pRenderer: The renderer for this object
+	* @parameter: _pRenderer: The renderer for this object. NULL to simulate headless without a mesh
 	* @parameter: DX10_Shader_Cloth: The shader that will be used to render the object
 	* @parameter: _width: The width of the Cloth
 	* @parameter: _height: The height of the Cloth
@@ -120,6 +190,14 @@ public:
 	* @return: void
 	********************/
 	void HookParticle(Physics_Particle* _particle);
+
+	/***********************
+	* UnhookParticle: Release a single hooked particle and reattach its tethered particles to the remaining hooks
+	* @author: Callan Moore
+	* @parameter: _particle: Pointer to the hooked particle to release
+	* @return: void
+	********************/
+	void UnhookParticle(Physics_Particle* _particle);
 	
 	/***********************
 	* ResetCloth: Reset the cloth to the default positions and states
@@ -217,8 +295,217 @@ public:
 	********************/
 	void Explode(float _ratio);
 
+	/***********************
+	* ToggleChebyshev: Toggle the Chebyshev acceleration of the constraint iterations
+	* @author: Callan Moore
+	* @return: void
+	********************/
+	void ToggleChebyshev() { m_chebyshevEnabled = !m_chebyshevEnabled; };
+
+	/***********************
+	* GetChebyshevEnabled: Retrieve whether the constraint iterations are Chebyshev accelerated
+	* @author: Callan Moore
+	* @return: bool: True if accelerated
+	********************/
+	bool GetChebyshevEnabled() { return m_chebyshevEnabled; };
+
+	/***********************
+	* GetSpectralRadius: Retrieve the current estimate of the spectral radius used by the Chebyshev acceleration
+	* @author: Callan Moore
+	* @return: float: The spectral radius estimate
+	********************/
+	float GetSpectralRadius() { return m_spectralRadius; };
+
+	/***********************
+	* ToggleAdaptiveIterations: Toggle between a fixed constraint iteration count and iterating until within tolerance
+	* @author: Callan Moore
+	* @return: void
+	********************/
+	void ToggleAdaptiveIterations() { m_adaptiveIterations = !m_adaptiveIterations; };
+
+	/***********************
+	* SetResidualTolerance: Set the relative constraint violation that the adaptive iterations stop at
+	* @author: Callan Moore
+	* @parameter: _tolerance: The tolerance as a ratio of the constraints rest distance
+	* @return: void
+	********************/
+	void SetResidualTolerance(float _tolerance) { m_residualTolerance = _tolerance; };
+
+	/***********************
+	* GetSolverMetrics: Retrieve the iteration count and residuals of the last processed step
+	* @author: Callan Moore
+	* @return: TSolverMetrics: The solver metrics
+	********************/
+	TSolverMetrics GetSolverMetrics() { return m_solverMetrics; };
+
+	/***********************
+	* SetIntegrator: Set the integrator used to move the cloth
+	* @author: Callan Moore
+	* @parameter: _integrator: Verlet with constraint projection or implicit backward Euler
+	* @return: void
+	********************/
+	void SetIntegrator(eIntegratorType _integrator) { m_integrator = _integrator; };
+
+	/***********************
+	* ToggleTethers: Toggle the long range attachments that limit how far particles can stretch from their nearest hook
+	* @author: Callan Moore
+	* @return: void
+	********************/
+	void ToggleTethers() { m_tethersEnabled = !m_tethersEnabled; };
+
+	/***********************
+	* ToggleContinuousCollision: Toggle the swept collision of particle movement against the collision objects
+	* @author: Callan Moore
+	* @return: void
+	********************/
+	void ToggleContinuousCollision() { m_continuousCollision = !m_continuousCollision; };
+
+	/***********************
+	* SetQuality: Set the iterations, substeps, self collision interval and sleep threshold of the cloth
+	* @author: Callan Moore
+	* @parameter: _quality: The quality settings
+	* @return: void
+	********************/
+	void SetQuality(TClothQuality _quality);
+
+	/***********************
+	* GetQuality: Retrieve the current quality settings of the cloth
+	* @author: Callan Moore
+	* @return: TClothQuality: The quality settings
+	********************/
+	TClothQuality GetQuality();
+
+	/***********************
+	* Wake: Wake the cloth so it is simulated again
+	* @author: Callan Moore
+	* @return: void
+	********************/
+	void Wake() { m_sleeping = false; m_stillFrames = 0; };
+
+	/***********************
+	* GetSleeping: Retrieve whether the cloth has come to rest and stopped simulating
+	* @author: Callan Moore
+	* @return: bool: True if the cloth is asleep
+	********************/
+	bool GetSleeping() { return m_sleeping; };
+
+	/***********************
+	* GetImplicitSolver: Retrieve the implicit solver used when the integrator is set to implicit
+	* @author: Callan Moore
+	* @return: Physics_ImplicitSolver*: Pointer to the implicit solver
+	********************/
+	Physics_ImplicitSolver* GetImplicitSolver() { return m_pImplicitSolver; };
+
+	/***********************
+	* CollisionsWithCloth: Calculate the collisions between this cloth and another cloth so they do not pass through each other
+	* @author: Callan Moore
+	* @parameter: _pOther: The other cloth to collide with
+	* @return: void
+	********************/
+	void CollisionsWithCloth(Physics_Cloth* _pOther);
+
+	/***********************
+	* GetBVH: Retrieve the triangle hierarchy of the cloth surface
+	* @author: Callan Moore
+	* @return: Physics_BVH*: Pointer to the hierarchy
+	********************/
+	Physics_BVH* GetBVH() { return m_pBVH; };
+
+	/***********************
+	* GetVertices: Retrieve the vertices of the cloth, one per particle
+	* @author: Callan Moore
+	* @return: TVertexColor*: Pointer to the first vertex
+	********************/
+	TVertexColor* GetVertices() { return m_pVertices; };
+
+	/***********************
+	* GetIndices: Retrieve the line list indices of the constraints. Broken constraints have both indices zeroed
+	* @author: Callan Moore
+	* @return: DWORD*: Pointer to the first index
+	********************/
+	DWORD* GetIndices() { return m_pIndices; };
+
+	/***********************
+	* GetParticleCount: Retrieve the number of particles and vertices in the cloth
+	* @author: Callan Moore
+	* @return: int: The particle count
+	********************/
+	int GetParticleCount() { return m_particleCount; };
+
+	/***********************
+	* GetIndexCount: Retrieve the number of constraint indices in the cloth
+	* @author: Callan Moore
+	* @return: int: The index count
+	********************/
+	int GetIndexCount() { return m_indexCount; };
+
+	/***********************
+	* GetIndicesVersion: Retrieve a counter that changes whenever constraints are made or broken
+	* @author: Callan Moore
+	* @return: UINT: The version of the indices
+	********************/
+	UINT GetIndicesVersion() { return m_indicesVersion; };
+
+	/***********************
+	* GetTimeStep: Retrieve the time step of each processed frame
+	* @author: Callan Moore
+	* @return: float: The time step
+	********************/
+	float GetTimeStep() { return m_timeStep; };
+
+	/***********************
+	* SetHeightfield: Set a terrain for the cloth to collide with as well as the floor
+	* @author: Callan Moore
+	* @parameter: _pHeightfield: The terrain heightfield. Not owned by the cloth. NULL to stop colliding with it
+	* @return: void
+	********************/
+	void SetHeightfield(Physics_Heightfield* _pHeightfield) { m_pHeightfield = _pHeightfield; };
+
+	/***********************
+	* SetEffects: Set the effects that burning constraints spawn embers and smoke into
+	* @author: Callan Moore
+	* @parameter: _pEffects: The particle effects. Not owned by the cloth. NULL to stop spawning effects
+	* @parameter: _emberEmitter: The ID of the emitter for embers
+	* @parameter: _smokeEmitter: The ID of the emitter for smoke
+	* @return: void
+	********************/
+	void SetEffects(Physics_Effects* _pEffects, int _emberEmitter, int _smokeEmitter) { m_pEffects = _pEffects; m_emberEmitter = _emberEmitter; m_smokeEmitter = _smokeEmitter; };
+
 private:
 	
+	/***********************
+	* SolveConstraints: Satisfy the constraints and collisions over multiple iterations
+	* @author: Callan Moore
+	* @parameter: _collisionType: The type of collision to use during this process
+	* @parameter: _pIndices: The index buffer of the cloth mesh. Broken constraints are removed from it
+	* @return: void
+	********************/
+	void SolveConstraints(eCollisionType _collisionType, DWORD* _pIndices);
+
+	/***********************
+	* Simulate: Integrate the particles over one substep and resolve the constraints, tethers and collisions
+	* @author: Callan Moore
+	* @parameter: _collisionType: The type of object to calculate collisions against
+	* @parameter: _pIndices: The index buffer to stop drawing broken constraints in
+	* @return: void
+	********************/
+	void Simulate(eCollisionType _collisionType, DWORD* _pIndices);
+
+	/***********************
+	* UpdateSleepState: Put the cloth to sleep once it has moved slower than the sleep velocity for long enough
+	* @author: Callan Moore
+	* @return: void
+	********************/
+	void UpdateSleepState();
+
+	/***********************
+	* ProcessCollisions: Calculate the collisions with the object, floor and the cloth itself
+	* @author: Callan Moore
+	* @parameter: _collisionType: The type of collision to use during this process
+	* @return: void
+	********************/
+	void ProcessCollisions(eCollisionType _collisionType);
+
 	/***********************
 	* GetParticle: Retrieve the particle at the input row and column index
 	* @author: Callan Moore
@@ -269,7 +556,7 @@ private:
 	void AddWindForceForTri(Physics_Particle* _pParticleA, Physics_Particle* _pParticleB, Physics_Particle* _pParticleC, v3float _force);
 
 	/***********************
-	* SelectParticles: Select particles that intersect with the ray
+	* SelectParticles: Select particles that intersect with the ray. If the ray passes between them, the particle nearest where it hits the cloth surface is selected
 	* @author: Callan Moore
 	* @parameter: _camRay: The current camera ray cast at the mouse point
 	* @parameter: _selectRadius: The radius of the particles to see if they intersect the ray
@@ -284,6 +571,16 @@ private:
 	* @return: void
 	********************/
 	void IgniteConnectedConstraints(Physics_Particle* _pParticle);
+
+	/***********************
+	* EmitBurnEffect: Spawn particles from an effects emitter at a position on the cloth
+	* @author: Callan Moore
+	* @parameter: _emitter: The ID of the emitter
+	* @parameter: _localPos: The position on the cloth in local space
+	* @parameter: _count: The number of particles to spawn
+	* @return: void
+	********************/
+	void EmitBurnEffect(int _emitter, v3float _localPos, int _count);
 	
 	/***********************
 	* CollisionsWithSelf: Calculate the collisions with itself so that it does not penetrate or clip
@@ -291,6 +588,82 @@ private:
 	* @return: void
 	********************/
 	void CollisionsWithSelf();
+
+	/***********************
+	* BuildBVH: Create the triangles of the cloth surface and build the hierarchy over them
+	* @author: Callan Moore
+	* @return: bool: Successful or not
+	********************/
+	bool BuildBVH();
+
+	/***********************
+	* PointTriangleCollisions: Push this cloths particles out of the triangles of the target cloth
+	* @author: Callan Moore
+	* @parameter: _pTarget: The cloth whose triangles are collided against. Can be this cloth
+	* @return: void
+	********************/
+	void PointTriangleCollisions(Physics_Cloth* _pTarget);
+
+	/***********************
+	* EdgeEdgeCollisions: Push this cloths triangle edges away from the triangle edges of the target cloth
+	* @author: Callan Moore
+	* @parameter: _pTarget: The cloth whose edges are collided against. Can be this cloth
+	* @return: void
+	********************/
+	void EdgeEdgeCollisions(Physics_Cloth* _pTarget);
+
+	/***********************
+	* TriangleActive: Check whether all particles of a triangle are still part of the cloth
+	* @author: Callan Moore
+	* @parameter: _pTriangle: The triangle to check
+	* @return: bool: True if the triangle is active
+	********************/
+	bool TriangleActive(TBVHTriangle* _pTriangle);
+
+	/***********************
+	* StoreIterate: Store the current particle positions as the latest iterate of the constraint solve
+	* @author: Callan Moore
+	* @return: void
+	********************/
+	void StoreIterate();
+
+	/***********************
+	* ChebyshevAccelerate: Apply the Chebyshev semi-iterative weight to the result of a constraint sweep
+	* @author: Callan Moore
+	* @parameter: _iteration: The index of the constraint iteration just completed
+	* @parameter: _prLastUpdate: The size of the previous sweeps update. Updated with this sweeps update
+	* @return: bool: False if the sweeps are diverging and acceleration should stop for this step
+	********************/
+	bool ChebyshevAccelerate(int _iteration, float& _prLastUpdate);
+
+	/***********************
+	* CalculateTethers: Calculate the nearest hook and rest mesh distance to it for every particle
+	* @author: Callan Moore
+	* @return: void
+	********************/
+	void CalculateTethers();
+
+	/***********************
+	* BuildTetherGraph: Build the neighbours of each particle from the intact immediate constraints
+	* @author: Callan Moore
+	* @return: void
+	********************/
+	void BuildTetherGraph();
+
+	/***********************
+	* PropagateTethers: Spread the tether distances out from the seed particles along the rest mesh
+	* @author: Callan Moore
+	* @parameter: _seeds: Indices of the particles whose tether distances are already known
+	* @return: void
+	********************/
+	void PropagateTethers(std::vector<int>& _seeds);
+
+	/***********************
+	* SatisfyTethers: Pull any particle that is further from its hook than its tether allows back onto the tether
+	* @author: Callan Moore
+	* @return: void
+	********************/
+	void SatisfyTethers();
 	
 	/***********************
 	* FloorCollision: Calculate collisions with a floor (plane)
@@ -299,6 +672,13 @@ private:
 	* @return: void
 	********************/
 	void FloorCollision(float _floorPos);
+
+	/***********************
+	* HeightfieldCollision: Calculate collisions with the terrain heightfield
+	* @author: Callan Moore
+	* @return: void
+	********************/
+	void HeightfieldCollision();
 	
 	/***********************
 	* SphereCollision: Calculate collisions with a sphere
@@ -329,6 +709,46 @@ private:
 	* @return: void
 	********************/
 	void PyramidCollision(v3float _pyraPointA, v3float _pyraPointB, v3float _pyraPointC, v3float _pyraPointD);
+
+	/***********************
+	* SweptSphereCollision: Stop particles that moved through a sphere this step at the point they hit it
+	* @author: Callan Moore
+	* @parameter: _center:The spheres centre position
+	* @parameter: _sphereRadius: The radius of the sphere
+	* @return: void
+	********************/
+	void SweptSphereCollision(v3float _center, float _sphereRadius);
+
+	/***********************
+	* SweptCapsuleCollision: Stop particles that moved through a capsule this step at the point they hit it
+	* @author: Callan Moore
+	* @parameter: _sphereCentre1: The first sphere of the capsules centre position
+	* @parameter: _sphereCentre2: The second sphere of the capsules centre position
+	* @parameter: float _capsuleRadius: The radius of the capsule
+	* @return: void
+	********************/
+	void SweptCapsuleCollision(v3float _sphereCentre1, v3float _sphereCentre2, float _capsuleRadius);
+
+	/***********************
+	* SweptPyramidCollision: Stop particles that moved through a pyramid this step at the point they hit it
+	* @author: Callan Moore
+	* @parameter: v3float _pyraPointA: First point of the pyramid
+	* @parameter: v3float _pyraPointB: Second point of the pyramid
+	* @parameter: v3float _pyraPointC: Third point of the pyramid
+	* @parameter: v3float _pyraPointD: Fourth point of the pyramid
+	* @return: void
+	********************/
+	void SweptPyramidCollision(v3float _pyraPointA, v3float _pyraPointB, v3float _pyraPointC, v3float _pyraPointD);
+
+	/***********************
+	* ResolveSweptHit: Move a particle back to where its movement hit a surface, keeping the movement along the surface
+	* @author: Callan Moore
+	* @parameter: _pParticle: The particle that hit the surface
+	* @parameter: _time: Ratio along the particles movement of the hit
+	* @parameter: _normal: The surface normal at the hit
+	* @return: void
+	********************/
+	void ResolveSweptHit(Physics_Particle* _pParticle, float _time, v3float _normal);
 	
 	
 private:
@@ -349,8 +769,54 @@ private:
 	int m_maxHooks;	
 	float m_selfCollisionRad;
 
+	Physics_BVH* m_pBVH;
+	std::vector<UINT> m_collisionTriangles;
+	Physics_Heightfield* m_pHeightfield;
+
 	int m_particleCount;
 	int m_constraintIterations;
+	bool m_continuousCollision;
+
+	// Quality Variables
+	int m_substeps;
+	int m_selfCollisionInterval;
+	int m_stepCount;
+	std::vector<v3float> m_substepAccelerations;
+
+	// Sleeping Variables
+	bool m_sleeping;
+	float m_sleepVelocity;
+	int m_sleepFrames;
+	int m_stillFrames;
+	eCollisionType m_lastCollisionType;
+
+	// Integrator Variables
+	eIntegratorType m_integrator;
+	Physics_ImplicitSolver* m_pImplicitSolver;
+
+	// Adaptive Iteration Variables
+	bool m_adaptiveIterations;
+	int m_minConstraintIterations;
+	int m_maxConstraintIterations;
+	float m_residualTolerance;
+	TSolverMetrics m_solverMetrics;
+
+	// Chebyshev Acceleration Variables
+	bool m_chebyshevEnabled;
+	float m_spectralRadius;
+	float m_chebyshevOmega;
+	std::vector<v3float> m_iteratePrevious;
+	std::vector<v3float> m_iterateCurrent;
+
+	// Long Range Attachment Variables
+	bool m_tethersEnabled;
+	bool m_tethersDirty;
+	float m_tetherSlack;
+	std::vector<int> m_tetherHooks;
+	std::vector<float> m_tetherLengths;
+	std::vector<int> m_tetherNeighbourStart;
+	std::vector<int> m_tetherNeighbours;
+	std::vector<float> m_tetherNeighbourDistances;
 
 	float m_damping;
 	float m_timeStep;
@@ -366,12 +832,25 @@ private:
 	int m_indexCount;
 	int m_nextIndex;
 
+	// Incremented whenever constraints are made or broken
+	UINT m_indicesVersion;
+	UINT m_uploadedIndicesVersion;
+
 	std::vector<Physics_Particle*> m_selectedParticles;
 
 	// Ignition Variables
 	float m_burnTime;
 	bool m_complexWeave;
 
+	// Burn Effect Variables
+	Physics_Effects* m_pEffects;
+	int m_emberEmitter;
+	int m_smokeEmitter;
+	float m_emberRate;
+	float m_emberCarry;
+	int m_igniteEmbers;
+	int m_destroySmoke;
+
 	float m_maxBlastRadius;
 	float m_blastRadius;
 };
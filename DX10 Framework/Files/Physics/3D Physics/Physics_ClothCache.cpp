@@ -0,0 +1,438 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Physics_ClothCache.cpp
+* Description : Records a simulated cloth to a cache file and plays it back without the solver
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// This Include
+#include "Physics_ClothCache.h"
+
+// Defines
+#define CLOTH_CACHE_VERSION 2
+
+/***********************
+* CalcBitsetWords: Calculate the number of 32 bit words in the constraint bitset of a frame
+* @author: Callan Moore
+* @parameter: _indexCount: The number of constraint indices
+* @return: UINT: The word count
+********************/
+static UINT CalcBitsetWords(UINT _indexCount)
+{
+	return ((_indexCount / 2) + 31) / 32;
+}
+
+Physics_ClothCacheWriter::Physics_ClothCacheWriter()
+{
+	// Initialise pointers to NULL
+	m_pCloth = 0;
+	m_chunkFrames = 0;
+}
+
+Physics_ClothCacheWriter::~Physics_ClothCacheWriter()
+{
+	if (m_file.is_open() == true)
+	{
+		Finalise();
+	}
+}
+
+bool Physics_ClothCacheWriter::Record(Physics_Cloth* _pCloth, eCollisionType _collisionType, int _frames, std::string _filename)
+{
+	Physics_ClothCacheWriter writer;
+	VALIDATE(writer.Initialise(_pCloth, _filename));
+
+	// Simulate and write one frame at a time so the sequence is never held in memory
+	for (int i = 0; i < _frames; i++)
+	{
+		_pCloth->Process(_collisionType);
+		VALIDATE(writer.WriteFrame());
+	}
+
+	return writer.Finalise();
+}
+
+bool Physics_ClothCacheWriter::Initialise(Physics_Cloth* _pCloth, std::string _filename, int _framesPerChunk)
+{
+	if (_pCloth == 0 || _framesPerChunk <= 0)
+	{
+		// Nothing to write, initialization failed
+		return false;
+	}
+
+	m_file.open(_filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (m_file.is_open() == false)
+	{
+		// File could not be created
+		return false;
+	}
+
+	// Assign member variables
+	m_pCloth = _pCloth;
+	m_chunkOffsets.clear();
+	m_chunkFrames = 0;
+
+	m_header.Magic[0] = 'C';
+	m_header.Magic[1] = 'L';
+	m_header.Magic[2] = 'C';
+	m_header.Magic[3] = 'H';
+	m_header.Version = CLOTH_CACHE_VERSION;
+	m_header.VertexCount = (UINT)m_pCloth->GetParticleCount();
+	m_header.IndexCount = (UINT)m_pCloth->GetIndexCount();
+	m_header.FrameSize = sizeof(TClothCacheFrame) + (m_header.VertexCount * sizeof(TVertexHalfColor)) + (CalcBitsetWords(m_header.IndexCount) * sizeof(UINT));
+	m_header.FramesPerChunk = (UINT)_framesPerChunk;
+	m_header.FrameCount = 0;
+	m_header.ChunkCount = 0;
+	m_header.TimeStep = m_pCloth->GetTimeStep();
+	m_header.ChunkTableOffset = 0;
+
+	// Reserve a single chunk of frames
+	m_chunkBuffer.clear();
+	m_chunkBuffer.reserve(m_header.FrameSize * m_header.FramesPerChunk);
+
+	// Write the header now and again with the final counts once finished. The original indices follow it
+	m_file.write((const char*)&m_header, sizeof(TClothCacheHeader));
+	m_file.write((const char*)m_pCloth->GetIndices(), m_header.IndexCount * sizeof(DWORD));
+
+	return m_file.good();
+}
+
+bool Physics_ClothCacheWriter::WriteFrame()
+{
+	if (m_file.is_open() == false)
+	{
+		// Not initialised or already finalised
+		return false;
+	}
+
+	UINT vertexCount = m_header.VertexCount;
+	TVertexColor* pVertices = m_pCloth->GetVertices();
+	DWORD* pIndices = m_pCloth->GetIndices();
+
+	// Add space for the frame to the end of the chunk
+	UINT frameStart = (UINT)m_chunkBuffer.size();
+	m_chunkBuffer.resize(frameStart + m_header.FrameSize, 0);
+	BYTE* pFrame = &m_chunkBuffer[frameStart];
+
+	TClothCacheFrame* pFrameHeader = (TClothCacheFrame*)pFrame;
+	TVertexHalfColor* pPacked = (TVertexHalfColor*)(pFrame + sizeof(TClothCacheFrame));
+	UINT* pBitset = (UINT*)(pPacked + vertexCount);
+
+	// Store the vertices exactly as they are uploaded so playback is a copy
+	D3DXVECTOR3 origin = CalcPackOrigin(pVertices, (int)vertexCount);
+	pFrameHeader->Origin[0] = origin.x;
+	pFrameHeader->Origin[1] = origin.y;
+	pFrameHeader->Origin[2] = origin.z;
+	for (UINT i = 0; i < vertexCount; i++)
+	{
+		PackVertexHalfColor(pVertices[i], origin, pPacked[i]);
+	}
+
+	// Broken constraints have both their indices zeroed
+	UINT constraintCount = m_header.IndexCount / 2;
+	for (UINT i = 0; i < constraintCount; i++)
+	{
+		if (pIndices[i * 2] != 0 || pIndices[(i * 2) + 1] != 0)
+		{
+			pBitset[i / 32] |= (1u << (i % 32));
+		}
+	}
+
+	m_header.FrameCount++;
+	m_chunkFrames++;
+	if (m_chunkFrames == m_header.FramesPerChunk)
+	{
+		return FlushChunk();
+	}
+
+	return true;
+}
+
+bool Physics_ClothCacheWriter::Finalise()
+{
+	if (m_file.is_open() == false)
+	{
+		// Not initialised or already finalised
+		return false;
+	}
+
+	if (m_chunkFrames > 0)
+	{
+		// Write the partially filled last chunk
+		FlushChunk();
+	}
+
+	// Write the table of chunk offsets after the last chunk
+	m_header.ChunkCount = (UINT)m_chunkOffsets.size();
+	m_header.ChunkTableOffset = (unsigned __int64)m_file.tellp();
+	if (m_chunkOffsets.empty() == false)
+	{
+		m_file.write((const char*)&m_chunkOffsets[0], m_chunkOffsets.size() * sizeof(unsigned __int64));
+	}
+
+	// Rewrite the header with the final counts
+	m_file.seekp(0, std::ios::beg);
+	m_file.write((const char*)&m_header, sizeof(TClothCacheHeader));
+
+	bool success = m_file.good();
+	m_file.close();
+	return success;
+}
+
+bool Physics_ClothCacheWriter::FlushChunk()
+{
+	TClothCacheChunk chunk;
+	chunk.FirstFrame = m_header.FrameCount - m_chunkFrames;
+	chunk.FrameCount = m_chunkFrames;
+
+	m_chunkOffsets.push_back((unsigned __int64)m_file.tellp());
+	m_file.write((const char*)&chunk, sizeof(TClothCacheChunk));
+	m_file.write((const char*)&m_chunkBuffer[0], m_chunkBuffer.size());
+
+	// Start the next chunk
+	m_chunkBuffer.clear();
+	m_chunkFrames = 0;
+
+	return m_file.good();
+}
+
+Physics_ClothCachePlayer::Physics_ClothCachePlayer()
+{
+	// Initialise pointers to NULL
+	m_hFile = INVALID_HANDLE_VALUE;
+	m_hMapping = 0;
+	m_pData = 0;
+	m_pHeader = 0;
+	m_pMesh = 0;
+	m_pIndices = 0;
+}
+
+Physics_ClothCachePlayer::~Physics_ClothCachePlayer()
+{
+	Release();
+}
+
+bool Physics_ClothCachePlayer::Initialise(DX10_Renderer* _pRenderer, std::string _filename)
+{
+	if (_pRenderer == 0)
+	{
+		// Pointer is NULL, initialization failed
+		return false;
+	}
+
+	// Map the whole cache file into memory. Frames are read straight from the mapping
+	m_hFile = CreateFileA(_filename.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+	if (m_hFile == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	VALIDATE(GetFileSizeEx(m_hFile, &fileSize));
+	m_dataSize = (unsigned __int64)fileSize.QuadPart;
+	if (m_dataSize < sizeof(TClothCacheHeader))
+	{
+		// File is too small to be a cache
+		return false;
+	}
+
+	m_hMapping = CreateFileMappingA(m_hFile, 0, PAGE_READONLY, 0, 0, 0);
+	if (m_hMapping == 0)
+	{
+		return false;
+	}
+
+	m_pData = (const BYTE*)MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0);
+	if (m_pData == 0)
+	{
+		return false;
+	}
+
+	// Validate the header against the file
+	m_pHeader = (const TClothCacheHeader*)m_pData;
+	if (m_pHeader->Magic[0] != 'C' || m_pHeader->Magic[1] != 'L' || m_pHeader->Magic[2] != 'C' || m_pHeader->Magic[3] != 'H'
+		|| m_pHeader->Version != CLOTH_CACHE_VERSION || m_pHeader->FrameCount == 0 || m_pHeader->FramesPerChunk == 0)
+	{
+		// Not a cache file or it was never finalised
+		return false;
+	}
+
+	// Every frame holds a packed vertex per vertex, so larger counts can not fit and would overflow the frame size
+	if ((unsigned __int64)m_pHeader->VertexCount * sizeof(TVertexHalfColor) > m_dataSize
+		|| m_pHeader->FrameSize != sizeof(TClothCacheFrame) + (m_pHeader->VertexCount * sizeof(TVertexHalfColor)) + (CalcBitsetWords(m_pHeader->IndexCount) * sizeof(UINT)))
+	{
+		// Frames do not match the mesh they describe
+		return false;
+	}
+
+	// The original indices follow the header
+	if (sizeof(TClothCacheHeader) + ((unsigned __int64)m_pHeader->IndexCount * sizeof(DWORD)) > m_dataSize)
+	{
+		return false;
+	}
+
+	// There must be a chunk for every frame and the chunk table must be inside the file
+	UINT chunksNeeded = ((m_pHeader->FrameCount - 1) / m_pHeader->FramesPerChunk) + 1;
+	if (m_pHeader->ChunkCount < chunksNeeded || m_pHeader->ChunkTableOffset > m_dataSize
+		|| (unsigned __int64)m_pHeader->ChunkCount * sizeof(unsigned __int64) > m_dataSize - m_pHeader->ChunkTableOffset)
+	{
+		return false;
+	}
+
+	m_pOriginalIndices = (const DWORD*)(m_pData + sizeof(TClothCacheHeader));
+	m_pChunkOffsets = (const unsigned __int64*)(m_pData + m_pHeader->ChunkTableOffset);
+
+	// Every chunk that holds frames must be inside the file. Only the last chunk may hold fewer than a full chunk of frames
+	for (UINT i = 0; i < chunksNeeded; i++)
+	{
+		UINT chunkFrames = m_pHeader->FrameCount - (i * m_pHeader->FramesPerChunk);
+		if (chunkFrames > m_pHeader->FramesPerChunk)
+		{
+			chunkFrames = m_pHeader->FramesPerChunk;
+		}
+
+		unsigned __int64 chunkSize = sizeof(TClothCacheChunk) + ((unsigned __int64)chunkFrames * m_pHeader->FrameSize);
+		if (m_pChunkOffsets[i] > m_dataSize || chunkSize > m_dataSize - m_pChunkOffsets[i])
+		{
+			return false;
+		}
+	}
+
+	// The indices are drawn as they are, so each must name a vertex
+	for (UINT i = 0; i < m_pHeader->IndexCount; i++)
+	{
+		if (m_pOriginalIndices[i] >= m_pHeader->VertexCount)
+		{
+			return false;
+		}
+	}
+
+	// Create a mesh that takes the packed frames as they are stored
+	m_pMesh = new DX10_Mesh();
+	VALIDATE(m_pMesh->InitialisePacked(_pRenderer, m_pHeader->VertexCount, m_pHeader->IndexCount, D3D10_PRIMITIVE_TOPOLOGY_LINELIST));
+
+	// Start from the original indices with every constraint active
+	m_pIndices = new DWORD[m_pHeader->IndexCount];
+	memcpy(m_pIndices, m_pOriginalIndices, m_pHeader->IndexCount * sizeof(DWORD));
+	m_activeConstraints.assign(CalcBitsetWords(m_pHeader->IndexCount), 0xFFFFFFFF);
+	if (m_pHeader->IndexCount > 0)
+	{
+		memcpy(m_pMesh->MapIndexBuffer(), m_pIndices, m_pHeader->IndexCount * sizeof(DWORD));
+		m_pMesh->UnmapIndexBuffer();
+	}
+
+	m_frameTime = 0.0f;
+	SetFrame(0);
+
+	return true;
+}
+
+void Physics_ClothCachePlayer::SetFrame(UINT _frame)
+{
+	m_currentFrame = _frame % m_pHeader->FrameCount;
+
+	// Find the frame inside its chunk
+	UINT chunk = m_currentFrame / m_pHeader->FramesPerChunk;
+	UINT frameInChunk = m_currentFrame % m_pHeader->FramesPerChunk;
+	const BYTE* pFrame = m_pData + m_pChunkOffsets[chunk] + sizeof(TClothCacheChunk) + ((unsigned __int64)frameInChunk * m_pHeader->FrameSize);
+
+	const TClothCacheFrame* pFrameHeader = (const TClothCacheFrame*)pFrame;
+	const TVertexHalfColor* pPacked = (const TVertexHalfColor*)(pFrame + sizeof(TClothCacheFrame));
+	const UINT* pBitset = (const UINT*)(pPacked + m_pHeader->VertexCount);
+
+	// The frame is stored in the upload format so it is copied straight from the mapping to the GPU
+	memcpy(m_pMesh->MapVertexBuffer(), pPacked, m_pHeader->VertexCount * sizeof(TVertexHalfColor));
+	m_pMesh->UnmapVertexBuffer();
+	m_pMesh->SetPackOrigin(D3DXVECTOR3(pFrameHeader->Origin[0], pFrameHeader->Origin[1], pFrameHeader->Origin[2]));
+
+	// Only rewrite the indices of the constraints that changed state since the last frame shown
+	UINT constraintCount = m_pHeader->IndexCount / 2;
+	bool indicesChanged = false;
+	for (UINT word = 0; word < (UINT)m_activeConstraints.size(); word++)
+	{
+		UINT changed = m_activeConstraints[word] ^ pBitset[word];
+		if (changed == 0)
+		{
+			continue;
+		}
+
+		for (UINT bit = 0; bit < 32; bit++)
+		{
+			UINT constraint = word * 32 + bit;
+			if ((changed & (1u << bit)) != 0 && constraint < constraintCount)
+			{
+				bool active = (pBitset[word] & (1u << bit)) != 0;
+				m_pIndices[constraint * 2] = (active == true) ? m_pOriginalIndices[constraint * 2] : 0;
+				m_pIndices[(constraint * 2) + 1] = (active == true) ? m_pOriginalIndices[(constraint * 2) + 1] : 0;
+			}
+		}
+		m_activeConstraints[word] = pBitset[word];
+		indicesChanged = true;
+	}
+
+	if (indicesChanged == true)
+	{
+		memcpy(m_pMesh->MapIndexBuffer(), m_pIndices, m_pHeader->IndexCount * sizeof(DWORD));
+		m_pMesh->UnmapIndexBuffer();
+	}
+}
+
+void Physics_ClothCachePlayer::Process(float _dt)
+{
+	// Step through the frames at the rate they were recorded
+	UINT frame = m_currentFrame;
+	m_frameTime += _dt;
+	while (m_frameTime >= m_pHeader->TimeStep)
+	{
+		m_frameTime -= m_pHeader->TimeStep;
+		frame++;
+	}
+
+	if (frame != m_currentFrame)
+	{
+		SetFrame(frame);
+	}
+}
+
+void Physics_ClothCachePlayer::Render(DX10_Shader_Cloth* _pShader, D3DXMATRIX* _pMatWorld)
+{
+	// Create the struct to hold the cloth rendering variables
+	TCloth cloth;
+	cloth.pMatWorld = _pMatWorld;
+	cloth.pMesh = m_pMesh;
+
+	// Render the cloth
+	_pShader->Render(cloth);
+}
+
+void Physics_ClothCachePlayer::Release()
+{
+	ReleasePtr(m_pMesh);
+	ReleasePtrArray(m_pIndices);
+
+	if (m_pData != 0)
+	{
+		UnmapViewOfFile(m_pData);
+		m_pData = 0;
+		m_pHeader = 0;
+	}
+
+	if (m_hMapping != 0)
+	{
+		CloseHandle(m_hMapping);
+		m_hMapping = 0;
+	}
+
+	if (m_hFile != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(m_hFile);
+		m_hFile = INVALID_HANDLE_VALUE;
+	}
+}
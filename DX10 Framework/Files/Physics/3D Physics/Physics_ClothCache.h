@@ -0,0 +1,229 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Physics_ClothCache.h
+* Description : Records a simulated cloth to a cache file and plays it back without the solver
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// Inclusion Guards
+#pragma once
+#ifndef __PHYSICS_CLOTHCACHE_H__
+#define __PHYSICS_CLOTHCACHE_H__
+
+// Local Includes
+#include "Physics_Cloth.h"
+
+// Library Includes
+#include <fstream>
+
+/***********************
+* TClothCacheHeader: Header at the start of a cloth cache file. The original indices follow it
+* @author: Callan Moore
+********************/
+struct TClothCacheHeader
+{
+	char Magic[4];
+	UINT Version;
+	UINT VertexCount;
+	UINT IndexCount;
+	UINT FrameSize;
+	UINT FramesPerChunk;
+	UINT FrameCount;
+	UINT ChunkCount;
+	float TimeStep;
+
+	// Offset of the table of chunk offsets written after the last chunk
+	unsigned __int64 ChunkTableOffset;
+};
+
+/***********************
+* TClothCacheChunk: Header of a chunk of consecutive frames
+* @author: Callan Moore
+********************/
+struct TClothCacheChunk
+{
+	UINT FirstFrame;
+	UINT FrameCount;
+};
+
+/***********************
+* TClothCacheFrame: Header of a single frame. The vertices packed as TVertexHalfColor and the constraint bitset follow it
+* @author: Callan Moore
+********************/
+struct TClothCacheFrame
+{
+	// Point the half precision positions are relative to
+	float Origin[3];
+};
+
+class Physics_ClothCacheWriter
+{
+public:
+	/***********************
+	* Physics_ClothCacheWriter: Default Constructor for Physics Cloth Cache Writer class
+	* @author: Callan Moore
+	********************/
+	Physics_ClothCacheWriter();
+
+	/***********************
+	* ~Physics_ClothCacheWriter: Default Destructor for Physics Cloth Cache Writer class. Finalises any open file
+	* @author: Callan Moore
+	********************/
+	~Physics_ClothCacheWriter();
+
+	/***********************
+	* Record: Batch simulate a cloth for a number of frames and write every frame to a cache file
+	* @author: Callan Moore
+	* @parameter: _pCloth: The cloth to simulate. Can be headless
+	* @parameter: _collisionType: The type of object the cloth collides with
+	* @parameter: _frames: The number of frames to simulate
+	* @parameter: _filename: The cache file to write
+	* @return: bool: Successful or not
+	********************/
+	static bool Record(Physics_Cloth* _pCloth, eCollisionType _collisionType, int _frames, std::string _filename);
+
+	/***********************
+	* Initialise: Open the cache file and write the header for the cloth
+	* @author: Callan Moore
+	* @parameter: _pCloth: The cloth whose frames will be written
+	* @parameter: _filename: The cache file to write
+	* @parameter: _framesPerChunk: The number of frames buffered before each write to the file
+	* @return: bool: Successful or not
+	********************/
+	bool Initialise(Physics_Cloth* _pCloth, std::string _filename, int _framesPerChunk = 32);
+
+	/***********************
+	* WriteFrame: Pack the current state of the cloth into the chunk buffer, writing the chunk when full
+	* @author: Callan Moore
+	* @return: bool: Successful or not
+	********************/
+	bool WriteFrame();
+
+	/***********************
+	* Finalise: Write the last chunk and the chunk table then close the file
+	* @author: Callan Moore
+	* @return: bool: Successful or not
+	********************/
+	bool Finalise();
+
+private:
+
+	/***********************
+	* FlushChunk: Write the buffered frames as a chunk
+	* @author: Callan Moore
+	* @return: bool: Successful or not
+	********************/
+	bool FlushChunk();
+
+private:
+	Physics_Cloth* m_pCloth;
+	std::ofstream m_file;
+
+	TClothCacheHeader m_header;
+	std::vector<unsigned __int64> m_chunkOffsets;
+
+	// Frames waiting to be written as the next chunk
+	std::vector<BYTE> m_chunkBuffer;
+	UINT m_chunkFrames;
+};
+
+class Physics_ClothCachePlayer
+{
+public:
+	/***********************
+	* Physics_ClothCachePlayer: Default Constructor for Physics Cloth Cache Player class
+	* @author: Callan Moore
+	********************/
+	Physics_ClothCachePlayer();
+
+	/***********************
+	* ~Physics_ClothCachePlayer: Default Destructor for Physics Cloth Cache Player class
+	* @author: Callan Moore
+	********************/
+	~Physics_ClothCachePlayer();
+
+	/***********************
+	* Initialise: Map a cache file into memory and create the mesh to play it back with
+	* @author: Callan Moore
+	* @parameter: _pRenderer: The renderer for the mesh
+	* @parameter: _filename: The cache file to play
+	* @return: bool: Successful or not
+	********************/
+	bool Initialise(DX10_Renderer* _pRenderer, std::string _filename);
+
+	/***********************
+	* SetFrame: Copy a frame of the cache straight into the mesh buffer
+	* @author: Callan Moore
+	* @parameter: _frame: The frame to show. Wraps around the frame count
+	* @return: void
+	********************/
+	void SetFrame(UINT _frame);
+
+	/***********************
+	* Process: Advance playback by a time step
+	* @author: Callan Moore
+	* @parameter: _dt: The time passed
+	* @return: void
+	********************/
+	void Process(float _dt);
+
+	/***********************
+	* Render: Render the current frame
+	* @author: Callan Moore
+	* @parameter: _pShader: The cloth shader to render with
+	* @parameter: _pMatWorld: The world matrix of the cloth
+	* @return: void
+	********************/
+	void Render(DX10_Shader_Cloth* _pShader, D3DXMATRIX* _pMatWorld);
+
+	/***********************
+	* GetFrameCount: Retrieve the number of frames in the cache
+	* @author: Callan Moore
+	* @return: UINT: The frame count
+	********************/
+	UINT GetFrameCount() { return m_pHeader->FrameCount; };
+
+	/***********************
+	* GetMesh: Retrieve the mesh the cache plays into
+	* @author: Callan Moore
+	* @return: DX10_Mesh*: The mesh
+	********************/
+	DX10_Mesh* GetMesh() { return m_pMesh; };
+
+private:
+
+	/***********************
+	* Release: Unmap the cache file and close its handles
+	* @author: Callan Moore
+	* @return: void
+	********************/
+	void Release();
+
+private:
+	HANDLE m_hFile;
+	HANDLE m_hMapping;
+	const BYTE* m_pData;
+	unsigned __int64 m_dataSize;
+
+	const TClothCacheHeader* m_pHeader;
+	const DWORD* m_pOriginalIndices;
+	const unsigned __int64* m_pChunkOffsets;
+
+	DX10_Mesh* m_pMesh;
+	DWORD* m_pIndices;
+
+	// Bitset of the constraints currently in the index buffer
+	std::vector<UINT> m_activeConstraints;
+
+	UINT m_currentFrame;
+	float m_frameTime;
+};
+
+#endif	// __PHYSICS_CLOTHCACHE_H__
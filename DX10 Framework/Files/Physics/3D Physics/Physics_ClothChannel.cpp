@@ -0,0 +1,412 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Physics_ClothChannel.cpp
+* Description : Shared memory ring of cloth vertex frames and commands between a simulation server and a client
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// This Include
+#include "Physics_ClothChannel.h"
+
+// Library Includes
+#include <string.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Defines
+#define CLOTH_CHANNEL_VERSION 2
+#define CLOTH_CHANNEL_ALIGNMENT 64
+
+// Orders the reads and writes of the shared memory between the two processes
+#ifdef _WIN32
+#define CHANNEL_BARRIER() MemoryBarrier()
+#else
+#define CHANNEL_BARRIER() __sync_synchronize()
+#endif
+
+/***********************
+* AlignSize: Round a size up to the alignment of the blocks in the shared memory
+* @author: Callan Moore
+* @parameter: _size: The size to align
+* @return: size_t: The aligned size
+********************/
+static size_t AlignSize(size_t _size)
+{
+	return (_size + CLOTH_CHANNEL_ALIGNMENT - 1) & ~((size_t)CLOTH_CHANNEL_ALIGNMENT - 1);
+}
+
+Physics_ClothChannel::Physics_ClothChannel()
+{
+	// Initialise pointers to NULL
+	m_owner = false;
+#ifdef _WIN32
+	m_hMapping = 0;
+#else
+	m_fileDescriptor = -1;
+#endif
+	m_pData = 0;
+	m_dataSize = 0;
+	m_pHeader = 0;
+	m_pIndexBlock = 0;
+	m_pCommands = 0;
+	m_writeFrame = 0;
+}
+
+Physics_ClothChannel::~Physics_ClothChannel()
+{
+	Release();
+}
+
+bool Physics_ClothChannel::Create(std::string _name, UINT _vertexCount, UINT _vertexStride, UINT _indexCount, UINT _slotCount, UINT _commandCapacity)
+{
+	if (_name.empty() == true || _vertexCount == 0 || _vertexStride == 0 || _slotCount < 2 || _commandCapacity == 0)
+	{
+		// Invalid layout, creation failed
+		return false;
+	}
+
+	// Lay out the header, frame slots, index block and command ring on cache line boundaries
+	size_t headerSize = AlignSize(sizeof(TClothChannelHeader));
+	size_t slotSize = AlignSize(sizeof(TClothFrameSlot) + (size_t)_vertexCount * _vertexStride);
+	size_t indexBlockSize = AlignSize(sizeof(TClothIndexBlock) + (size_t)_indexCount * sizeof(DWORD));
+	size_t commandsSize = (size_t)_commandCapacity * sizeof(TClothCommand);
+
+	m_name = _name;
+	m_owner = true;
+	if (Map(true, headerSize + (slotSize * _slotCount) + indexBlockSize + commandsSize) == false)
+	{
+		Release();
+		return false;
+	}
+
+	m_pHeader = (TClothChannelHeader*)m_pData;
+	m_pHeader->Version = CLOTH_CHANNEL_VERSION;
+	m_pHeader->VertexCount = _vertexCount;
+	m_pHeader->VertexStride = _vertexStride;
+	m_pHeader->IndexCount = _indexCount;
+	m_pHeader->SlotCount = _slotCount;
+	m_pHeader->SlotSize = (UINT)slotSize;
+	m_pHeader->CommandCapacity = _commandCapacity;
+	m_pHeader->PublishedFrame = -1;
+	m_pHeader->CommandHead = 0;
+	m_pHeader->CommandTail = 0;
+
+	m_pIndexBlock = (TClothIndexBlock*)(m_pData + headerSize + (slotSize * _slotCount));
+	m_pIndexBlock->Sequence = 0;
+	m_pIndexBlock->Version = 0;
+	m_pCommands = (TClothCommand*)((BYTE*)m_pIndexBlock + indexBlockSize);
+	m_writeFrame = 0;
+
+	// Write the magic last so a client never opens a half written header
+	CHANNEL_BARRIER();
+	memcpy(m_pHeader->Magic, "CLSH", 4);
+
+	return true;
+}
+
+bool Physics_ClothChannel::Open(std::string _name)
+{
+	if (_name.empty() == true)
+	{
+		return false;
+	}
+
+	m_name = _name;
+	m_owner = false;
+	if (Map(false, 0) == false)
+	{
+		Release();
+		return false;
+	}
+
+	// Validate the header against the mapped size
+	m_pHeader = (TClothChannelHeader*)m_pData;
+	size_t headerSize = AlignSize(sizeof(TClothChannelHeader));
+	if (m_dataSize < headerSize || memcmp(m_pHeader->Magic, "CLSH", 4) != 0 || m_pHeader->Version != CLOTH_CHANNEL_VERSION)
+	{
+		// Not a cloth channel or the server has not finished creating it
+		Release();
+		return false;
+	}
+	CHANNEL_BARRIER();
+
+	if (m_pHeader->SlotCount == 0 || m_pHeader->CommandCapacity == 0 || m_pHeader->VertexCount == 0 || m_pHeader->IndexCount == 0)
+	{
+		// Slots and commands are found by a modulo of their counts, and the client copies at least one vertex and index
+		Release();
+		return false;
+	}
+
+	if (m_pHeader->SlotSize < sizeof(TClothFrameSlot) + (size_t)m_pHeader->VertexCount * m_pHeader->VertexStride)
+	{
+		// A slot can not hold the frame it describes
+		Release();
+		return false;
+	}
+
+	size_t slotsSize = (size_t)m_pHeader->SlotSize * m_pHeader->SlotCount;
+	size_t indexBlockSize = AlignSize(sizeof(TClothIndexBlock) + (size_t)m_pHeader->IndexCount * sizeof(DWORD));
+	size_t commandsSize = (size_t)m_pHeader->CommandCapacity * sizeof(TClothCommand);
+	if (m_dataSize < headerSize + slotsSize + indexBlockSize + commandsSize)
+	{
+		// The mapping is too small for the layout it describes
+		Release();
+		return false;
+	}
+
+	m_pIndexBlock = (TClothIndexBlock*)(m_pData + headerSize + slotsSize);
+	m_pCommands = (TClothCommand*)((BYTE*)m_pIndexBlock + indexBlockSize);
+
+	return true;
+}
+
+BYTE* Physics_ClothChannel::BeginFrame(const float* _pOrigin)
+{
+	// Mark the slot as being written before touching its vertices
+	TClothFrameSlot* pSlot = GetSlot(m_writeFrame);
+	pSlot->Sequence++;
+	CHANNEL_BARRIER();
+	pSlot->FrameNumber = m_writeFrame;
+	memcpy(pSlot->Origin, _pOrigin, sizeof(pSlot->Origin));
+
+	return (BYTE*)pSlot + sizeof(TClothFrameSlot);
+}
+
+void Physics_ClothChannel::EndFrame()
+{
+	TClothFrameSlot* pSlot = GetSlot(m_writeFrame);
+	CHANNEL_BARRIER();
+	pSlot->Sequence++;
+
+	// Publish the frame only once its slot is complete
+	CHANNEL_BARRIER();
+	m_pHeader->PublishedFrame = (LONG)m_writeFrame;
+	m_writeFrame++;
+}
+
+const BYTE* Physics_ClothChannel::AcquireFrame(UINT& _prFrame, LONG& _prSequence, float* _pOrigin)
+{
+	LONG published = m_pHeader->PublishedFrame;
+	if (published < 0)
+	{
+		// The server has not published a frame yet
+		return 0;
+	}
+	CHANNEL_BARRIER();
+
+	TClothFrameSlot* pSlot = GetSlot((UINT)published);
+	LONG sequence = pSlot->Sequence;
+	CHANNEL_BARRIER();
+	if ((sequence & 1) != 0 || pSlot->FrameNumber != (UINT)published)
+	{
+		// The server has already lapped the ring and is rewriting this slot
+		return 0;
+	}
+
+	_prFrame = (UINT)published;
+	_prSequence = sequence;
+	memcpy(_pOrigin, pSlot->Origin, sizeof(pSlot->Origin));
+	return (const BYTE*)pSlot + sizeof(TClothFrameSlot);
+}
+
+bool Physics_ClothChannel::ValidateFrame(UINT _frame, LONG _sequence)
+{
+	CHANNEL_BARRIER();
+	return (GetSlot(_frame)->Sequence == _sequence);
+}
+
+void Physics_ClothChannel::WriteIndices(const DWORD* _pIndices, UINT _version)
+{
+	m_pIndexBlock->Sequence++;
+	CHANNEL_BARRIER();
+
+	memcpy((BYTE*)m_pIndexBlock + sizeof(TClothIndexBlock), _pIndices, m_pHeader->IndexCount * sizeof(DWORD));
+	m_pIndexBlock->Version = _version;
+
+	CHANNEL_BARRIER();
+	m_pIndexBlock->Sequence++;
+}
+
+const DWORD* Physics_ClothChannel::AcquireIndices(UINT& _prVersion, LONG& _prSequence)
+{
+	LONG sequence = m_pIndexBlock->Sequence;
+	CHANNEL_BARRIER();
+	if ((sequence & 1) != 0)
+	{
+		// The server is rewriting the indices
+		return 0;
+	}
+
+	_prVersion = m_pIndexBlock->Version;
+	_prSequence = sequence;
+	return (const DWORD*)((const BYTE*)m_pIndexBlock + sizeof(TClothIndexBlock));
+}
+
+bool Physics_ClothChannel::ValidateIndices(LONG _sequence)
+{
+	CHANNEL_BARRIER();
+	return (m_pIndexBlock->Sequence == _sequence);
+}
+
+bool Physics_ClothChannel::PushCommand(const TClothCommand& _command)
+{
+	UINT head = (UINT)m_pHeader->CommandHead;
+	UINT tail = (UINT)m_pHeader->CommandTail;
+	if (head - tail >= m_pHeader->CommandCapacity)
+	{
+		// The server has fallen behind and the ring is full
+		return false;
+	}
+
+	// Write the command before moving the head past it
+	m_pCommands[head % m_pHeader->CommandCapacity] = _command;
+	CHANNEL_BARRIER();
+	m_pHeader->CommandHead = (LONG)(head + 1);
+
+	return true;
+}
+
+bool Physics_ClothChannel::PopCommand(TClothCommand& _prCommand)
+{
+	UINT tail = (UINT)m_pHeader->CommandTail;
+	UINT head = (UINT)m_pHeader->CommandHead;
+	if (tail == head)
+	{
+		// No commands waiting
+		return false;
+	}
+	CHANNEL_BARRIER();
+
+	// Read the command before moving the tail past it so the client cannot overwrite it
+	_prCommand = m_pCommands[tail % m_pHeader->CommandCapacity];
+	CHANNEL_BARRIER();
+	m_pHeader->CommandTail = (LONG)(tail + 1);
+
+	return true;
+}
+
+void Physics_ClothChannel::Release()
+{
+#ifdef _WIN32
+	if (m_pData != 0)
+	{
+		UnmapViewOfFile(m_pData);
+	}
+	if (m_hMapping != 0)
+	{
+		// The name is removed once every process has closed its handle
+		CloseHandle(m_hMapping);
+		m_hMapping = 0;
+	}
+#else
+	if (m_pData != 0)
+	{
+		munmap(m_pData, m_dataSize);
+	}
+	if (m_fileDescriptor >= 0)
+	{
+		close(m_fileDescriptor);
+		m_fileDescriptor = -1;
+	}
+	if (m_owner == true && m_name.empty() == false)
+	{
+		// Remove the name so clients can no longer open it
+		shm_unlink(("/" + m_name).c_str());
+	}
+#endif
+
+	m_pData = 0;
+	m_dataSize = 0;
+	m_pHeader = 0;
+	m_pIndexBlock = 0;
+	m_pCommands = 0;
+	m_owner = false;
+}
+
+// Private Functions
+
+bool Physics_ClothChannel::Map(bool _create, size_t _size)
+{
+#ifdef _WIN32
+	std::string mappingName = "Local\\" + m_name;
+	if (_create == true)
+	{
+		// Back the mapping with the page file
+		m_hMapping = CreateFileMappingA(INVALID_HANDLE_VALUE, 0, PAGE_READWRITE, (DWORD)((unsigned __int64)_size >> 32), (DWORD)_size, mappingName.c_str());
+		if (m_hMapping != 0 && GetLastError() == ERROR_ALREADY_EXISTS)
+		{
+			// Another server owns this name
+			return false;
+		}
+	}
+	else
+	{
+		m_hMapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, mappingName.c_str());
+	}
+	if (m_hMapping == 0)
+	{
+		return false;
+	}
+
+	m_pData = (BYTE*)MapViewOfFile(m_hMapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+	if (m_pData == 0)
+	{
+		return false;
+	}
+
+	// The view covers the whole mapping
+	MEMORY_BASIC_INFORMATION info;
+	VirtualQuery(m_pData, &info, sizeof(info));
+	m_dataSize = (_create == true) ? _size : info.RegionSize;
+#else
+	std::string mappingName = "/" + m_name;
+	if (_create == true)
+	{
+		// Remove any mapping left behind by a server that did not shut down
+		shm_unlink(mappingName.c_str());
+		m_fileDescriptor = shm_open(mappingName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+		if (m_fileDescriptor < 0 || ftruncate(m_fileDescriptor, (off_t)_size) != 0)
+		{
+			return false;
+		}
+		m_dataSize = _size;
+	}
+	else
+	{
+		m_fileDescriptor = shm_open(mappingName.c_str(), O_RDWR, 0600);
+		struct stat fileInfo;
+		if (m_fileDescriptor < 0 || fstat(m_fileDescriptor, &fileInfo) != 0)
+		{
+			return false;
+		}
+		m_dataSize = (size_t)fileInfo.st_size;
+	}
+
+	void* pMapped = mmap(0, m_dataSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_fileDescriptor, 0);
+	if (pMapped == MAP_FAILED)
+	{
+		m_dataSize = 0;
+		return false;
+	}
+	m_pData = (BYTE*)pMapped;
+#endif
+
+	return true;
+}
+
+TClothFrameSlot* Physics_ClothChannel::GetSlot(UINT _frame)
+{
+	size_t headerSize = AlignSize(sizeof(TClothChannelHeader));
+	return (TClothFrameSlot*)(m_pData + headerSize + ((size_t)(_frame % m_pHeader->SlotCount) * m_pHeader->SlotSize));
+}
@@ -0,0 +1,274 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Physics_ClothChannel.h
+* Description : Shared memory ring of cloth vertex frames and commands between a simulation server and a client
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// Inclusion Guards
+#pragma once
+#ifndef __PHYSICS_CLOTHCHANNEL_H__
+#define __PHYSICS_CLOTHCHANNEL_H__
+
+// Library Includes
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <stdint.h>
+typedef uint32_t UINT;
+typedef uint32_t DWORD;
+typedef int32_t LONG;
+typedef unsigned char BYTE;
+#endif
+#include <string>
+
+// Enumerators
+/***********************
+* eClothCommand: Enum for the commands a client can send to the simulation server
+* @author: Callan Moore
+********************/
+enum eClothCommand
+{
+	CC_NONE,
+	CC_SETWIND,
+	CC_RELEASE,
+	CC_MOVEHOOKS,
+	CC_CUT,
+	CC_IGNITE,
+	CC_RESET,
+	CC_SHUTDOWN
+};
+
+/***********************
+* TClothCommand: A command sent from the client to the simulation server
+* @author: Callan Moore
+********************/
+struct TClothCommand
+{
+	UINT Type;
+
+	// Wind: Force xyz, force type. Rays: Origin xyz, direction xyz, radius. Move hooks: Closer if non zero
+	float Data[7];
+};
+
+/***********************
+* TClothChannelHeader: Header at the start of the shared memory. The frame slots, the index block and the command ring follow it
+* @author: Callan Moore
+********************/
+struct TClothChannelHeader
+{
+	char Magic[4];
+	UINT Version;
+	UINT VertexCount;
+	UINT VertexStride;
+	UINT IndexCount;
+	UINT SlotCount;
+	UINT SlotSize;
+	UINT CommandCapacity;
+
+	// Number of the last frame completely written by the server. -1 before the first frame
+	volatile LONG PublishedFrame;
+
+	// Command ring positions. The head is only written by the client and the tail only by the server
+	volatile LONG CommandHead;
+	volatile LONG CommandTail;
+};
+
+/***********************
+* TClothFrameSlot: Header of a frame slot in the ring. The vertices of the frame follow it
+* @author: Callan Moore
+********************/
+struct TClothFrameSlot
+{
+	// Odd while the server is writing the slot
+	volatile LONG Sequence;
+	UINT FrameNumber;
+
+	// The point the packed positions of the frame are relative to
+	float Origin[3];
+};
+
+/***********************
+* TClothIndexBlock: Header of the index block. The indices follow it and are only rewritten when constraints break
+* @author: Callan Moore
+********************/
+struct TClothIndexBlock
+{
+	// Odd while the server is writing the indices
+	volatile LONG Sequence;
+	UINT Version;
+};
+
+class Physics_ClothChannel
+{
+public:
+	/***********************
+	* Physics_ClothChannel: Default Constructor for Physics Cloth Channel class
+	* @author: Callan Moore
+	********************/
+	Physics_ClothChannel();
+
+	/***********************
+	* ~Physics_ClothChannel: Default Destructor for Physics Cloth Channel class
+	* @author: Callan Moore
+	********************/
+	~Physics_ClothChannel();
+
+	/***********************
+	* Create: Create the named shared memory as the server
+	* @author: Callan Moore
+	* @parameter: _name: The name of the channel
+	* @parameter: _vertexCount: The number of vertices in each frame
+	* @parameter: _vertexStride: The size in bytes of each vertex
+	* @parameter: _indexCount: The number of indices
+	* @parameter: _slotCount: The number of frames in the ring
+	* @parameter: _commandCapacity: The number of commands the command ring can hold
+	* @return: bool: Successful or not
+	********************/
+	bool Create(std::string _name, UINT _vertexCount, UINT _vertexStride, UINT _indexCount, UINT _slotCount = 4, UINT _commandCapacity = 64);
+
+	/***********************
+	* Open: Open the named shared memory created by a server as the client
+	* @author: Callan Moore
+	* @parameter: _name: The name of the channel
+	* @return: bool: Successful or not
+	********************/
+	bool Open(std::string _name);
+
+	/***********************
+	* BeginFrame: Start writing the next frame slot. Server only
+	* @author: Callan Moore
+	* @parameter: _pOrigin: The three coordinates of the point the packed positions of the frame are relative to
+	* @return: BYTE*: The vertices of the slot to write into
+	********************/
+	BYTE* BeginFrame(const float* _pOrigin);
+
+	/***********************
+	* EndFrame: Finish writing the frame slot and publish it. Server only
+	* @author: Callan Moore
+	* @return: void
+	********************/
+	void EndFrame();
+
+	/***********************
+	* AcquireFrame: Retrieve the vertices of the newest published frame without copying them. Client only
+	* @author: Callan Moore
+	* @parameter: _prFrame: Storage for the frame number
+	* @parameter: _prSequence: Storage for the sequence to validate the read with
+	* @parameter: _pOrigin: Storage for the three coordinates of the point the packed positions are relative to
+	* @return: const BYTE*: The vertices of the frame. NULL if nothing is published or the slot is being written
+	********************/
+	const BYTE* AcquireFrame(UINT& _prFrame, LONG& _prSequence, float* _pOrigin);
+
+	/***********************
+	* ValidateFrame: Check the server did not overwrite a frame while it was being read. Client only
+	* @author: Callan Moore
+	* @parameter: _frame: The frame number from AcquireFrame
+	* @parameter: _sequence: The sequence from AcquireFrame
+	* @return: bool: True if the data read was consistent
+	********************/
+	bool ValidateFrame(UINT _frame, LONG _sequence);
+
+	/***********************
+	* WriteIndices: Write a new version of the indices. Server only
+	* @author: Callan Moore
+	* @parameter: _pIndices: The indices to copy
+	* @parameter: _version: The version of the indices
+	* @return: void
+	********************/
+	void WriteIndices(const DWORD* _pIndices, UINT _version);
+
+	/***********************
+	* AcquireIndices: Retrieve the indices without copying them. Client only
+	* @author: Callan Moore
+	* @parameter: _prVersion: Storage for the version of the indices
+	* @parameter: _prSequence: Storage for the sequence to validate the read with
+	* @return: const DWORD*: The indices. NULL if they are being written
+	********************/
+	const DWORD* AcquireIndices(UINT& _prVersion, LONG& _prSequence);
+
+	/***********************
+	* ValidateIndices: Check the server did not rewrite the indices while they were being read. Client only
+	* @author: Callan Moore
+	* @parameter: _sequence: The sequence from AcquireIndices
+	* @return: bool: True if the data read was consistent
+	********************/
+	bool ValidateIndices(LONG _sequence);
+
+	/***********************
+	* PushCommand: Add a command to the command ring. Client only
+	* @author: Callan Moore
+	* @parameter: _command: The command to send
+	* @return: bool: False if the ring is full
+	********************/
+	bool PushCommand(const TClothCommand& _command);
+
+	/***********************
+	* PopCommand: Remove the oldest command from the command ring. Server only
+	* @author: Callan Moore
+	* @parameter: _prCommand: Storage for the command
+	* @return: bool: False if the ring is empty
+	********************/
+	bool PopCommand(TClothCommand& _prCommand);
+
+	/***********************
+	* GetHeader: Retrieve the header of the shared memory
+	* @author: Callan Moore
+	* @return: TClothChannelHeader*: The header. NULL if not created or opened
+	********************/
+	TClothChannelHeader* GetHeader() { return m_pHeader; };
+
+	/***********************
+	* Release: Unmap the shared memory. The server also removes the name
+	* @author: Callan Moore
+	* @return: void
+	********************/
+	void Release();
+
+private:
+
+	/***********************
+	* Map: Create or open the named shared memory and map it
+	* @author: Callan Moore
+	* @parameter: _create: True to create the shared memory
+	* @parameter: _size: The size to create. Ignored when opening
+	* @return: bool: Successful or not
+	********************/
+	bool Map(bool _create, size_t _size);
+
+	/***********************
+	* GetSlot: Retrieve a frame slot
+	* @author: Callan Moore
+	* @parameter: _frame: The frame number to find the slot of
+	* @return: TClothFrameSlot*: The slot
+	********************/
+	TClothFrameSlot* GetSlot(UINT _frame);
+
+private:
+	std::string m_name;
+	bool m_owner;
+
+#ifdef _WIN32
+	HANDLE m_hMapping;
+#else
+	int m_fileDescriptor;
+#endif
+	BYTE* m_pData;
+	size_t m_dataSize;
+
+	TClothChannelHeader* m_pHeader;
+	TClothIndexBlock* m_pIndexBlock;
+	TClothCommand* m_pCommands;
+
+	// Frame the server is writing
+	UINT m_writeFrame;
+};
+
+#endif	// __PHYSICS_CLOTHCHANNEL_H__
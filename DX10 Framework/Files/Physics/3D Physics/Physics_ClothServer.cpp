@@ -0,0 +1,376 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Physics_ClothServer.cpp
+* Description : Runs cloth simulation in a separate process and renders its frames in the client through shared memory
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// This Include
+#include "Physics_ClothServer.h"
+
+// Defines
+// Attempts to copy a frame or the indices into the mesh buffer before giving up on it until the next frame
+#define CLOTH_CLIENT_COPY_ATTEMPTS 3
+
+Physics_ClothServer::Physics_ClothServer()
+{
+	// Initialise pointers to NULL
+	m_pCloth = 0;
+}
+
+Physics_ClothServer::~Physics_ClothServer()
+{
+}
+
+bool Physics_ClothServer::Run(std::string _channelName, int _width, int _height, eCollisionType _collisionType)
+{
+	// Create the cloth without a renderer so it only simulates
+	Physics_Cloth* pCloth = new Physics_Cloth();
+	Physics_ClothServer* pServer = new Physics_ClothServer();
+	if (pCloth->Initialise(0, 0, _width, _height) == false || pServer->Initialise(pCloth, _channelName) == false)
+	{
+		ReleasePtr(pServer);
+		ReleasePtr(pCloth);
+		return false;
+	}
+
+	__int64 ticksPerSec;
+	__int64 lastTime;
+	QueryPerformanceFrequency((LARGE_INTEGER*)&ticksPerSec);
+	QueryPerformanceCounter((LARGE_INTEGER*)&lastTime);
+	__int64 ticksPerStep = (__int64)(pCloth->GetTimeStep() * ticksPerSec);
+
+	// Step the cloth at its own time step until the client shuts the server down
+	while (pServer->Process(_collisionType) == true)
+	{
+		__int64 currentTime;
+		QueryPerformanceCounter((LARGE_INTEGER*)&currentTime);
+
+		__int64 remainingTicks = ticksPerStep - (currentTime - lastTime);
+		if (remainingTicks > 0)
+		{
+			Sleep((DWORD)((remainingTicks * 1000) / ticksPerSec));
+		}
+		QueryPerformanceCounter((LARGE_INTEGER*)&lastTime);
+	}
+
+	ReleasePtr(pServer);
+	ReleasePtr(pCloth);
+	return true;
+}
+
+bool Physics_ClothServer::Initialise(Physics_Cloth* _pCloth, std::string _channelName, UINT _slotCount)
+{
+	if (_pCloth == 0)
+	{
+		// Nothing to simulate, initialization failed
+		return false;
+	}
+
+	// Assign member variables
+	m_pCloth = _pCloth;
+	m_wind = { 0.0f, 0.0f, 0.0f };
+	m_windType = FT_WIND;
+
+	// The frames are stored in the same compact format the client uploads to the GPU
+	VALIDATE(m_channel.Create(_channelName, (UINT)m_pCloth->GetParticleCount(), sizeof(TVertexHalfColor), (UINT)m_pCloth->GetIndexCount(), _slotCount));
+
+	// Publish the starting state so the client has a frame as soon as it connects
+	m_channel.WriteIndices(m_pCloth->GetIndices(), m_pCloth->GetIndicesVersion());
+	m_publishedIndicesVersion = m_pCloth->GetIndicesVersion();
+	Publish();
+
+	return true;
+}
+
+bool Physics_ClothServer::Process(eCollisionType _collisionType)
+{
+	// Run the commands the client sent since the last step
+	TClothCommand command;
+	while (m_channel.PopCommand(command) == true)
+	{
+		if (ExecuteCommand(command) == false)
+		{
+			return false;
+		}
+	}
+
+	if ((m_wind == v3float(0.0f, 0.0f, 0.0f)) == false)
+	{
+		m_pCloth->AddForce(m_wind, m_windType, false);
+	}
+
+	m_pCloth->Process(_collisionType);
+	Publish();
+
+	return true;
+}
+
+// Private Functions
+
+bool Physics_ClothServer::ExecuteCommand(TClothCommand& _command)
+{
+	TCameraRay camRay;
+	camRay.Origin = { _command.Data[0], _command.Data[1], _command.Data[2] };
+	camRay.Direction = { _command.Data[3], _command.Data[4], _command.Data[5] };
+
+	switch (_command.Type)
+	{
+		case CC_SETWIND:
+		{
+			m_wind = { _command.Data[0], _command.Data[1], _command.Data[2] };
+			m_windType = (eForceType)(int)_command.Data[3];
+		}
+		break;
+		case CC_RELEASE:
+		{
+			m_pCloth->ReleaseCloth();
+		}
+		break;
+		case CC_MOVEHOOKS:
+		{
+			m_pCloth->MoveHooks(_command.Data[0] != 0.0f);
+		}
+		break;
+		case CC_CUT:
+		{
+			m_pCloth->Cut(camRay, _command.Data[6]);
+		}
+		break;
+		case CC_IGNITE:
+		{
+			m_pCloth->Ignite(camRay, _command.Data[6]);
+		}
+		break;
+		case CC_RESET:
+		{
+			m_pCloth->ResetCloth();
+		}
+		break;
+		case CC_SHUTDOWN:
+		{
+			return false;
+		}
+		break;
+		default: break;
+	}	// End Switch
+
+	return true;
+}
+
+void Physics_ClothServer::Publish()
+{
+	if (m_pCloth->GetIndicesVersion() != m_publishedIndicesVersion)
+	{
+		// Constraints were made or broken
+		m_channel.WriteIndices(m_pCloth->GetIndices(), m_pCloth->GetIndicesVersion());
+		m_publishedIndicesVersion = m_pCloth->GetIndicesVersion();
+	}
+
+	// Pack the vertices straight into the slot the client will upload from, relative to the centre of the cloth
+	TVertexColor* pVertices = m_pCloth->GetVertices();
+	D3DXVECTOR3 origin = CalcPackOrigin(pVertices, m_pCloth->GetParticleCount());
+	TVertexHalfColor* pPacked = (TVertexHalfColor*)m_channel.BeginFrame((float*)&origin);
+	for (int i = 0; i < m_pCloth->GetParticleCount(); i++)
+	{
+		PackVertexHalfColor(pVertices[i], origin, pPacked[i]);
+	}
+	m_channel.EndFrame();
+}
+
+Physics_ClothClient::Physics_ClothClient()
+{
+	// Initialise pointers to NULL
+	m_pMesh = 0;
+}
+
+Physics_ClothClient::~Physics_ClothClient()
+{
+	ReleasePtr(m_pMesh);
+}
+
+bool Physics_ClothClient::Initialise(DX10_Renderer* _pRenderer, std::string _channelName)
+{
+	if (_pRenderer == 0)
+	{
+		// Pointer is NULL, initialization failed
+		return false;
+	}
+
+	VALIDATE(m_channel.Open(_channelName));
+
+	TClothChannelHeader* pHeader = m_channel.GetHeader();
+	if (pHeader->VertexStride != sizeof(TVertexHalfColor))
+	{
+		// The server publishes a different vertex format
+		return false;
+	}
+
+	// The mesh is written directly from the shared memory
+	m_pMesh = new DX10_Mesh();
+	VALIDATE(m_pMesh->InitialisePacked(_pRenderer, pHeader->VertexCount, pHeader->IndexCount, D3D10_PRIMITIVE_TOPOLOGY_LINELIST));
+
+	m_hasFrame = false;
+	m_hasIndices = false;
+	m_uploadedFrame = 0;
+	m_uploadedIndicesVersion = 0;
+
+	return true;
+}
+
+bool Physics_ClothClient::Process()
+{
+	UploadIndices();
+
+	UINT frame;
+	LONG sequence;
+	D3DXVECTOR3 origin;
+	const BYTE* pVertices = m_channel.AcquireFrame(frame, sequence, (float*)&origin);
+	if (pVertices == 0 || (m_hasFrame == true && frame == m_uploadedFrame))
+	{
+		// No new frame has been published
+		return false;
+	}
+
+	// Copy straight from the shared memory into the GPU buffer. If the server overwrote the slot during the copy, copy the newest frame over it
+	size_t frameSize = (size_t)m_channel.GetHeader()->VertexCount * sizeof(TVertexHalfColor);
+	void* pDestination = m_pMesh->MapVertexBuffer();
+	bool validated = false;
+	for (int i = 0; i < CLOTH_CLIENT_COPY_ATTEMPTS && pVertices != 0; i++)
+	{
+		memcpy(pDestination, pVertices, frameSize);
+		validated = m_channel.ValidateFrame(frame, sequence);
+		if (validated == true)
+		{
+			break;
+		}
+
+		// Stops when the newest slot is being rewritten rather than copying a stale one again
+		pVertices = m_channel.AcquireFrame(frame, sequence, (float*)&origin);
+	}
+	m_pMesh->UnmapVertexBuffer();
+
+	if (validated == false)
+	{
+		// The previous frame was discarded when the buffer was mapped. Hide the torn frame and try again next frame
+		m_hasFrame = false;
+		return false;
+	}
+	m_pMesh->SetPackOrigin(origin);
+
+	m_hasFrame = true;
+	m_uploadedFrame = frame;
+	return true;
+}
+
+void Physics_ClothClient::Render(DX10_Shader_Cloth* _pShader, D3DXMATRIX* _pMatWorld)
+{
+	if (m_hasFrame == false || m_hasIndices == false)
+	{
+		// Nothing whole has been uploaded yet
+		return;
+	}
+
+	// Create the struct to hold the cloth rendering variables
+	TCloth cloth;
+	cloth.pMatWorld = _pMatWorld;
+	cloth.pMesh = m_pMesh;
+
+	// Render the cloth
+	_pShader->Render(cloth);
+}
+
+bool Physics_ClothClient::SetWind(v3float _force, eForceType _forceType)
+{
+	float data[4] = { _force.x, _force.y, _force.z, (float)_forceType };
+	return SendCommand(CC_SETWIND, data, 4);
+}
+
+bool Physics_ClothClient::ReleaseCloth()
+{
+	return SendCommand(CC_RELEASE);
+}
+
+bool Physics_ClothClient::MoveHooks(bool _closer)
+{
+	float data[1] = { (_closer == true) ? 1.0f : 0.0f };
+	return SendCommand(CC_MOVEHOOKS, data, 1);
+}
+
+bool Physics_ClothClient::Cut(TCameraRay _camRay, float _selectRadius)
+{
+	float data[7] = { _camRay.Origin.x, _camRay.Origin.y, _camRay.Origin.z, _camRay.Direction.x, _camRay.Direction.y, _camRay.Direction.z, _selectRadius };
+	return SendCommand(CC_CUT, data, 7);
+}
+
+bool Physics_ClothClient::Ignite(TCameraRay _camRay, float _selectRadius)
+{
+	float data[7] = { _camRay.Origin.x, _camRay.Origin.y, _camRay.Origin.z, _camRay.Direction.x, _camRay.Direction.y, _camRay.Direction.z, _selectRadius };
+	return SendCommand(CC_IGNITE, data, 7);
+}
+
+bool Physics_ClothClient::ResetCloth()
+{
+	return SendCommand(CC_RESET);
+}
+
+bool Physics_ClothClient::Shutdown()
+{
+	return SendCommand(CC_SHUTDOWN);
+}
+
+// Private Functions
+
+bool Physics_ClothClient::SendCommand(eClothCommand _type, const float* _pData, int _dataCount)
+{
+	TClothCommand command;
+	memset(&command, 0, sizeof(TClothCommand));
+	command.Type = _type;
+	for (int i = 0; i < _dataCount && i < 7; i++)
+	{
+		command.Data[i] = _pData[i];
+	}
+
+	return m_channel.PushCommand(command);
+}
+
+void Physics_ClothClient::UploadIndices()
+{
+	UINT version;
+	LONG sequence;
+	const DWORD* pIndices = m_channel.AcquireIndices(version, sequence);
+	if (pIndices == 0 || (m_hasIndices == true && version == m_uploadedIndicesVersion))
+	{
+		// Unchanged or being rewritten. Try again next frame
+		return;
+	}
+
+	// Copy straight from the shared memory into the GPU buffer, copying again if the server rewrote the indices during the copy
+	size_t indicesSize = (size_t)m_channel.GetHeader()->IndexCount * sizeof(DWORD);
+	void* pDestination = m_pMesh->MapIndexBuffer();
+	bool validated = false;
+	for (int i = 0; i < CLOTH_CLIENT_COPY_ATTEMPTS && pIndices != 0; i++)
+	{
+		memcpy(pDestination, pIndices, indicesSize);
+		validated = m_channel.ValidateIndices(sequence);
+		if (validated == true)
+		{
+			break;
+		}
+
+		// Stops when the indices are being rewritten rather than copying the same torn indices again
+		pIndices = m_channel.AcquireIndices(version, sequence);
+	}
+	m_pMesh->UnmapIndexBuffer();
+
+	// The previous indices were discarded when the buffer was mapped, so torn indices hide the cloth until they are uploaded whole
+	m_hasIndices = validated;
+	m_uploadedIndicesVersion = version;
+}
@@ -0,0 +1,222 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Physics_ClothServer.h
+* Description : Runs cloth simulation in a separate process and renders its frames in the client through shared memory
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// Inclusion Guards
+#pragma once
+#ifndef __PHYSICS_CLOTHSERVER_H__
+#define __PHYSICS_CLOTHSERVER_H__
+
+// Local Includes
+#include "Physics_Cloth.h"
+#include "Physics_ClothChannel.h"
+
+class Physics_ClothServer
+{
+public:
+	/***********************
+	* Physics_ClothServer: Default Constructor for Physics Cloth Server class
+	* @author: Callan Moore
+	********************/
+	Physics_ClothServer();
+
+	/***********************
+	* ~Physics_ClothServer: Default Destructor for Physics Cloth Server class
+	* @author: Callan Moore
+	********************/
+	~Physics_ClothServer();
+
+	/***********************
+	* Run: Simulate a headless cloth and publish its frames until a client sends the shutdown command
+	* @author: Callan Moore
+	* @parameter: _channelName: The name of the shared memory channel to create
+	* @parameter: _width: The number of particles across the cloth
+	* @parameter: _height: The number of particles down the cloth
+	* @parameter: _collisionType: The type of object the cloth collides with
+	* @return: bool: Successful or not
+	********************/
+	static bool Run(std::string _channelName, int _width, int _height, eCollisionType _collisionType);
+
+	/***********************
+	* Initialise: Create the channel for a cloth and publish its first frame
+	* @author: Callan Moore
+	* @parameter: _pCloth: The cloth to simulate. Should be headless
+	* @parameter: _channelName: The name of the shared memory channel to create
+	* @parameter: _slotCount: The number of frames in the ring
+	* @return: bool: Successful or not
+	********************/
+	bool Initialise(Physics_Cloth* _pCloth, std::string _channelName, UINT _slotCount = 4);
+
+	/***********************
+	* Process: Run the waiting commands, step the cloth and publish the frame
+	* @author: Callan Moore
+	* @parameter: _collisionType: The type of object the cloth collides with
+	* @return: bool: False once the shutdown command is received
+	********************/
+	bool Process(eCollisionType _collisionType);
+
+private:
+
+	/***********************
+	* ExecuteCommand: Apply a command from the client to the cloth
+	* @author: Callan Moore
+	* @parameter: _command: The command to apply
+	* @return: bool: False if the command was to shut down
+	********************/
+	bool ExecuteCommand(TClothCommand& _command);
+
+	/***********************
+	* Publish: Pack the cloth vertices straight into the next frame slot and write the indices if they changed
+	* @author: Callan Moore
+	* @return: void
+	********************/
+	void Publish();
+
+private:
+	Physics_Cloth* m_pCloth;
+	Physics_ClothChannel m_channel;
+	UINT m_publishedIndicesVersion;
+
+	// Wind stays applied until the client changes it
+	v3float m_wind;
+	eForceType m_windType;
+};
+
+class Physics_ClothClient
+{
+public:
+	/***********************
+	* Physics_ClothClient: Default Constructor for Physics Cloth Client class
+	* @author: Callan Moore
+	********************/
+	Physics_ClothClient();
+
+	/***********************
+	* ~Physics_ClothClient: Default Destructor for Physics Cloth Client class
+	* @author: Callan Moore
+	********************/
+	~Physics_ClothClient();
+
+	/***********************
+	* Initialise: Open the channel of a running server and create the mesh to render its frames
+	* @author: Callan Moore
+	* @parameter: _pRenderer: The renderer for the mesh
+	* @parameter: _channelName: The name of the shared memory channel to open
+	* @return: bool: Successful or not
+	********************/
+	bool Initialise(DX10_Renderer* _pRenderer, std::string _channelName);
+
+	/***********************
+	* Process: Copy the newest published frame straight into the mesh buffer. If the server overwrote it during every copy
+	*	attempt the buffer is torn, so the cloth is hidden until a whole frame is uploaded
+	* @author: Callan Moore
+	* @return: bool: True if a new frame was uploaded
+	********************/
+	bool Process();
+
+	/***********************
+	* Render: Render the last uploaded frame
+	* @author: Callan Moore
+	* @parameter: _pShader: The cloth shader to render with
+	* @parameter: _pMatWorld: The world matrix of the cloth
+	* @return: void
+	********************/
+	void Render(DX10_Shader_Cloth* _pShader, D3DXMATRIX* _pMatWorld);
+
+	/***********************
+	* SetWind: Set the wind the server applies every step
+	* @author: Callan Moore
+	* @parameter: _force: The force of the wind. Zero to stop it
+	* @parameter: _forceType: The type of the force
+	* @return: bool: False if the command ring is full
+	********************/
+	bool SetWind(v3float _force, eForceType _forceType);
+
+	/***********************
+	* ReleaseCloth: Release the cloth from its hooks
+	* @author: Callan Moore
+	* @return: bool: False if the command ring is full
+	********************/
+	bool ReleaseCloth();
+
+	/***********************
+	* MoveHooks: Move the hooks of the cloth
+	* @author: Callan Moore
+	* @parameter: _closer: Move the hooks closer together or further apart
+	* @return: bool: False if the command ring is full
+	********************/
+	bool MoveHooks(bool _closer);
+
+	/***********************
+	* Cut: Cut the cloth where the ray passes through it
+	* @author: Callan Moore
+	* @parameter: _camRay: The ray from the camera
+	* @parameter: _selectRadius: The radius around the ray to cut
+	* @return: bool: False if the command ring is full
+	********************/
+	bool Cut(TCameraRay _camRay, float _selectRadius);
+
+	/***********************
+	* Ignite: Ignite the cloth where the ray passes through it
+	* @author: Callan Moore
+	* @parameter: _camRay: The ray from the camera
+	* @parameter: _selectRadius: The radius around the ray to ignite
+	* @return: bool: False if the command ring is full
+	********************/
+	bool Ignite(TCameraRay _camRay, float _selectRadius);
+
+	/***********************
+	* ResetCloth: Reset the cloth to its starting state
+	* @author: Callan Moore
+	* @return: bool: False if the command ring is full
+	********************/
+	bool ResetCloth();
+
+	/***********************
+	* Shutdown: Tell the server to stop
+	* @author: Callan Moore
+	* @return: bool: False if the command ring is full
+	********************/
+	bool Shutdown();
+
+private:
+
+	/***********************
+	* SendCommand: Send a command to the server
+	* @author: Callan Moore
+	* @parameter: _type: The type of command
+	* @parameter: _pData: The data of the command. Can be NULL
+	* @parameter: _dataCount: The number of floats of data
+	* @return: bool: False if the command ring is full
+	********************/
+	bool SendCommand(eClothCommand _type, const float* _pData = 0, int _dataCount = 0);
+
+	/***********************
+	* UploadIndices: Copy the indices straight into the mesh buffer if the server has changed them. Torn indices hide the cloth
+	*	until they are uploaded whole
+	* @author: Callan Moore
+	* @return: void
+	********************/
+	void UploadIndices();
+
+private:
+	Physics_ClothChannel m_channel;
+	DX10_Mesh* m_pMesh;
+
+	bool m_hasFrame;
+	bool m_hasIndices;
+	UINT m_uploadedFrame;
+	UINT m_uploadedIndicesVersion;
+};
+
+#endif	// __PHYSICS_CLOTHSERVER_H__
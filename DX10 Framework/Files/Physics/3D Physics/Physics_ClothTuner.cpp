@@ -0,0 +1,173 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Physics_ClothTuner.cpp
+* Description : Adjusts the quality of a cloth to keep its processing time within a frame budget
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// This Include
+#include "Physics_ClothTuner.h"
+
+Physics_ClothTuner::Physics_ClothTuner()
+{
+	// Initialise pointers to NULL
+	m_pCloth = 0;
+}
+
+Physics_ClothTuner::~Physics_ClothTuner()
+{
+}
+
+bool Physics_ClothTuner::Initialise(Physics_Cloth* _pCloth, float _budget, TClothQuality _lowest, TClothQuality _highest, int _levels)
+{
+	if (_pCloth == 0 || _budget <= 0.0f)
+	{
+		// Nothing to tune, initialization failed
+		return false;
+	}
+
+	// Assign member variables
+	m_pCloth = _pCloth;
+	m_lowest = _lowest;
+	m_highest = _highest;
+	m_levels = max(_levels, 1);
+	m_pinned = false;
+
+	__int64 ticksPerSec;
+	QueryPerformanceFrequency((LARGE_INTEGER*)&ticksPerSec);
+	m_millisecondsPerTick = 1000.0 / (double)ticksPerSec;
+	m_smoothing = 0.1f;
+
+	// Lower the quality quickly when over budget but only raise it after a long stretch well under budget
+	m_lowerThreshold = 0.7f;
+	m_framesToLower = 10;
+	m_framesToRaise = 60;
+	m_maxRaiseBackoff = 16;
+	m_cooldownFrames = 30;
+
+	SetBudget(_budget);
+
+	// Start in the middle of the range and let the measurements move it
+	SetLevel((m_levels - 1) / 2);
+
+	return true;
+}
+
+void Physics_ClothTuner::Process(eCollisionType _collisionType)
+{
+	// Measure the cost of processing the cloth
+	__int64 startTime;
+	__int64 endTime;
+	QueryPerformanceCounter((LARGE_INTEGER*)&startTime);
+	m_pCloth->Process(_collisionType);
+	QueryPerformanceCounter((LARGE_INTEGER*)&endTime);
+
+	float cost = (float)((endTime - startTime) * m_millisecondsPerTick);
+
+	// Smooth the cost so single slow frames do not change the quality
+	if (m_averageCost < 0.0f)
+	{
+		m_averageCost = cost;
+	}
+	else
+	{
+		m_averageCost += (cost - m_averageCost) * m_smoothing;
+	}
+
+	m_framesSinceRaise++;
+	if (m_framesSinceRaise >= m_framesToRaise * m_maxRaiseBackoff)
+	{
+		// The last raise has held for a long time so allow raising at the normal rate again
+		m_raiseBackoff = 1;
+	}
+
+	if (m_pinned == true)
+	{
+		// Quality is fixed
+		return;
+	}
+
+	if (m_cooldown > 0)
+	{
+		// Give the average time to settle after the last change
+		m_cooldown--;
+		return;
+	}
+
+	// Count how long the cost has been outside the band between the lower threshold and the budget
+	if (m_averageCost > m_budget)
+	{
+		m_overFrames++;
+		m_underFrames = 0;
+	}
+	else if (m_averageCost < m_budget * m_lowerThreshold)
+	{
+		m_underFrames++;
+		m_overFrames = 0;
+	}
+	else
+	{
+		m_overFrames = 0;
+		m_underFrames = 0;
+	}
+
+	if (m_overFrames >= m_framesToLower && m_level > 0)
+	{
+		if (m_framesSinceRaise < m_framesToRaise * m_raiseBackoff)
+		{
+			// The last raise went over budget. Wait longer before trying it again
+			m_raiseBackoff = min(m_raiseBackoff * 2, m_maxRaiseBackoff);
+		}
+		SetLevel(m_level - 1);
+	}
+	else if (m_underFrames >= m_framesToRaise * m_raiseBackoff && m_level < m_levels - 1)
+	{
+		SetLevel(m_level + 1);
+		m_framesSinceRaise = 0;
+	}
+}
+
+void Physics_ClothTuner::SetBudget(float _budget)
+{
+	m_budget = _budget;
+
+	// Start measuring again against the new budget
+	m_averageCost = -1.0f;
+	m_overFrames = 0;
+	m_underFrames = 0;
+	m_raiseBackoff = 1;
+	m_cooldown = 0;
+	m_framesSinceRaise = 0;
+}
+
+void Physics_ClothTuner::SetLevel(int _level)
+{
+	m_level = min(max(_level, 0), m_levels - 1);
+	m_pCloth->SetQuality(CalcQuality(m_level));
+
+	// Wait for the cost of the new level to be measured before changing again
+	m_overFrames = 0;
+	m_underFrames = 0;
+	m_cooldown = m_cooldownFrames;
+}
+
+TClothQuality Physics_ClothTuner::CalcQuality(int _level)
+{
+	// Interpolate every setting between the lowest and highest quality
+	float ratio = (m_levels > 1) ? ((float)_level / (float)(m_levels - 1)) : 1.0f;
+
+	TClothQuality quality;
+	quality.ConstraintIterations = (int)round(m_lowest.ConstraintIterations + (m_highest.ConstraintIterations - m_lowest.ConstraintIterations) * ratio);
+	quality.Substeps = (int)round(m_lowest.Substeps + (m_highest.Substeps - m_lowest.Substeps) * ratio);
+	quality.SelfCollisionInterval = (int)round(m_lowest.SelfCollisionInterval + (m_highest.SelfCollisionInterval - m_lowest.SelfCollisionInterval) * ratio);
+	quality.SleepVelocity = m_lowest.SleepVelocity + (m_highest.SleepVelocity - m_lowest.SleepVelocity) * ratio;
+
+	return quality;
+}
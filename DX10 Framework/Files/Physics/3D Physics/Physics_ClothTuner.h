@@ -0,0 +1,148 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Physics_ClothTuner.h
+* Description : Adjusts the quality of a cloth to keep its processing time within a frame budget
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// Inclusion Guards
+#pragma once
+#ifndef __PHYSICS_CLOTHTUNER_H__
+#define __PHYSICS_CLOTHTUNER_H__
+
+// Local Includes
+#include "Physics_Cloth.h"
+
+class Physics_ClothTuner
+{
+public:
+	/***********************
+	* Physics_ClothTuner: Default Constructor for Physics Cloth Tuner class
+	* @author: Callan Moore
+	********************/
+	Physics_ClothTuner();
+
+	/***********************
+	* ~Physics_ClothTuner: Default Destructor for Physics Cloth Tuner class
+	* @author: Callan Moore
+	********************/
+	~Physics_ClothTuner();
+
+	/***********************
+	* Initialise: Initialise the tuner for a cloth
+	* @author: Callan Moore
+	* @parameter: _pCloth: The cloth to tune
+	* @parameter: _budget: The time in milliseconds the cloth may take each frame
+	* @parameter: _lowest: The quality settings used when the cloth is furthest over budget
+	* @parameter: _highest: The quality settings used when there is spare time
+	* @parameter: _levels: The number of quality levels between the lowest and highest settings
+	* @return: bool: Successful or not
+	********************/
+	bool Initialise(Physics_Cloth* _pCloth, float _budget, TClothQuality _lowest, TClothQuality _highest, int _levels = 8);
+
+	/***********************
+	* Process: Process the cloth, measure how long it took and adjust the quality if needed
+	* @author: Callan Moore
+	* @parameter: _collisionType: The type of object the cloth collides with
+	* @return: void
+	********************/
+	void Process(eCollisionType _collisionType);
+
+	/***********************
+	* SetBudget: Set the time in milliseconds the cloth may take each frame
+	* @author: Callan Moore
+	* @parameter: _budget: The budget in milliseconds
+	* @return: void
+	********************/
+	void SetBudget(float _budget);
+
+	/***********************
+	* SetPinned: Pin the quality at the current level so it is no longer adjusted
+	* @author: Callan Moore
+	* @parameter: _pinned: True to stop adjusting the quality
+	* @return: void
+	********************/
+	void SetPinned(bool _pinned) { m_pinned = _pinned; };
+
+	/***********************
+	* GetPinned: Retrieve whether the quality is pinned
+	* @author: Callan Moore
+	* @return: bool: True if the quality is pinned
+	********************/
+	bool GetPinned() { return m_pinned; };
+
+	/***********************
+	* SetLevel: Set the quality level and apply its settings to the cloth
+	* @author: Callan Moore
+	* @parameter: _level: The quality level. 0 is the lowest quality
+	* @return: void
+	********************/
+	void SetLevel(int _level);
+
+	/***********************
+	* GetLevel: Retrieve the current quality level
+	* @author: Callan Moore
+	* @return: int: The quality level
+	********************/
+	int GetLevel() { return m_level; };
+
+	/***********************
+	* GetQuality: Retrieve the quality settings currently applied to the cloth
+	* @author: Callan Moore
+	* @return: TClothQuality: The quality settings
+	********************/
+	TClothQuality GetQuality() { return m_pCloth->GetQuality(); };
+
+	/***********************
+	* GetAverageCost: Retrieve the smoothed processing time of the cloth
+	* @author: Callan Moore
+	* @return: float: The average time in milliseconds
+	********************/
+	float GetAverageCost() { return m_averageCost; };
+
+private:
+
+	/***********************
+	* CalcQuality: Calculate the quality settings for a quality level
+	* @author: Callan Moore
+	* @parameter: _level: The quality level
+	* @return: TClothQuality: The quality settings
+	********************/
+	TClothQuality CalcQuality(int _level);
+
+private:
+	Physics_Cloth* m_pCloth;
+
+	TClothQuality m_lowest;
+	TClothQuality m_highest;
+	int m_levels;
+	int m_level;
+	bool m_pinned;
+
+	// Cost Measurement Variables
+	double m_millisecondsPerTick;
+	float m_budget;
+	float m_averageCost;
+	float m_smoothing;
+
+	// Hysteresis Variables
+	float m_lowerThreshold;
+	int m_overFrames;
+	int m_underFrames;
+	int m_framesToLower;
+	int m_framesToRaise;
+	int m_raiseBackoff;
+	int m_maxRaiseBackoff;
+	int m_cooldown;
+	int m_cooldownFrames;
+	int m_framesSinceRaise;
+};
+
+#endif	// __PHYSICS_CLOTHTUNER_H__
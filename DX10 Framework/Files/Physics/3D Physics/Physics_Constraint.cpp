@@ -62,8 +62,10 @@ bool Physics_Constraint::Initialise(Physics_Particle* _pA, Physics_Particle* _pB
 	return true;
 }
 
-bool Physics_Constraint::SatisfyConstraint()
+bool Physics_Constraint::SatisfyConstraint(float& _prViolation)
 {
+	_prViolation = 0.0f;
+
 	// Check if the calculations need to be run
 	if (m_active == true)
 	{
@@ -97,6 +99,9 @@ bool Physics_Constraint::SatisfyConstraint()
 					correctionVec = differenceVec * (1 - minDist / currDist);
 				}
 
+				// Record how far outside the limits the constraint was
+				_prViolation = correctionVec.Magnitude() / m_restDist;
+
 				// Halve the correction vector so each particle and can get half
 				v3float correctionVecHalved = correctionVec / 2.0f;
 
@@ -109,6 +114,22 @@ bool Physics_Constraint::SatisfyConstraint()
 	return true;
 }
 
+bool Physics_Constraint::CheckBreak()
+{
+	if (m_active == true)
+	{
+		// Compare the current distance between the particles with the breaking threshold
+		float currDist = (*m_pParticleB->GetPosition() - *m_pParticleA->GetPosition()).Magnitude();
+		if (currDist > m_breakDist)
+		{
+			// Distance has exceeded breaking threshold, set the constraint to inactive (broken)
+			m_active = false;
+			return true;
+		}
+	}
+	return false;
+}
+
 void Physics_Constraint::Ignite(float _burnTimer)
 {
 	// Set the ignited state of the constraint to true
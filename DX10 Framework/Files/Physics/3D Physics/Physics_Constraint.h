@@ -61,9 +61,10 @@ public:
 	/***********************
 	* SatisfyConstraint: Manipulate the particles and correct them to satisfy the constraints
 	* @author: Callan Moore
+	* @parameter: _prViolation: Storage variable for how far the constraint was outside its limits, relative to its rest distance
 	* @return: bool: Constraint was satisfied, false means constraint was broken
 	********************/
-	bool SatisfyConstraint();
+	bool SatisfyConstraint(float& _prViolation);
 
 	/***********************
 	* BurnDown: Process the burning of the constraint
@@ -89,6 +90,55 @@ public:
 	********************/
 	bool CanBeIgnited() { return (m_active == true && m_ignited == false); };
 
+	/***********************
+	* GetBurningState: Check if the constraint is ignited and has not yet burnt away
+	* @author: Callan Moore
+	* @return: bool: true if the constraint is burning
+	********************/
+	bool GetBurningState() { return (m_active == true && m_ignited == true); };
+
+	/***********************
+	* CheckBreak: Check if the constraint has stretched past its breaking distance, breaking it if so
+	* @author: Callan Moore
+	* @return: bool: True if the constraint broke
+	********************/
+	bool CheckBreak();
+
+	/***********************
+	* GetActiveState: Retrieve the current active state of the constraint
+	* @author: Callan Moore
+	* @return: bool: Active or broken
+	********************/
+	bool GetActiveState() { return m_active; };
+
+	/***********************
+	* GetImmediate: Retrieve whether the constraint is between immediate neighbors
+	* @author: Callan Moore
+	* @return: bool: True if immediate
+	********************/
+	bool GetImmediate() { return m_immediate; };
+
+	/***********************
+	* GetRestDistance: Retrieve the distance the constraint holds its particles at
+	* @author: Callan Moore
+	* @return: float: The rest distance
+	********************/
+	float GetRestDistance() { return m_restDist; };
+
+	/***********************
+	* GetParticleA: Retrieve the first particle of the constraint
+	* @author: Callan Moore
+	* @return: Physics_Particle*: Pointer to the first particle
+	********************/
+	Physics_Particle* GetParticleA() { return m_pParticleA; };
+
+	/***********************
+	* GetParticleB: Retrieve the second particle of the constraint
+	* @author: Callan Moore
+	* @return: Physics_Particle*: Pointer to the second particle
+	********************/
+	Physics_Particle* GetParticleB() { return m_pParticleB; };
+
 private:
 	Physics_Particle* m_pParticleA;
 	Physics_Particle* m_pParticleB;
@@ -0,0 +1,343 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Physics_Effects.cpp
+* Description : Pooled particle effects (embers, smoke) drawn as one batched point stream
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// This Include
+#include "Physics_Effects.h"
+
+Physics_Effects::Physics_Effects()
+{
+	// Initialise pointers to NULL
+	m_pRenderer = 0;
+	m_pShader = 0;
+	m_pMesh = 0;
+
+	m_randomIndex = 0;
+}
+
+Physics_Effects::~Physics_Effects()
+{
+	// Release allocated memory
+	for (int i = 0; i < (int)m_pools.size(); i++)
+	{
+		ReleasePtr(m_pools[i]);
+	}
+	ReleasePtr(m_pMesh);
+}
+
+bool Physics_Effects::Initialise(DX10_Renderer* _pRenderer, DX10_Shader_Cloth* _pShader, int _capacity)
+{
+	if ((_pRenderer != 0 && _pShader == 0) || _capacity <= 0)
+	{
+		// Pointer is NULL or there is no room for particles, initialization failed
+		return false;
+	}
+
+	// Assign member variables. A NULL renderer runs the effects headless without a mesh
+	m_pRenderer = _pRenderer;
+	m_pShader = _pShader;
+	m_capacity = _capacity;
+	m_reserved = 0;
+	m_drawCount = 0;
+
+	// No emit can spawn more particles than the capacity, so the random numbers of any emit fit without allocating
+	m_randoms.resize(m_capacity * 4);
+
+	// Particles are simulated in world space
+	D3DXMatrixIdentity(&m_matWorld);
+
+	if (m_pRenderer != 0)
+	{
+		// One dynamic point stream without indices holds the live particles of every emitter
+		m_pMesh = new DX10_Mesh();
+		VALIDATE(m_pMesh->InitialisePacked(m_pRenderer, m_capacity, 0, D3D10_PRIMITIVE_TOPOLOGY_POINTLIST));
+		m_pMesh->SetDrawCount(0);
+	}
+
+	return true;
+}
+
+int Physics_Effects::AddEmitter(TEmitterSettings _settings)
+{
+	if (_settings.Capacity <= 0 || m_reserved + _settings.Capacity > m_capacity)
+	{
+		// The pool would not fit in the vertex stream
+		return -1;
+	}
+	m_reserved += _settings.Capacity;
+
+	// Create the pool at its full size so emitting never allocates
+	// Padded to a whole number of SSE registers so the update never needs a scalar tail
+	int paddedCapacity = (_settings.Capacity + EFFECTS_LANES - 1) & ~(EFFECTS_LANES - 1);
+	TEmitterPool* pPool = new TEmitterPool();
+	pPool->Settings = _settings;
+	pPool->LiveCount = 0;
+	pPool->DrawCount = 0;
+	pPool->PackOrigin = D3DXVECTOR3(0.0f, 0.0f, 0.0f);
+	pPool->PosX.resize(paddedCapacity);
+	pPool->PosY.resize(paddedCapacity);
+	pPool->PosZ.resize(paddedCapacity);
+	pPool->VelX.resize(paddedCapacity);
+	pPool->VelY.resize(paddedCapacity);
+	pPool->VelZ.resize(paddedCapacity);
+	pPool->Life.resize(paddedCapacity);
+	pPool->LifeRate.resize(paddedCapacity);
+
+	// Pack the color gradient once so the vertex write is a lookup
+	for (int i = 0; i < EFFECTS_GRADIENT_STEPS; i++)
+	{
+		D3DXCOLOR color;
+		D3DXColorLerp(&color, &_settings.StartColor, &_settings.EndColor, (float)i / (float)(EFFECTS_GRADIENT_STEPS - 1));
+		pPool->Gradient[i] = PackColorRGBA8(color);
+	}
+
+	m_pools.push_back(pPool);
+	return (int)m_pools.size() - 1;
+}
+
+int Physics_Effects::Emit(int _emitter, v3float _position, int _count)
+{
+	if (_emitter < 0 || _emitter >= (int)m_pools.size())
+	{
+		// No such emitter
+		return 0;
+	}
+
+	TEmitterPool* pPool = m_pools[_emitter];
+	TEmitterSettings* pSettings = &pPool->Settings;
+	int emitCount = min(_count, pSettings->Capacity - pPool->LiveCount);
+
+	// Draw all four random numbers of every new particle in one fill
+	if (emitCount > 0)
+	{
+		FillRandomRange(GetRandomSeed(), RS_EFFECTS, m_randomIndex, &m_randoms[0], emitCount * 4, -1.0f, 1.0f);
+		m_randomIndex += emitCount * 4;
+	}
+
+	for (int i = 0; i < emitCount; i++)
+	{
+		float* pRandoms = &m_randoms[i * 4];
+		int index = pPool->LiveCount++;
+		pPool->PosX[index] = _position.x;
+		pPool->PosY[index] = _position.y;
+		pPool->PosZ[index] = _position.z;
+		pPool->VelX[index] = pSettings->Velocity.x + (pRandoms[0] * pSettings->Spread);
+		pPool->VelY[index] = pSettings->Velocity.y + (pRandoms[1] * pSettings->Spread);
+		pPool->VelZ[index] = pSettings->Velocity.z + (pRandoms[2] * pSettings->Spread);
+
+		float lifetime = max(0.01f, pSettings->Lifetime + (pRandoms[3] * pSettings->LifetimeVariance));
+		pPool->Life[index] = 0.0f;
+		pPool->LifeRate[index] = 1.0f / lifetime;
+	}
+
+	if (emitCount < _count)
+	{
+		PROFILE_COUNT("Effects.ParticlesDropped", _count - emitCount);
+	}
+	return emitCount;
+}
+
+void Physics_Effects::Process(float _dt)
+{
+	{
+		PROFILE_SCOPE("Effects.Update");
+		for (int i = 0; i < (int)m_pools.size(); i++)
+		{
+			UpdatePool(*m_pools[i], _dt);
+		}
+	}
+
+	m_drawCount = GetLiveCount();
+	PROFILE_COUNT("Effects.LiveParticles", m_drawCount);
+
+	if (m_pMesh != 0)
+	{
+		PROFILE_SCOPE("Effects.VertexWrite");
+
+		// Pack the pools one after another straight into the vertex stream, each relative to its own origin
+		TVertexHalfColor* pVertices = (TVertexHalfColor*)m_pMesh->MapVertexBuffer();
+		D3DXFLOAT16 one = D3DXFLOAT16(1.0f);
+		for (int i = 0; i < (int)m_pools.size(); i++)
+		{
+			TEmitterPool* pPool = m_pools[i];
+			D3DXVECTOR3 origin = pPool->PackOrigin;
+			for (int j = 0; j < pPool->LiveCount; j++)
+			{
+				pVertices->pos[0] = PackHalf(pPool->PosX[j] - origin.x);
+				pVertices->pos[1] = PackHalf(pPool->PosY[j] - origin.y);
+				pVertices->pos[2] = PackHalf(pPool->PosZ[j] - origin.z);
+				pVertices->pos[3] = one;
+				pVertices->color = pPool->Gradient[(int)(pPool->Life[j] * (EFFECTS_GRADIENT_STEPS - 1))];
+				pVertices++;
+			}
+			pPool->DrawCount = pPool->LiveCount;
+		}
+		m_pMesh->UnmapVertexBuffer();
+		PROFILE_COUNT("Effects.BytesUploaded", sizeof(TVertexHalfColor) * m_drawCount);
+	}
+}
+
+void Physics_Effects::Render()
+{
+	if (m_pMesh == 0 || m_drawCount == 0)
+	{
+		// Nothing to render
+		return;
+	}
+
+	TCloth cloth;
+	cloth.pMatWorld = &m_matWorld;
+	cloth.pMesh = m_pMesh;
+
+	// Render each emitter's range of the stream with the origin it was packed relative to
+	UINT drawStart = 0;
+	for (int i = 0; i < (int)m_pools.size(); i++)
+	{
+		TEmitterPool* pPool = m_pools[i];
+		if (pPool->DrawCount > 0)
+		{
+			m_pMesh->SetDrawRange(drawStart, pPool->DrawCount);
+			m_pMesh->SetPackOrigin(pPool->PackOrigin);
+			m_pShader->Render(cloth);
+		}
+		drawStart += pPool->DrawCount;
+	}
+}
+
+void Physics_Effects::Clear()
+{
+	for (int i = 0; i < (int)m_pools.size(); i++)
+	{
+		m_pools[i]->LiveCount = 0;
+		m_pools[i]->DrawCount = 0;
+	}
+	m_drawCount = 0;
+
+	if (m_pMesh != 0)
+	{
+		m_pMesh->SetDrawCount(0);
+	}
+}
+
+int Physics_Effects::GetLiveCount()
+{
+	int liveCount = 0;
+	for (int i = 0; i < (int)m_pools.size(); i++)
+	{
+		liveCount += m_pools[i]->LiveCount;
+	}
+	return liveCount;
+}
+
+// Private Functions
+
+void Physics_Effects::UpdatePool(TEmitterPool& _pool, float _dt)
+{
+	int liveCount = _pool.LiveCount;
+	float* pPosX = &_pool.PosX[0];
+	float* pPosY = &_pool.PosY[0];
+	float* pPosZ = &_pool.PosZ[0];
+	float* pVelX = &_pool.VelX[0];
+	float* pVelY = &_pool.VelY[0];
+	float* pVelZ = &_pool.VelZ[0];
+	float* pLife = &_pool.Life[0];
+	float* pLifeRate = &_pool.LifeRate[0];
+
+	// Every particle of a pool shares its settings, so four are moved and aged at a time
+	__m128 dt = _mm_set1_ps(_dt);
+	__m128 dragFactor = _mm_set1_ps(max(0.0f, 1.0f - (_pool.Settings.Drag * _dt)));
+	__m128 accelX = _mm_set1_ps(_pool.Settings.Acceleration.x * _dt);
+	__m128 accelY = _mm_set1_ps(_pool.Settings.Acceleration.y * _dt);
+	__m128 accelZ = _mm_set1_ps(_pool.Settings.Acceleration.z * _dt);
+
+	// Bound the moved particles. Lanes past the live count hold no particle and are left out
+	__m128 lanes = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+	__m128 live = _mm_set1_ps((float)liveCount);
+	__m128 lowestX = _mm_set1_ps(FLT_MAX);
+	__m128 lowestY = _mm_set1_ps(FLT_MAX);
+	__m128 lowestZ = _mm_set1_ps(FLT_MAX);
+	__m128 highestX = _mm_set1_ps(-FLT_MAX);
+	__m128 highestY = _mm_set1_ps(-FLT_MAX);
+	__m128 highestZ = _mm_set1_ps(-FLT_MAX);
+
+	for (int i = 0; i < liveCount; i += EFFECTS_LANES)
+	{
+		__m128 velX = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(pVelX + i), dragFactor), accelX);
+		__m128 velY = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(pVelY + i), dragFactor), accelY);
+		__m128 velZ = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(pVelZ + i), dragFactor), accelZ);
+		__m128 posX = _mm_add_ps(_mm_loadu_ps(pPosX + i), _mm_mul_ps(velX, dt));
+		__m128 posY = _mm_add_ps(_mm_loadu_ps(pPosY + i), _mm_mul_ps(velY, dt));
+		__m128 posZ = _mm_add_ps(_mm_loadu_ps(pPosZ + i), _mm_mul_ps(velZ, dt));
+
+		_mm_storeu_ps(pVelX + i, velX);
+		_mm_storeu_ps(pVelY + i, velY);
+		_mm_storeu_ps(pVelZ + i, velZ);
+		_mm_storeu_ps(pPosX + i, posX);
+		_mm_storeu_ps(pPosY + i, posY);
+		_mm_storeu_ps(pPosZ + i, posZ);
+		_mm_storeu_ps(pLife + i, _mm_add_ps(_mm_loadu_ps(pLife + i), _mm_mul_ps(_mm_loadu_ps(pLifeRate + i), dt)));
+
+		__m128 inPool = _mm_cmplt_ps(_mm_add_ps(lanes, _mm_set1_ps((float)i)), live);
+		lowestX = SelectLanes(inPool, _mm_min_ps(lowestX, posX), lowestX);
+		lowestY = SelectLanes(inPool, _mm_min_ps(lowestY, posY), lowestY);
+		lowestZ = SelectLanes(inPool, _mm_min_ps(lowestZ, posZ), lowestZ);
+		highestX = SelectLanes(inPool, _mm_max_ps(highestX, posX), highestX);
+		highestY = SelectLanes(inPool, _mm_max_ps(highestY, posY), highestY);
+		highestZ = SelectLanes(inPool, _mm_max_ps(highestZ, posZ), highestZ);
+	}
+
+	if (liveCount > 0)
+	{
+		// Fold the lanes of the bounds and pack the pool relative to their centre
+		SIMD_ALIGN float lowest[3][EFFECTS_LANES];
+		SIMD_ALIGN float highest[3][EFFECTS_LANES];
+		_mm_store_ps(lowest[0], lowestX);
+		_mm_store_ps(lowest[1], lowestY);
+		_mm_store_ps(lowest[2], lowestZ);
+		_mm_store_ps(highest[0], highestX);
+		_mm_store_ps(highest[1], highestY);
+		_mm_store_ps(highest[2], highestZ);
+
+		float centre[3];
+		for (int axis = 0; axis < 3; axis++)
+		{
+			float low = min(min(lowest[axis][0], lowest[axis][1]), min(lowest[axis][2], lowest[axis][3]));
+			float high = max(max(highest[axis][0], highest[axis][1]), max(highest[axis][2], highest[axis][3]));
+			centre[axis] = (low + high) * 0.5f;
+		}
+		_pool.PackOrigin = D3DXVECTOR3(centre[0], centre[1], centre[2]);
+	}
+
+	// Remove the dead by moving the last live particle into their place
+	int i = 0;
+	while (i < liveCount)
+	{
+		if (pLife[i] >= 1.0f)
+		{
+			liveCount--;
+			pPosX[i] = pPosX[liveCount];
+			pPosY[i] = pPosY[liveCount];
+			pPosZ[i] = pPosZ[liveCount];
+			pVelX[i] = pVelX[liveCount];
+			pVelY[i] = pVelY[liveCount];
+			pVelZ[i] = pVelZ[liveCount];
+			pLife[i] = pLife[liveCount];
+			pLifeRate[i] = pLifeRate[liveCount];
+		}
+		else
+		{
+			i++;
+		}
+	}
+	_pool.LiveCount = liveCount;
+}
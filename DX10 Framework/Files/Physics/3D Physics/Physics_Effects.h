@@ -0,0 +1,176 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Physics_Effects.h
+* Description : Pooled particle effects (embers, smoke) drawn as one batched point stream
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// Inclusion Guards
+#pragma once
+#ifndef __PHYSICS_EFFECTS_H__
+#define __PHYSICS_EFFECTS_H__
+
+// Local Includes
+#include "../../DX10/DX10.h"
+#include "../../Utility/Profiler.h"
+
+// Defines
+// Number of steps in the color gradient of each emitter
+#define EFFECTS_GRADIENT_STEPS 256
+// Particles of a pool updated together in one SSE register. Pools are padded to a multiple of this
+#define EFFECTS_LANES 4
+
+/***********************
+* TEmitterSettings: Settings of an emitter and the particles it spawns
+* @author: Callan Moore
+********************/
+struct TEmitterSettings
+{
+	int Capacity;
+	float Lifetime;
+	float LifetimeVariance;
+	v3float Velocity;
+	float Spread;
+	v3float Acceleration;
+	float Drag;
+	D3DXCOLOR StartColor;
+	D3DXCOLOR EndColor;
+};
+
+/***********************
+* TEmitterPool: Fixed capacity pool of live particles for one emitter, stored as structure of arrays
+* @author: Callan Moore
+********************/
+struct TEmitterPool
+{
+	TEmitterSettings Settings;
+	int LiveCount;
+
+	std::vector<float> PosX;
+	std::vector<float> PosY;
+	std::vector<float> PosZ;
+	std::vector<float> VelX;
+	std::vector<float> VelY;
+	std::vector<float> VelZ;
+
+	// Life runs from zero at birth to one at death
+	std::vector<float> Life;
+	std::vector<float> LifeRate;
+
+	// Packed colors from birth to death
+	UINT Gradient[EFFECTS_GRADIENT_STEPS];
+
+	// Centre of the bounds of the particles at the last update. Their half precision positions are packed relative to it
+	D3DXVECTOR3 PackOrigin;
+
+	// Particles of the pool written to the vertex stream by the last Process
+	int DrawCount;
+};
+
+class Physics_Effects
+{
+public:
+	/***********************
+	* Physics_Effects: Default Constructor for Physics Effects class
+	* @author: Callan Moore
+	********************/
+	Physics_Effects();
+
+	/***********************
+	* ~Physics_Effects: Default Destructor for Physics Effects class
+	* @author: Callan Moore
+	********************/
+	~Physics_Effects();
+
+	/***********************
+	* Initialise: Initialise the effects and the vertex stream every emitter is drawn from
+	* @author: Callan Moore
+	* @parameter: _pRenderer: DX10 Renderer for this application. NULL to simulate without rendering
+	* @parameter: _pShader: The cloth shader to render the particles with
+	* @parameter: _capacity: The most particles all of the emitters can hold together
+	* @return: bool: Successful or not
+	********************/
+	bool Initialise(DX10_Renderer* _pRenderer, DX10_Shader_Cloth* _pShader, int _capacity);
+
+	/***********************
+	* AddEmitter: Add an emitter with its own pool of particles
+	* @author: Callan Moore
+	* @parameter: _settings: The settings of the emitter
+	* @return: int: The ID of the emitter. -1 if its pool does not fit in the remaining capacity
+	********************/
+	int AddEmitter(TEmitterSettings _settings);
+
+	/***********************
+	* Emit: Spawn particles from an emitter. Particles that do not fit in the pool are dropped
+	* @author: Callan Moore
+	* @parameter: _emitter: The ID of the emitter
+	* @parameter: _position: The world position to spawn at
+	* @parameter: _count: The number of particles to spawn
+	* @return: int: The number of particles spawned
+	********************/
+	int Emit(int _emitter, v3float _position, int _count);
+
+	/***********************
+	* Process: Move and age every live particle, remove the dead and write the vertex stream
+	* @author: Callan Moore
+	* @parameter: _dt: The time to step
+	* @return: void
+	********************/
+	void Process(float _dt);
+
+	/***********************
+	* Render: Render the live particles of each emitter from the shared vertex stream
+	* @author: Callan Moore
+	* @return: void
+	********************/
+	void Render();
+
+	/***********************
+	* Clear: Remove every live particle
+	* @author: Callan Moore
+	* @return: void
+	********************/
+	void Clear();
+
+	/***********************
+	* GetLiveCount: Retrieve the number of live particles across all emitters
+	* @author: Callan Moore
+	* @return: int: The live particle count
+	********************/
+	int GetLiveCount();
+
+private:
+
+	/***********************
+	* UpdatePool: Move and age the particles of one pool four at a time, bound them for packing, then swap the dead ones out
+	* @author: Callan Moore
+	* @parameter: _pool: The pool to update
+	* @parameter: _dt: The time to step
+	* @return: void
+	********************/
+	void UpdatePool(TEmitterPool& _pool, float _dt);
+
+private:
+	DX10_Renderer* m_pRenderer;
+	DX10_Shader_Cloth* m_pShader;
+	DX10_Mesh* m_pMesh;
+	D3DXMATRIX m_matWorld;
+
+	std::vector<TEmitterPool*> m_pools;
+	int m_capacity;
+	int m_reserved;
+	int m_drawCount;
+
+	// Index of the next number of the effects random stream, and storage for the numbers of the largest emit
+	UINT64 m_randomIndex;
+	std::vector<float> m_randoms;
+};
+
+#endif	// __PHYSICS_EFFECTS_H__
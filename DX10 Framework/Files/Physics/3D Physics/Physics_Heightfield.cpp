@@ -0,0 +1,82 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Physics_Heightfield.cpp
+* Description : Collider that samples the height grid of a terrain plane mesh
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// This Include
+#include "Physics_Heightfield.h"
+
+Physics_Heightfield::Physics_Heightfield()
+{
+	// Initialise pointers to NULL
+	m_pTerrain = 0;
+}
+
+Physics_Heightfield::~Physics_Heightfield()
+{
+}
+
+bool Physics_Heightfield::Initialise(DX10_Mesh* _pTerrain, v3float _position)
+{
+	if (_pTerrain == 0 || _pTerrain->GetVertexBuffer() == 0 || _pTerrain->GetSize() < 2)
+	{
+		// Not a plane mesh, initialization failed
+		return false;
+	}
+
+	// Assign member variables
+	m_pTerrain = _pTerrain;
+	m_position = _position;
+	m_scale = _pTerrain->GetScale();
+	m_size = _pTerrain->GetSize();
+
+	return true;
+}
+
+bool Physics_Heightfield::Sample(float _x, float _z, float& _prHeight, v3float& _prNormal)
+{
+	// Convert the position into grid coordinates. The plane is centred on its position
+	float gridX = ((_x - m_position.x) / m_scale.x) + ((float)(m_size - 1) / 2.0f);
+	float gridZ = ((_z - m_position.z) / m_scale.z) + ((float)(m_size - 1) / 2.0f);
+	if (gridX < 0.0f || gridZ < 0.0f || gridX > (float)(m_size - 1) || gridZ > (float)(m_size - 1))
+	{
+		// Outside the terrain
+		return false;
+	}
+
+	// Find the grid cell and the position within it
+	int col = min((int)gridX, m_size - 2);
+	int row = min((int)gridZ, m_size - 2);
+	float fracX = gridX - (float)col;
+	float fracZ = gridZ - (float)row;
+
+	// Read the four corner heights straight from the terrain vertices
+	TVertexNormalUV* pVertices = m_pTerrain->GetVertexBuffer();
+	int index = (row * m_size) + col;
+	float height00 = pVertices[index].pos.y;
+	float height10 = pVertices[index + 1].pos.y;
+	float height01 = pVertices[index + m_size].pos.y;
+	float height11 = pVertices[index + m_size + 1].pos.y;
+
+	// Blend the heights across the cell
+	float heightNear = height00 + (height10 - height00) * fracX;
+	float heightFar = height01 + (height11 - height01) * fracX;
+	_prHeight = m_position.y + (heightNear + (heightFar - heightNear) * fracZ);
+
+	// The normal comes from the slope of the blended surface
+	float slopeX = ((height10 - height00) * (1.0f - fracZ) + (height11 - height01) * fracZ) / m_scale.x;
+	float slopeZ = ((height01 - height00) * (1.0f - fracX) + (height11 - height10) * fracX) / m_scale.z;
+	_prNormal = v3float(-slopeX, 1.0f, -slopeZ);
+	_prNormal.Normalise();
+
+	return true;
+}
@@ -0,0 +1,73 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Physics_Heightfield.h
+* Description : Collider that samples the height grid of a terrain plane mesh
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// Inclusion Guards
+#pragma once
+#ifndef __PHYSICS_HEIGHTFIELD_H__
+#define __PHYSICS_HEIGHTFIELD_H__
+
+// Local Includes
+#include "../../DX10/DX10.h"
+
+class Physics_Heightfield
+{
+public:
+	/***********************
+	* Physics_Heightfield: Default Constructor for Physics Heightfield class
+	* @author: Callan Moore
+	********************/
+	Physics_Heightfield();
+
+	/***********************
+	* ~Physics_Heightfield: Default Destructor for Physics Heightfield class
+	* @author: Callan Moore
+	********************/
+	~Physics_Heightfield();
+
+	/***********************
+	* Initialise: Initialise the heightfield over a terrain. The heights are read from the terrain vertices so changes to it are seen straight away
+	* @author: Callan Moore
+	* @parameter: _pTerrain: A mesh created with InitialisePlane
+	* @parameter: _position: The world position of the centre of the terrain
+	* @return: bool: Successful or not
+	********************/
+	bool Initialise(DX10_Mesh* _pTerrain, v3float _position);
+
+	/***********************
+	* Sample: Bilinearly sample the height and surface normal of the terrain
+	* @author: Callan Moore
+	* @parameter: _x: The world X position to sample at
+	* @parameter: _z: The world Z position to sample at
+	* @parameter: _prHeight: Storage for the world height of the terrain
+	* @parameter: _prNormal: Storage for the normal of the terrain
+	* @return: bool: False if the position is outside the terrain
+	********************/
+	bool Sample(float _x, float _z, float& _prHeight, v3float& _prNormal);
+
+	/***********************
+	* SetPosition: Set the world position of the centre of the terrain
+	* @author: Callan Moore
+	* @parameter: _position: The new position
+	* @return: void
+	********************/
+	void SetPosition(v3float _position) { m_position = _position; };
+
+private:
+	DX10_Mesh* m_pTerrain;
+	v3float m_position;
+	v3float m_scale;
+	int m_size;
+};
+
+#endif	// __PHYSICS_HEIGHTFIELD_H__
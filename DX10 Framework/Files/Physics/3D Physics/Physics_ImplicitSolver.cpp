@@ -0,0 +1,400 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Physics_ImplicitSolver.cpp
+* Description : Backward Euler integrator for a grid of particles joined by constraints
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// This Include
+#include "Physics_ImplicitSolver.h"
+
+// Library Includes
+#include <xmmintrin.h>
+#include <algorithm>
+
+Physics_ImplicitSolver::Physics_ImplicitSolver()
+{
+	// Initialise pointers to NULL
+	m_pParticles = 0;
+	m_pConstraints = 0;
+}
+
+Physics_ImplicitSolver::~Physics_ImplicitSolver()
+{
+}
+
+bool Physics_ImplicitSolver::Initialise(Physics_Particle* _pParticles, int _particleCount, std::vector<Physics_Constraint>* _pConstraints, float _timeStep)
+{
+	if (_pParticles == 0 || _pConstraints == 0 || _particleCount <= 0)
+	{
+		// Pointer is NULL, initialization failed
+		return false;
+	}
+
+	// Assign member variables
+	m_pParticles = _pParticles;
+	m_pConstraints = _pConstraints;
+	m_particleCount = _particleCount;
+	m_timeStep = _timeStep;
+
+	m_stiffness = 20000.0f;
+	m_stiffnessSecondary = 5000.0f;
+	m_springDamping = 2.0f;
+
+	m_maxIterations = 40;
+	m_tolerance = 0.001f;
+	m_iterations = 0;
+	m_residual = 0.0f;
+
+	// Springs on a regular grid only join particles a few fixed index offsets apart. Group them into bands by offset
+	m_bands.clear();
+	int maxOffset = 0;
+	for (UINT i = 0; i < m_pConstraints->size(); i++)
+	{
+		int indexA = (int)(*m_pConstraints)[i].GetParticleA()->GetParticleID();
+		int indexB = (int)(*m_pConstraints)[i].GetParticleB()->GetParticleID();
+		int lowerIndex = min(indexA, indexB);
+		int offset = abs(indexB - indexA);
+
+		TSpringBand* pBand = FindBand(offset, lowerIndex);
+		pBand->Constraints[lowerIndex] = (int)i;
+		maxOffset = max(maxOffset, offset);
+	}
+
+	// Pad the vectors so four wide operations can read past the last particle at any band offset
+	m_paddedCount = ((m_particleCount + 3) / 4) * 4 + maxOffset + 4;
+	for (UINT i = 0; i < m_bands.size(); i++)
+	{
+		for (int j = 0; j < 6; j++)
+		{
+			m_bands[i].Blocks[j].assign(m_paddedCount, 0.0f);
+		}
+	}
+
+	m_free.assign(m_paddedCount, 0.0f);
+	m_mass.assign(m_paddedCount, 0.0f);
+	for (int i = 0; i < 3; i++)
+	{
+		m_velocity[i].assign(m_paddedCount, 0.0f);
+		m_rhs[i].assign(m_paddedCount, 0.0f);
+		m_inverseDiagonal[i].assign(m_paddedCount, 0.0f);
+		m_deltaVelocity[i].assign(m_paddedCount, 0.0f);
+		m_residualVec[i].assign(m_paddedCount, 0.0f);
+		m_search[i].assign(m_paddedCount, 0.0f);
+		m_product[i].assign(m_paddedCount, 0.0f);
+		m_preconditioned[i].assign(m_paddedCount, 0.0f);
+	}
+
+	return true;
+}
+
+void Physics_ImplicitSolver::Step(float _damping)
+{
+	AssembleSystem();
+
+	// Solve (M - h^2 df/dx - h df/dv) dv = h (f + h df/dx v) with preconditioned conjugate gradient
+	for (int i = 0; i < 3; i++)
+	{
+		std::fill(m_deltaVelocity[i].begin(), m_deltaVelocity[i].end(), 0.0f);
+		m_residualVec[i] = m_rhs[i];
+	}
+	Filter(m_residualVec);
+
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < m_particleCount; j++)
+		{
+			m_search[i][j] = m_residualVec[i][j] * m_inverseDiagonal[i][j];
+		}
+	}
+	Filter(m_search);
+
+	float delta = Dot(m_residualVec, m_search);
+	float initialDelta = delta;
+	float targetDelta = initialDelta * m_tolerance * m_tolerance;
+	m_iterations = 0;
+
+	while (m_iterations < m_maxIterations && delta > targetDelta && delta > FLT_MIN)
+	{
+		MultiplySystem(m_search, m_product);
+		Filter(m_product);
+
+		float curvature = Dot(m_search, m_product);
+		if (curvature <= FLT_MIN)
+		{
+			// Search direction has no curvature left to reduce
+			break;
+		}
+		float alpha = delta / curvature;
+
+		// Step along the search direction and update the residual
+		for (int i = 0; i < 3; i++)
+		{
+			for (int j = 0; j < m_particleCount; j++)
+			{
+				m_deltaVelocity[i][j] += alpha * m_search[i][j];
+				m_residualVec[i][j] -= alpha * m_product[i][j];
+				m_preconditioned[i][j] = m_residualVec[i][j] * m_inverseDiagonal[i][j];
+			}
+		}
+
+		float newDelta = Dot(m_residualVec, m_preconditioned);
+		float beta = newDelta / delta;
+		delta = newDelta;
+
+		// Calculate the next search direction conjugate to the previous ones
+		for (int i = 0; i < 3; i++)
+		{
+			for (int j = 0; j < m_particleCount; j++)
+			{
+				m_search[i][j] = m_preconditioned[i][j] + beta * m_search[i][j];
+			}
+		}
+		Filter(m_search);
+
+		m_iterations++;
+	}
+	m_residual = (initialDelta > FLT_MIN) ? sqrt(delta / initialDelta) : 0.0f;
+
+	// Move each particle with its new velocity
+	float dampingInverse = 1.0f - _damping;
+	for (int i = 0; i < m_particleCount; i++)
+	{
+		v3float velocity = { m_velocity[0][i] + m_deltaVelocity[0][i], m_velocity[1][i] + m_deltaVelocity[1][i], m_velocity[2][i] + m_deltaVelocity[2][i] };
+		m_pParticles[i].Integrate(velocity * dampingInverse * m_free[i]);
+	}
+}
+
+void Physics_ImplicitSolver::AssembleSystem()
+{
+	float timeStepSquared = m_timeStep * m_timeStep;
+
+	// Start each particle with its mass and external forces
+	for (int i = 0; i < m_particleCount; i++)
+	{
+		Physics_Particle* pParticle = &m_pParticles[i];
+
+		// Static, selected and destroyed particles are not moved by the solve
+		m_free[i] = (pParticle->GetActiveState() == true && pParticle->GetStaticState() == false && pParticle->GetSelectedState() == false) ? 1.0f : 0.0f;
+		m_mass[i] = pParticle->GetMass();
+
+		v3float velocity = pParticle->GetVelocity();
+		v3float force = pParticle->GetAcceleration() * m_mass[i];
+		m_velocity[0][i] = velocity.x;
+		m_velocity[1][i] = velocity.y;
+		m_velocity[2][i] = velocity.z;
+		m_rhs[0][i] = force.x * m_timeStep;
+		m_rhs[1][i] = force.y * m_timeStep;
+		m_rhs[2][i] = force.z * m_timeStep;
+		m_inverseDiagonal[0][i] = m_inverseDiagonal[1][i] = m_inverseDiagonal[2][i] = m_mass[i];
+	}
+
+	// Add the force and system block of every spring
+	for (UINT band = 0; band < m_bands.size(); band++)
+	{
+		TSpringBand* pBand = &m_bands[band];
+		for (int i = 0; i < m_particleCount; i++)
+		{
+			// Clear the block so missing and broken springs contribute nothing
+			for (int j = 0; j < 6; j++)
+			{
+				pBand->Blocks[j][i] = 0.0f;
+			}
+
+			if (pBand->Constraints[i] < 0)
+			{
+				continue;
+			}
+
+			Physics_Constraint* pConstraint = &(*m_pConstraints)[pBand->Constraints[i]];
+			int indexA = i;
+			int indexB = i + pBand->Offset;
+			if (pConstraint->GetActiveState() == false || m_pParticles[indexA].GetActiveState() == false || m_pParticles[indexB].GetActiveState() == false)
+			{
+				continue;
+			}
+
+			// Calculate the direction and length of the spring
+			v3float line = *m_pParticles[indexB].GetPosition() - *m_pParticles[indexA].GetPosition();
+			float length = line.Magnitude();
+			float restDist = pConstraint->GetRestDistance();
+			if (length < 0.0001f || (pConstraint->GetImmediate() == false && length < restDist))
+			{
+				// Secondary constraints only resist stretching
+				continue;
+			}
+			v3float dir = line / length;
+
+			// Spring and damping force on particle A (B receives the opposite)
+			float stiffness = (pConstraint->GetImmediate() == true) ? m_stiffness : m_stiffnessSecondary;
+			v3float velocityDiff = { m_velocity[0][indexB] - m_velocity[0][indexA], m_velocity[1][indexB] - m_velocity[1][indexA], m_velocity[2][indexB] - m_velocity[2][indexA] };
+			v3float force = dir * (stiffness * (length - restDist) + m_springDamping * velocityDiff.Dot(dir));
+
+			// Stiffness block K = k(nn' + max(0, 1 - L/l)(I - nn')). Compression is dropped to keep the system definite
+			float transverse = stiffness * max(0.0f, 1.0f - restDist / length);
+			float axial = stiffness - transverse;
+			float stiffnessBlock[6] = {
+				axial * dir.x * dir.x + transverse, axial * dir.x * dir.y, axial * dir.x * dir.z,
+				axial * dir.y * dir.y + transverse, axial * dir.y * dir.z,
+				axial * dir.z * dir.z + transverse };
+
+			// K (vA - vB) term of the right hand side
+			v3float stiffVelocity = {
+				-(stiffnessBlock[0] * velocityDiff.x + stiffnessBlock[1] * velocityDiff.y + stiffnessBlock[2] * velocityDiff.z),
+				-(stiffnessBlock[1] * velocityDiff.x + stiffnessBlock[3] * velocityDiff.y + stiffnessBlock[4] * velocityDiff.z),
+				-(stiffnessBlock[2] * velocityDiff.x + stiffnessBlock[4] * velocityDiff.y + stiffnessBlock[5] * velocityDiff.z) };
+
+			v3float rhsA = force * m_timeStep - stiffVelocity * timeStepSquared;
+			m_rhs[0][indexA] += rhsA.x;
+			m_rhs[1][indexA] += rhsA.y;
+			m_rhs[2][indexA] += rhsA.z;
+			m_rhs[0][indexB] -= rhsA.x;
+			m_rhs[1][indexB] -= rhsA.y;
+			m_rhs[2][indexB] -= rhsA.z;
+
+			// System block C = h^2 K + h kd nn'
+			float dampingScale = m_timeStep * m_springDamping;
+			float direction[3] = { dir.x, dir.y, dir.z };
+			int block = 0;
+			for (int row = 0; row < 3; row++)
+			{
+				for (int col = row; col < 3; col++)
+				{
+					pBand->Blocks[block][i] = stiffnessBlock[block] * timeStepSquared + direction[row] * direction[col] * dampingScale;
+					block++;
+				}
+			}
+
+			// Add the block diagonal to both particles for the Jacobi preconditioner
+			m_inverseDiagonal[0][indexA] += pBand->Blocks[0][i];
+			m_inverseDiagonal[1][indexA] += pBand->Blocks[3][i];
+			m_inverseDiagonal[2][indexA] += pBand->Blocks[5][i];
+			m_inverseDiagonal[0][indexB] += pBand->Blocks[0][i];
+			m_inverseDiagonal[1][indexB] += pBand->Blocks[3][i];
+			m_inverseDiagonal[2][indexB] += pBand->Blocks[5][i];
+		}
+	}
+
+	// Invert the diagonal
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < m_particleCount; j++)
+		{
+			m_inverseDiagonal[i][j] = 1.0f / m_inverseDiagonal[i][j];
+		}
+	}
+}
+
+void Physics_ImplicitSolver::MultiplySystem(std::vector<float>* _pIn, std::vector<float>* _pOut)
+{
+	float* pInX = &_pIn[0][0];
+	float* pInY = &_pIn[1][0];
+	float* pInZ = &_pIn[2][0];
+	float* pOutX = &_pOut[0][0];
+	float* pOutY = &_pOut[1][0];
+	float* pOutZ = &_pOut[2][0];
+
+	// Mass diagonal
+	for (int i = 0; i < m_paddedCount; i++)
+	{
+		pOutX[i] = m_mass[i] * pInX[i];
+		pOutY[i] = m_mass[i] * pInY[i];
+		pOutZ[i] = m_mass[i] * pInZ[i];
+	}
+
+	// Each band adds C (inA - inB) to particle A and the negative to particle B, four springs at a time
+	for (UINT band = 0; band < m_bands.size(); band++)
+	{
+		TSpringBand* pBand = &m_bands[band];
+		int offset = pBand->Offset;
+		const float* pXX = &pBand->Blocks[0][0];
+		const float* pXY = &pBand->Blocks[1][0];
+		const float* pXZ = &pBand->Blocks[2][0];
+		const float* pYY = &pBand->Blocks[3][0];
+		const float* pYZ = &pBand->Blocks[4][0];
+		const float* pZZ = &pBand->Blocks[5][0];
+
+		for (int i = 0; i < m_particleCount; i += 4)
+		{
+			__m128 diffX = _mm_sub_ps(_mm_loadu_ps(pInX + i), _mm_loadu_ps(pInX + i + offset));
+			__m128 diffY = _mm_sub_ps(_mm_loadu_ps(pInY + i), _mm_loadu_ps(pInY + i + offset));
+			__m128 diffZ = _mm_sub_ps(_mm_loadu_ps(pInZ + i), _mm_loadu_ps(pInZ + i + offset));
+
+			__m128 xx = _mm_loadu_ps(pXX + i);
+			__m128 xy = _mm_loadu_ps(pXY + i);
+			__m128 xz = _mm_loadu_ps(pXZ + i);
+			__m128 yy = _mm_loadu_ps(pYY + i);
+			__m128 yz = _mm_loadu_ps(pYZ + i);
+			__m128 zz = _mm_loadu_ps(pZZ + i);
+
+			__m128 resultX = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xx, diffX), _mm_mul_ps(xy, diffY)), _mm_mul_ps(xz, diffZ));
+			__m128 resultY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xy, diffX), _mm_mul_ps(yy, diffY)), _mm_mul_ps(yz, diffZ));
+			__m128 resultZ = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xz, diffX), _mm_mul_ps(yz, diffY)), _mm_mul_ps(zz, diffZ));
+
+			// Read modify write in order so overlapping ranges for small offsets accumulate correctly
+			_mm_storeu_ps(pOutX + i, _mm_add_ps(_mm_loadu_ps(pOutX + i), resultX));
+			_mm_storeu_ps(pOutY + i, _mm_add_ps(_mm_loadu_ps(pOutY + i), resultY));
+			_mm_storeu_ps(pOutZ + i, _mm_add_ps(_mm_loadu_ps(pOutZ + i), resultZ));
+			_mm_storeu_ps(pOutX + i + offset, _mm_sub_ps(_mm_loadu_ps(pOutX + i + offset), resultX));
+			_mm_storeu_ps(pOutY + i + offset, _mm_sub_ps(_mm_loadu_ps(pOutY + i + offset), resultY));
+			_mm_storeu_ps(pOutZ + i + offset, _mm_sub_ps(_mm_loadu_ps(pOutZ + i + offset), resultZ));
+		}
+	}
+}
+
+void Physics_ImplicitSolver::Filter(std::vector<float>* _pVector)
+{
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < m_particleCount; j++)
+		{
+			_pVector[i][j] *= m_free[j];
+		}
+	}
+}
+
+float Physics_ImplicitSolver::Dot(std::vector<float>* _pA, std::vector<float>* _pB)
+{
+	// Accumulate four lanes at a time. Padding is zero so the tail adds nothing
+	__m128 sum = _mm_setzero_ps();
+	for (int i = 0; i < 3; i++)
+	{
+		const float* pA = &_pA[i][0];
+		const float* pB = &_pB[i][0];
+		for (int j = 0; j < m_particleCount; j += 4)
+		{
+			sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(pA + j), _mm_loadu_ps(pB + j)));
+		}
+	}
+
+	float lanes[4];
+	_mm_storeu_ps(lanes, sum);
+	return (lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+}
+
+TSpringBand* Physics_ImplicitSolver::FindBand(int _offset, int _index)
+{
+	// Use an existing band with a free slot at the index
+	for (UINT i = 0; i < m_bands.size(); i++)
+	{
+		if (m_bands[i].Offset == _offset && m_bands[i].Constraints[_index] < 0)
+		{
+			return &m_bands[i];
+		}
+	}
+
+	// Create a new band for the offset
+	TSpringBand band;
+	band.Offset = _offset;
+	band.Constraints.assign(m_particleCount, -1);
+	m_bands.push_back(band);
+
+	return &m_bands.back();
+}
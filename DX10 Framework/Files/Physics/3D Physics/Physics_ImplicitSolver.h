@@ -0,0 +1,178 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Physics_ImplicitSolver.h
+* Description : Backward Euler integrator for a grid of particles joined by constraints
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// Inclusion Guards
+#pragma once
+#ifndef __PHYSICS_IMPLICITSOLVER_H__
+#define __PHYSICS_IMPLICITSOLVER_H__
+
+// Local Includes
+#include "Physics_Constraint.h"
+
+/***********************
+* TSpringBand: All springs of the grid that join particles a fixed index offset apart
+* @author: Callan Moore
+********************/
+struct TSpringBand
+{
+	int Offset;
+
+	// Constraint index for each lower particle index. -1 if there is no spring
+	std::vector<int> Constraints;
+
+	// Upper triangle of the symmetric 3x3 system block for each spring (xx, xy, xz, yy, yz, zz)
+	std::vector<float> Blocks[6];
+};
+
+class Physics_ImplicitSolver
+{
+public:
+	/***********************
+	* Physics_ImplicitSolver: Default Constructor for Physics Implicit Solver class
+	* @author: Callan Moore
+	********************/
+	Physics_ImplicitSolver();
+
+	/***********************
+	* ~Physics_ImplicitSolver: Default Destructor for Physics Implicit Solver class
+	* @author: Callan Moore
+	********************/
+	~Physics_ImplicitSolver();
+
+	/***********************
+	* Initialise: Initialise the solver for a grid of particles and the constraints between them
+	* @author: Callan Moore
+	* @parameter: _pParticles: The particles of the grid, stored row by row
+	* @parameter: _particleCount: The number of particles
+	* @parameter: _pConstraints: The constraints between the particles
+	* @parameter: _timeStep: The time step to integrate over
+	* @return: bool: Successful or not
+	********************/
+	bool Initialise(Physics_Particle* _pParticles, int _particleCount, std::vector<Physics_Constraint>* _pConstraints, float _timeStep);
+
+	/***********************
+	* Step: Integrate all particles one time step using backward Euler
+	* @author: Callan Moore
+	* @parameter: _damping: Ratio of velocity lost each step
+	* @return: void
+	********************/
+	void Step(float _damping);
+
+	/***********************
+	* SetStiffness: Set the spring stiffness of the constraints
+	* @author: Callan Moore
+	* @parameter: _immediate: Stiffness of the immediate neighbor constraints
+	* @parameter: _secondary: Stiffness of the secondary constraints
+	* @return: void
+	********************/
+	void SetStiffness(float _immediate, float _secondary) { m_stiffness = _immediate; m_stiffnessSecondary = _secondary; };
+
+	/***********************
+	* SetTimeStep: Set the time step to integrate over
+	* @author: Callan Moore
+	* @parameter: _timeStep: The time step
+	* @return: void
+	********************/
+	void SetTimeStep(float _timeStep) { m_timeStep = _timeStep; };
+
+	/***********************
+	* GetIterations: Retrieve the conjugate gradient iterations used by the last step
+	* @author: Callan Moore
+	* @return: int: The iteration count
+	********************/
+	int GetIterations() { return m_iterations; };
+
+	/***********************
+	* GetResidual: Retrieve the relative residual the last step's solve finished with
+	* @author: Callan Moore
+	* @return: float: The relative residual
+	********************/
+	float GetResidual() { return m_residual; };
+
+private:
+
+	/***********************
+	* AssembleSystem: Calculate the system blocks, preconditioner and right hand side for the current state
+	* @author: Callan Moore
+	* @return: void
+	********************/
+	void AssembleSystem();
+
+	/***********************
+	* MultiplySystem: Multiply a vector by the system matrix without building the matrix
+	* @author: Callan Moore
+	* @parameter: _pIn: The x, y and z components of the vector to multiply
+	* @parameter: _pOut: Storage for the x, y and z components of the result
+	* @return: void
+	********************/
+	void MultiplySystem(std::vector<float>* _pIn, std::vector<float>* _pOut);
+
+	/***********************
+	* Filter: Zero the components of a vector for particles that can not move
+	* @author: Callan Moore
+	* @parameter: _pVector: The x, y and z components of the vector to filter
+	* @return: void
+	********************/
+	void Filter(std::vector<float>* _pVector);
+
+	/***********************
+	* Dot: Calculate the dot product of two vectors
+	* @author: Callan Moore
+	* @parameter: _pA: The x, y and z components of the first vector
+	* @parameter: _pB: The x, y and z components of the second vector
+	* @return: float: The dot product
+	********************/
+	float Dot(std::vector<float>* _pA, std::vector<float>* _pB);
+
+	/***********************
+	* FindBand: Find the spring band for an offset that has no spring at the input index yet, creating one if needed
+	* @author: Callan Moore
+	* @parameter: _offset: The index offset between the two particles
+	* @parameter: _index: The lower particle index
+	* @return: TSpringBand*: Pointer to the band
+	********************/
+	TSpringBand* FindBand(int _offset, int _index);
+
+private:
+	Physics_Particle* m_pParticles;
+	std::vector<Physics_Constraint>* m_pConstraints;
+	std::vector<TSpringBand> m_bands;
+
+	int m_particleCount;
+	int m_paddedCount;
+	float m_timeStep;
+
+	float m_stiffness;
+	float m_stiffnessSecondary;
+	float m_springDamping;
+
+	int m_maxIterations;
+	float m_tolerance;
+	int m_iterations;
+	float m_residual;
+
+	// Per particle vectors in x, y and z component arrays
+	std::vector<float> m_free;
+	std::vector<float> m_mass;
+	std::vector<float> m_velocity[3];
+	std::vector<float> m_rhs[3];
+	std::vector<float> m_inverseDiagonal[3];
+	std::vector<float> m_deltaVelocity[3];
+	std::vector<float> m_residualVec[3];
+	std::vector<float> m_search[3];
+	std::vector<float> m_product[3];
+	std::vector<float> m_preconditioned[3];
+};
+
+#endif	// __PHYSICS_IMPLICITSOLVER_H__
@@ -60,12 +60,12 @@ bool Physics_Particle::Initialise(UINT _particleID, TVertexColor* _pVertex, v3fl
 	return true;
 }
 
-void Physics_Particle::Process()
+void Physics_Particle::Process(bool _integrate)
 {
 	if (m_active == true)
 	{
 		// Process movement only if the particle is not static
-		if (m_static == false)
+		if (m_static == false && _integrate == true)
 		{
 			// Calculate and update position using verlet integration
 			v3float temp = m_pos;
@@ -119,6 +119,26 @@ void Physics_Particle::Move(v3float _movement)
 	}
 }
 
+void Physics_Particle::Integrate(v3float _velocity)
+{
+	if (m_active == true && m_static == false)
+	{
+		// Calculate and update position using the input velocity
+		m_prevPos = m_pos;
+		m_pos += _velocity * m_timeStep;
+	}
+	m_acceleration = { 0.0f, 0.0f, 0.0f };
+}
+
+void Physics_Particle::SetTimeStep(float _timeStep)
+{
+	// Verlet stores velocity as the last movement so scale it to the length of the new step
+	m_prevPos = m_pos - ((m_pos - m_prevPos) * (_timeStep / m_timeStep));
+
+	m_timeStep = _timeStep;
+	m_timeStepSquared = pow(_timeStep, 2.0f);
+}
+
 void Physics_Particle::SetPosition(v3float _pos, bool _stopMovement)
 {
 	if (m_static == false)
@@ -59,9 +59,26 @@ public:
 	/***********************
 	* Process: Process the Particle
 	* @author: Callan Moore
+	* @parameter: _integrate: Whether to move the particle using verlet integration. False when another integrator moves it
 	* @return: void
 	********************/
-	void Process();
+	void Process(bool _integrate = true);
+
+	/***********************
+	* Integrate: Move the particle by a velocity over one time step (only if the particle is not static)
+	* @author: Callan Moore
+	* @parameter: _velocity: The velocity for the time step
+	* @return: void
+	********************/
+	void Integrate(v3float _velocity);
+
+	/***********************
+	* SetTimeStep: Change the time step of the particle while keeping its current velocity
+	* @author: Callan Moore
+	* @parameter: _timeStep: The new time step
+	* @return: void
+	********************/
+	void SetTimeStep(float _timeStep);
 	
 	/***********************
 	* Move: The the particle by the input amount (only if the particle is not static)
@@ -100,6 +117,34 @@ public:
 	* @return: v3float*: The position of the particle in world space
 	********************/
 	v3float* GetPosition() { return &m_pos; };
+
+	/***********************
+	* GetPreviousPosition: Retrieve the position of the particle before its last movement
+	* @author: Callan Moore
+	* @return: v3float*: The previous position of the particle in world space
+	********************/
+	v3float* GetPreviousPosition() { return &m_prevPos; };
+
+	/***********************
+	* GetVelocity: Calculate the velocity of the particle from its last movement
+	* @author: Callan Moore
+	* @return: v3float: The velocity of the particle
+	********************/
+	v3float GetVelocity() { return ((m_pos - m_prevPos) / m_timeStep); };
+
+	/***********************
+	* GetAcceleration: Retrieve the acceleration accumulated from forces this time step
+	* @author: Callan Moore
+	* @return: v3float: The acceleration of the particle
+	********************/
+	v3float GetAcceleration() { return m_acceleration; };
+
+	/***********************
+	* GetMass: Retrieve the mass of the particle
+	* @author: Callan Moore
+	* @return: float: The mass of the particle
+	********************/
+	float GetMass() { return m_mass; };
 	
 	/***********************
 	* SetPosition: Set the position of the particle
@@ -0,0 +1,537 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Physics_Strands.cpp
+* Description : Batch of short particle chains (ropes, hair, cables) simulated together in structure of arrays form
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// This Include
+#include "Physics_Strands.h"
+
+Physics_Strands::Physics_Strands()
+{
+	// Initialise pointers to NULL
+	m_pRenderer = 0;
+	m_pShader = 0;
+	m_pMesh = 0;
+	m_pVertices = 0;
+	m_pIndices = 0;
+	m_pHeightfield = 0;
+
+	m_shuttingDown = false;
+	m_step = 0;
+	m_workersBusy = 0;
+}
+
+Physics_Strands::~Physics_Strands()
+{
+	// Stop the workers
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_shuttingDown = true;
+	}
+	m_stepReady.notify_all();
+	for (UINT i = 0; i < m_threads.size(); i++)
+	{
+		m_threads[i].join();
+	}
+
+	// Release allocated memory. The mesh owns the vertices and indices when there is one
+	if (m_pMesh != 0)
+	{
+		ReleasePtr(m_pMesh);
+	}
+	else
+	{
+		ReleasePtrArray(m_pVertices);
+		ReleasePtrArray(m_pIndices);
+	}
+}
+
+bool Physics_Strands::Initialise(DX10_Renderer* _pRenderer, DX10_Shader_Cloth* _pShader, int _strandCount, int _particlesPerStrand, float _damping, float _timeStep, int _threadCount)
+{
+	if ((_pRenderer != 0 && _pShader == 0) || _strandCount <= 0 || _particlesPerStrand < 2 || _threadCount < 0 || m_threads.empty() == false)
+	{
+		// Pointer is NULL, there are no chains to make or the strands are already running, initialization failed
+		return false;
+	}
+
+	// Assign member variables. A NULL renderer runs the strands headless without a mesh
+	BaseInitialise();
+	m_pRenderer = _pRenderer;
+	m_pShader = _pShader;
+	m_strandCount = _strandCount;
+	m_particlesPerStrand = _particlesPerStrand;
+	m_packetCount = (m_strandCount + STRAND_LANES - 1) / STRAND_LANES;
+	m_vertexCount = m_strandCount * m_particlesPerStrand;
+	m_indexCount = m_strandCount * (m_particlesPerStrand - 1) * 2;
+	m_constraintIterations = 3;
+	m_timeStep = _timeStep;
+	m_damping = _damping;
+	m_acceleration = { 0.0f, 0.0f, 0.0f };
+
+	// The pyramid collider never moves so its faces are packed once
+	m_pyramidFaces.Set(0, COLLIDER_PYRAMID_POINT_A, COLLIDER_PYRAMID_POINT_B, COLLIDER_PYRAMID_POINT_C);
+	m_pyramidFaces.Set(1, COLLIDER_PYRAMID_POINT_A, COLLIDER_PYRAMID_POINT_C, COLLIDER_PYRAMID_POINT_D);
+	m_pyramidFaces.Set(2, COLLIDER_PYRAMID_POINT_A, COLLIDER_PYRAMID_POINT_D, COLLIDER_PYRAMID_POINT_B);
+	m_pyramidFaces.Set(3, COLLIDER_PYRAMID_POINT_B, COLLIDER_PYRAMID_POINT_D, COLLIDER_PYRAMID_POINT_C);
+
+	// The unused lanes of the last packet stay pinned at the origin with no length
+	int particleCount = m_packetCount * m_particlesPerStrand * STRAND_LANES;
+	m_posX.assign(particleCount, 0.0f);
+	m_posY.assign(particleCount, 0.0f);
+	m_posZ.assign(particleCount, 0.0f);
+	m_prevX.assign(particleCount, 0.0f);
+	m_prevY.assign(particleCount, 0.0f);
+	m_prevZ.assign(particleCount, 0.0f);
+	m_invMass.assign(particleCount, 0.0f);
+	m_restLength.assign(m_packetCount * STRAND_LANES, 0.0f);
+
+	// Each strand is drawn as its own line list
+	m_pVertices = new TVertexColor[m_vertexCount];
+	m_pIndices = new DWORD[m_indexCount];
+	int index = 0;
+	for (int strand = 0; strand < m_strandCount; strand++)
+	{
+		for (int particle = 0; particle < m_particlesPerStrand - 1; particle++)
+		{
+			m_pIndices[index++] = (strand * m_particlesPerStrand) + particle;
+			m_pIndices[index++] = (strand * m_particlesPerStrand) + particle + 1;
+		}
+		SetStrand(strand, { 0.0f, 0.0f, 0.0f }, { 0.0f, -1.0f, 0.0f }, 1.0f);
+	}
+
+	if (m_pRenderer != 0)
+	{
+		// Create a new Strands Mesh
+		m_pMesh = new DX10_Mesh();
+		VALIDATE(m_pMesh->InitialiseCloth(m_pRenderer, m_pVertices, m_pIndices, m_vertexCount, m_indexCount, D3D10_PRIMITIVE_TOPOLOGY_LINELIST, D3D10_USAGE_DYNAMIC, D3D10_USAGE_DYNAMIC));
+	}
+
+	// Give each worker a contiguous range of packets. Small batches are not split for nothing
+	int threadCount = (_threadCount == 0) ? max(1, (int)std::thread::hardware_concurrency()) : _threadCount;
+	m_workerCount = min(threadCount, max(1, m_packetCount / STRAND_MIN_PACKETS_PER_THREAD));
+	m_packetsPerWorker = (m_packetCount + m_workerCount - 1) / m_workerCount;
+
+	// The calling thread of Process is the first worker so one fewer thread is started
+	for (int worker = 1; worker < m_workerCount; worker++)
+	{
+		m_threads.push_back(std::thread(&Physics_Strands::WorkerLoop, this, worker));
+	}
+
+	return true;
+}
+
+void Physics_Strands::SetStrand(int _strand, v3float _root, v3float _direction, float _length, D3DXCOLOR _color)
+{
+	if (_strand < 0 || _strand >= m_strandCount)
+	{
+		// No such strand
+		return;
+	}
+
+	v3float step = _direction.Normalise() * (_length / (float)(m_particlesPerStrand - 1));
+	m_restLength[_strand] = step.Magnitude();
+
+	for (int particle = 0; particle < m_particlesPerStrand; particle++)
+	{
+		int index = ParticleIndex(_strand, particle);
+		v3float pos = _root + (step * (float)particle);
+		m_posX[index] = m_prevX[index] = pos.x;
+		m_posY[index] = m_prevY[index] = pos.y;
+		m_posZ[index] = m_prevZ[index] = pos.z;
+
+		// The root is pinned
+		m_invMass[index] = (particle == 0) ? 0.0f : 1.0f;
+
+		TVertexColor* pVertex = &m_pVertices[(_strand * m_particlesPerStrand) + particle];
+		pVertex->pos = D3DXVECTOR3(pos.x, pos.y, pos.z);
+		pVertex->color = _color;
+	}
+}
+
+void Physics_Strands::MoveRoot(int _strand, v3float _root)
+{
+	if (_strand < 0 || _strand >= m_strandCount)
+	{
+		// No such strand
+		return;
+	}
+
+	int index = ParticleIndex(_strand, 0);
+	m_posX[index] = m_prevX[index] = _root.x;
+	m_posY[index] = m_prevY[index] = _root.y;
+	m_posZ[index] = m_prevZ[index] = _root.z;
+}
+
+void Physics_Strands::Process(eCollisionType _collisionType)
+{
+	CalcWorldMatrix();
+
+	// Adding Gravity
+	v3float acceleration = m_acceleration + v3float(0.0f, -9.81f, 0.0f);
+	m_acceleration = { 0.0f, 0.0f, 0.0f };
+
+	{
+		PROFILE_SCOPE("Strands.Solve");
+
+		// Hand the step to the waiting workers and solve the first range on this thread
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_stepCollisionType = _collisionType;
+			m_stepAcceleration = acceleration;
+			m_workersBusy = (int)m_threads.size();
+			m_step++;
+		}
+		m_stepReady.notify_all();
+
+		ProcessWorkerPackets(0);
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_stepDone.wait(lock, [this] { return (m_workersBusy == 0); });
+	}
+
+	// Update the vertex for each Particle
+	{
+		PROFILE_SCOPE("Strands.VertexWrite");
+		for (int strand = 0; strand < m_strandCount; strand++)
+		{
+			for (int particle = 0; particle < m_particlesPerStrand; particle++)
+			{
+				int index = ParticleIndex(strand, particle);
+				TVertexColor* pVertex = &m_pVertices[(strand * m_particlesPerStrand) + particle];
+				pVertex->pos.x = m_posX[index];
+				pVertex->pos.y = m_posY[index];
+				pVertex->pos.z = m_posZ[index];
+			}
+		}
+	}
+
+	// Update the Buffer. The strands never break so the indices do not change
+	if (m_pMesh != 0)
+	{
+		PROFILE_SCOPE("Strands.UpdateBuffer");
+		m_pMesh->UpdateBufferCloth(false);
+		PROFILE_COUNT("Strands.BytesUploaded", sizeof(TVertexHalfColor) * m_vertexCount);
+	}
+}
+
+void Physics_Strands::Render()
+{
+	// Create the struct to hold the strands rendering variables
+	if (m_pMesh == 0)
+	{
+		// Headless strands have nothing to render
+		return;
+	}
+
+	TCloth cloth;
+	cloth.pMatWorld = &m_matWorld;
+	cloth.pMesh = m_pMesh;
+
+	// Render the strands
+	m_pShader->Render(cloth);
+}
+
+v3float Physics_Strands::GetPosition(int _strand, int _particle)
+{
+	int index = ParticleIndex(_strand, _particle);
+	return v3float(m_posX[index], m_posY[index], m_posZ[index]);
+}
+
+// Private Functions
+
+void Physics_Strands::WorkerLoop(int _worker)
+{
+	UINT lastStep = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_stepReady.wait(lock, [this, lastStep] { return (m_shuttingDown == true || m_step != lastStep); });
+			if (m_shuttingDown == true)
+			{
+				break;
+			}
+			lastStep = m_step;
+		}
+
+		ProcessWorkerPackets(_worker);
+
+		bool lastToFinish = false;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_workersBusy--;
+			lastToFinish = (m_workersBusy == 0);
+		}
+		if (lastToFinish == true)
+		{
+			m_stepDone.notify_one();
+		}
+	}
+}
+
+void Physics_Strands::ProcessWorkerPackets(int _worker)
+{
+	// The step settings are written before the step counter is moved on and not again until every worker is done
+	int firstPacket = _worker * m_packetsPerWorker;
+	int lastPacket = min(m_packetCount, firstPacket + m_packetsPerWorker);
+	ProcessPackets(firstPacket, lastPacket, m_stepCollisionType, m_stepAcceleration);
+}
+
+void Physics_Strands::ProcessPackets(int _firstPacket, int _lastPacket, eCollisionType _collisionType, v3float _acceleration)
+{
+	float* pPosX = &m_posX[0];
+	float* pPosY = &m_posY[0];
+	float* pPosZ = &m_posZ[0];
+	float* pPrevX = &m_prevX[0];
+	float* pPrevY = &m_prevY[0];
+	float* pPrevZ = &m_prevZ[0];
+	float* pInvMass = &m_invMass[0];
+
+	v3float stepAcceleration = _acceleration * (m_timeStep * m_timeStep);
+	__m128 dampingInverse = _mm_set1_ps(1.0f - m_damping);
+	__m128 stepAccelerationX = _mm_set1_ps(stepAcceleration.x);
+	__m128 stepAccelerationY = _mm_set1_ps(stepAcceleration.y);
+	__m128 stepAccelerationZ = _mm_set1_ps(stepAcceleration.z);
+	__m128 epsilon = _mm_set1_ps(FLT_EPSILON);
+	int packetSize = m_particlesPerStrand * STRAND_LANES;
+
+	for (int packet = _firstPacket; packet < _lastPacket; packet++)
+	{
+		int start = packet * packetSize;
+		int end = start + packetSize;
+		__m128 restLength = _mm_loadu_ps(&m_restLength[packet * STRAND_LANES]);
+
+		// Verlet integration matching the cloth particles, a link of every lane at a time. Pinned particles have no inverse mass so they do not move
+		for (int i = start; i < end; i += STRAND_LANES)
+		{
+			__m128 posX = _mm_loadu_ps(pPosX + i);
+			__m128 posY = _mm_loadu_ps(pPosY + i);
+			__m128 posZ = _mm_loadu_ps(pPosZ + i);
+			__m128 invMass = _mm_loadu_ps(pInvMass + i);
+
+			__m128 moveX = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(posX, _mm_loadu_ps(pPrevX + i)), dampingInverse), stepAccelerationX), invMass);
+			__m128 moveY = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(posY, _mm_loadu_ps(pPrevY + i)), dampingInverse), stepAccelerationY), invMass);
+			__m128 moveZ = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(posZ, _mm_loadu_ps(pPrevZ + i)), dampingInverse), stepAccelerationZ), invMass);
+
+			_mm_storeu_ps(pPrevX + i, posX);
+			_mm_storeu_ps(pPrevY + i, posY);
+			_mm_storeu_ps(pPrevZ + i, posZ);
+			_mm_storeu_ps(pPosX + i, _mm_add_ps(posX, moveX));
+			_mm_storeu_ps(pPosY + i, _mm_add_ps(posY, moveY));
+			_mm_storeu_ps(pPosZ + i, _mm_add_ps(posZ, moveZ));
+		}
+
+		for (int iteration = 0; iteration < m_constraintIterations; iteration++)
+		{
+			// Walk down the chains. Each link is solved for all the lanes of the packet at once
+			for (int a = start; a < end - STRAND_LANES; a += STRAND_LANES)
+			{
+				int b = a + STRAND_LANES;
+				__m128 posAX = _mm_loadu_ps(pPosX + a);
+				__m128 posAY = _mm_loadu_ps(pPosY + a);
+				__m128 posAZ = _mm_loadu_ps(pPosZ + a);
+				__m128 posBX = _mm_loadu_ps(pPosX + b);
+				__m128 posBY = _mm_loadu_ps(pPosY + b);
+				__m128 posBZ = _mm_loadu_ps(pPosZ + b);
+				__m128 invMassA = _mm_loadu_ps(pInvMass + a);
+				__m128 invMassB = _mm_loadu_ps(pInvMass + b);
+
+				__m128 diffX = _mm_sub_ps(posBX, posAX);
+				__m128 diffY = _mm_sub_ps(posBY, posAY);
+				__m128 diffZ = _mm_sub_ps(posBZ, posAZ);
+				__m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(diffX, diffX), _mm_mul_ps(diffY, diffY)), _mm_mul_ps(diffZ, diffZ)));
+
+				// Split the correction by inverse mass so a pinned root, or an unused lane, takes none of it
+				__m128 massSum = _mm_add_ps(invMassA, invMassB);
+				__m128 correction = _mm_div_ps(_mm_sub_ps(length, restLength), _mm_add_ps(_mm_mul_ps(length, massSum), epsilon));
+				__m128 correctA = _mm_mul_ps(correction, invMassA);
+				__m128 correctB = _mm_mul_ps(correction, invMassB);
+
+				_mm_storeu_ps(pPosX + a, _mm_add_ps(posAX, _mm_mul_ps(diffX, correctA)));
+				_mm_storeu_ps(pPosY + a, _mm_add_ps(posAY, _mm_mul_ps(diffY, correctA)));
+				_mm_storeu_ps(pPosZ + a, _mm_add_ps(posAZ, _mm_mul_ps(diffZ, correctA)));
+				_mm_storeu_ps(pPosX + b, _mm_sub_ps(posBX, _mm_mul_ps(diffX, correctB)));
+				_mm_storeu_ps(pPosY + b, _mm_sub_ps(posBY, _mm_mul_ps(diffY, correctB)));
+				_mm_storeu_ps(pPosZ + b, _mm_sub_ps(posBZ, _mm_mul_ps(diffZ, correctB)));
+			}
+
+			// Collide the packet while it is still in cache
+			for (int i = start; i < end; i += STRAND_LANES)
+			{
+				CollideLanes(i, _collisionType);
+			}
+		}
+	}
+}
+
+void Physics_Strands::CollideLanes(int _index, eCollisionType _collisionType)
+{
+	__m128 startX = _mm_loadu_ps(&m_posX[_index]);
+	__m128 startY = _mm_loadu_ps(&m_posY[_index]);
+	__m128 startZ = _mm_loadu_ps(&m_posZ[_index]);
+	__m128 posX = startX;
+	__m128 posY = startY;
+	__m128 posZ = startZ;
+
+	// Pinned particles are not collided, the same as static cloth particles
+	__m128 movable = _mm_cmpneq_ps(_mm_loadu_ps(&m_invMass[_index]), _mm_setzero_ps());
+	__m128 stopMovement = _mm_setzero_ps();
+
+	// Lanes are pushed one at a time by the pyramid and terrain, through these
+	SIMD_ALIGN float laneX[STRAND_LANES];
+	SIMD_ALIGN float laneY[STRAND_LANES];
+	SIMD_ALIGN float laneZ[STRAND_LANES];
+	SIMD_ALIGN float laneStop[STRAND_LANES];
+	int movableLanes = _mm_movemask_ps(movable);
+
+	// Calculate the collisions with the same objects as the cloth
+	switch (_collisionType)
+	{
+		case CT_SPHERE:
+		{
+			v3float center = COLLIDER_SPHERE_CENTRE;
+			SphereCollisionLanes(posX, posY, posZ, _mm_set1_ps(center.x), _mm_set1_ps(center.y), _mm_set1_ps(center.z), COLLIDER_SPHERE_RADIUS);
+		}
+		break;
+		case CT_CAPSULE:
+		{
+			// Collide with a sphere at the closest point on the capsule line
+			v3float capsuleStart = COLLIDER_CAPSULE_CENTRE_A;
+			v3float capsuleLine = COLLIDER_CAPSULE_CENTRE_B - COLLIDER_CAPSULE_CENTRE_A;
+			__m128 lineX = _mm_set1_ps(capsuleLine.x);
+			__m128 lineY = _mm_set1_ps(capsuleLine.y);
+			__m128 lineZ = _mm_set1_ps(capsuleLine.z);
+			__m128 startToPosX = _mm_sub_ps(posX, _mm_set1_ps(capsuleStart.x));
+			__m128 startToPosY = _mm_sub_ps(posY, _mm_set1_ps(capsuleStart.y));
+			__m128 startToPosZ = _mm_sub_ps(posZ, _mm_set1_ps(capsuleStart.z));
+
+			__m128 ratio = _mm_div_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(startToPosX, lineX), _mm_mul_ps(startToPosY, lineY)), _mm_mul_ps(startToPosZ, lineZ)), _mm_set1_ps(capsuleLine.Dot(capsuleLine)));
+			ratio = _mm_min_ps(_mm_set1_ps(1.0f), _mm_max_ps(_mm_setzero_ps(), ratio));
+			SphereCollisionLanes(posX, posY, posZ,
+				_mm_add_ps(_mm_set1_ps(capsuleStart.x), _mm_mul_ps(lineX, ratio)),
+				_mm_add_ps(_mm_set1_ps(capsuleStart.y), _mm_mul_ps(lineY, ratio)),
+				_mm_add_ps(_mm_set1_ps(capsuleStart.z), _mm_mul_ps(lineZ, ratio)),
+				COLLIDER_CAPSULE_RADIUS);
+		}
+		break;
+		case CT_PYRAMID:
+		{
+			// The four faces are already tested at once for each particle, so the lanes are pushed out one at a time
+			_mm_store_ps(laneX, posX);
+			_mm_store_ps(laneY, posY);
+			_mm_store_ps(laneZ, posZ);
+			_mm_store_ps(laneStop, _mm_setzero_ps());
+			for (int lane = 0; lane < STRAND_LANES; lane++)
+			{
+				if ((movableLanes & (1 << lane)) != 0)
+				{
+					v3float pos = v3float(laneX[lane], laneY[lane], laneZ[lane]);
+					laneStop[lane] = (PyramidCollision(pos) == true) ? 1.0f : 0.0f;
+					laneX[lane] = pos.x;
+					laneY[lane] = pos.y;
+					laneZ[lane] = pos.z;
+				}
+			}
+			posX = _mm_load_ps(laneX);
+			posY = _mm_load_ps(laneY);
+			posZ = _mm_load_ps(laneZ);
+			stopMovement = _mm_cmpneq_ps(_mm_load_ps(laneStop), _mm_setzero_ps());
+		}
+		break;
+		default: break;
+	}	// End Switch
+
+	// Calculate the permanent collisions
+	__m128 floorHeight = _mm_set1_ps(COLLIDER_FLOOR_HEIGHT);
+	__m128 onFloor = _mm_and_ps(movable, _mm_cmple_ps(posY, _mm_set1_ps(COLLIDER_FLOOR_HEIGHT + 0.1f)));
+	__m128 floorDistance = _mm_andnot_ps(_mm_set1_ps(-0.0f), _mm_sub_ps(posY, floorHeight));
+	posY = SelectLanes(onFloor, _mm_add_ps(posY, floorDistance), posY);
+	stopMovement = _mm_or_ps(stopMovement, onFloor);
+
+	if (m_pHeightfield != 0)
+	{
+		// The terrain is sampled one lane at a time
+		_mm_store_ps(laneX, posX);
+		_mm_store_ps(laneY, posY);
+		_mm_store_ps(laneZ, posZ);
+		_mm_store_ps(laneStop, _mm_setzero_ps());
+		for (int lane = 0; lane < STRAND_LANES; lane++)
+		{
+			float height;
+			v3float normal;
+			if ((movableLanes & (1 << lane)) != 0 && m_pHeightfield->Sample(laneX[lane], laneZ[lane], height, normal) == true && laneY[lane] < height)
+			{
+				v3float pos = v3float(laneX[lane], laneY[lane], laneZ[lane]) + (normal * ((height - laneY[lane]) * normal.y));
+				laneX[lane] = pos.x;
+				laneY[lane] = pos.y;
+				laneZ[lane] = pos.z;
+				laneStop[lane] = 1.0f;
+			}
+		}
+		posX = _mm_load_ps(laneX);
+		posY = _mm_load_ps(laneY);
+		posZ = _mm_load_ps(laneZ);
+		stopMovement = _mm_or_ps(stopMovement, _mm_cmpneq_ps(_mm_load_ps(laneStop), _mm_setzero_ps()));
+	}
+
+	// Only the movable lanes are written back
+	posX = SelectLanes(movable, posX, startX);
+	posY = SelectLanes(movable, posY, startY);
+	posZ = SelectLanes(movable, posZ, startZ);
+	_mm_storeu_ps(&m_posX[_index], posX);
+	_mm_storeu_ps(&m_posY[_index], posY);
+	_mm_storeu_ps(&m_posZ[_index], posZ);
+
+	// Stops the movement of the lanes that hit something so verlet integration doesn't carry them back in
+	_mm_storeu_ps(&m_prevX[_index], SelectLanes(stopMovement, posX, _mm_loadu_ps(&m_prevX[_index])));
+	_mm_storeu_ps(&m_prevY[_index], SelectLanes(stopMovement, posY, _mm_loadu_ps(&m_prevY[_index])));
+	_mm_storeu_ps(&m_prevZ[_index], SelectLanes(stopMovement, posZ, _mm_loadu_ps(&m_prevZ[_index])));
+}
+
+void Physics_Strands::SphereCollisionLanes(__m128& _prPosX, __m128& _prPosY, __m128& _prPosZ, __m128 _centerX, __m128 _centerY, __m128 _centerZ, float _sphereRadius)
+{
+	// Calculate the line between each particle and its sphere
+	__m128 lineX = _mm_sub_ps(_prPosX, _centerX);
+	__m128 lineY = _mm_sub_ps(_prPosY, _centerY);
+	__m128 lineZ = _mm_sub_ps(_prPosZ, _centerZ);
+	__m128 distanceApart = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(lineX, lineX), _mm_mul_ps(lineY, lineY)), _mm_mul_ps(lineZ, lineZ)));
+
+	// Push the particles that are in their sphere out using the shortest path possible. A particle on the centre has no path and stays
+	__m128 radius = _mm_set1_ps(_sphereRadius);
+	__m128 inside = _mm_and_ps(_mm_cmplt_ps(distanceApart, radius), _mm_cmpneq_ps(distanceApart, _mm_setzero_ps()));
+	__m128 push = _mm_sub_ps(radius, distanceApart);
+	_prPosX = SelectLanes(inside, _mm_add_ps(_prPosX, _mm_mul_ps(_mm_div_ps(lineX, distanceApart), push)), _prPosX);
+	_prPosY = SelectLanes(inside, _mm_add_ps(_prPosY, _mm_mul_ps(_mm_div_ps(lineY, distanceApart), push)), _prPosY);
+	_prPosZ = SelectLanes(inside, _mm_add_ps(_prPosZ, _mm_mul_ps(_mm_div_ps(lineZ, distanceApart), push)), _prPosZ);
+}
+
+bool Physics_Strands::PyramidCollision(v3float& _prPos)
+{
+	// Find the closest point on the four faces of the pyramid
+	v3float closestPt;
+	float closestDist = NearestPointOnTriangles(_prPos, m_pyramidFaces, closestPt);
+
+	// If the point is outside all planes then the point is within the bounds of the pyramid
+	if (PointOutsideOfPlanes(_prPos, m_pyramidFaces) == 0xF)
+	{
+		// Move the particle outside the pyramid using the closest point
+		_prPos = closestPt + ((closestPt - _prPos).Normalise() * COLLIDER_PYRAMID_MARGIN);
+		return true;
+	}
+	else if (closestDist < COLLIDER_PYRAMID_MARGIN * COLLIDER_PYRAMID_MARGIN)
+	{
+		// Move the particle a small distance from the pyramid
+		_prPos = closestPt + ((_prPos - closestPt).Normalise() * COLLIDER_PYRAMID_MARGIN);
+		return true;
+	}
+	return false;
+}
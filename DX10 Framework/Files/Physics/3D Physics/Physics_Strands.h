@@ -0,0 +1,262 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Physics_Strands.h
+* Description : Batch of short particle chains (ropes, hair, cables) simulated together in structure of arrays form
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// Inclusion Guards
+#pragma once
+#ifndef __PHYSICS_STRANDS_H__
+#define __PHYSICS_STRANDS_H__
+
+// Local Includes
+#include "Physics_Cloth.h"
+
+// Library Includes
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Defines
+// Strands are solved in packets of this many side by side so each step along the chains is one SIMD operation
+#define STRAND_LANES 4
+// Fewest packets given to a worker thread so small batches are not split for nothing
+#define STRAND_MIN_PACKETS_PER_THREAD 32
+
+class Physics_Strands
+	: public DX10_Obj_Generic
+{
+public:
+	/***********************
+	* Physics_Strands: Default Constructor for Physics Strands class
+	* @author: Callan Moore
+	********************/
+	Physics_Strands();
+
+	/***********************
+	* ~Physics_Strands: Default Destructor for Physics Strands class. Stops the worker threads
+	* @author: Callan Moore
+	********************/
+	~Physics_Strands();
+
+	/***********************
+	* Initialise: Initialise the strands and start the worker threads that solve them. Every strand starts hanging one unit down from the origin
+	* @author: Callan Moore
+	* @parameter: _pRenderer: DX10 Renderer for this application. NULL to simulate without rendering
+	* @parameter: _pShader: The cloth shader to render the strands with
+	* @parameter: _strandCount: The number of strands
+	* @parameter: _particlesPerStrand: The number of particles down each strand including the root
+	* @parameter: _damping: The damping of the particle movement
+	* @parameter: _timeStep: The time step of each processed frame
+	* @parameter: _threadCount: The most threads that solve the strands, the calling thread included. Zero for one per core
+	* @return: bool: Successful or not
+	********************/
+	bool Initialise(DX10_Renderer* _pRenderer, DX10_Shader_Cloth* _pShader, int _strandCount, int _particlesPerStrand, float _damping = 0.01f, float _timeStep = 0.016667f, int _threadCount = 0);
+
+	/***********************
+	* SetStrand: Lay a strand out in a straight line from its root. The root is pinned
+	* @author: Callan Moore
+	* @parameter: _strand: The index of the strand
+	* @parameter: _root: The position of the root
+	* @parameter: _direction: The direction the strand points from the root
+	* @parameter: _length: The length of the strand
+	* @parameter: _color: The color of the strand
+	* @return: void
+	********************/
+	void SetStrand(int _strand, v3float _root, v3float _direction, float _length, D3DXCOLOR _color = d3dxColors::White);
+
+	/***********************
+	* MoveRoot: Move the pinned root of a strand. The rest of the strand follows through its constraints
+	* @author: Callan Moore
+	* @parameter: _strand: The index of the strand
+	* @parameter: _root: The new position of the root
+	* @return: void
+	********************/
+	void MoveRoot(int _strand, v3float _root);
+
+	/***********************
+	* Process: Integrate, constrain and collide every strand for one time step
+	* @author: Callan Moore
+	* @parameter: _collisionType: The type of object the strands collide with
+	* @return: void
+	********************/
+	void Process(eCollisionType _collisionType);
+
+	/***********************
+	* Render: Render the strands to the screen
+	* @author: Callan Moore
+	* @return: void
+	********************/
+	void Render();
+
+	/***********************
+	* AddForce: Add a force to every strand for the next processed step
+	* @author: Callan Moore
+	* @parameter: _force: The force to add
+	* @return: void
+	********************/
+	void AddForce(v3float _force) { m_acceleration += _force; };
+
+	/***********************
+	* SetHeightfield: Set a terrain for the strands to collide with as well as the floor
+	* @author: Callan Moore
+	* @parameter: _pHeightfield: The terrain heightfield. Not owned by the strands. NULL to stop colliding with it
+	* @return: void
+	********************/
+	void SetHeightfield(Physics_Heightfield* _pHeightfield) { m_pHeightfield = _pHeightfield; };
+
+	/***********************
+	* SetConstraintIterations: Set the number of times the constraints are solved each step
+	* @author: Callan Moore
+	* @parameter: _iterations: The number of iterations
+	* @return: void
+	********************/
+	void SetConstraintIterations(int _iterations) { m_constraintIterations = max(1, _iterations); };
+
+	/***********************
+	* GetPosition: Retrieve the position of a particle on a strand
+	* @author: Callan Moore
+	* @parameter: _strand: The index of the strand
+	* @parameter: _particle: The index of the particle down the strand
+	* @return: v3float: The position of the particle
+	********************/
+	v3float GetPosition(int _strand, int _particle);
+
+	/***********************
+	* GetStrandCount: Retrieve the number of strands
+	* @author: Callan Moore
+	* @return: int: The strand count
+	********************/
+	int GetStrandCount() { return m_strandCount; };
+
+	/***********************
+	* GetParticlesPerStrand: Retrieve the number of particles down each strand
+	* @author: Callan Moore
+	* @return: int: The particle count of a strand
+	********************/
+	int GetParticlesPerStrand() { return m_particlesPerStrand; };
+
+private:
+
+	/***********************
+	* ParticleIndex: Calculate where a particle is stored. Packets are contiguous and the lanes of a packet are interleaved
+	* @author: Callan Moore
+	* @parameter: _strand: The index of the strand
+	* @parameter: _particle: The index of the particle down the strand
+	* @return: int: The index into the particle arrays
+	********************/
+	int ParticleIndex(int _strand, int _particle) { return (((_strand / STRAND_LANES) * m_particlesPerStrand) + _particle) * STRAND_LANES + (_strand % STRAND_LANES); };
+
+	/***********************
+	* WorkerLoop: Wait for each step and solve the range of packets of a worker until the strands shut down
+	* @author: Callan Moore
+	* @parameter: _worker: The index of the worker. The calling thread of Process is worker zero
+	* @return: void
+	********************/
+	void WorkerLoop(int _worker);
+
+	/***********************
+	* ProcessWorkerPackets: Integrate, constrain and collide the range of packets of a worker for the current step
+	* @author: Callan Moore
+	* @parameter: _worker: The index of the worker
+	* @return: void
+	********************/
+	void ProcessWorkerPackets(int _worker);
+
+	/***********************
+	* ProcessPackets: Integrate, constrain and collide a range of packets. Packets share no particles so ranges can run on separate threads
+	* @author: Callan Moore
+	* @parameter: _firstPacket: The first packet to process
+	* @parameter: _lastPacket: One past the last packet to process
+	* @parameter: _collisionType: The type of object the strands collide with
+	* @parameter: _acceleration: The acceleration of every particle this step
+	* @return: void
+	********************/
+	void ProcessPackets(int _firstPacket, int _lastPacket, eCollisionType _collisionType, v3float _acceleration);
+
+	/***********************
+	* CollideLanes: Push the particles of every lane at one link of a packet out of the collision object, floor and terrain
+	* @author: Callan Moore
+	* @parameter: _index: The index into the particle arrays of the first lane
+	* @parameter: _collisionType: The type of object the strands collide with
+	* @return: void
+	********************/
+	void CollideLanes(int _index, eCollisionType _collisionType);
+
+	/***********************
+	* SphereCollisionLanes: Push the positions of four lanes out of a sphere each
+	* @author: Callan Moore
+	* @parameter: _prPosX: The X of the positions to push out
+	* @parameter: _prPosY: The Y of the positions to push out
+	* @parameter: _prPosZ: The Z of the positions to push out
+	* @parameter: _centerX: The X of the centre of the sphere of each lane
+	* @parameter: _centerY: The Y of the centre of the sphere of each lane
+	* @parameter: _centerZ: The Z of the centre of the sphere of each lane
+	* @parameter: _sphereRadius: The radius of the spheres
+	* @return: void
+	********************/
+	void SphereCollisionLanes(__m128& _prPosX, __m128& _prPosY, __m128& _prPosZ, __m128 _centerX, __m128 _centerY, __m128 _centerZ, float _sphereRadius);
+
+	/***********************
+	* PyramidCollision: Push a position out of the pyramid
+	* @author: Callan Moore
+	* @parameter: _prPos: The position to push out
+	* @return: bool: True if the position was moved
+	********************/
+	bool PyramidCollision(v3float& _prPos);
+
+private:
+	DX10_Renderer* m_pRenderer;
+	DX10_Shader_Cloth* m_pShader;
+	DX10_Mesh* m_pMesh;
+	TVertexColor* m_pVertices;
+	DWORD* m_pIndices;
+	Physics_Heightfield* m_pHeightfield;
+
+	int m_strandCount;
+	int m_particlesPerStrand;
+	int m_packetCount;
+	int m_vertexCount;
+	int m_indexCount;
+	int m_constraintIterations;
+	int m_workerCount;
+	int m_packetsPerWorker;
+
+	float m_timeStep;
+	float m_damping;
+	v3float m_acceleration;
+	TTrianglePacket m_pyramidFaces;
+
+	// Particle Variables. Stored in packets of STRAND_LANES strands
+	std::vector<float> m_posX;
+	std::vector<float> m_posY;
+	std::vector<float> m_posZ;
+	std::vector<float> m_prevX;
+	std::vector<float> m_prevY;
+	std::vector<float> m_prevZ;
+	std::vector<float> m_invMass;
+
+	// Distance between neighbouring particles for each lane of each packet
+	std::vector<float> m_restLength;
+
+	// Worker threads started once and handed each step. The step counter tells a worker a new step is waiting
+	std::vector<std::thread> m_threads;
+	std::mutex m_mutex;
+	std::condition_variable m_stepReady;
+	std::condition_variable m_stepDone;
+	bool m_shuttingDown;
+	UINT m_step;
+	int m_workersBusy;
+	eCollisionType m_stepCollisionType;
+	v3float m_stepAcceleration;
+};
+
+#endif	// __PHYSICS_STRANDS_H__
@@ -19,6 +19,8 @@
 
 // Physics 2D Includes
 #include "3D Physics/Physics_Cloth.h"
+#include "3D Physics/Physics_ClothServer.h"
+#include "3D Physics/Physics_Strands.h"
 
 
 #endif	// __PHYSICS_2D_H__
\ No newline at end of file
@@ -0,0 +1,189 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Benchmark_Cloth.cpp
+* Description : Headless benchmark comparing the position based and implicit cloth integrators on the same cloth
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// This Include
+#include "Benchmark_Cloth.h"
+
+bool Benchmark_Cloth::Run(std::string _filePath)
+{
+	std::ofstream report(_filePath.c_str());
+	if (report.is_open() == false)
+	{
+		return false;
+	}
+
+	const char* scenarioNames[CS_COUNT] = { "Hanging", "Wind 40x", "Explode" };
+	bool implicitStable = true;
+
+	report << "Cloth " << BENCHMARK_CLOTH_SIZE << " x " << BENCHMARK_CLOTH_SIZE << ", 1/30 s steps, no substeps" << std::endl;
+	report << "Scenario        PBD ms   Implicit ms   Speedup   PBD stable   Implicit stable   CG iterations" << std::endl;
+	for (int scenario = 0; scenario < CS_COUNT; scenario++)
+	{
+		double pbdSeconds;
+		double implicitSeconds;
+		bool pbdStable;
+		bool stable;
+		float pbdIterations;
+		float implicitIterations;
+		if (RunScenario(IT_VERLET, (eClothScenario)scenario, pbdSeconds, pbdStable, pbdIterations) == false
+			|| RunScenario(IT_IMPLICIT, (eClothScenario)scenario, implicitSeconds, stable, implicitIterations) == false)
+		{
+			return false;
+		}
+		implicitStable &= stable;
+
+		double pbdMs = (pbdSeconds * 1000.0) / BENCHMARK_CLOTH_FRAMES;
+		double implicitMs = (implicitSeconds * 1000.0) / BENCHMARK_CLOTH_FRAMES;
+		report << std::left << std::setw(12) << scenarioNames[scenario] << std::right << std::fixed << std::setprecision(3)
+			<< std::setw(10) << pbdMs << std::setw(14) << implicitMs
+			<< std::setw(9) << std::setprecision(2) << ((implicitMs > 0.0) ? pbdMs / implicitMs : 0.0) << "x"
+			<< std::setw(13) << ((pbdStable == true) ? "yes" : "NO") << std::setw(18) << ((stable == true) ? "yes" : "NO")
+			<< std::setw(16) << std::setprecision(1) << implicitIterations << std::endl;
+	}
+
+	// Compare the violation left by each iteration count with and without Chebyshev acceleration
+	report << std::endl << "Wind 40x, position based, violation left by the last sweep as a ratio of the rest length" << std::endl;
+	report << "Iterations   Plain RMS   Plain max   Plain ms   Chebyshev RMS   Chebyshev max   Chebyshev ms" << std::endl;
+	for (int iterations = 1; iterations <= BENCHMARK_CLOTH_MAX_ITERATIONS; iterations++)
+	{
+		double plainSeconds;
+		double chebyshevSeconds;
+		float plainRMS;
+		float plainMax;
+		float chebyshevRMS;
+		float chebyshevMax;
+		if (RunConvergence(iterations, false, plainSeconds, plainRMS, plainMax) == false
+			|| RunConvergence(iterations, true, chebyshevSeconds, chebyshevRMS, chebyshevMax) == false)
+		{
+			return false;
+		}
+
+		report << std::setw(10) << iterations << std::setprecision(5)
+			<< std::setw(12) << plainRMS << std::setw(12) << plainMax
+			<< std::setw(11) << std::setprecision(3) << (plainSeconds * 1000.0) / BENCHMARK_CLOTH_FRAMES << std::setprecision(5)
+			<< std::setw(16) << chebyshevRMS << std::setw(16) << chebyshevMax
+			<< std::setw(15) << std::setprecision(3) << (chebyshevSeconds * 1000.0) / BENCHMARK_CLOTH_FRAMES << std::endl;
+	}
+
+	return implicitStable;
+}
+
+// Private Functions
+
+bool Benchmark_Cloth::RunScenario(eIntegratorType _integrator, eClothScenario _scenario, double& _prSeconds, bool& _prStable, float& _prSolverIterations)
+{
+	Physics_Cloth* pCloth = new Physics_Cloth();
+	if (pCloth->Initialise(0, 0, BENCHMARK_CLOTH_SIZE, BENCHMARK_CLOTH_SIZE, 0.01f, BENCHMARK_CLOTH_TIME_STEP) == false)
+	{
+		ReleasePtr(pCloth);
+		return false;
+	}
+
+	// One step per frame and no sleeping so every frame is simulated
+	TClothQuality quality = pCloth->GetQuality();
+	quality.Substeps = 1;
+	quality.SleepVelocity = 0.0f;
+	pCloth->SetQuality(quality);
+	pCloth->SetIntegrator(_integrator);
+	pCloth->UpdateWindSpeed(1.0f);
+
+	if (_scenario == CS_EXPLODE)
+	{
+		pCloth->Explode(0.5f);
+	}
+
+	int solverIterations = 0;
+	Timer timer;
+	timer.Reset();
+	_prSeconds = 0.0;
+	for (int frame = 0; frame < BENCHMARK_CLOTH_FRAMES; frame++)
+	{
+		timer.Tick();
+		if (_scenario == CS_WIND)
+		{
+			pCloth->AddForce({ 0.0f, 0.0f, 1.0f }, FT_WIND, false);
+		}
+		pCloth->Process(CT_NONE);
+		timer.Tick();
+		_prSeconds += timer.GetDeltaTime();
+
+		if (_integrator == IT_IMPLICIT)
+		{
+			solverIterations += pCloth->GetImplicitSolver()->GetIterations();
+		}
+	}
+	_prSolverIterations = (float)solverIterations / (float)BENCHMARK_CLOTH_FRAMES;
+
+	// A cloth that blew up has particles that are not finite or have flown off
+	_prStable = true;
+	TVertexColor* pVertices = pCloth->GetVertices();
+	for (int i = 0; i < pCloth->GetParticleCount(); i++)
+	{
+		// Written so a position that is not a number fails the comparison
+		D3DXVECTOR3 pos = pVertices[i].pos;
+		if ((sqrt(pos.x * pos.x + pos.y * pos.y + pos.z * pos.z) < BENCHMARK_CLOTH_BOUNDS) == false)
+		{
+			_prStable = false;
+		}
+	}
+
+	ReleasePtr(pCloth);
+	return true;
+}
+
+bool Benchmark_Cloth::RunConvergence(int _iterations, bool _chebyshev, double& _prSeconds, float& _prRMSResidual, float& _prMaxResidual)
+{
+	Physics_Cloth* pCloth = new Physics_Cloth();
+	if (pCloth->Initialise(0, 0, BENCHMARK_CLOTH_SIZE, BENCHMARK_CLOTH_SIZE, 0.01f, BENCHMARK_CLOTH_TIME_STEP) == false)
+	{
+		ReleasePtr(pCloth);
+		return false;
+	}
+
+	// A fixed iteration count, one step per frame and no sleeping so every frame does the same work
+	TClothQuality quality = pCloth->GetQuality();
+	quality.ConstraintIterations = _iterations;
+	quality.Substeps = 1;
+	quality.SleepVelocity = 0.0f;
+	pCloth->SetQuality(quality);
+	pCloth->SetIntegrator(IT_VERLET);
+	pCloth->UpdateWindSpeed(1.0f);
+	if (pCloth->GetChebyshevEnabled() != _chebyshev)
+	{
+		pCloth->ToggleChebyshev();
+	}
+
+	double sumRMS = 0.0;
+	double sumMax = 0.0;
+	Timer timer;
+	timer.Reset();
+	_prSeconds = 0.0;
+	for (int frame = 0; frame < BENCHMARK_CLOTH_FRAMES; frame++)
+	{
+		timer.Tick();
+		pCloth->AddForce({ 0.0f, 0.0f, 1.0f }, FT_WIND, false);
+		pCloth->Process(CT_NONE);
+		timer.Tick();
+		_prSeconds += timer.GetDeltaTime();
+
+		TSolverMetrics metrics = pCloth->GetSolverMetrics();
+		sumRMS += metrics.RMSResidual;
+		sumMax += metrics.MaxResidual;
+	}
+	_prRMSResidual = (float)(sumRMS / BENCHMARK_CLOTH_FRAMES);
+	_prMaxResidual = (float)(sumMax / BENCHMARK_CLOTH_FRAMES);
+
+	ReleasePtr(pCloth);
+	return true;
+}
\ No newline at end of file
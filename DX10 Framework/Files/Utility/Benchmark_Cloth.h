@@ -0,0 +1,94 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Benchmark_Cloth.h
+* Description : Headless benchmark comparing the position based and implicit cloth integrators on the same cloth
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// Inclusion Guards
+#pragma once
+#ifndef __BENCHMARK_CLOTH_H__
+#define __BENCHMARK_CLOTH_H__
+
+// Local Includes
+#include "Utilities.h"
+#include "../Physics/3D Physics/Physics_Cloth.h"
+#include "Timer.h"
+
+// Library Includes
+#include <fstream>
+#include <iomanip>
+
+// Defines
+// Particles across and down the cloth, less one
+#define BENCHMARK_CLOTH_SIZE 31
+// Time step of each frame. Large enough that the position based solve needs its iterations
+#define BENCHMARK_CLOTH_TIME_STEP (1.0f / 30.0f)
+// Number of frames each scenario is stepped for
+#define BENCHMARK_CLOTH_FRAMES 90
+// Furthest a particle may be from the origin before the cloth is reported as unstable
+#define BENCHMARK_CLOTH_BOUNDS 1000.0f
+// Most constraint iterations the convergence comparison steps the position based cloth with
+#define BENCHMARK_CLOTH_MAX_ITERATIONS 8
+
+/***********************
+* eClothScenario: Enum for the scenarios each integrator is stepped through
+* @author: Callan Moore
+********************/
+enum eClothScenario
+{
+	CS_HANGING,
+	CS_WIND,
+	CS_EXPLODE,
+	CS_COUNT
+};
+
+class Benchmark_Cloth
+{
+public:
+	/***********************
+	* Run: Step the same cloth through each scenario with the position based and the implicit integrators at a thirtieth of a
+	*	second with no substeps, and write a report of the frame times and whether each stayed stable. Then compare how far
+	*	the constraint iterations converge with and without Chebyshev acceleration
+	* @author: Callan Moore
+	* @parameter: _filePath: The file to write the report to
+	* @return: bool: False if the report could not be written, a cloth could not be created or the implicit cloth became unstable
+	********************/
+	static bool Run(std::string _filePath);
+
+private:
+
+	/***********************
+	* RunScenario: Step a new cloth through a scenario with one integrator
+	* @author: Callan Moore
+	* @parameter: _integrator: The integrator to move the cloth with
+	* @parameter: _scenario: The scenario to step
+	* @parameter: _prSeconds: Storage for the time taken by the steps
+	* @parameter: _prStable: Storage for whether every particle stayed finite and within bounds
+	* @parameter: _prSolverIterations: Storage for the mean conjugate gradient iterations of an implicit step. Zero for the position based integrator
+	* @return: bool: False if the cloth could not be created
+	********************/
+	static bool RunScenario(eIntegratorType _integrator, eClothScenario _scenario, double& _prSeconds, bool& _prStable, float& _prSolverIterations);
+
+	/***********************
+	* RunConvergence: Step a new position based cloth in the wind with a fixed number of constraint iterations and measure
+	*	the constraint violation left after them
+	* @author: Callan Moore
+	* @parameter: _iterations: The constraint iterations of each step
+	* @parameter: _chebyshev: Whether the iterations are Chebyshev accelerated
+	* @parameter: _prSeconds: Storage for the time taken by the steps
+	* @parameter: _prRMSResidual: Storage for the mean over the frames of the RMS violation found by the last sweep of a step
+	* @parameter: _prMaxResidual: Storage for the mean over the frames of the largest violation found by the last sweep of a step
+	* @return: bool: False if the cloth could not be created
+	********************/
+	static bool RunConvergence(int _iterations, bool _chebyshev, double& _prSeconds, float& _prRMSResidual, float& _prMaxResidual);
+};
+
+#endif	// __BENCHMARK_CLOTH_H__
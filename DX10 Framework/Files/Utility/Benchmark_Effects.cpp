@@ -0,0 +1,129 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Benchmark_Effects.cpp
+* Description : Headless benchmark of the pooled particle effects at their target particle count
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// This Include
+#include "Benchmark_Effects.h"
+
+bool Benchmark_Effects::Run(std::string _filePath)
+{
+	std::ofstream report(_filePath.c_str());
+	if (report.is_open() == false)
+	{
+		return false;
+	}
+
+	// Two emitters share the target count, one short lived and fast like embers and one slow like smoke. Particles die
+	// every frame so the swap removal and the emits that replace them are part of the timing
+	Physics_Effects* pEffects = new Physics_Effects();
+	if (pEffects->Initialise(0, 0, BENCHMARK_EFFECTS_PARTICLES) == false)
+	{
+		ReleasePtr(pEffects);
+		return false;
+	}
+	int embers = pEffects->AddEmitter(CreateSettings(BENCHMARK_EFFECTS_PARTICLES / 2, 0.75f, { 0.0f, 4.0f, 0.0f }, { 0.0f, -9.8f, 0.0f }));
+	int smoke = pEffects->AddEmitter(CreateSettings(BENCHMARK_EFFECTS_PARTICLES - (BENCHMARK_EFFECTS_PARTICLES / 2), 3.0f, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.5f, 0.0f }));
+
+	// Sum of the live counts so the compiler cannot drop the work
+	double liveTotal = 0.0;
+	double emitSeconds = 0.0;
+	double processSeconds = 0.0;
+	double slowestFrameSeconds = 0.0;
+	int lowestLive = BENCHMARK_EFFECTS_PARTICLES;
+	Timer timer;
+	timer.Reset();
+	for (int frame = 0; frame < BENCHMARK_EFFECTS_FRAMES; frame++)
+	{
+		// Refill both pools before each update so every update moves the full count
+		timer.Tick();
+		pEffects->Emit(embers, { 0.0f, 0.0f, 0.0f }, BENCHMARK_EFFECTS_PARTICLES);
+		pEffects->Emit(smoke, { 0.0f, 0.0f, 0.0f }, BENCHMARK_EFFECTS_PARTICLES);
+		timer.Tick();
+		double emitted = timer.GetDeltaTime();
+		lowestLive = min(lowestLive, pEffects->GetLiveCount());
+		pEffects->Process(BENCHMARK_EFFECTS_FRAME_TIME);
+		timer.Tick();
+		double processed = timer.GetDeltaTime();
+
+		emitSeconds += emitted;
+		processSeconds += processed;
+		slowestFrameSeconds = max(slowestFrameSeconds, emitted + processed);
+		liveTotal += pEffects->GetLiveCount();
+	}
+	ReleasePtr(pEffects);
+
+	double emitMs = (emitSeconds * 1000.0) / BENCHMARK_EFFECTS_FRAMES;
+	double processMs = (processSeconds * 1000.0) / BENCHMARK_EFFECTS_FRAMES;
+	double frameMs = emitMs + processMs;
+	double budgetMs = BENCHMARK_EFFECTS_FRAME_TIME * 1000.0;
+	bool full = (lowestLive == BENCHMARK_EFFECTS_PARTICLES);
+
+	report << "Particles per frame       " << BENCHMARK_EFFECTS_PARTICLES << ((full == true) ? "" : "   NOT FULL") << std::endl;
+	report << std::fixed << std::setprecision(3);
+	report << "Emit ms                   " << std::setw(9) << emitMs << std::endl;
+	report << "Update ms                 " << std::setw(9) << processMs << std::endl;
+	report << "Frame ms                  " << std::setw(9) << frameMs << std::endl;
+	report << "Slowest frame ms          " << std::setw(9) << slowestFrameSeconds * 1000.0 << std::endl;
+	report << "Update ns per particle    " << std::setw(9) << (processSeconds * 1e9) / ((double)BENCHMARK_EFFECTS_PARTICLES * BENCHMARK_EFFECTS_FRAMES) << std::endl;
+	report << "Frame budget ms           " << std::setw(9) << budgetMs << ((frameMs <= budgetMs) ? "   ok" : "   OVER BUDGET") << std::endl;
+	report << "Live particles (average)  " << std::setw(9) << std::setprecision(0) << liveTotal / BENCHMARK_EFFECTS_FRAMES << std::endl;
+
+	// Burn a headless cloth that spawns into the effects the way the application would
+	Physics_Cloth* pCloth = new Physics_Cloth();
+	pEffects = new Physics_Effects();
+	bool burnt = (pCloth->Initialise(0, 0, 20, 20) == true && pEffects->Initialise(0, 0, BENCHMARK_EFFECTS_PARTICLES) == true);
+	int spawned = 0;
+	if (burnt == true)
+	{
+		embers = pEffects->AddEmitter(CreateSettings(BENCHMARK_EFFECTS_PARTICLES / 2, 0.75f, { 0.0f, 4.0f, 0.0f }, { 0.0f, -9.8f, 0.0f }));
+		smoke = pEffects->AddEmitter(CreateSettings(BENCHMARK_EFFECTS_PARTICLES - (BENCHMARK_EFFECTS_PARTICLES / 2), 3.0f, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.5f, 0.0f }));
+		pCloth->SetEffects(pEffects, embers, smoke);
+
+		// Light the middle of the cloth with a ray straight at it
+		TCameraRay ray;
+		ray.Origin = { 0.0f, 0.0f, -20.0f };
+		ray.Direction = { 0.0f, 0.0f, 1.0f };
+		pCloth->Ignite(ray, 1.0f);
+
+		for (int frame = 0; frame < BENCHMARK_EFFECTS_BURN_FRAMES; frame++)
+		{
+			pCloth->Process(CT_NONE);
+			pEffects->Process(BENCHMARK_EFFECTS_FRAME_TIME);
+			spawned = max(spawned, pEffects->GetLiveCount());
+		}
+	}
+	ReleasePtr(pEffects);
+	ReleasePtr(pCloth);
+
+	burnt &= (spawned > 0);
+	report << std::endl << "Burning cloth most live   " << std::setw(9) << spawned << ((burnt == true) ? "   ok" : "   NOTHING SPAWNED") << std::endl;
+
+	return (full == true && burnt == true);
+}
+
+// Private Functions
+
+TEmitterSettings Benchmark_Effects::CreateSettings(int _capacity, float _lifetime, v3float _velocity, v3float _acceleration)
+{
+	TEmitterSettings settings;
+	settings.Capacity = _capacity;
+	settings.Lifetime = _lifetime;
+	settings.LifetimeVariance = _lifetime * 0.5f;
+	settings.Velocity = _velocity;
+	settings.Spread = 1.0f;
+	settings.Acceleration = _acceleration;
+	settings.Drag = 0.5f;
+	settings.StartColor = D3DXCOLOR(1.0f, 0.6f, 0.1f, 1.0f);
+	settings.EndColor = D3DXCOLOR(0.2f, 0.2f, 0.2f, 0.0f);
+	return settings;
+}
@@ -0,0 +1,65 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Benchmark_Effects.h
+* Description : Headless benchmark of the pooled particle effects at their target particle count
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// Inclusion Guards
+#pragma once
+#ifndef __BENCHMARK_EFFECTS_H__
+#define __BENCHMARK_EFFECTS_H__
+
+// Local Includes
+#include "Utilities.h"
+#include "../Physics/3D Physics/Physics_Cloth.h"
+#include "Timer.h"
+
+// Library Includes
+#include <fstream>
+#include <iomanip>
+
+// Defines
+// Number of live particles the effects are expected to update every frame on one core
+#define BENCHMARK_EFFECTS_PARTICLES 100000
+// Number of frames timed
+#define BENCHMARK_EFFECTS_FRAMES 300
+// Time of each frame. The application steps its physics at 30 frames a second
+#define BENCHMARK_EFFECTS_FRAME_TIME (1.0f / 30.0f)
+// Number of frames the burning cloth is stepped for
+#define BENCHMARK_EFFECTS_BURN_FRAMES 120
+
+class Benchmark_Effects
+{
+public:
+	/***********************
+	* Run: Keep the effects full at the target particle count and time the emits and updates of every frame against the
+	*	frame time, then burn a headless cloth into the effects to check burning constraints spawn embers and smoke
+	* @author: Callan Moore
+	* @parameter: _filePath: The file to write the report to
+	* @return: bool: False if the report could not be written, the effects could not be kept full or the burning cloth spawned nothing
+	********************/
+	static bool Run(std::string _filePath);
+
+private:
+
+	/***********************
+	* CreateSettings: Create the settings of an emitter for the benchmark
+	* @author: Callan Moore
+	* @parameter: _capacity: The most particles the emitter holds
+	* @parameter: _lifetime: The average life of a particle in seconds
+	* @parameter: _velocity: The velocity particles spawn with
+	* @parameter: _acceleration: The constant acceleration of the particles
+	* @return: TEmitterSettings: The settings
+	********************/
+	static TEmitterSettings CreateSettings(int _capacity, float _lifetime, v3float _velocity, v3float _acceleration);
+};
+
+#endif	// __BENCHMARK_EFFECTS_H__
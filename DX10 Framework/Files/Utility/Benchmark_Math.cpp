@@ -0,0 +1,746 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Benchmark_Math.cpp
+* Description : Microbenchmarks comparing the scalar math types and D3DX with the SIMD math layer
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// This Include
+#include "Benchmark_Math.h"
+
+bool Benchmark_Math::Run(std::string _filePath)
+{
+	std::ofstream report(_filePath.c_str());
+	if (report.is_open() == false)
+	{
+		return false;
+	}
+
+	// Fill the inputs with random vectors. One is zero to keep the normalise paths honest
+	std::vector<v3float> inputA(BENCHMARK_VECTORS);
+	std::vector<v3float> inputB(BENCHMARK_VECTORS);
+	std::vector<v3float> output(BENCHMARK_VECTORS);
+	std::vector<float> outputFloats(BENCHMARK_VECTORS);
+	for (int i = 0; i < BENCHMARK_VECTORS; i++)
+	{
+		inputA[i] = { (float)(rand() % 2001 - 1000) / 100.0f, (float)(rand() % 2001 - 1000) / 100.0f, (float)(rand() % 2001 - 1000) / 100.0f };
+		inputB[i] = { (float)(rand() % 2001 - 1000) / 100.0f, (float)(rand() % 2001 - 1000) / 100.0f, (float)(rand() % 2001 - 1000) / 100.0f };
+	}
+	inputA[0] = { 0.0f, 0.0f, 0.0f };
+
+	// Sum every result so the compiler cannot drop the work
+	float checksum = 0.0f;
+	Timer timer;
+	timer.Reset();
+	double scalarSeconds;
+	double simdSeconds;
+
+	report << "Operation                 Scalar ns   SIMD ns   Speedup" << std::endl;
+
+	// Length
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		for (int i = 0; i < BENCHMARK_VECTORS; i++)
+		{
+			outputFloats[i] = inputA[i].Magnitude();
+		}
+		checksum += outputFloats[repeat % BENCHMARK_VECTORS];
+	}
+	timer.Tick();
+	scalarSeconds = timer.GetDeltaTime();
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		for (int i = 0; i < BENCHMARK_VECTORS; i++)
+		{
+			outputFloats[i] = Length(v4simd(inputA[i]));
+		}
+		checksum += outputFloats[repeat % BENCHMARK_VECTORS];
+	}
+	timer.Tick();
+	simdSeconds = timer.GetDeltaTime();
+	Report(report, "Length (single)", scalarSeconds, simdSeconds);
+
+	// Add
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		for (int i = 0; i < BENCHMARK_VECTORS; i++)
+		{
+			output[i] = inputA[i] + inputB[i];
+		}
+		checksum += output[repeat % BENCHMARK_VECTORS].x;
+	}
+	timer.Tick();
+	scalarSeconds = timer.GetDeltaTime();
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		BatchAdd(&inputA[0], &inputB[0], &output[0], BENCHMARK_VECTORS);
+		checksum += output[repeat % BENCHMARK_VECTORS].x;
+	}
+	timer.Tick();
+	simdSeconds = timer.GetDeltaTime();
+	Report(report, "Add (batch)", scalarSeconds, simdSeconds);
+
+	// Scale
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		for (int i = 0; i < BENCHMARK_VECTORS; i++)
+		{
+			output[i] = inputA[i] * 0.5f;
+		}
+		checksum += output[repeat % BENCHMARK_VECTORS].x;
+	}
+	timer.Tick();
+	scalarSeconds = timer.GetDeltaTime();
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		BatchScale(&inputA[0], 0.5f, &output[0], BENCHMARK_VECTORS);
+		checksum += output[repeat % BENCHMARK_VECTORS].x;
+	}
+	timer.Tick();
+	simdSeconds = timer.GetDeltaTime();
+	Report(report, "Scale (batch)", scalarSeconds, simdSeconds);
+
+	// Dot
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		for (int i = 0; i < BENCHMARK_VECTORS; i++)
+		{
+			outputFloats[i] = inputA[i].Dot(inputB[i]);
+		}
+		checksum += outputFloats[repeat % BENCHMARK_VECTORS];
+	}
+	timer.Tick();
+	scalarSeconds = timer.GetDeltaTime();
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		BatchDot(&inputA[0], &inputB[0], &outputFloats[0], BENCHMARK_VECTORS);
+		checksum += outputFloats[repeat % BENCHMARK_VECTORS];
+	}
+	timer.Tick();
+	simdSeconds = timer.GetDeltaTime();
+	Report(report, "Dot (batch)", scalarSeconds, simdSeconds);
+
+	// Cross
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		for (int i = 0; i < BENCHMARK_VECTORS; i++)
+		{
+			output[i] = inputA[i].Cross(inputB[i]);
+		}
+		checksum += output[repeat % BENCHMARK_VECTORS].x;
+	}
+	timer.Tick();
+	scalarSeconds = timer.GetDeltaTime();
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		BatchCross(&inputA[0], &inputB[0], &output[0], BENCHMARK_VECTORS);
+		checksum += output[repeat % BENCHMARK_VECTORS].x;
+	}
+	timer.Tick();
+	simdSeconds = timer.GetDeltaTime();
+	Report(report, "Cross (batch)", scalarSeconds, simdSeconds);
+
+	// Normalise. The scalar version is the same for each accuracy
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		for (int i = 0; i < BENCHMARK_VECTORS; i++)
+		{
+			output[i] = inputA[i];
+			output[i].Normalise();
+		}
+		checksum += output[repeat % BENCHMARK_VECTORS].x;
+	}
+	timer.Tick();
+	scalarSeconds = timer.GetDeltaTime();
+
+	std::string accuracyNames[3] = { "Normalise exact (batch)", "Normalise refined (batch)", "Normalise fast (batch)" };
+	for (int accuracy = NA_EXACT; accuracy <= NA_FAST; accuracy++)
+	{
+		timer.Tick();
+		for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+		{
+			BatchNormalise(&inputA[0], &output[0], BENCHMARK_VECTORS, (eNormaliseAccuracy)accuracy);
+			checksum += output[repeat % BENCHMARK_VECTORS].x;
+		}
+		timer.Tick();
+		simdSeconds = timer.GetDeltaTime();
+		Report(report, accuracyNames[accuracy], scalarSeconds, simdSeconds);
+	}
+
+	// Random numbers. Each repeat draws the next block of the stream
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		UINT64 firstIndex = (UINT64)repeat * BENCHMARK_VECTORS;
+		for (int i = 0; i < BENCHMARK_VECTORS; i++)
+		{
+			outputFloats[i] = RandomRange(1, RS_EFFECTS, firstIndex + i, -1.0f, 1.0f);
+		}
+		checksum += outputFloats[repeat % BENCHMARK_VECTORS];
+	}
+	timer.Tick();
+	scalarSeconds = timer.GetDeltaTime();
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		FillRandomRange(1, RS_EFFECTS, (UINT64)repeat * BENCHMARK_VECTORS, &outputFloats[0], BENCHMARK_VECTORS, -1.0f, 1.0f);
+		checksum += outputFloats[repeat % BENCHMARK_VECTORS];
+	}
+	timer.Tick();
+	simdSeconds = timer.GetDeltaTime();
+	Report(report, "Random range (batch)", scalarSeconds, simdSeconds);
+
+	bool matchesD3DX = RunMatrix(report, checksum);
+	bool matchesScalar = RunCollision(report, checksum);
+
+	report << "Checksum: " << checksum << std::endl;
+	return (matchesD3DX == true && matchesScalar == true);
+}
+
+// Private Functions
+
+bool Benchmark_Math::RunMatrix(std::ostream& _rOut, float& _rChecksum)
+{
+	// Random rotation, scale and translation matrices, like the world and view matrices in the framework
+	std::vector<D3DXMATRIX> inputA(BENCHMARK_MATRICES);
+	std::vector<D3DXMATRIX> inputB(BENCHMARK_MATRICES);
+	std::vector<D3DXMATRIX> outputD3DX(BENCHMARK_MATRICES);
+	std::vector<D3DXMATRIX> outputSIMD(BENCHMARK_MATRICES);
+	for (int i = 0; i < BENCHMARK_MATRICES; i++)
+	{
+		v4simd axisA((float)(rand() % 201 - 100), (float)(rand() % 201 - 100), (float)(rand() % 201 - 100) + 0.5f);
+		v4simd axisB((float)(rand() % 201 - 100) + 0.5f, (float)(rand() % 201 - 100), (float)(rand() % 201 - 100));
+		v4simd scale(RandomFloat(0.5f, 2.0f), RandomFloat(0.5f, 2.0f), RandomFloat(0.5f, 2.0f));
+		v4simd translation(RandomFloat(-100.0f, 100.0f), RandomFloat(-100.0f, 100.0f), RandomFloat(-100.0f, 100.0f));
+		MatrixCompose(scale, QuaternionRotationAxis(axisA, RandomFloat(-PI, PI)), translation).Store(inputA[i]);
+		MatrixCompose(v4simd(1.0f, 1.0f, 1.0f), QuaternionRotationAxis(axisB, RandomFloat(-PI, PI)), translation * -0.5f).Store(inputB[i]);
+	}
+
+	std::vector<v3float> points(BENCHMARK_VECTORS);
+	std::vector<v3float> outputPointsD3DX(BENCHMARK_VECTORS);
+	std::vector<v3float> outputPointsSIMD(BENCHMARK_VECTORS);
+	for (int i = 0; i < BENCHMARK_VECTORS; i++)
+	{
+		points[i] = { RandomFloat(-100.0f, 100.0f), RandomFloat(-100.0f, 100.0f), RandomFloat(-100.0f, 100.0f) };
+	}
+
+	// Points go through a perspective projection so the divide by W is exercised
+	D3DXMATRIX matView;
+	D3DXMATRIX matProj;
+	D3DXMATRIX matViewProj;
+	D3DXMatrixLookAtLH(&matView, &D3DXVECTOR3(0.0f, 25.0f, -250.0f), &D3DXVECTOR3(0.0f, 0.0f, 0.0f), &D3DXVECTOR3(0.0f, 1.0f, 0.0f));
+	D3DXMatrixPerspectiveFovLH(&matProj, 0.25f * PI, 4.0f / 3.0f, 1.0f, 10000.0f);
+	D3DXMatrixMultiply(&matViewProj, &matView, &matProj);
+	m4simd simdViewProj(matViewProj);
+
+	bool matchesD3DX = true;
+	Timer timer;
+	timer.Reset();
+	double d3dxSeconds;
+	double simdSeconds;
+	double matrixOperations = (double)BENCHMARK_MATRICES * (double)BENCHMARK_REPEATS;
+	std::vector<float> errors;
+
+	_rOut << std::endl << "Operation                   D3DX ns   SIMD ns   Speedup" << std::endl;
+
+	// Multiply
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		for (int i = 0; i < BENCHMARK_MATRICES; i++)
+		{
+			D3DXMatrixMultiply(&outputD3DX[i], &inputA[i], &inputB[i]);
+		}
+		_rChecksum += outputD3DX[repeat % BENCHMARK_MATRICES]._11;
+	}
+	timer.Tick();
+	d3dxSeconds = timer.GetDeltaTime();
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		for (int i = 0; i < BENCHMARK_MATRICES; i++)
+		{
+			MatrixMultiply(m4simd(inputA[i]), m4simd(inputB[i])).Store(outputSIMD[i]);
+		}
+		_rChecksum += outputSIMD[repeat % BENCHMARK_MATRICES]._11;
+	}
+	timer.Tick();
+	simdSeconds = timer.GetDeltaTime();
+	Report(_rOut, "Matrix multiply", d3dxSeconds, simdSeconds, matrixOperations);
+	errors.push_back(MaxError(outputSIMD[0], outputD3DX[0], BENCHMARK_MATRICES * 16));
+
+	// General inverse
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		for (int i = 0; i < BENCHMARK_MATRICES; i++)
+		{
+			D3DXMatrixInverse(&outputD3DX[i], NULL, &inputA[i]);
+		}
+		_rChecksum += outputD3DX[repeat % BENCHMARK_MATRICES]._11;
+	}
+	timer.Tick();
+	d3dxSeconds = timer.GetDeltaTime();
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		for (int i = 0; i < BENCHMARK_MATRICES; i++)
+		{
+			m4simd inverse;
+			MatrixInverse(m4simd(inputA[i]), inverse);
+			inverse.Store(outputSIMD[i]);
+		}
+		_rChecksum += outputSIMD[repeat % BENCHMARK_MATRICES]._11;
+	}
+	timer.Tick();
+	simdSeconds = timer.GetDeltaTime();
+	Report(_rOut, "Matrix inverse", d3dxSeconds, simdSeconds, matrixOperations);
+	errors.push_back(MaxError(outputSIMD[0], outputD3DX[0], BENCHMARK_MATRICES * 16));
+
+	// Affine inverse. D3DX has no affine version so it is timed against the general D3DX inverse above
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		for (int i = 0; i < BENCHMARK_MATRICES; i++)
+		{
+			m4simd inverse;
+			MatrixInverseAffine(m4simd(inputA[i]), inverse);
+			inverse.Store(outputSIMD[i]);
+		}
+		_rChecksum += outputSIMD[repeat % BENCHMARK_MATRICES]._11;
+	}
+	timer.Tick();
+	simdSeconds = timer.GetDeltaTime();
+	Report(_rOut, "Matrix inverse affine", d3dxSeconds, simdSeconds, matrixOperations);
+	errors.push_back(MaxError(outputSIMD[0], outputD3DX[0], BENCHMARK_MATRICES * 16));
+
+	// World matrix as built by DX10_Obj_Generic::CalcWorldMatrix
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		for (int i = 0; i < BENCHMARK_MATRICES; i++)
+		{
+			D3DXMATRIX matRotateX;
+			D3DXMATRIX matRotateY;
+			D3DXMATRIX matRotateZ;
+			D3DXMATRIX matTranslation;
+			D3DXMATRIX matScale;
+			D3DXMatrixScaling(&matScale, inputA[i]._21, inputA[i]._22, inputA[i]._23);
+			D3DXMatrixRotationX(&matRotateX, inputA[i]._11);
+			D3DXMatrixRotationY(&matRotateY, inputA[i]._12);
+			D3DXMatrixRotationZ(&matRotateZ, inputA[i]._13);
+			D3DXMatrixTranslation(&matTranslation, inputA[i]._41, inputA[i]._42, inputA[i]._43);
+			outputD3DX[i] = matScale * matRotateX * matRotateY * matRotateZ * matTranslation;
+		}
+		_rChecksum += outputD3DX[repeat % BENCHMARK_MATRICES]._11;
+	}
+	timer.Tick();
+	d3dxSeconds = timer.GetDeltaTime();
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		for (int i = 0; i < BENCHMARK_MATRICES; i++)
+		{
+			m4simd matWorld = MatrixScaling(v4simd(inputA[i]._21, inputA[i]._22, inputA[i]._23)) * MatrixRotationX(inputA[i]._11) * MatrixRotationY(inputA[i]._12) * MatrixRotationZ(inputA[i]._13);
+			matWorld.r[3] = MatrixTranslation(v4simd(inputA[i]._41, inputA[i]._42, inputA[i]._43)).r[3];
+			matWorld.Store(outputSIMD[i]);
+		}
+		_rChecksum += outputSIMD[repeat % BENCHMARK_MATRICES]._11;
+	}
+	timer.Tick();
+	simdSeconds = timer.GetDeltaTime();
+	Report(_rOut, "World matrix", d3dxSeconds, simdSeconds, matrixOperations);
+	errors.push_back(MaxError(outputSIMD[0], outputD3DX[0], BENCHMARK_MATRICES * 16));
+
+	// Transform points
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		for (int i = 0; i < BENCHMARK_VECTORS; i++)
+		{
+			D3DXVec3TransformCoord((D3DXVECTOR3*)&outputPointsD3DX[i], (D3DXVECTOR3*)&points[i], &matViewProj);
+		}
+		_rChecksum += outputPointsD3DX[repeat % BENCHMARK_VECTORS].x;
+	}
+	timer.Tick();
+	d3dxSeconds = timer.GetDeltaTime();
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		BatchTransformCoord(simdViewProj, &points[0], &outputPointsSIMD[0], BENCHMARK_VECTORS);
+		_rChecksum += outputPointsSIMD[repeat % BENCHMARK_VECTORS].x;
+	}
+	timer.Tick();
+	simdSeconds = timer.GetDeltaTime();
+	Report(_rOut, "Transform coord (batch)", d3dxSeconds, simdSeconds);
+	errors.push_back(MaxError((float*)&outputPointsSIMD[0], (float*)&outputPointsD3DX[0], BENCHMARK_VECTORS * 3));
+
+	// Transform normals
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		for (int i = 0; i < BENCHMARK_VECTORS; i++)
+		{
+			D3DXVec3TransformNormal((D3DXVECTOR3*)&outputPointsD3DX[i], (D3DXVECTOR3*)&points[i], &inputA[0]);
+		}
+		_rChecksum += outputPointsD3DX[repeat % BENCHMARK_VECTORS].x;
+	}
+	timer.Tick();
+	d3dxSeconds = timer.GetDeltaTime();
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		BatchTransformNormal(m4simd(inputA[0]), &points[0], &outputPointsSIMD[0], BENCHMARK_VECTORS);
+		_rChecksum += outputPointsSIMD[repeat % BENCHMARK_VECTORS].x;
+	}
+	timer.Tick();
+	simdSeconds = timer.GetDeltaTime();
+	Report(_rOut, "Transform normal (batch)", d3dxSeconds, simdSeconds);
+	errors.push_back(MaxError((float*)&outputPointsSIMD[0], (float*)&outputPointsD3DX[0], BENCHMARK_VECTORS * 3));
+
+	// Check the functions that are too cheap or too rarely called to be worth timing
+	D3DXMATRIX reference;
+	D3DXMATRIX result;
+	_rOut << std::endl << "Largest difference from D3DX" << std::endl;
+	matchesD3DX &= ReportError(_rOut, "Matrix multiply", errors[0]);
+	matchesD3DX &= ReportError(_rOut, "Matrix inverse", errors[1]);
+	matchesD3DX &= ReportError(_rOut, "Matrix inverse affine", errors[2]);
+	matchesD3DX &= ReportError(_rOut, "World matrix", errors[3]);
+	matchesD3DX &= ReportError(_rOut, "Transform coord (batch)", errors[4]);
+	matchesD3DX &= ReportError(_rOut, "Transform normal (batch)", errors[5]);
+
+	D3DXMatrixInverse(&reference, NULL, &matViewProj);
+	m4simd inverseViewProj;
+	MatrixInverse(simdViewProj, inverseViewProj);
+	inverseViewProj.Store(result);
+	matchesD3DX &= ReportError(_rOut, "Matrix inverse projection", MaxError(result, reference, 16));
+
+	D3DXMatrixLookAtLH(&reference, &D3DXVECTOR3(3.0f, 25.0f, -50.0f), &D3DXVECTOR3(1.0f, 2.0f, 3.0f), &D3DXVECTOR3(0.0f, 1.0f, 0.0f));
+	MatrixLookAtLH(v4simd(3.0f, 25.0f, -50.0f), v4simd(1.0f, 2.0f, 3.0f), v4simd(0.0f, 1.0f, 0.0f)).Store(result);
+	matchesD3DX &= ReportError(_rOut, "Look at LH", MaxError(result, reference, 16));
+
+	D3DXMatrixPerspectiveFovLH(&reference, 0.25f * PI, 4.0f / 3.0f, 1.0f, 10000.0f);
+	MatrixPerspectiveFovLH(0.25f * PI, 4.0f / 3.0f, 1.0f, 10000.0f).Store(result);
+	matchesD3DX &= ReportError(_rOut, "Perspective fov LH", MaxError(result, reference, 16));
+
+	D3DXMatrixOrthoLH(&reference, 800.0f, 600.0f, 0.1f, 100.0f);
+	MatrixOrthoLH(800.0f, 600.0f, 0.1f, 100.0f).Store(result);
+	matchesD3DX &= ReportError(_rOut, "Ortho LH", MaxError(result, reference, 16));
+
+	D3DXMatrixRotationYawPitchRoll(&reference, 1.1f, -0.4f, 0.3f);
+	MatrixRotationYawPitchRoll(1.1f, -0.4f, 0.3f).Store(result);
+	matchesD3DX &= ReportError(_rOut, "Rotation yaw pitch roll", MaxError(result, reference, 16));
+
+	D3DXMatrixRotationAxis(&reference, &D3DXVECTOR3(1.0f, 2.0f, -3.0f), 0.77f);
+	MatrixRotationAxis(v4simd(1.0f, 2.0f, -3.0f), 0.77f).Store(result);
+	matchesD3DX &= ReportError(_rOut, "Rotation axis", MaxError(result, reference, 16));
+
+	D3DXPLANE plane(1.0f, 2.0f, 2.0f, -6.0f);
+	D3DXMatrixReflect(&reference, &plane);
+	MatrixReflect(v4simd(1.0f, 2.0f, 2.0f, -6.0f)).Store(result);
+	matchesD3DX &= ReportError(_rOut, "Reflect", MaxError(result, reference, 16));
+
+	// Quaternions are compared through the matrices they build, which also checks MatrixRotationQuaternion
+	D3DXQUATERNION quat1;
+	D3DXQUATERNION quat2;
+	D3DXQUATERNION quatResult;
+	D3DXQuaternionRotationAxis(&quat1, &D3DXVECTOR3(1.0f, 2.0f, -3.0f), 0.77f);
+	D3DXQuaternionRotationAxis(&quat2, &D3DXVECTOR3(-2.0f, 0.5f, 1.0f), 1.9f);
+	q4simd simdQuat1 = QuaternionRotationAxis(v4simd(1.0f, 2.0f, -3.0f), 0.77f);
+	q4simd simdQuat2 = QuaternionRotationAxis(v4simd(-2.0f, 0.5f, 1.0f), 1.9f);
+
+	D3DXQuaternionMultiply(&quatResult, &quat1, &quat2);
+	D3DXMatrixRotationQuaternion(&reference, &quatResult);
+	MatrixRotationQuaternion(QuaternionMultiply(simdQuat1, simdQuat2)).Store(result);
+	matchesD3DX &= ReportError(_rOut, "Quaternion multiply", MaxError(result, reference, 16));
+
+	D3DXQuaternionSlerp(&quatResult, &quat1, &quat2, 0.3f);
+	D3DXMatrixRotationQuaternion(&reference, &quatResult);
+	MatrixRotationQuaternion(QuaternionSlerp(simdQuat1, simdQuat2, 0.3f)).Store(result);
+	matchesD3DX &= ReportError(_rOut, "Quaternion slerp", MaxError(result, reference, 16));
+
+	D3DXQuaternionRotationYawPitchRoll(&quatResult, 1.1f, -0.4f, 0.3f);
+	D3DXMatrixRotationQuaternion(&reference, &quatResult);
+	MatrixRotationQuaternion(QuaternionRotationYawPitchRoll(1.1f, -0.4f, 0.3f)).Store(result);
+	matchesD3DX &= ReportError(_rOut, "Quaternion yaw pitch roll", MaxError(result, reference, 16));
+
+	D3DXMatrixTransformation(&reference, NULL, NULL, &D3DXVECTOR3(2.0f, 3.0f, 0.5f), NULL, &quat1, &D3DXVECTOR3(4.0f, -5.0f, 6.0f));
+	MatrixCompose(v4simd(2.0f, 3.0f, 0.5f), simdQuat1, v4simd(4.0f, -5.0f, 6.0f)).Store(result);
+	matchesD3DX &= ReportError(_rOut, "Compose", MaxError(result, reference, 16));
+
+	return matchesD3DX;
+}
+
+bool Benchmark_Math::RunCollision(std::ostream& _rOut, float& _rChecksum)
+{
+	// Points and rays scattered around four random triangles, like particles around the pyramid collider
+	v3float triangles[4][3];
+	TTrianglePacket packet;
+	for (int tri = 0; tri < 4; tri++)
+	{
+		for (int corner = 0; corner < 3; corner++)
+		{
+			triangles[tri][corner] = { RandomFloat(-10.0f, 10.0f), RandomFloat(-10.0f, 10.0f), RandomFloat(-10.0f, 10.0f) };
+		}
+		packet.Set(tri, triangles[tri][0], triangles[tri][1], triangles[tri][2]);
+	}
+
+	std::vector<v3float> points(BENCHMARK_VECTORS);
+	std::vector<v3float> outputScalar(BENCHMARK_VECTORS);
+	std::vector<v3float> outputSIMD(BENCHMARK_VECTORS);
+	std::vector<int> masksScalar(BENCHMARK_VECTORS);
+	std::vector<int> masksSIMD(BENCHMARK_VECTORS);
+	for (int i = 0; i < BENCHMARK_VECTORS; i++)
+	{
+		points[i] = { RandomFloat(-15.0f, 15.0f), RandomFloat(-15.0f, 15.0f), RandomFloat(-15.0f, 15.0f) };
+	}
+	v3float rayDirection = v3float(RandomFloat(-1.0f, 1.0f), RandomFloat(-1.0f, 1.0f), 1.0f).Normalise();
+
+	Timer timer;
+	timer.Reset();
+	double scalarSeconds;
+	double simdSeconds;
+	int mismatches;
+	std::vector<float> errors;
+
+	_rOut << std::endl << "Operation                 Scalar ns   SIMD ns   Speedup" << std::endl;
+
+	// One point against four triangles
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		for (int i = 0; i < BENCHMARK_VECTORS; i++)
+		{
+			float closestDist = FLT_MAX;
+			for (int tri = 0; tri < 4; tri++)
+			{
+				v3float closestTriPoint = ClosestPointOnTriangle(points[i], triangles[tri][0], triangles[tri][1], triangles[tri][2]);
+				v3float diff = points[i] - closestTriPoint;
+				float dist = diff.Dot(diff);
+				if (dist < closestDist)
+				{
+					closestDist = dist;
+					outputScalar[i] = closestTriPoint;
+				}
+			}
+		}
+		_rChecksum += outputScalar[repeat % BENCHMARK_VECTORS].x;
+	}
+	timer.Tick();
+	scalarSeconds = timer.GetDeltaTime();
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		for (int i = 0; i < BENCHMARK_VECTORS; i++)
+		{
+			NearestPointOnTriangles(points[i], packet, outputSIMD[i]);
+		}
+		_rChecksum += outputSIMD[repeat % BENCHMARK_VECTORS].x;
+	}
+	timer.Tick();
+	simdSeconds = timer.GetDeltaTime();
+	Report(_rOut, "Closest point (4 tris)", scalarSeconds, simdSeconds);
+	errors.push_back(MaxError((float*)&outputSIMD[0], (float*)&outputScalar[0], BENCHMARK_VECTORS * 3));
+
+	// Many points against one triangle
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		for (int i = 0; i < BENCHMARK_VECTORS; i++)
+		{
+			outputScalar[i] = ClosestPointOnTriangle(points[i], triangles[0][0], triangles[0][1], triangles[0][2]);
+		}
+		_rChecksum += outputScalar[repeat % BENCHMARK_VECTORS].x;
+	}
+	timer.Tick();
+	scalarSeconds = timer.GetDeltaTime();
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		ClosestPointsOnTriangle(&points[0], triangles[0][0], triangles[0][1], triangles[0][2], &outputSIMD[0], BENCHMARK_VECTORS);
+		_rChecksum += outputSIMD[repeat % BENCHMARK_VECTORS].x;
+	}
+	timer.Tick();
+	simdSeconds = timer.GetDeltaTime();
+	Report(_rOut, "Closest point (batch)", scalarSeconds, simdSeconds);
+	errors.push_back(MaxError((float*)&outputSIMD[0], (float*)&outputScalar[0], BENCHMARK_VECTORS * 3));
+
+	// One point against four planes
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		for (int i = 0; i < BENCHMARK_VECTORS; i++)
+		{
+			int mask = 0;
+			for (int tri = 0; tri < 4; tri++)
+			{
+				if (PointOutsideOfPlane(points[i], triangles[tri][0], triangles[tri][1], triangles[tri][2]) == true)
+				{
+					mask |= (1 << tri);
+				}
+			}
+			masksScalar[i] = mask;
+		}
+		_rChecksum += (float)masksScalar[repeat % BENCHMARK_VECTORS];
+	}
+	timer.Tick();
+	scalarSeconds = timer.GetDeltaTime();
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		for (int i = 0; i < BENCHMARK_VECTORS; i++)
+		{
+			masksSIMD[i] = PointOutsideOfPlanes(points[i], packet);
+		}
+		_rChecksum += (float)masksSIMD[repeat % BENCHMARK_VECTORS];
+	}
+	timer.Tick();
+	simdSeconds = timer.GetDeltaTime();
+	Report(_rOut, "Outside of plane (4 tris)", scalarSeconds, simdSeconds);
+	mismatches = 0;
+	for (int i = 0; i < BENCHMARK_VECTORS; i++)
+	{
+		mismatches += (masksSIMD[i] != masksScalar[i]) ? 1 : 0;
+	}
+	errors.push_back((float)mismatches / (float)BENCHMARK_VECTORS);
+
+	// One ray against four triangles. Only the hits are compared, the distances agree to rounding
+	float distance;
+	__m128 distances;
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		for (int i = 0; i < BENCHMARK_VECTORS; i++)
+		{
+			int mask = 0;
+			for (int tri = 0; tri < 4; tri++)
+			{
+				if (RayTriangleIntersect(points[i], rayDirection, triangles[tri][0], triangles[tri][1], triangles[tri][2], distance) == true)
+				{
+					mask |= (1 << tri);
+				}
+			}
+			masksScalar[i] = mask;
+		}
+		_rChecksum += (float)masksScalar[repeat % BENCHMARK_VECTORS];
+	}
+	timer.Tick();
+	scalarSeconds = timer.GetDeltaTime();
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		for (int i = 0; i < BENCHMARK_VECTORS; i++)
+		{
+			masksSIMD[i] = RayIntersectTriangles(points[i], rayDirection, packet, distances);
+		}
+		_rChecksum += (float)masksSIMD[repeat % BENCHMARK_VECTORS];
+	}
+	timer.Tick();
+	simdSeconds = timer.GetDeltaTime();
+	Report(_rOut, "Ray triangle (4 tris)", scalarSeconds, simdSeconds);
+	mismatches = 0;
+	for (int i = 0; i < BENCHMARK_VECTORS; i++)
+	{
+		mismatches += (masksSIMD[i] != masksScalar[i]) ? 1 : 0;
+	}
+	errors.push_back((float)mismatches / (float)BENCHMARK_VECTORS);
+
+	// Four rays against a sphere each, as in particle picking
+	float radius = 2.0f;
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		for (int i = 0; i < BENCHMARK_VECTORS; i++)
+		{
+			masksScalar[i] = (RaySphereIntersect(points[i], rayDirection, radius) == true) ? 1 : 0;
+		}
+		_rChecksum += (float)masksScalar[repeat % BENCHMARK_VECTORS];
+	}
+	timer.Tick();
+	scalarSeconds = timer.GetDeltaTime();
+	timer.Tick();
+	for (int repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+	{
+		for (int i = 0; i < BENCHMARK_VECTORS; i += 4)
+		{
+			int mask = RaySpheresIntersect(&points[i], rayDirection, radius);
+			for (int lane = 0; lane < 4; lane++)
+			{
+				masksSIMD[i + lane] = (mask >> lane) & 1;
+			}
+		}
+		_rChecksum += (float)masksSIMD[repeat % BENCHMARK_VECTORS];
+	}
+	timer.Tick();
+	simdSeconds = timer.GetDeltaTime();
+	Report(_rOut, "Ray sphere (batch)", scalarSeconds, simdSeconds);
+	mismatches = 0;
+	for (int i = 0; i < BENCHMARK_VECTORS; i++)
+	{
+		mismatches += (masksSIMD[i] != masksScalar[i]) ? 1 : 0;
+	}
+	errors.push_back((float)mismatches / (float)BENCHMARK_VECTORS);
+
+	// Closest points are compared by size, hit tests by the fraction of results that differ
+	bool matchesScalar = true;
+	_rOut << std::endl << "Largest difference from scalar" << std::endl;
+	matchesScalar &= ReportError(_rOut, "Closest point (4 tris)", errors[0]);
+	matchesScalar &= ReportError(_rOut, "Closest point (batch)", errors[1]);
+	matchesScalar &= ReportError(_rOut, "Outside of plane (4 tris)", errors[2]);
+	matchesScalar &= ReportError(_rOut, "Ray triangle (4 tris)", errors[3]);
+	matchesScalar &= ReportError(_rOut, "Ray sphere (batch)", errors[4]);
+
+	return matchesScalar;
+}
+
+float Benchmark_Math::RandomFloat(float _min, float _max)
+{
+	return _min + ((float)rand() / (float)RAND_MAX) * (_max - _min);
+}
+
+float Benchmark_Math::MaxError(const float* _pResult, const float* _pReference, int _count)
+{
+	float maxError = 0.0f;
+	for (int i = 0; i < _count; i++)
+	{
+		float error = fabs(_pResult[i] - _pReference[i]) / max(1.0f, fabs(_pReference[i]));
+		maxError = max(maxError, error);
+	}
+	return maxError;
+}
+
+void Benchmark_Math::Report(std::ostream& _rOut, std::string _name, double _scalarSeconds, double _simdSeconds, double _operations)
+{
+	double scalarNs = (_scalarSeconds * 1e9) / _operations;
+	double simdNs = (_simdSeconds * 1e9) / _operations;
+
+	_rOut << std::left << std::setw(26) << _name << std::right << std::fixed << std::setprecision(3)
+		<< std::setw(9) << scalarNs << std::setw(10) << simdNs
+		<< std::setw(9) << std::setprecision(2) << ((simdNs > 0.0) ? scalarNs / simdNs : 0.0) << "x" << std::endl;
+}
+
+bool Benchmark_Math::ReportError(std::ostream& _rOut, std::string _name, float _error)
+{
+	bool withinTolerance = (_error <= BENCHMARK_TOLERANCE);
+	_rOut << std::left << std::setw(26) << _name << std::right << std::scientific << std::setprecision(2)
+		<< std::setw(10) << _error << ((withinTolerance == true) ? "   ok" : "   WRONG") << std::endl;
+	return withinTolerance;
+}
@@ -0,0 +1,116 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Benchmark_Math.h
+* Description : Microbenchmarks comparing the scalar math types and D3DX with the SIMD math layer
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// Inclusion Guards
+#pragma once
+#ifndef __BENCHMARK_MATH_H__
+#define __BENCHMARK_MATH_H__
+
+// Local Includes
+#include "Utilities.h"
+#include "Utility_SIMD.h"
+#include "Utility_Matrix.h"
+#include "Utility_Collision.h"
+#include "Timer.h"
+
+// Library Includes
+#include <d3dx10.h>
+#include <fstream>
+#include <iomanip>
+
+// Defines
+// Number of vectors in each benchmark array. Small enough to stay in cache so the math is measured, not memory
+#define BENCHMARK_VECTORS 4096
+// Number of times each benchmark runs over its arrays
+#define BENCHMARK_REPEATS 2000
+// Number of matrices in each matrix benchmark array
+#define BENCHMARK_MATRICES 1024
+// Largest difference from the D3DX result, relative to the size of the result, before a SIMD function is reported as wrong
+#define BENCHMARK_TOLERANCE 1e-4f
+
+class Benchmark_Math
+{
+public:
+	/***********************
+	* Run: Time the scalar and SIMD versions of each vector operation, then time the SIMD matrix operations
+	*	against D3DX and the batched collision kernels against the scalar ones, check they give the same results, and write a report
+	* @author: Callan Moore
+	* @parameter: _filePath: The file to write the report to
+	* @return: bool: False if the report could not be written or a SIMD result disagrees with D3DX or the scalar functions
+	********************/
+	static bool Run(std::string _filePath);
+
+private:
+
+	/***********************
+	* RunMatrix: Time the SIMD matrix operations against D3DX and check their results
+	* @author: Callan Moore
+	* @parameter: _rOut: The stream to write to
+	* @parameter: _rChecksum: Running sum of results so the compiler cannot drop the work
+	* @return: bool: False if a SIMD result disagrees with D3DX
+	********************/
+	static bool RunMatrix(std::ostream& _rOut, float& _rChecksum);
+
+	/***********************
+	* RunCollision: Time the batched collision kernels against the scalar collision functions and check their results
+	* @author: Callan Moore
+	* @parameter: _rOut: The stream to write to
+	* @parameter: _rChecksum: Running sum of results so the compiler cannot drop the work
+	* @return: bool: False if a batched result disagrees with the scalar functions
+	********************/
+	static bool RunCollision(std::ostream& _rOut, float& _rChecksum);
+
+	/***********************
+	* RandomFloat: Generate a random float within a range
+	* @author: Callan Moore
+	* @parameter: _min: The lowest value
+	* @parameter: _max: The highest value
+	* @return: float: The random value
+	********************/
+	static float RandomFloat(float _min, float _max);
+
+	/***********************
+	* MaxError: Find the largest difference between two arrays of floats, relative to the size of the reference
+	* @author: Callan Moore
+	* @parameter: _pResult: The floats to check
+	* @parameter: _pReference: The floats that are known to be right
+	* @parameter: _count: The number of floats
+	* @return: float: The largest relative difference
+	********************/
+	static float MaxError(const float* _pResult, const float* _pReference, int _count);
+
+	/***********************
+	* Report: Write the result of one benchmark as nanoseconds per operation
+	* @author: Callan Moore
+	* @parameter: _rOut: The stream to write to
+	* @parameter: _name: The name of the operation
+	* @parameter: _scalarSeconds: The time taken by the scalar or D3DX version
+	* @parameter: _simdSeconds: The time taken by the SIMD version
+	* @parameter: _operations: The number of operations each version performed
+	* @return: void
+	********************/
+	static void Report(std::ostream& _rOut, std::string _name, double _scalarSeconds, double _simdSeconds, double _operations = (double)BENCHMARK_VECTORS * (double)BENCHMARK_REPEATS);
+
+	/***********************
+	* ReportError: Write the largest difference of one SIMD function from D3DX
+	* @author: Callan Moore
+	* @parameter: _rOut: The stream to write to
+	* @parameter: _name: The name of the operation
+	* @parameter: _error: The largest relative difference
+	* @return: bool: True if the difference is within tolerance
+	********************/
+	static bool ReportError(std::ostream& _rOut, std::string _name, float _error);
+};
+
+#endif	// __BENCHMARK_MATH_H__
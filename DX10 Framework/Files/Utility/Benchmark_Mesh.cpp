@@ -0,0 +1,279 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Benchmark_Mesh.cpp
+* Description : Benchmark comparing the original stream based OBJ loader with the single pass parser and the binary cache
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// This Include
+#include "Benchmark_Mesh.h"
+
+bool Benchmark_Mesh::Run(std::string _filePath)
+{
+	std::ofstream report(_filePath.c_str());
+	if (report.is_open() == false)
+	{
+		return false;
+	}
+
+	// Find every mesh file
+	std::vector<std::string> fileNames;
+	WIN32_FIND_DATAA findData;
+	HANDLE find = FindFirstFileA(BENCHMARK_MESH_FOLDER "*.txt", &findData);
+	if (find != INVALID_HANDLE_VALUE)
+	{
+		do
+		{
+			fileNames.push_back(std::string(BENCHMARK_MESH_FOLDER) + findData.cFileName);
+		} while (FindNextFileA(find, &findData) != FALSE);
+		FindClose(find);
+	}
+
+	// A scale that is not one keeps the scaling in the comparison
+	v3float scale = { 1.5f, 2.0f, 0.75f };
+	bool allIdentical = (fileNames.empty() == false);
+	double totalStreamSeconds = 0.0;
+	double totalParserSeconds = 0.0;
+	double totalCachedSeconds = 0.0;
+	size_t totalCorners = 0;
+	size_t totalWelded = 0;
+
+	report << "Mesh                       Corners   Welded  Index   Streams ms   Parser ms   Cached ms   Speedup   Cache x            ACMR            ATVR   Output   LOD triangles (error)" << std::endl;
+	for (UINT i = 0; i < fileNames.size(); i++)
+	{
+		std::vector<TVertexNormalUV> streamVertices;
+		std::vector<TVertexNormalUV> parserVertices;
+		std::vector<DWORD> parserIndices;
+		bool loaded = true;
+
+		Timer timer;
+		timer.Reset();
+		timer.Tick();
+		for (int repeat = 0; repeat < BENCHMARK_MESH_REPEATS; repeat++)
+		{
+			streamVertices.clear();
+			loaded &= LoadWithStreams(fileNames[i], scale, streamVertices);
+		}
+		timer.Tick();
+		double streamSeconds = (double)timer.GetDeltaTime() / BENCHMARK_MESH_REPEATS;
+
+		timer.Tick();
+		for (int repeat = 0; repeat < BENCHMARK_MESH_REPEATS; repeat++)
+		{
+			loaded &= DX10_ObjParser::Load(fileNames[i], scale, parserVertices, parserIndices);
+		}
+		timer.Tick();
+		double parserSeconds = (double)timer.GetDeltaTime() / BENCHMARK_MESH_REPEATS;
+
+		// The first load builds the cache so every timed load maps it. The copy stands in for the upload to the GPU
+		std::string cacheName = DX10_MeshCache::GetCachePath(fileNames[i], scale);
+		DeleteFileA(cacheName.c_str());
+		std::vector<TVertexNormalUV> cachedVertices;
+		std::vector<DWORD> cachedIndices;
+		std::vector<TMeshLod> cachedLods;
+		UINT indexStride = 0;
+		{
+			DX10_MeshCache cache;
+			loaded &= cache.Initialise(fileNames[i], scale);
+			loaded &= cache.IsMapped();
+		}
+		timer.Tick();
+		for (int repeat = 0; repeat < BENCHMARK_MESH_REPEATS; repeat++)
+		{
+			DX10_MeshCache cache;
+			loaded &= cache.Initialise(fileNames[i], scale);
+			cachedVertices.assign(cache.GetVertices(), cache.GetVertices() + cache.GetVertexCount());
+			indexStride = cache.GetIndexStride();
+			cachedLods = cache.GetLods();
+			if (indexStride == sizeof(WORD))
+			{
+				cachedIndices.assign((const WORD*)cache.GetIndices(), (const WORD*)cache.GetIndices() + cache.GetIndexCount());
+			}
+			else
+			{
+				cachedIndices.assign((const DWORD*)cache.GetIndices(), (const DWORD*)cache.GetIndices() + cache.GetIndexCount());
+			}
+		}
+		timer.Tick();
+		double cachedSeconds = (double)timer.GetDeltaTime() / BENCHMARK_MESH_REPEATS;
+		DeleteFileA(cacheName.c_str());
+
+		// The cache holds the parser output after the optimiser, followed by the levels of detail. The simulated vertex cache
+		// shows what the reordering of the full mesh gained
+		UINT fullIndexCount = (cachedLods.empty() == true) ? 0 : cachedLods[0].IndexCount;
+		TVertexCacheStats parserStats = DX10_MeshOptimiser::SimulateVertexCache(parserIndices, (UINT)parserVertices.size());
+		TVertexCacheStats cachedStats = DX10_MeshOptimiser::SimulateVertexCache(std::vector<DWORD>(cachedIndices.begin(), cachedIndices.begin() + min(fullIndexCount, (UINT)cachedIndices.size())), (UINT)cachedVertices.size());
+		std::vector<TVertexNormalUV> optimisedVertices = parserVertices;
+		std::vector<DWORD> optimisedIndices = parserIndices;
+		std::vector<TMeshLod> optimisedLods;
+		DX10_MeshOptimiser::Optimise(optimisedVertices, optimisedIndices);
+		DX10_MeshSimplifier::BuildLods(optimisedVertices, optimisedIndices, optimisedLods);
+
+		// Every corner of the welded mesh must match the original loader bit for bit, and the cache must match the optimised parser output
+		bool identical = (loaded == true && streamVertices.size() == parserIndices.size() && parserVertices.empty() == false);
+		for (UINT index = 0; identical == true && index < parserIndices.size(); index++)
+		{
+			identical = (parserIndices[index] < parserVertices.size()
+				&& memcmp(&streamVertices[index], &parserVertices[parserIndices[index]], sizeof(TVertexNormalUV)) == 0);
+		}
+		if (identical == true)
+		{
+			identical = (cachedVertices.size() == optimisedVertices.size() && cachedIndices == optimisedIndices
+				&& memcmp(&cachedVertices[0], &optimisedVertices[0], optimisedVertices.size() * sizeof(TVertexNormalUV)) == 0
+				&& cachedLods.size() == optimisedLods.size()
+				&& memcmp(&cachedLods[0], &optimisedLods[0], optimisedLods.size() * sizeof(TMeshLod)) == 0);
+		}
+		allIdentical &= identical;
+		totalCorners += streamVertices.size();
+		totalWelded += parserVertices.size();
+		totalStreamSeconds += streamSeconds;
+		totalParserSeconds += parserSeconds;
+		totalCachedSeconds += cachedSeconds;
+
+		report << std::left << std::setw(26) << fileNames[i].substr(strlen(BENCHMARK_MESH_FOLDER)) << std::right
+			<< std::setw(8) << streamVertices.size() << std::setw(9) << parserVertices.size() << std::setw(7) << indexStride * 8
+			<< std::fixed << std::setprecision(3)
+			<< std::setw(13) << streamSeconds * 1000.0 << std::setw(12) << parserSeconds * 1000.0 << std::setw(12) << cachedSeconds * 1000.0
+			<< std::setw(9) << std::setprecision(2) << ((parserSeconds > 0.0) ? streamSeconds / parserSeconds : 0.0) << "x"
+			<< std::setw(9) << ((cachedSeconds > 0.0) ? parserSeconds / cachedSeconds : 0.0) << "x"
+			<< std::setw(8) << parserStats.ACMR << " -> " << std::setw(4) << cachedStats.ACMR
+			<< std::setw(8) << parserStats.ATVR << " -> " << std::setw(4) << cachedStats.ATVR
+			<< ((identical == true) ? "   identical" : "   DIFFERENT") << "  ";
+		for (UINT lod = 0; lod < cachedLods.size(); lod++)
+		{
+			report << " " << cachedLods[lod].IndexCount / 3 << " (" << std::setprecision(3) << cachedLods[lod].Error << ")";
+		}
+		report << std::endl;
+	}
+
+	report << std::left << std::setw(26) << "Total" << std::right << std::setw(8) << totalCorners << std::setw(9) << totalWelded
+		<< std::setw(7) << "" << std::fixed << std::setprecision(3) << std::setw(13) << totalStreamSeconds * 1000.0 << std::setw(12) << totalParserSeconds * 1000.0 << std::setw(12) << totalCachedSeconds * 1000.0
+		<< std::setw(9) << std::setprecision(2) << ((totalParserSeconds > 0.0) ? totalStreamSeconds / totalParserSeconds : 0.0) << "x"
+		<< std::setw(9) << ((totalCachedSeconds > 0.0) ? totalParserSeconds / totalCachedSeconds : 0.0) << "x" << std::endl;
+
+	return allIdentical;
+}
+
+// Private Functions
+
+bool Benchmark_Mesh::LoadWithStreams(std::string _fileName, v3float _scale, std::vector<TVertexNormalUV>& _prVertices)
+{
+	std::ifstream fin;
+	char input;
+	char input2;
+	int vertexCount = 0;
+	int texCount = 0;
+	int normalCount = 0;
+	int polygonCount = 0;
+
+	// Count the vertices, texture coordinates, normals and faces with a first pass over the file
+	fin.open(_fileName.c_str());
+	if (fin.fail() == true)
+	{
+		return false;
+	}
+	fin.get(input);
+	while (!fin.eof())
+	{
+		if (input == 'v')
+		{
+			fin.get(input);
+			if (input == ' ') { vertexCount++; }
+			if (input == 't') { texCount++; }
+			if (input == 'n') { normalCount++; }
+		}
+		if (input == 'f')
+		{
+			fin.get(input);
+			if (input == ' ') { polygonCount++; }
+		}
+		while (input != '\n')
+		{
+			fin.get(input);
+		}
+		fin.get(input);
+	}
+	fin.close();
+
+	std::vector<v3float> vertices(vertexCount);
+	std::vector<v3float> texUVs(texCount);
+	std::vector<v3float> normals(normalCount);
+	std::vector<int> faces(polygonCount * 9);
+	int vertexIndex = 0;
+	int texcoordIndex = 0;
+	int normalIndex = 0;
+	int faceIndex = 0;
+
+	// Parse the file with a second pass, converting to a left hand system
+	fin.open(_fileName.c_str());
+	if (fin.fail() == true)
+	{
+		return false;
+	}
+	fin.get(input);
+	while (!fin.eof())
+	{
+		if (input == 'v')
+		{
+			fin.get(input);
+			if (input == ' ')
+			{
+				fin >> vertices[vertexIndex].x >> vertices[vertexIndex].y >> vertices[vertexIndex].z;
+				vertices[vertexIndex].z = vertices[vertexIndex].z * -1.0f;
+				vertexIndex++;
+			}
+			if (input == 't')
+			{
+				fin >> texUVs[texcoordIndex].x >> texUVs[texcoordIndex].y;
+				texUVs[texcoordIndex].y = 1.0f - texUVs[texcoordIndex].y;
+				texcoordIndex++;
+			}
+			if (input == 'n')
+			{
+				fin >> normals[normalIndex].x >> normals[normalIndex].y >> normals[normalIndex].z;
+				normals[normalIndex].z = normals[normalIndex].z * -1.0f;
+				normalIndex++;
+			}
+		}
+		if (input == 'f')
+		{
+			fin.get(input);
+			if (input == ' ')
+			{
+				// Read the face data in backwards to convert it to a left hand system from right hand system.
+				int* pFace = &faces[faceIndex * 9];
+				fin >> pFace[6] >> input2 >> pFace[7] >> input2 >> pFace[8]
+					>> pFace[3] >> input2 >> pFace[4] >> input2 >> pFace[5]
+					>> pFace[0] >> input2 >> pFace[1] >> input2 >> pFace[2];
+				faceIndex++;
+			}
+		}
+		while (input != '\n')
+		{
+			fin.get(input);
+		}
+		fin.get(input);
+	}
+	fin.close();
+
+	for (int i = 0; i < faceIndex * 3; i++)
+	{
+		int vIndex = faces[i * 3] - 1;
+		int tIndex = faces[i * 3 + 1] - 1;
+		int nIndex = faces[i * 3 + 2] - 1;
+
+		TVertexNormalUV vertex = {	{ vertices[vIndex].x * _scale.x, vertices[vIndex].y * _scale.y, vertices[vIndex].z * _scale.z },
+									{ normals[nIndex].x, normals[nIndex].y, normals[nIndex].z },
+									{ texUVs[tIndex].x, texUVs[tIndex].y } };
+		_prVertices.push_back(vertex);
+	}
+
+	return true;
+}
@@ -0,0 +1,61 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Benchmark_Mesh.h
+* Description : Benchmark comparing the original stream based OBJ loader with the single pass parser and the binary cache
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// Inclusion Guards
+#pragma once
+#ifndef __BENCHMARK_MESH_H__
+#define __BENCHMARK_MESH_H__
+
+// Local Includes
+#include "Utilities.h"
+#include "../DX10/DX10/Systems/DX10_MeshCache.h"
+#include "Timer.h"
+
+// Library Includes
+#include <fstream>
+#include <iomanip>
+
+// Defines
+// Folder holding every mesh file the benchmark loads
+#define BENCHMARK_MESH_FOLDER "Resources/Meshes/"
+// Number of times each mesh is loaded by each loader
+#define BENCHMARK_MESH_REPEATS 10
+
+class Benchmark_Mesh
+{
+public:
+	/***********************
+	* Run: Load every mesh file with the original loader, the single pass parser and the binary cache, check they
+	*	give the same triangles and write a report of the vertex counts before and after welding, the load times and
+	*	the simulated vertex cache before and after the optimiser
+	* @author: Callan Moore
+	* @parameter: _filePath: The file to write the report to
+	* @return: bool: False if the report could not be written or a mesh loads differently
+	********************/
+	static bool Run(std::string _filePath);
+
+private:
+
+	/***********************
+	* LoadWithStreams: The original loader. Counts the file with one stream pass then parses it with another
+	* @author: Callan Moore
+	* @parameter: _fileName: The file name of the mesh with file path
+	* @parameter: _scale: The scale to load the mesh with
+	* @parameter: _prVertices: Storage variable for the vertices. Three per triangle
+	* @return: bool: Successful or not
+	********************/
+	static bool LoadWithStreams(std::string _fileName, v3float _scale, std::vector<TVertexNormalUV>& _prVertices);
+};
+
+#endif	// __BENCHMARK_MESH_H__
@@ -0,0 +1,163 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Benchmark_Strands.cpp
+* Description : Headless benchmark comparing the cloth particles and constraints with the packed strand solver
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// This Include
+#include "Benchmark_Strands.h"
+
+bool Benchmark_Strands::Run(std::string _filePath)
+{
+	std::ofstream report(_filePath.c_str());
+	if (report.is_open() == false)
+	{
+		return false;
+	}
+
+	std::vector<v3float> singlePositions;
+	std::vector<v3float> threadedPositions;
+	double particleSeconds = RunParticles();
+	double singleSeconds = RunStrands(1, singlePositions);
+	double threadedSeconds = RunStrands(0, threadedPositions);
+	if (singleSeconds < 0.0 || threadedSeconds < 0.0)
+	{
+		return false;
+	}
+
+	// Packets share no particles so splitting them across threads must not change a single bit
+	bool identical = (singlePositions.size() == threadedPositions.size()
+		&& memcmp(&singlePositions[0], &threadedPositions[0], singlePositions.size() * sizeof(v3float)) == 0);
+
+	int threads = max(1, (int)std::thread::hardware_concurrency());
+	report << "Strands " << BENCHMARK_STRANDS_COUNT << " x " << BENCHMARK_STRANDS_PARTICLES << " particles, " << threads << " cores" << std::endl;
+	report << "Solver                            ms/frame   Speedup" << std::endl;
+	Report(report, "Particles and constraints", particleSeconds, particleSeconds);
+	Report(report, "Packed strands (1 thread)", singleSeconds, particleSeconds);
+	Report(report, "Packed strands (every core)", threadedSeconds, particleSeconds);
+	report << std::endl << "Threaded matches single thread     " << ((identical == true) ? "ok" : "DIFFERENT") << std::endl;
+
+	return identical;
+}
+
+// Private Functions
+
+v3float Benchmark_Strands::GetRoot(int _strand)
+{
+	// Strands start out sideways so they swing down and stretch their constraints
+	return v3float((float)(_strand % 64) * 0.5f, 10.0f, (float)(_strand / 64) * 0.5f);
+}
+
+double Benchmark_Strands::RunParticles()
+{
+	int particleCount = BENCHMARK_STRANDS_COUNT * BENCHMARK_STRANDS_PARTICLES;
+	int constraintCount = BENCHMARK_STRANDS_COUNT * (BENCHMARK_STRANDS_PARTICLES - 1);
+	TVertexColor* pVertices = new TVertexColor[particleCount];
+	Physics_Particle* pParticles = new Physics_Particle[particleCount];
+	Physics_Constraint* pConstraints = new Physics_Constraint[constraintCount];
+
+	// Each strand is a chain of particles with a static root, linked the same way the cloth links its weave
+	float step = 1.0f / (float)(BENCHMARK_STRANDS_PARTICLES - 1);
+	for (int strand = 0; strand < BENCHMARK_STRANDS_COUNT; strand++)
+	{
+		v3float root = GetRoot(strand);
+		for (int particle = 0; particle < BENCHMARK_STRANDS_PARTICLES; particle++)
+		{
+			int index = (strand * BENCHMARK_STRANDS_PARTICLES) + particle;
+			pParticles[index].Initialise(index, &pVertices[index], root + v3float(step * particle, 0.0f, 0.0f), BENCHMARK_STRANDS_TIME_STEP, 0.01f, (particle == 0));
+			if (particle > 0)
+			{
+				pConstraints[(strand * (BENCHMARK_STRANDS_PARTICLES - 1)) + particle - 1].Initialise(&pParticles[index - 1], &pParticles[index], true, 1000.0f);
+			}
+		}
+	}
+
+	// The same integration, iterations and floor as the packed strands
+	Timer timer;
+	timer.Reset();
+	for (int frame = 0; frame < BENCHMARK_STRANDS_FRAMES; frame++)
+	{
+		for (int i = 0; i < particleCount; i++)
+		{
+			pParticles[i].AddForce(v3float(0.0f, -9.81f, 0.0f));
+			pParticles[i].Process();
+		}
+
+		for (int iteration = 0; iteration < 3; iteration++)
+		{
+			float violation;
+			for (int i = 0; i < constraintCount; i++)
+			{
+				pConstraints[i].SatisfyConstraint(violation);
+			}
+			for (int i = 0; i < particleCount; i++)
+			{
+				v3float pos = *pParticles[i].GetPosition();
+				if (pos.y <= COLLIDER_FLOOR_HEIGHT + 0.1f)
+				{
+					pos.y += abs(pos.y - COLLIDER_FLOOR_HEIGHT);
+					pParticles[i].SetPosition(pos, true);
+				}
+			}
+		}
+	}
+	timer.Tick();
+	double seconds = timer.GetDeltaTime();
+
+	ReleasePtrArray(pConstraints);
+	ReleasePtrArray(pParticles);
+	ReleasePtrArray(pVertices);
+	return seconds;
+}
+
+double Benchmark_Strands::RunStrands(int _threadCount, std::vector<v3float>& _prPositions)
+{
+	Physics_Strands* pStrands = new Physics_Strands();
+	if (pStrands->Initialise(0, 0, BENCHMARK_STRANDS_COUNT, BENCHMARK_STRANDS_PARTICLES, 0.01f, BENCHMARK_STRANDS_TIME_STEP, _threadCount) == false)
+	{
+		ReleasePtr(pStrands);
+		return -1.0;
+	}
+	for (int strand = 0; strand < BENCHMARK_STRANDS_COUNT; strand++)
+	{
+		pStrands->SetStrand(strand, GetRoot(strand), v3float(1.0f, 0.0f, 0.0f), 1.0f);
+	}
+
+	Timer timer;
+	timer.Reset();
+	for (int frame = 0; frame < BENCHMARK_STRANDS_FRAMES; frame++)
+	{
+		pStrands->Process(CT_NONE);
+	}
+	timer.Tick();
+	double seconds = timer.GetDeltaTime();
+
+	_prPositions.clear();
+	for (int strand = 0; strand < BENCHMARK_STRANDS_COUNT; strand++)
+	{
+		for (int particle = 0; particle < BENCHMARK_STRANDS_PARTICLES; particle++)
+		{
+			_prPositions.push_back(pStrands->GetPosition(strand, particle));
+		}
+	}
+
+	ReleasePtr(pStrands);
+	return seconds;
+}
+
+void Benchmark_Strands::Report(std::ostream& _rOut, std::string _name, double _seconds, double _baseSeconds)
+{
+	double frameMs = (_seconds * 1000.0) / BENCHMARK_STRANDS_FRAMES;
+
+	_rOut << std::left << std::setw(32) << _name << std::right << std::fixed << std::setprecision(3)
+		<< std::setw(11) << frameMs
+		<< std::setw(9) << std::setprecision(2) << ((_seconds > 0.0) ? _baseSeconds / _seconds : 0.0) << "x" << std::endl;
+}
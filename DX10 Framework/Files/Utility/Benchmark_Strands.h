@@ -0,0 +1,89 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Benchmark_Strands.h
+* Description : Headless benchmark comparing the cloth particles and constraints with the packed strand solver
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// Inclusion Guards
+#pragma once
+#ifndef __BENCHMARK_STRANDS_H__
+#define __BENCHMARK_STRANDS_H__
+
+// Local Includes
+#include "Utilities.h"
+#include "../Physics/3D Physics/Physics_Strands.h"
+#include "Timer.h"
+
+// Library Includes
+#include <fstream>
+#include <iomanip>
+
+// Defines
+// Number of strands simulated by each solver
+#define BENCHMARK_STRANDS_COUNT 4096
+// Number of particles down each strand including the root
+#define BENCHMARK_STRANDS_PARTICLES 16
+// Number of frames each solver is stepped for
+#define BENCHMARK_STRANDS_FRAMES 100
+// Time step of each frame
+#define BENCHMARK_STRANDS_TIME_STEP (1.0f / 60.0f)
+
+class Benchmark_Strands
+{
+public:
+	/***********************
+	* Run: Step the same strands as chains of cloth particles and constraints, as packed strands on one thread and as packed
+	*	strands on every core, check the threaded strands match the single threaded ones and write a report of the frame times
+	* @author: Callan Moore
+	* @parameter: _filePath: The file to write the report to
+	* @return: bool: False if the report could not be written, a solver could not be created or the threaded strands differ
+	********************/
+	static bool Run(std::string _filePath);
+
+private:
+
+	/***********************
+	* GetRoot: Calculate where a strand is rooted. The roots form a square grid above the floor
+	* @author: Callan Moore
+	* @parameter: _strand: The index of the strand
+	* @return: v3float: The root position
+	********************/
+	static v3float GetRoot(int _strand);
+
+	/***********************
+	* RunParticles: Step the strands as chains of the particles and constraints the cloth is built from
+	* @author: Callan Moore
+	* @return: double: The time taken in seconds
+	********************/
+	static double RunParticles();
+
+	/***********************
+	* RunStrands: Step the strands with the packed strand solver
+	* @author: Callan Moore
+	* @parameter: _threadCount: The most threads the solver uses. Zero for one per core
+	* @parameter: _prPositions: Storage for the position of every particle after the last frame
+	* @return: double: The time taken in seconds. Negative if the solver could not be created
+	********************/
+	static double RunStrands(int _threadCount, std::vector<v3float>& _prPositions);
+
+	/***********************
+	* Report: Write the time of one solver as milliseconds per frame with its speedup over the particles and constraints
+	* @author: Callan Moore
+	* @parameter: _rOut: The stream to write to
+	* @parameter: _name: The name of the solver
+	* @parameter: _seconds: The time taken by the solver
+	* @parameter: _baseSeconds: The time taken by the particles and constraints
+	* @return: void
+	********************/
+	static void Report(std::ostream& _rOut, std::string _name, double _seconds, double _baseSeconds);
+};
+
+#endif	// __BENCHMARK_STRANDS_H__
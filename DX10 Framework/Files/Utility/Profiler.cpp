@@ -0,0 +1,215 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Profiler.cpp
+* Description : Scoped timers and counters that aggregate into rolling histograms
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// This Include
+#include "Profiler.h"
+
+// Library Includes
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+// Static Variables
+Profiler* Profiler::s_pProfiler = 0;
+
+Profiler::Profiler()
+{
+	m_historySize = 240;
+	m_frameCount = 0;
+
+	__int64 ticksPerSec;
+	QueryPerformanceFrequency((LARGE_INTEGER*)&ticksPerSec);
+	m_millisecondsPerTick = 1000.0 / (double)ticksPerSec;
+}
+
+Profiler* Profiler::GetInstance()
+{
+	if (s_pProfiler == 0)
+	{
+		// If the profiler does not exist, create the profiler
+		s_pProfiler = new Profiler();
+	}
+	return s_pProfiler;
+}
+
+void Profiler::DestroyInstance()
+{
+	if (s_pProfiler != 0)
+	{
+		delete s_pProfiler;
+		s_pProfiler = 0;
+	}
+}
+
+int Profiler::RegisterSeries(std::string _name, bool _timer)
+{
+	for (int i = 0; i < (int)m_series.size(); i++)
+	{
+		if (m_series[i].Name == _name)
+		{
+			// Series already exists
+			return i;
+		}
+	}
+
+	TProfileSeries series;
+	series.Name = _name;
+	series.Timer = _timer;
+	series.FrameTotal = 0.0;
+	series.History.assign(m_historySize, 0.0f);
+	series.NextSample = 0;
+	series.SampleCount = 0;
+	m_series.push_back(series);
+
+	return (int)m_series.size() - 1;
+}
+
+void Profiler::EndFrame()
+{
+	for (int i = 0; i < (int)m_series.size(); i++)
+	{
+		TProfileSeries* pSeries = &m_series[i];
+
+		// Overwrite the oldest sample with this frames total
+		pSeries->History[pSeries->NextSample] = (float)pSeries->FrameTotal;
+		pSeries->NextSample = (pSeries->NextSample + 1) % m_historySize;
+		pSeries->SampleCount = min(pSeries->SampleCount + 1, m_historySize);
+		pSeries->FrameTotal = 0.0;
+	}
+
+	m_frameCount++;
+}
+
+void Profiler::SetHistorySize(int _frames)
+{
+	m_historySize = max(_frames, 1);
+
+	for (int i = 0; i < (int)m_series.size(); i++)
+	{
+		m_series[i].History.assign(m_historySize, 0.0f);
+		m_series[i].NextSample = 0;
+		m_series[i].SampleCount = 0;
+	}
+}
+
+bool Profiler::GetStats(std::string _name, TProfileStats& _prStats, int _buckets)
+{
+	for (int i = 0; i < (int)m_series.size(); i++)
+	{
+		if (m_series[i].Name == _name)
+		{
+			CalcStats(&m_series[i], _prStats, _buckets);
+			return true;
+		}
+	}
+
+	// No series with that name
+	return false;
+}
+
+void Profiler::CalcStats(TProfileSeries* _pSeries, TProfileStats& _prStats, int _buckets)
+{
+	_prStats.Samples = _pSeries->SampleCount;
+	_prStats.Last = _prStats.Min = _prStats.Max = _prStats.Mean = 0.0f;
+	_prStats.Percentile50 = _prStats.Percentile95 = _prStats.Percentile99 = 0.0f;
+	_prStats.BucketWidth = 0.0f;
+	_prStats.Histogram.assign(max(_buckets, 1), 0);
+
+	if (_pSeries->SampleCount == 0)
+	{
+		// No frames have been recorded
+		return;
+	}
+
+	// The samples are stored at the front of the ring buffer until it first wraps
+	m_sortBuffer.assign(_pSeries->History.begin(), _pSeries->History.begin() + _pSeries->SampleCount);
+	_prStats.Last = _pSeries->History[(_pSeries->NextSample + m_historySize - 1) % m_historySize];
+
+	double sum = 0.0;
+	_prStats.Min = _prStats.Max = m_sortBuffer[0];
+	for (int i = 0; i < (int)m_sortBuffer.size(); i++)
+	{
+		sum += m_sortBuffer[i];
+		_prStats.Min = min(_prStats.Min, m_sortBuffer[i]);
+		_prStats.Max = max(_prStats.Max, m_sortBuffer[i]);
+	}
+	_prStats.Mean = (float)(sum / m_sortBuffer.size());
+
+	// Bucket every sample between zero and the maximum
+	if (_prStats.Max > 0.0f)
+	{
+		_prStats.BucketWidth = _prStats.Max / (float)_prStats.Histogram.size();
+		for (int i = 0; i < (int)m_sortBuffer.size(); i++)
+		{
+			int bucket = (int)(m_sortBuffer[i] / _prStats.BucketWidth);
+			bucket = min(max(bucket, 0), (int)_prStats.Histogram.size() - 1);
+			_prStats.Histogram[bucket]++;
+		}
+	}
+
+	// Sort once to read all the percentiles
+	std::sort(m_sortBuffer.begin(), m_sortBuffer.end());
+	int lastIndex = (int)m_sortBuffer.size() - 1;
+	_prStats.Percentile50 = m_sortBuffer[(int)(lastIndex * 0.50f + 0.5f)];
+	_prStats.Percentile95 = m_sortBuffer[(int)(lastIndex * 0.95f + 0.5f)];
+	_prStats.Percentile99 = m_sortBuffer[(int)(lastIndex * 0.99f + 0.5f)];
+}
+
+std::string Profiler::ToJSON(int _buckets)
+{
+	std::ostringstream json;
+	json << "{\n\t\"frames\": " << m_frameCount << ",\n\t\"series\": [";
+
+	TProfileStats stats;
+	for (int i = 0; i < (int)m_series.size(); i++)
+	{
+		CalcStats(&m_series[i], stats, _buckets);
+
+		json << ((i == 0) ? "\n" : ",\n");
+		json << "\t\t{ \"name\": \"" << m_series[i].Name << "\"";
+		json << ", \"type\": \"" << ((m_series[i].Timer == true) ? "timer" : "counter") << "\"";
+		json << ", \"unit\": \"" << ((m_series[i].Timer == true) ? "ms" : "count") << "\"";
+		json << ", \"samples\": " << stats.Samples;
+		json << ", \"last\": " << stats.Last;
+		json << ", \"min\": " << stats.Min;
+		json << ", \"max\": " << stats.Max;
+		json << ", \"mean\": " << stats.Mean;
+		json << ", \"p50\": " << stats.Percentile50;
+		json << ", \"p95\": " << stats.Percentile95;
+		json << ", \"p99\": " << stats.Percentile99;
+		json << ", \"bucketWidth\": " << stats.BucketWidth;
+		json << ", \"histogram\": [";
+		for (int j = 0; j < (int)stats.Histogram.size(); j++)
+		{
+			json << ((j == 0) ? "" : ", ") << stats.Histogram[j];
+		}
+		json << "] }";
+	}
+
+	json << "\n\t]\n}\n";
+	return json.str();
+}
+
+bool Profiler::DumpJSON(std::string _filename, int _buckets)
+{
+	std::ofstream file(_filename.c_str());
+	if (file.is_open() == false)
+	{
+		// File could not be created
+		return false;
+	}
+
+	file << ToJSON(_buckets);
+	return true;
+}
@@ -0,0 +1,257 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Profiler.h
+* Description : Scoped timers and counters that aggregate into rolling histograms
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// Inclusion Guards
+#pragma once
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+// Library Includes
+#include <windows.h>
+#include <string>
+#include <vector>
+
+// Defines
+// Profiling is compiled in for debug builds and for any build that defines PROFILING
+#if defined(PROFILING) || defined(DEBUG) || defined(_DEBUG)
+	#define PROFILING_ENABLED
+#endif
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifdef PROFILING_ENABLED
+	// Time the rest of the enclosing scope. The series is looked up once per call site
+	#define PROFILE_SCOPE(name)																				\
+		static int PROFILE_CONCAT(profileTimer, __LINE__) = Profiler::GetInstance()->RegisterSeries(name, true);	\
+		ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(PROFILE_CONCAT(profileTimer, __LINE__))
+
+	// Add an amount to a counter for the current frame. Wrapped so it is a single statement that takes the trailing semicolon
+	#define PROFILE_COUNT(name, amount) do {																\
+		static int profileCounter = Profiler::GetInstance()->RegisterSeries(name, false);					\
+		Profiler::GetInstance()->AddSample(profileCounter, (double)(amount));								\
+	} while (0)
+
+	// Close the current frame and push every series total into its history
+	#define PROFILE_END_FRAME() Profiler::GetInstance()->EndFrame()
+#else
+	#define PROFILE_SCOPE(name)
+	#define PROFILE_COUNT(name, amount) do {} while (0)
+	#define PROFILE_END_FRAME()
+#endif
+
+/***********************
+* TProfileSeries: The history of a single timer or counter
+* @author: Callan Moore
+********************/
+struct TProfileSeries
+{
+	std::string Name;
+	bool Timer;
+
+	// Total accumulated during the current frame
+	double FrameTotal;
+
+	// Ring buffer of the per frame totals. Timers are stored in milliseconds
+	std::vector<float> History;
+	int NextSample;
+	int SampleCount;
+};
+
+/***********************
+* TProfileStats: Statistics of a series over its rolling history
+* @author: Callan Moore
+********************/
+struct TProfileStats
+{
+	int Samples;
+	float Last;
+	float Min;
+	float Max;
+	float Mean;
+	float Percentile50;
+	float Percentile95;
+	float Percentile99;
+
+	// Histogram of the history in equal width buckets from zero to the maximum
+	float BucketWidth;
+	std::vector<int> Histogram;
+};
+
+class Profiler
+{
+public:
+	/***********************
+	* GetInstance: Returns the singleton instance of the Profiler, if it doesn't exist creates it
+	* @author: Callan Moore
+	* @return: Profiler*: The current instance of the Profiler
+	********************/
+	static Profiler* GetInstance();
+
+	/***********************
+	* DestroyInstance: Release the singleton instance of the Profiler
+	* @author: Callan Moore
+	* @return: void
+	********************/
+	static void DestroyInstance();
+
+	/***********************
+	* RegisterSeries: Find a series by name, creating it if it does not exist
+	* @author: Callan Moore
+	* @parameter: _name: The name of the series
+	* @parameter: _timer: True for a timer in milliseconds, false for a counter
+	* @return: int: The ID of the series
+	********************/
+	int RegisterSeries(std::string _name, bool _timer);
+
+	/***********************
+	* AddSample: Add an amount to the current frame total of a series
+	* @author: Callan Moore
+	* @parameter: _id: The ID of the series
+	* @parameter: _amount: The amount to add
+	* @return: void
+	********************/
+	void AddSample(int _id, double _amount) { m_series[_id].FrameTotal += _amount; };
+
+	/***********************
+	* AddTime: Add a time measured in performance counter ticks to the current frame total of a timer
+	* @author: Callan Moore
+	* @parameter: _id: The ID of the timer series
+	* @parameter: _ticks: The time in performance counter ticks
+	* @return: void
+	********************/
+	void AddTime(int _id, __int64 _ticks) { m_series[_id].FrameTotal += _ticks * m_millisecondsPerTick; };
+
+	/***********************
+	* EndFrame: Push the frame total of every series into its history and start a new frame
+	* @author: Callan Moore
+	* @return: void
+	********************/
+	void EndFrame();
+
+	/***********************
+	* SetHistorySize: Set the number of frames each series keeps. Clears all history
+	* @author: Callan Moore
+	* @parameter: _frames: The number of frames to keep
+	* @return: void
+	********************/
+	void SetHistorySize(int _frames);
+
+	/***********************
+	* GetStats: Calculate the statistics of a series over its history
+	* @author: Callan Moore
+	* @parameter: _name: The name of the series
+	* @parameter: _prStats: Storage variable for the statistics
+	* @parameter: _buckets: The number of histogram buckets
+	* @return: bool: False if there is no series with the name
+	********************/
+	bool GetStats(std::string _name, TProfileStats& _prStats, int _buckets = 16);
+
+	/***********************
+	* GetSeriesCount: Retrieve the number of registered series
+	* @author: Callan Moore
+	* @return: int: The series count
+	********************/
+	int GetSeriesCount() { return (int)m_series.size(); };
+
+	/***********************
+	* GetSeries: Retrieve a series by ID
+	* @author: Callan Moore
+	* @parameter: _id: The ID of the series
+	* @return: TProfileSeries*: Pointer to the series
+	********************/
+	TProfileSeries* GetSeries(int _id) { return &m_series[_id]; };
+
+	/***********************
+	* GetFrameCount: Retrieve the number of frames ended since the profiler was created
+	* @author: Callan Moore
+	* @return: int: The frame count
+	********************/
+	int GetFrameCount() { return m_frameCount; };
+
+	/***********************
+	* ToJSON: Write the statistics of every series as a JSON document
+	* @author: Callan Moore
+	* @parameter: _buckets: The number of histogram buckets per series
+	* @return: std::string: The JSON document
+	********************/
+	std::string ToJSON(int _buckets = 16);
+
+	/***********************
+	* DumpJSON: Write the statistics of every series to a JSON file
+	* @author: Callan Moore
+	* @parameter: _filename: The file to write
+	* @parameter: _buckets: The number of histogram buckets per series
+	* @return: bool: Successful or not
+	********************/
+	bool DumpJSON(std::string _filename, int _buckets = 16);
+
+private:
+	/***********************
+	* Profiler: Default Constructor for Profiler class
+	* @author: Callan Moore
+	********************/
+	Profiler();
+
+	/***********************
+	* CalcStats: Calculate the statistics of a series over its history
+	* @author: Callan Moore
+	* @parameter: _pSeries: The series
+	* @parameter: _prStats: Storage variable for the statistics
+	* @parameter: _buckets: The number of histogram buckets
+	* @return: void
+	********************/
+	void CalcStats(TProfileSeries* _pSeries, TProfileStats& _prStats, int _buckets);
+
+private:
+	static Profiler* s_pProfiler;
+
+	std::vector<TProfileSeries> m_series;
+	std::vector<float> m_sortBuffer;
+	int m_historySize;
+	int m_frameCount;
+	double m_millisecondsPerTick;
+};
+
+class ProfileScope
+{
+public:
+	/***********************
+	* ProfileScope: Constructor for Profile Scope class. Starts timing
+	* @author: Callan Moore
+	* @parameter: _id: The ID of the timer series to add the time to
+	********************/
+	ProfileScope(int _id)
+	{
+		m_id = _id;
+		QueryPerformanceCounter((LARGE_INTEGER*)&m_start);
+	}
+
+	/***********************
+	* ~ProfileScope: Destructor for Profile Scope class. Adds the time since construction to the timer
+	* @author: Callan Moore
+	********************/
+	~ProfileScope()
+	{
+		__int64 end;
+		QueryPerformanceCounter((LARGE_INTEGER*)&end);
+		Profiler::GetInstance()->AddTime(m_id, end - m_start);
+	}
+
+private:
+	int m_id;
+	__int64 m_start;
+};
+
+#endif	// __PROFILER_H__
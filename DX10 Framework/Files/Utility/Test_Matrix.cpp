@@ -0,0 +1,295 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Test_Matrix.cpp
+* Description : Checks the SIMD matrices and quaternions against hard coded D3DX results. Needs neither D3DX nor Windows
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// This Include
+#include "Test_Matrix.h"
+
+bool Test_Matrix::Run(std::string _filePath)
+{
+	std::ofstream report(_filePath.c_str());
+	if (report.is_open() == false)
+	{
+		return false;
+	}
+
+	return Run(report);
+}
+
+bool Test_Matrix::Run(std::ostream& _rOut)
+{
+	// Every expected result was worked out in double precision from the formulas D3DX documents for the same inputs
+	bool allCorrect = true;
+	_rOut << "Function                             Error   Result" << std::endl;
+
+	// Rotations of half a radian around each axis
+	const float rotationX[16] =
+	{
+		1.0f, 0.0f, 0.0f, 0.0f,
+		0.0f, 0.8775826f, 0.4794255f, 0.0f,
+		0.0f, -0.4794255f, 0.8775826f, 0.0f,
+		0.0f, 0.0f, 0.0f, 1.0f
+	};
+	const float rotationY[16] =
+	{
+		0.8775826f, 0.0f, -0.4794255f, 0.0f,
+		0.0f, 1.0f, 0.0f, 0.0f,
+		0.4794255f, 0.0f, 0.8775826f, 0.0f,
+		0.0f, 0.0f, 0.0f, 1.0f
+	};
+	const float rotationZ[16] =
+	{
+		0.8775826f, 0.4794255f, 0.0f, 0.0f,
+		-0.4794255f, 0.8775826f, 0.0f, 0.0f,
+		0.0f, 0.0f, 1.0f, 0.0f,
+		0.0f, 0.0f, 0.0f, 1.0f
+	};
+	allCorrect &= CheckMatrix(_rOut, "MatrixRotationX", MatrixRotationX(0.5f), rotationX);
+	allCorrect &= CheckMatrix(_rOut, "MatrixRotationY", MatrixRotationY(0.5f), rotationY);
+	allCorrect &= CheckMatrix(_rOut, "MatrixRotationZ", MatrixRotationZ(0.5f), rotationZ);
+
+	// 0.7 radians around (1, 2, 3), which is not unit length
+	const float rotationAxis[16] =
+	{
+		0.7816392f, 0.5501172f, -0.2939579f, 0.0f,
+		-0.4829293f, 0.8320301f, 0.2729563f, 0.0f,
+		0.3947398f, -0.0713925f, 0.9160151f, 0.0f,
+		0.0f, 0.0f, 0.0f, 1.0f
+	};
+	allCorrect &= CheckMatrix(_rOut, "MatrixRotationAxis", MatrixRotationAxis(v4simd(1.0f, 2.0f, 3.0f), 0.7f), rotationAxis);
+
+	// Yaw 0.3, pitch -0.4 and roll 0.5
+	const float yawPitchRoll[16] =
+	{
+		0.7832139f, 0.4415802f, -0.4377019f, 0.0f,
+		-0.5590058f, 0.8083071f, -0.1848032f, 0.0f,
+		0.2721921f, 0.3894183f, 0.8799232f, 0.0f,
+		0.0f, 0.0f, 0.0f, 1.0f
+	};
+	allCorrect &= CheckMatrix(_rOut, "MatrixRotationYawPitchRoll", MatrixRotationYawPitchRoll(0.3f, -0.4f, 0.5f), yawPitchRoll);
+
+	// Scale by (2, 3, 4), roll by half a radian then move by (1, -2, 3). Checks the order of the multiply
+	const float scaleRotateTranslate[16] =
+	{
+		1.755165f, 0.9588511f, 0.0f, 0.0f,
+		-1.438277f, 2.632748f, 0.0f, 0.0f,
+		0.0f, 0.0f, 4.0f, 0.0f,
+		1.0f, -2.0f, 3.0f, 1.0f
+	};
+	m4simd scaleRotateTranslateResult = MatrixScaling(v4simd(2.0f, 3.0f, 4.0f)) * MatrixRotationZ(0.5f) * MatrixTranslation(v4simd(1.0f, -2.0f, 3.0f));
+	allCorrect &= CheckMatrix(_rOut, "MatrixMultiply", scaleRotateTranslateResult, scaleRotateTranslate);
+
+	// A general matrix with no special structure, used by the transpose and the full inverse
+	const float general[16] =
+	{
+		2.0f, 1.0f, 0.0f, 1.0f,
+		0.0f, 3.0f, 1.0f, 0.0f,
+		1.0f, 0.0f, 2.0f, 1.0f,
+		0.0f, 1.0f, 1.0f, 4.0f
+	};
+	const float transposed[16] =
+	{
+		2.0f, 0.0f, 1.0f, 0.0f,
+		1.0f, 3.0f, 0.0f, 1.0f,
+		0.0f, 1.0f, 2.0f, 1.0f,
+		1.0f, 0.0f, 1.0f, 4.0f
+	};
+	allCorrect &= CheckMatrix(_rOut, "MatrixTranspose", MatrixTranspose(m4simd(general)), transposed);
+
+	// Scale by (2, 3, 4), rotate 0.7 radians around (1, 2, 3) then move by (1, -2, 3)
+	const float composed[16] =
+	{
+		1.563278f, 1.100234f, -0.5879158f, 0.0f,
+		-1.448788f, 2.49609f, 0.818869f, 0.0f,
+		1.578959f, -0.28557f, 3.66406f, 0.0f,
+		1.0f, -2.0f, 3.0f, 1.0f
+	};
+	m4simd composedResult = MatrixCompose(v4simd(2.0f, 3.0f, 4.0f), QuaternionRotationAxis(v4simd(1.0f, 2.0f, 3.0f), 0.7f), v4simd(1.0f, -2.0f, 3.0f));
+	allCorrect &= CheckMatrix(_rOut, "MatrixCompose", composedResult, composed);
+	allCorrect &= CheckMatrix(_rOut, "MatrixRotationQuaternion", MatrixRotationQuaternion(QuaternionRotationAxis(v4simd(1.0f, 2.0f, 3.0f), 0.7f)), rotationAxis);
+
+	// Looking from (3, 4, -5) at (1, 0, 2) with Y up
+	const float lookAt[16] =
+	{
+		0.9615239f, -0.1322901f, -0.2407717f, 0.0f,
+		0.0f, 0.8764222f, -0.4815434f, 0.0f,
+		0.2747211f, 0.4630155f, 0.842701f, 0.0f,
+		-1.510966f, -0.7937409f, 6.861994f, 1.0f
+	};
+	allCorrect &= CheckMatrix(_rOut, "MatrixLookAtLH", MatrixLookAtLH(v4simd(3.0f, 4.0f, -5.0f), v4simd(1.0f, 0.0f, 2.0f), v4simd(0.0f, 1.0f, 0.0f)), lookAt);
+
+	// A 60 degree 16:9 view from 0.1 to 100
+	const float perspective[16] =
+	{
+		0.9742786f, 0.0f, 0.0f, 0.0f,
+		0.0f, 1.732051f, 0.0f, 0.0f,
+		0.0f, 0.0f, 1.001001f, 1.0f,
+		0.0f, 0.0f, -0.1001001f, 0.0f
+	};
+	m4simd perspectiveResult = MatrixPerspectiveFovLH(PI / 3.0f, 16.0f / 9.0f, 0.1f, 100.0f);
+	allCorrect &= CheckMatrix(_rOut, "MatrixPerspectiveFovLH", perspectiveResult, perspective);
+
+	// An 8 by 6 view from 1 to 50
+	const float ortho[16] =
+	{
+		0.25f, 0.0f, 0.0f, 0.0f,
+		0.0f, 0.3333333f, 0.0f, 0.0f,
+		0.0f, 0.0f, 0.02040816f, 0.0f,
+		0.0f, 0.0f, -0.02040816f, 1.0f
+	};
+	allCorrect &= CheckMatrix(_rOut, "MatrixOrthoLH", MatrixOrthoLH(8.0f, 6.0f, 1.0f, 50.0f), ortho);
+
+	// The plane x + 2y + 2z - 3 = 0, which is not normalised
+	const float reflect[16] =
+	{
+		0.7777778f, -0.4444444f, -0.4444444f, 0.0f,
+		-0.4444444f, 0.1111111f, -0.8888889f, 0.0f,
+		-0.4444444f, -0.8888889f, 0.1111111f, 0.0f,
+		0.6666667f, 1.333333f, 1.333333f, 1.0f
+	};
+	allCorrect &= CheckMatrix(_rOut, "MatrixReflect", MatrixReflect(v4simd(1.0f, 2.0f, 2.0f, -3.0f)), reflect);
+
+	// The inverse of the general matrix, whose determinant is 50
+	const float inverse[16] =
+	{
+		0.44f, -0.1f, 0.12f, -0.14f,
+		0.08f, 0.3f, -0.16f, 0.02f,
+		-0.24f, 0.1f, 0.48f, -0.06f,
+		0.04f, -0.1f, -0.08f, 0.26f
+	};
+	const float determinant = 50.0f;
+	m4simd inverseResult;
+	float determinantResult = 0.0f;
+	bool inverted = MatrixInverse(m4simd(general), inverseResult, &determinantResult);
+	allCorrect &= CheckMatrix(_rOut, "MatrixInverse", (inverted == true) ? inverseResult : m4simd(), inverse);
+	allCorrect &= CheckFloats(_rOut, "MatrixInverse determinant", &determinantResult, &determinant, 1);
+
+	// The inverse of the composed matrix
+	const float inverseAffine[16] =
+	{
+		0.3908196f, -0.1609764f, 0.09868495f, 0.0f,
+		0.2750586f, 0.2773434f, -0.01784812f, 0.0f,
+		-0.1469789f, 0.09098545f, 0.2290038f, 0.0f,
+		0.6002345f, 0.4427068f, -0.8213925f, 1.0f
+	};
+	m4simd inverseAffineResult;
+	inverted = MatrixInverseAffine(composedResult, inverseAffineResult);
+	allCorrect &= CheckMatrix(_rOut, "MatrixInverseAffine", (inverted == true) ? inverseAffineResult : m4simd(), inverseAffine);
+
+	// Singular matrices are refused and leave the output alone
+	m4simd singular(_mm_setr_ps(1.0f, 2.0f, 3.0f, 0.0f), _mm_setr_ps(2.0f, 4.0f, 6.0f, 0.0f), _mm_setr_ps(0.0f, 1.0f, 0.0f, 0.0f), _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f));
+	const float identity[16] =
+	{
+		1.0f, 0.0f, 0.0f, 0.0f,
+		0.0f, 1.0f, 0.0f, 0.0f,
+		0.0f, 0.0f, 1.0f, 0.0f,
+		0.0f, 0.0f, 0.0f, 1.0f
+	};
+	m4simd untouched;
+	bool refused = (MatrixInverse(singular, untouched) == false) && (MatrixInverseAffine(singular, untouched) == false);
+	allCorrect &= CheckMatrix(_rOut, "Singular inverse refused", (refused == true) ? untouched : singular, identity);
+
+	// Seven points, so the batch functions run one group of four and a tail of three
+	const v3float points[7] =
+	{
+		{ 1.0f, 2.0f, 10.0f }, { -3.0f, 0.5f, 4.0f }, { 0.0f, 0.0f, 1.0f }, { 2.0f, -1.0f, 7.0f },
+		{ 5.0f, 5.0f, 50.0f }, { -1.0f, -2.0f, 3.0f }, { 0.25f, 0.75f, 2.0f }
+	};
+	const float coords[21] =
+	{
+		0.09742786f, 0.3464102f, 0.990991f, -0.7307089f, 0.2165064f, 0.975976f, 0.0f, 0.0f, 0.9009009f,
+		0.2783653f, -0.2474358f, 0.986701f, 0.09742786f, 0.1732051f, 0.998999f, -0.3247595f, -1.154701f, 0.9676343f,
+		0.1217848f, 0.6495191f, 0.950951f
+	};
+	const float normals[21] =
+	{
+		14.45529f, 3.236715f, 37.69042f, 0.9016078f, -3.194938f, 16.82942f, 1.578959f, -0.28557f, 3.66406f,
+		15.62806f, -2.294611f, 23.65372f, 79.52041f, 3.703124f, 184.3578f, 6.071175f, -6.949125f, 9.942359f,
+		2.462147f, 1.575986f, 7.795293f
+	};
+	v3float results[7];
+	for (int i = 0; i < 7; i++)
+	{
+		results[i] = TransformCoord(perspectiveResult, v4simd(points[i])).ToV3float();
+	}
+	allCorrect &= CheckFloats(_rOut, "TransformCoord", &results[0].x, coords, 21);
+	for (int i = 0; i < 7; i++)
+	{
+		results[i] = TransformNormal(composedResult, v4simd(points[i])).ToV3float();
+	}
+	allCorrect &= CheckFloats(_rOut, "TransformNormal", &results[0].x, normals, 21);
+	BatchTransformCoord(perspectiveResult, points, results, 7);
+	allCorrect &= CheckFloats(_rOut, "BatchTransformCoord", &results[0].x, coords, 21);
+	BatchTransformNormal(composedResult, points, results, 7);
+	allCorrect &= CheckFloats(_rOut, "BatchTransformNormal", &results[0].x, normals, 21);
+
+	// 0.7 radians around (1, 2, 3)
+	const float quaternionAxis[4] = { 0.09164329f, 0.1832866f, 0.2749299f, 0.9393727f };
+	allCorrect &= CheckQuaternion(_rOut, "QuaternionRotationAxis", QuaternionRotationAxis(v4simd(1.0f, 2.0f, 3.0f), 0.7f), quaternionAxis);
+
+	// Half a radian around X followed by 0.8 radians around Y. The reverse order gives a different Z so the order is checked
+	q4simd aroundX = QuaternionRotationAxis(v4simd(1.0f, 0.0f, 0.0f), 0.5f);
+	q4simd aroundY = QuaternionRotationAxis(v4simd(0.0f, 1.0f, 0.0f), 0.8f);
+	const float quaternionProduct[4] = { 0.2278741f, 0.3773123f, -0.09634364f, 0.8924274f };
+	allCorrect &= CheckQuaternion(_rOut, "QuaternionMultiply", QuaternionMultiply(aroundX, aroundY), quaternionProduct);
+
+	// The same rotation as the yaw pitch roll matrix
+	const float quaternionYawPitchRoll[4] = { -0.1540971f, 0.1905059f, 0.2685155f, 0.9315906f };
+	allCorrect &= CheckQuaternion(_rOut, "QuaternionRotationYawPitchRoll", QuaternionRotationYawPitchRoll(0.3f, -0.4f, 0.5f), quaternionYawPitchRoll);
+	allCorrect &= CheckMatrix(_rOut, "Quaternion to yaw pitch roll", MatrixRotationQuaternion(QuaternionRotationYawPitchRoll(0.3f, -0.4f, 0.5f)), yawPitchRoll);
+
+	// A quaternion scaled by three normalises back to itself
+	const float quaternionAroundY[4] = { 0.0f, 0.3894183f, 0.0f, 0.921061f };
+	allCorrect &= CheckQuaternion(_rOut, "QuaternionNormalised", QuaternionNormalised(q4simd(_mm_mul_ps(aroundY.m, _mm_set1_ps(3.0f)))), quaternionAroundY);
+
+	// 30 percent of the way between the two rotations. Negating the second quaternion must take the same short path
+	const float quaternionSlerp[4] = { 0.1764749f, 0.1208056f, 0.0f, 0.9768637f };
+	allCorrect &= CheckQuaternion(_rOut, "QuaternionSlerp", QuaternionSlerp(aroundX, aroundY, 0.3f), quaternionSlerp);
+	allCorrect &= CheckQuaternion(_rOut, "QuaternionSlerp (flipped)", QuaternionSlerp(aroundX, q4simd(_mm_sub_ps(_mm_setzero_ps(), aroundY.m)), 0.3f), quaternionSlerp);
+
+	_rOut << ((allCorrect == true) ? "All results match" : "Some results are WRONG") << std::endl;
+	return allCorrect;
+}
+
+/***********************
+* Private Functions
+********************/
+
+bool Test_Matrix::CheckMatrix(std::ostream& _rOut, std::string _name, const m4simd& _rMatrix, const float* _pExpected)
+{
+	SIMD_ALIGN float elements[16];
+	_rMatrix.Store(elements);
+	return CheckFloats(_rOut, _name, elements, _pExpected, 16);
+}
+
+bool Test_Matrix::CheckQuaternion(std::ostream& _rOut, std::string _name, const q4simd& _rQuaternion, const float* _pExpected)
+{
+	SIMD_ALIGN float components[4];
+	_mm_store_ps(components, _rQuaternion.m);
+	return CheckFloats(_rOut, _name, components, _pExpected, 4);
+}
+
+bool Test_Matrix::CheckFloats(std::ostream& _rOut, std::string _name, const float* _pResult, const float* _pExpected, int _count)
+{
+	float maxError = 0.0f;
+	for (int i = 0; i < _count; i++)
+	{
+		float error = fabsf(_pResult[i] - _pExpected[i]) / max(1.0f, fabsf(_pExpected[i]));
+		maxError = max(maxError, error);
+	}
+
+	bool withinTolerance = (maxError <= TEST_MATRIX_TOLERANCE);
+	_rOut << std::left << std::setw(32) << _name << std::right << std::scientific << std::setprecision(2)
+		<< std::setw(10) << maxError << ((withinTolerance == true) ? "   ok" : "   WRONG") << std::endl;
+	return withinTolerance;
+}
@@ -0,0 +1,95 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Test_Matrix.h
+* Description : Checks the SIMD matrices and quaternions against hard coded D3DX results. Needs neither D3DX nor Windows
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// Inclusion Guards
+#pragma once
+#ifndef __TEST_MATRIX_H__
+#define __TEST_MATRIX_H__
+
+// Library Includes
+#include <string>
+#include <fstream>
+#include <iomanip>
+
+// Defines
+// Utility_Math.h uses the min and max macros from windows.h. Stand in for them when it is built without Windows
+#ifndef max
+	#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+#ifndef min
+	#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+// Largest difference from the expected result, relative to the size of the result, before a function is reported as wrong
+#define TEST_MATRIX_TOLERANCE 1e-5f
+
+// Local Includes
+#include "Utility_Matrix.h"
+
+class Test_Matrix
+{
+public:
+	/***********************
+	* Run: Check every matrix and quaternion function against results worked out with the D3DX formulas, and write a report
+	* @author: Callan Moore
+	* @parameter: _filePath: The file to write the report to
+	* @return: bool: False if the report could not be written or any result is wrong
+	********************/
+	static bool Run(std::string _filePath);
+
+	/***********************
+	* Run: Check every matrix and quaternion function against results worked out with the D3DX formulas
+	* @author: Callan Moore
+	* @parameter: _rOut: The stream to write the report to
+	* @return: bool: False if any result is wrong
+	********************/
+	static bool Run(std::ostream& _rOut);
+
+private:
+
+	/***********************
+	* CheckMatrix: Compare a matrix with its expected elements and report the result
+	* @author: Callan Moore
+	* @parameter: _rOut: The stream to write to
+	* @parameter: _name: The name of the function
+	* @parameter: _rMatrix: The matrix the function made
+	* @parameter: _pExpected: The sixteen expected elements, row major
+	* @return: bool: True if every element is within tolerance
+	********************/
+	static bool CheckMatrix(std::ostream& _rOut, std::string _name, const m4simd& _rMatrix, const float* _pExpected);
+
+	/***********************
+	* CheckQuaternion: Compare a quaternion with its expected components and report the result
+	* @author: Callan Moore
+	* @parameter: _rOut: The stream to write to
+	* @parameter: _name: The name of the function
+	* @parameter: _rQuaternion: The quaternion the function made
+	* @parameter: _pExpected: The expected X, Y, Z and W
+	* @return: bool: True if every component is within tolerance
+	********************/
+	static bool CheckQuaternion(std::ostream& _rOut, std::string _name, const q4simd& _rQuaternion, const float* _pExpected);
+
+	/***********************
+	* CheckFloats: Compare an array of floats with the expected values and report the result
+	* @author: Callan Moore
+	* @parameter: _rOut: The stream to write to
+	* @parameter: _name: The name of the function
+	* @parameter: _pResult: The floats the function made
+	* @parameter: _pExpected: The expected floats
+	* @parameter: _count: The number of floats
+	* @return: bool: True if every float is within tolerance
+	********************/
+	static bool CheckFloats(std::ostream& _rOut, std::string _name, const float* _pResult, const float* _pExpected, int _count);
+};
+
+#endif	// __TEST_MATRIX_H__
@@ -50,6 +50,10 @@
 
 // Local Includes
 #include "Utility_Math.h"
+#include "Utility_SIMD.h"
+#include "Utility_Matrix.h"
+#include "Utility_Collision.h"
+#include "Utility_Random.h"
 
 /***********************
 * Increment: Increment an input value by the given amount and return the new value
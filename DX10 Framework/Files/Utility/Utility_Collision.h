@@ -0,0 +1,379 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Utility_Collision.h
+* Description : SSE batched closest point, plane side and ray intersection kernels for four primitives at a time
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+//Inclusion Guards
+#pragma once
+#ifndef __UTILITY_COLLISION_H__
+#define __UTILITY_COLLISION_H__
+
+// Local Includes
+#include "Utility_SIMD.h"
+
+// Defines
+// Rays closer than this to parallel with a triangle, or hits closer than this to the ray origin, are misses
+#define COLLISION_RAY_EPSILON 1e-6f
+
+/***********************
+* TTrianglePacket: Four triangles stored one component per array so each array loads as one SSE register.
+*	Edges are stored instead of the second and third points as every kernel starts from them.
+*	Not aligned so packets can live inside heap allocated classes
+* @author: Callan Moore
+********************/
+struct TTrianglePacket
+{
+	float AX[4], AY[4], AZ[4];
+	float ABX[4], ABY[4], ABZ[4];
+	float ACX[4], ACY[4], ACZ[4];
+
+	/***********************
+	* Set: Store one triangle in a lane of the packet
+	* @author: Callan Moore
+	* @parameter: _lane: The lane to store in, 0 to 3
+	* @parameter: _a: The first point of the triangle
+	* @parameter: _b: The second point of the triangle
+	* @parameter: _c: The third point of the triangle
+	* @return: void
+	********************/
+	void Set(int _lane, const v3float& _a, const v3float& _b, const v3float& _c)
+	{
+		AX[_lane] = _a.x;
+		AY[_lane] = _a.y;
+		AZ[_lane] = _a.z;
+		ABX[_lane] = _b.x - _a.x;
+		ABY[_lane] = _b.y - _a.y;
+		ABZ[_lane] = _b.z - _a.z;
+		ACX[_lane] = _c.x - _a.x;
+		ACY[_lane] = _c.y - _a.y;
+		ACZ[_lane] = _c.z - _a.z;
+	}
+
+	/***********************
+	* Pad: Copy the last used lane into the unused lanes so partly filled packets give sensible results in every lane
+	* @author: Callan Moore
+	* @parameter: _count: The number of lanes in use, 1 to 4
+	* @return: void
+	********************/
+	void Pad(int _count)
+	{
+		for (int lane = _count; lane < 4; lane++)
+		{
+			AX[lane] = AX[_count - 1];
+			AY[lane] = AY[_count - 1];
+			AZ[lane] = AZ[_count - 1];
+			ABX[lane] = ABX[_count - 1];
+			ABY[lane] = ABY[_count - 1];
+			ABZ[lane] = ABZ[_count - 1];
+			ACX[lane] = ACX[_count - 1];
+			ACY[lane] = ACY[_count - 1];
+			ACZ[lane] = ACZ[_count - 1];
+		}
+	}
+};
+
+/***********************
+* SelectLanes: Pick each lane from one of two registers
+* @author: Callan Moore
+* @parameter: _mask: All bits set in the lanes to take from the first register
+* @parameter: _a: The register to take the masked lanes from
+* @parameter: _b: The register to take the other lanes from
+* @return: __m128: The blended register
+********************/
+SIMD_INLINE __m128 SelectLanes(__m128 _mask, __m128 _a, __m128 _b)
+{
+	return _mm_or_ps(_mm_and_ps(_mask, _a), _mm_andnot_ps(_mask, _b));
+}
+
+/***********************
+* ClosestPointOnTriangle4: Calculate the closest points for four point and triangle pairs held one component per register.
+*	Follows the same regions, in the same order, as the scalar ClosestPointOnTriangle but evaluates them all and blends
+* @author: Callan Moore
+* @parameter: _px, _py, _pz: The four points
+* @parameter: _ax, _ay, _az: The first point of each triangle
+* @parameter: _abx, _aby, _abz: The edge from the first to the second point of each triangle
+* @parameter: _acx, _acy, _acz: The edge from the first to the third point of each triangle
+* @parameter: _prX, _prY, _prZ: Storage for the four closest points
+* @return: void
+********************/
+SIMD_INLINE void ClosestPointOnTriangle4(__m128 _px, __m128 _py, __m128 _pz,
+	__m128 _ax, __m128 _ay, __m128 _az, __m128 _abx, __m128 _aby, __m128 _abz, __m128 _acx, __m128 _acy, __m128 _acz,
+	__m128& _prX, __m128& _prY, __m128& _prZ)
+{
+	__m128 zero = _mm_setzero_ps();
+
+	// Point relative to A, then B and C found by stepping along the edges
+	__m128 apX = _mm_sub_ps(_px, _ax);
+	__m128 apY = _mm_sub_ps(_py, _ay);
+	__m128 apZ = _mm_sub_ps(_pz, _az);
+	__m128 ABdotAP = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_abx, apX), _mm_mul_ps(_aby, apY)), _mm_mul_ps(_abz, apZ));
+	__m128 ACdotAP = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_acx, apX), _mm_mul_ps(_acy, apY)), _mm_mul_ps(_acz, apZ));
+	__m128 ABdotAB = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_abx, _abx), _mm_mul_ps(_aby, _aby)), _mm_mul_ps(_abz, _abz));
+	__m128 ACdotAC = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_acx, _acx), _mm_mul_ps(_acy, _acy)), _mm_mul_ps(_acz, _acz));
+	__m128 ABdotAC = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_abx, _acx), _mm_mul_ps(_aby, _acy)), _mm_mul_ps(_abz, _acz));
+
+	// (P - B) = (P - A) - AB and (P - C) = (P - A) - AC, so their dot products follow without reloading the points
+	__m128 ABdotBP = _mm_sub_ps(ABdotAP, ABdotAB);
+	__m128 ACdotBP = _mm_sub_ps(ACdotAP, ABdotAC);
+	__m128 ABdotCP = _mm_sub_ps(ABdotAP, ABdotAC);
+	__m128 ACdotCP = _mm_sub_ps(ACdotAP, ACdotAC);
+
+	__m128 regionCheckAB = _mm_sub_ps(_mm_mul_ps(ABdotAP, ACdotBP), _mm_mul_ps(ABdotBP, ACdotAP));
+	__m128 regionCheckAC = _mm_sub_ps(_mm_mul_ps(ABdotCP, ACdotAP), _mm_mul_ps(ABdotAP, ACdotCP));
+	__m128 regionCheckBC = _mm_sub_ps(_mm_mul_ps(ABdotBP, ACdotCP), _mm_mul_ps(ABdotCP, ACdotBP));
+
+	// Start from the face region and let each earlier region of the scalar version overwrite it
+	__m128 denominator = _mm_add_ps(_mm_add_ps(regionCheckBC, regionCheckAC), regionCheckAB);
+	__m128 modifierAB = _mm_div_ps(regionCheckAC, denominator);
+	__m128 modifierAC = _mm_div_ps(regionCheckAB, denominator);
+	__m128 resultX = _mm_add_ps(_ax, _mm_add_ps(_mm_mul_ps(_abx, modifierAB), _mm_mul_ps(_acx, modifierAC)));
+	__m128 resultY = _mm_add_ps(_ay, _mm_add_ps(_mm_mul_ps(_aby, modifierAB), _mm_mul_ps(_acy, modifierAC)));
+	__m128 resultZ = _mm_add_ps(_az, _mm_add_ps(_mm_mul_ps(_abz, modifierAB), _mm_mul_ps(_acz, modifierAC)));
+
+	// Edge region of B and C
+	__m128 BCstart = _mm_sub_ps(ACdotBP, ABdotBP);
+	__m128 BCend = _mm_sub_ps(ABdotCP, ACdotCP);
+	__m128 inRegion = _mm_and_ps(_mm_cmple_ps(regionCheckBC, zero), _mm_and_ps(_mm_cmpge_ps(BCstart, zero), _mm_cmpge_ps(BCend, zero)));
+	__m128 modifier = _mm_div_ps(BCstart, _mm_add_ps(BCstart, BCend));
+	__m128 bcX = _mm_sub_ps(_acx, _abx);
+	__m128 bcY = _mm_sub_ps(_acy, _aby);
+	__m128 bcZ = _mm_sub_ps(_acz, _abz);
+	resultX = SelectLanes(inRegion, _mm_add_ps(_mm_add_ps(_ax, _abx), _mm_mul_ps(bcX, modifier)), resultX);
+	resultY = SelectLanes(inRegion, _mm_add_ps(_mm_add_ps(_ay, _aby), _mm_mul_ps(bcY, modifier)), resultY);
+	resultZ = SelectLanes(inRegion, _mm_add_ps(_mm_add_ps(_az, _abz), _mm_mul_ps(bcZ, modifier)), resultZ);
+
+	// Edge region of A and C
+	inRegion = _mm_and_ps(_mm_cmple_ps(regionCheckAC, zero), _mm_and_ps(_mm_cmpge_ps(ACdotAP, zero), _mm_cmple_ps(ACdotCP, zero)));
+	modifier = _mm_div_ps(ACdotAP, _mm_sub_ps(ACdotAP, ACdotCP));
+	resultX = SelectLanes(inRegion, _mm_add_ps(_ax, _mm_mul_ps(_acx, modifier)), resultX);
+	resultY = SelectLanes(inRegion, _mm_add_ps(_ay, _mm_mul_ps(_acy, modifier)), resultY);
+	resultZ = SelectLanes(inRegion, _mm_add_ps(_az, _mm_mul_ps(_acz, modifier)), resultZ);
+
+	// Edge region of A and B
+	inRegion = _mm_and_ps(_mm_cmple_ps(regionCheckAB, zero), _mm_and_ps(_mm_cmpge_ps(ABdotAP, zero), _mm_cmple_ps(ABdotBP, zero)));
+	modifier = _mm_div_ps(ABdotAP, _mm_sub_ps(ABdotAP, ABdotBP));
+	resultX = SelectLanes(inRegion, _mm_add_ps(_ax, _mm_mul_ps(_abx, modifier)), resultX);
+	resultY = SelectLanes(inRegion, _mm_add_ps(_ay, _mm_mul_ps(_aby, modifier)), resultY);
+	resultZ = SelectLanes(inRegion, _mm_add_ps(_az, _mm_mul_ps(_abz, modifier)), resultZ);
+
+	// Vertex region outside C
+	inRegion = _mm_and_ps(_mm_cmpge_ps(ACdotCP, zero), _mm_cmple_ps(ABdotCP, ACdotCP));
+	resultX = SelectLanes(inRegion, _mm_add_ps(_ax, _acx), resultX);
+	resultY = SelectLanes(inRegion, _mm_add_ps(_ay, _acy), resultY);
+	resultZ = SelectLanes(inRegion, _mm_add_ps(_az, _acz), resultZ);
+
+	// Vertex region outside B
+	inRegion = _mm_and_ps(_mm_cmpge_ps(ABdotBP, zero), _mm_cmple_ps(ACdotBP, ABdotBP));
+	resultX = SelectLanes(inRegion, _mm_add_ps(_ax, _abx), resultX);
+	resultY = SelectLanes(inRegion, _mm_add_ps(_ay, _aby), resultY);
+	resultZ = SelectLanes(inRegion, _mm_add_ps(_az, _abz), resultZ);
+
+	// Vertex region outside A
+	inRegion = _mm_and_ps(_mm_cmple_ps(ABdotAP, zero), _mm_cmple_ps(ACdotAP, zero));
+	_prX = SelectLanes(inRegion, _ax, resultX);
+	_prY = SelectLanes(inRegion, _ay, resultY);
+	_prZ = SelectLanes(inRegion, _az, resultZ);
+}
+
+/***********************
+* ClosestPointOnTriangles: Calculate the closest point on each of the four triangles of a packet to one point
+* @author: Callan Moore
+* @parameter: _point: The point to check
+* @parameter: _tris: The triangles
+* @parameter: _prX, _prY, _prZ: Storage for the closest point on each triangle
+* @return: void
+********************/
+SIMD_INLINE void ClosestPointOnTriangles(const v3float& _point, const TTrianglePacket& _tris, __m128& _prX, __m128& _prY, __m128& _prZ)
+{
+	ClosestPointOnTriangle4(_mm_set1_ps(_point.x), _mm_set1_ps(_point.y), _mm_set1_ps(_point.z),
+		_mm_loadu_ps(_tris.AX), _mm_loadu_ps(_tris.AY), _mm_loadu_ps(_tris.AZ),
+		_mm_loadu_ps(_tris.ABX), _mm_loadu_ps(_tris.ABY), _mm_loadu_ps(_tris.ABZ),
+		_mm_loadu_ps(_tris.ACX), _mm_loadu_ps(_tris.ACY), _mm_loadu_ps(_tris.ACZ),
+		_prX, _prY, _prZ);
+}
+
+/***********************
+* NearestPointOnTriangles: Find the closest point to one point over all four triangles of a packet
+* @author: Callan Moore
+* @parameter: _point: The point to check
+* @parameter: _tris: The triangles. Unused lanes should be padded
+* @parameter: _prClosest: Storage for the closest point
+* @return: float: The squared distance from the point to the closest point
+********************/
+inline float NearestPointOnTriangles(const v3float& _point, const TTrianglePacket& _tris, v3float& _prClosest)
+{
+	__m128 x, y, z;
+	ClosestPointOnTriangles(_point, _tris, x, y, z);
+
+	__m128 dx = _mm_sub_ps(x, _mm_set1_ps(_point.x));
+	__m128 dy = _mm_sub_ps(y, _mm_set1_ps(_point.y));
+	__m128 dz = _mm_sub_ps(z, _mm_set1_ps(_point.z));
+	SIMD_ALIGN float distSq[4];
+	_mm_store_ps(distSq, _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+
+	// Earlier lanes win ties, matching a scalar loop over the triangles in order
+	int nearest = 0;
+	for (int lane = 1; lane < 4; lane++)
+	{
+		if (distSq[lane] < distSq[nearest])
+		{
+			nearest = lane;
+		}
+	}
+
+	SIMD_ALIGN float pointsX[4];
+	SIMD_ALIGN float pointsY[4];
+	SIMD_ALIGN float pointsZ[4];
+	_mm_store_ps(pointsX, x);
+	_mm_store_ps(pointsY, y);
+	_mm_store_ps(pointsZ, z);
+	_prClosest = v3float(pointsX[nearest], pointsY[nearest], pointsZ[nearest]);
+	return distSq[nearest];
+}
+
+/***********************
+* ClosestPointsOnTriangle: Calculate the closest point on one triangle to each point of an array. The output may be the input
+* @author: Callan Moore
+* @parameter: _pPoints: The points to check
+* @parameter: _triPointA: The first point of the triangle
+* @parameter: _triPointB: The second point of the triangle
+* @parameter: _triPointC: The third point of the triangle
+* @parameter: _pOut: Storage for the closest points
+* @parameter: _count: The number of points
+* @return: void
+********************/
+inline void ClosestPointsOnTriangle(const v3float* _pPoints, const v3float& _triPointA, const v3float& _triPointB, const v3float& _triPointC, v3float* _pOut, int _count)
+{
+	__m128 ax = _mm_set1_ps(_triPointA.x);
+	__m128 ay = _mm_set1_ps(_triPointA.y);
+	__m128 az = _mm_set1_ps(_triPointA.z);
+	__m128 abx = _mm_set1_ps(_triPointB.x - _triPointA.x);
+	__m128 aby = _mm_set1_ps(_triPointB.y - _triPointA.y);
+	__m128 abz = _mm_set1_ps(_triPointB.z - _triPointA.z);
+	__m128 acx = _mm_set1_ps(_triPointC.x - _triPointA.x);
+	__m128 acy = _mm_set1_ps(_triPointC.y - _triPointA.y);
+	__m128 acz = _mm_set1_ps(_triPointC.z - _triPointA.z);
+
+	int i = 0;
+	for (; i + 4 <= _count; i += 4)
+	{
+		__m128 px, py, pz;
+		__m128 x, y, z;
+		LoadV3float4(_pPoints + i, px, py, pz);
+		ClosestPointOnTriangle4(px, py, pz, ax, ay, az, abx, aby, abz, acx, acy, acz, x, y, z);
+		StoreV3float4(_pOut + i, x, y, z);
+	}
+	for (; i < _count; i++)
+	{
+		_pOut[i] = ClosestPointOnTriangle(_pPoints[i], _triPointA, _triPointB, _triPointC);
+	}
+}
+
+/***********************
+* PointOutsideOfPlanes: Check which of the four triangles of a packet a point is outside of, like PointOutsideOfPlane
+* @author: Callan Moore
+* @parameter: _point: The point to check
+* @parameter: _tris: The triangles
+* @return: int: One bit per lane, set if the point is outside that triangles plane
+********************/
+SIMD_INLINE int PointOutsideOfPlanes(const v3float& _point, const TTrianglePacket& _tris)
+{
+	__m128 abx = _mm_loadu_ps(_tris.ABX);
+	__m128 aby = _mm_loadu_ps(_tris.ABY);
+	__m128 abz = _mm_loadu_ps(_tris.ABZ);
+	__m128 acx = _mm_loadu_ps(_tris.ACX);
+	__m128 acy = _mm_loadu_ps(_tris.ACY);
+	__m128 acz = _mm_loadu_ps(_tris.ACZ);
+
+	// Unnormalised face normals. Only the sign of the distance matters
+	__m128 nx = _mm_sub_ps(_mm_mul_ps(aby, acz), _mm_mul_ps(abz, acy));
+	__m128 ny = _mm_sub_ps(_mm_mul_ps(abz, acx), _mm_mul_ps(abx, acz));
+	__m128 nz = _mm_sub_ps(_mm_mul_ps(abx, acy), _mm_mul_ps(aby, acx));
+
+	__m128 apX = _mm_sub_ps(_mm_set1_ps(_point.x), _mm_loadu_ps(_tris.AX));
+	__m128 apY = _mm_sub_ps(_mm_set1_ps(_point.y), _mm_loadu_ps(_tris.AY));
+	__m128 apZ = _mm_sub_ps(_mm_set1_ps(_point.z), _mm_loadu_ps(_tris.AZ));
+	__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(apX, nx), _mm_mul_ps(apY, ny)), _mm_mul_ps(apZ, nz));
+	return _mm_movemask_ps(_mm_cmpge_ps(distance, _mm_setzero_ps()));
+}
+
+/***********************
+* RayIntersectTriangles: Test one ray against the four triangles of a packet with the Moller-Trumbore test. Both faces are hit
+* @author: Callan Moore
+* @parameter: _origin: The origin of the ray
+* @parameter: _direction: The direction of the ray. Need not be unit length, distances are in multiples of it
+* @parameter: _tris: The triangles
+* @parameter: _prDistance: Storage for the distance along the ray to each hit. Only meaningful in lanes that hit
+* @return: int: One bit per lane, set if the ray hits that triangle
+********************/
+SIMD_INLINE int RayIntersectTriangles(const v3float& _origin, const v3float& _direction, const TTrianglePacket& _tris, __m128& _prDistance)
+{
+	__m128 dx = _mm_set1_ps(_direction.x);
+	__m128 dy = _mm_set1_ps(_direction.y);
+	__m128 dz = _mm_set1_ps(_direction.z);
+	__m128 abx = _mm_loadu_ps(_tris.ABX);
+	__m128 aby = _mm_loadu_ps(_tris.ABY);
+	__m128 abz = _mm_loadu_ps(_tris.ABZ);
+	__m128 acx = _mm_loadu_ps(_tris.ACX);
+	__m128 acy = _mm_loadu_ps(_tris.ACY);
+	__m128 acz = _mm_loadu_ps(_tris.ACZ);
+
+	// P = D x AC. The determinant is AB . P and is near zero when the ray is parallel to the triangle
+	__m128 px = _mm_sub_ps(_mm_mul_ps(dy, acz), _mm_mul_ps(dz, acy));
+	__m128 py = _mm_sub_ps(_mm_mul_ps(dz, acx), _mm_mul_ps(dx, acz));
+	__m128 pz = _mm_sub_ps(_mm_mul_ps(dx, acy), _mm_mul_ps(dy, acx));
+	__m128 determinant = _mm_add_ps(_mm_add_ps(_mm_mul_ps(abx, px), _mm_mul_ps(aby, py)), _mm_mul_ps(abz, pz));
+	__m128 absDeterminant = _mm_andnot_ps(_mm_set1_ps(-0.0f), determinant);
+	__m128 hit = _mm_cmpgt_ps(absDeterminant, _mm_set1_ps(COLLISION_RAY_EPSILON));
+	__m128 reciprocal = _mm_div_ps(_mm_set1_ps(1.0f), determinant);
+
+	// First barycentric coordinate
+	__m128 tx = _mm_sub_ps(_mm_set1_ps(_origin.x), _mm_loadu_ps(_tris.AX));
+	__m128 ty = _mm_sub_ps(_mm_set1_ps(_origin.y), _mm_loadu_ps(_tris.AY));
+	__m128 tz = _mm_sub_ps(_mm_set1_ps(_origin.z), _mm_loadu_ps(_tris.AZ));
+	__m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, px), _mm_mul_ps(ty, py)), _mm_mul_ps(tz, pz)), reciprocal);
+	hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmpge_ps(u, _mm_setzero_ps()), _mm_cmple_ps(u, _mm_set1_ps(1.0f))));
+
+	// Q = T x AB gives the second barycentric coordinate and the distance
+	__m128 qx = _mm_sub_ps(_mm_mul_ps(ty, abz), _mm_mul_ps(tz, aby));
+	__m128 qy = _mm_sub_ps(_mm_mul_ps(tz, abx), _mm_mul_ps(tx, abz));
+	__m128 qz = _mm_sub_ps(_mm_mul_ps(tx, aby), _mm_mul_ps(ty, abx));
+	__m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), reciprocal);
+	hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmpge_ps(v, _mm_setzero_ps()), _mm_cmple_ps(_mm_add_ps(u, v), _mm_set1_ps(1.0f))));
+
+	_prDistance = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(acx, qx), _mm_mul_ps(acy, qy)), _mm_mul_ps(acz, qz)), reciprocal);
+	hit = _mm_and_ps(hit, _mm_cmpgt_ps(_prDistance, _mm_set1_ps(COLLISION_RAY_EPSILON)));
+	return _mm_movemask_ps(hit);
+}
+
+/***********************
+* RaySpheresIntersect: Check four rays that share a direction against a sphere at each of their local origins, like RaySphereIntersect
+* @author: Callan Moore
+* @parameter: _pOrigins: Four consecutive ray origins, each in local space to its sphere
+* @parameter: _direction: The direction shared by the rays
+* @parameter: _sphereRad: Radius of the spheres
+* @return: int: One bit per ray, set if that ray intersects its sphere
+********************/
+SIMD_INLINE int RaySpheresIntersect(const v3float* _pOrigins, const v3float& _direction, float _sphereRad)
+{
+	__m128 ox, oy, oz;
+	LoadV3float4(_pOrigins, ox, oy, oz);
+
+	// The discriminant b^2 - 4ac with a and the radius term shared by all four rays
+	float a = (_direction.x * _direction.x) + (_direction.y * _direction.y) + (_direction.z * _direction.z);
+	__m128 b = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(ox, _mm_set1_ps(_direction.x)), _mm_mul_ps(oy, _mm_set1_ps(_direction.y))), _mm_mul_ps(oz, _mm_set1_ps(_direction.z))), _mm_set1_ps(2.0f));
+	__m128 c = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(ox, ox), _mm_mul_ps(oy, oy)), _mm_mul_ps(oz, oz)), _mm_set1_ps(_sphereRad * _sphereRad));
+	__m128 discriminant = _mm_sub_ps(_mm_mul_ps(b, b), _mm_mul_ps(_mm_set1_ps(4.0f * a), c));
+	return _mm_movemask_ps(_mm_cmpge_ps(discriminant, _mm_setzero_ps()));
+}
+
+#endif	// __UTILITY_COLLISION_H__
@@ -22,6 +22,7 @@
 
 // Library Includes
 #include <math.h>
+#include <float.h>
 
 /***********************
 Constants
@@ -293,11 +294,14 @@ struct v3float
 	* operator+=: Addition Assignment Operator for the v3float struct
 	* @author: Callan Moore
 	* @parameter: _v3: Right hand side of the addition
-	* @return: v3float: The result of the addition assignment
+	* @return: v3float&: This vector after the addition assignment
 	********************/
-	v3float operator+= (const v3float _v3)
+	v3float& operator+= (const v3float _v3)
 	{
-		return v3float{ x += _v3.x, y += _v3.y, z += _v3.z };
+		x += _v3.x;
+		y += _v3.y;
+		z += _v3.z;
+		return *this;
 	}
 
 	/***********************
@@ -336,11 +340,14 @@ struct v3float
 	* operator-=: Subtraction Assignment Operator for the v3float struct minus a v3float
 	* @author: Callan Moore
 	* @parameter: _v3: Right hand side of the subtraction
-	* @return: v3float: The result of the subtraction
+	* @return: v3float&: This vector after the subtraction
 	********************/
-	v3float operator-= (const v3float _v3)
+	v3float& operator-= (const v3float _v3)
 	{
-		return v3float{ x -= _v3.x, y -= _v3.y, z -= _v3.z };
+		x -= _v3.x;
+		y -= _v3.y;
+		z -= _v3.z;
+		return *this;
 	}
 
 	/***********************
@@ -358,11 +365,14 @@ struct v3float
 	* operator*=: Multiplication Assignment Operator for a v3float times a v3float
 	* @author: Jc Fowles
 	* @parameter: _v3: Right hand side of the multiplication
-	* @return: v3float: The result of the multiplication
+	* @return: v3float&: This vector after the multiplication
 	********************/
-	v3float operator*= (const v3float _v3) 
+	v3float& operator*= (const v3float _v3) 
 	{
-		return v3float{ x *= _v3.x, y *= _v3.y, z *= _v3.z };
+		x *= _v3.x;
+		y *= _v3.y;
+		z *= _v3.z;
+		return *this;
 	}
 
 	/***********************
@@ -394,7 +404,7 @@ struct v3float
 	********************/
 	float Magnitude()
 	{
-		return (sqrt(pow(x, 2) + pow(y, 2) + pow(z, 2)));
+		return sqrt((x * x) + (y * y) + (z * z));
 	}
 
 	/***********************
@@ -606,10 +616,10 @@ inline bool RaySphereIntersect(v3float _rayOrigin, v3float _rayDirection, float
 	// Calculate the a, b, and c Coefficients of the Discriminant
 	float a = _rayDirection.Dot(_rayDirection);
 	float b = _rayDirection.Dot(_rayOrigin) * 2.0f;
-	float c = _rayOrigin.Dot(_rayOrigin) - pow(_sphereRad, 2);
+	float c = _rayOrigin.Dot(_rayOrigin) - (_sphereRad * _sphereRad);
 
 	// Calculate the Discriminant (b^2 - 4ac)
-	float discriminant = pow(b, 2) - (4 * a * c);
+	float discriminant = (b * b) - (4 * a * c);
 
 	if (discriminant < 0.0f)
 	{
@@ -623,6 +633,51 @@ inline bool RaySphereIntersect(v3float _rayOrigin, v3float _rayDirection, float
 	}
 }
 
+/***********************
+* RayTriangleIntersect: Checks whether a Ray intersects a triangle from either side using the Moller-Trumbore test
+* @author: Callan Moore
+* @parameter: _rayOrigin: The Origin point of the Ray
+* @parameter: _rayDirection: The Direction of the Ray. Distances are in multiples of it
+* @parameter: _triPointA: The first point of the triangle
+* @parameter: _triPointB: The second point of the triangle
+* @parameter: _triPointC: The third point of the triangle
+* @parameter: _prDistance: Storage variable for the distance along the Ray to the hit
+* @return: bool: True if the Ray intersects the triangle
+********************/
+inline bool RayTriangleIntersect(v3float _rayOrigin, v3float _rayDirection, v3float _triPointA, v3float _triPointB, v3float _triPointC, float& _prDistance)
+{
+	v3float triLineAB = _triPointB - _triPointA;
+	v3float triLineAC = _triPointC - _triPointA;
+
+	// A determinant near zero means the Ray is parallel to the triangle
+	v3float dirCrossAC = _rayDirection.Cross(triLineAC);
+	float determinant = triLineAB.Dot(dirCrossAC);
+	if (fabs(determinant) <= 1e-6f)
+	{
+		return false;
+	}
+	float invDeterminant = 1.0f / determinant;
+
+	// Calculate the barycentric coordinates of the hit and reject it if it is outside the triangle
+	v3float triAToOrigin = _rayOrigin - _triPointA;
+	float u = triAToOrigin.Dot(dirCrossAC) * invDeterminant;
+	if (u < 0.0f || u > 1.0f)
+	{
+		return false;
+	}
+
+	v3float originCrossAB = triAToOrigin.Cross(triLineAB);
+	float v = _rayDirection.Dot(originCrossAB) * invDeterminant;
+	if (v < 0.0f || (u + v) > 1.0f)
+	{
+		return false;
+	}
+
+	// Only hits in front of the Ray origin count
+	_prDistance = triLineAC.Dot(originCrossAB) * invDeterminant;
+	return (_prDistance > 1e-6f);
+}
+
 
 /***********************
 * PointOutsideOfPlane: Checks if a point is outside of the plane (on the opposite side as the normal)
@@ -720,4 +775,279 @@ inline v3float ClosestPointOnTriangle(v3float _point, v3float _triPointA, v3floa
 	return _triPointA + triLineAB * modifierAC + triLineAC * modiferAB; 
 }
 
+/***********************
+* ClosestPointsBetweenSegments: Calculate the closest points between two line segments
+* @author: Callan Moore
+* @parameter: v3float _segAStart: The start point of the first segment
+* @parameter: v3float _segAEnd: The end point of the first segment
+* @parameter: v3float _segBStart: The start point of the second segment
+* @parameter: v3float _segBEnd: The end point of the second segment
+* @parameter: v3float & _prClosestA: Storage variable for the closest point on the first segment
+* @parameter: v3float & _prClosestB: Storage variable for the closest point on the second segment
+* @return: float: The distance between the two closest points
+********************/
+inline float ClosestPointsBetweenSegments(v3float _segAStart, v3float _segAEnd, v3float _segBStart, v3float _segBEnd, v3float& _prClosestA, v3float& _prClosestB)
+{
+	v3float segLineA = _segAEnd - _segAStart;
+	v3float segLineB = _segBEnd - _segBStart;
+	v3float startToStart = _segAStart - _segBStart;
+
+	float lengthSqA = segLineA.Dot(segLineA);
+	float lengthSqB = segLineB.Dot(segLineB);
+	float BdotStart = segLineB.Dot(startToStart);
+	float modifierA = 0.0f;
+	float modifierB = 0.0f;
+
+	if (lengthSqA <= FLT_EPSILON && lengthSqB <= FLT_EPSILON)
+	{
+		// Both segments are points
+		modifierA = 0.0f;
+		modifierB = 0.0f;
+	}
+	else if (lengthSqA <= FLT_EPSILON)
+	{
+		// First segment is a point
+		modifierA = 0.0f;
+		modifierB = min(max(BdotStart / lengthSqB, 0.0f), 1.0f);
+	}
+	else
+	{
+		float AdotStart = segLineA.Dot(startToStart);
+		if (lengthSqB <= FLT_EPSILON)
+		{
+			// Second segment is a point
+			modifierB = 0.0f;
+			modifierA = min(max(-AdotStart / lengthSqA, 0.0f), 1.0f);
+		}
+		else
+		{
+			// Neither segment is degenerate. Clamp the closest point on the infinite line of A unless parallel
+			float AdotB = segLineA.Dot(segLineB);
+			float denominator = lengthSqA * lengthSqB - AdotB * AdotB;
+			if (denominator != 0.0f)
+			{
+				modifierA = min(max((AdotB * BdotStart - AdotStart * lengthSqB) / denominator, 0.0f), 1.0f);
+			}
+
+			// Find the matching point on B and reclamp A if B had to be clamped
+			modifierB = (AdotB * modifierA + BdotStart) / lengthSqB;
+			if (modifierB < 0.0f)
+			{
+				modifierB = 0.0f;
+				modifierA = min(max(-AdotStart / lengthSqA, 0.0f), 1.0f);
+			}
+			else if (modifierB > 1.0f)
+			{
+				modifierB = 1.0f;
+				modifierA = min(max((AdotB - AdotStart) / lengthSqA, 0.0f), 1.0f);
+			}
+		}
+	}
+
+	_prClosestA = _segAStart + segLineA * modifierA;
+	_prClosestB = _segBStart + segLineB * modifierB;
+	return (_prClosestA - _prClosestB).Magnitude();
+}
+
+/***********************
+* SegmentSphereFirstHit: Calculate where a segment starting outside a sphere first enters it
+* @author: Callan Moore
+* @parameter: v3float _segStart: The start point of the segment
+* @parameter: v3float _segEnd: The end point of the segment
+* @parameter: v3float _centre: The centre of the sphere
+* @parameter: float _radius: The radius of the sphere
+* @parameter: float & _prTime: Storage variable for the ratio along the segment of the first hit
+* @parameter: v3float & _prNormal: Storage variable for the surface normal at the first hit
+* @return: bool: True if the segment starts outside the sphere and enters it
+********************/
+inline bool SegmentSphereFirstHit(v3float _segStart, v3float _segEnd, v3float _centre, float _radius, float& _prTime, v3float& _prNormal)
+{
+	v3float segLine = _segEnd - _segStart;
+	v3float centreToStart = _segStart - _centre;
+
+	// Solve |centreToStart + segLine * t| = radius for the smallest t
+	float a = segLine.Dot(segLine);
+	float b = centreToStart.Dot(segLine);
+	float c = centreToStart.Dot(centreToStart) - (_radius * _radius);
+
+	if (c <= 0.0f || b >= 0.0f || a <= FLT_EPSILON)
+	{
+		// Segment starts inside the sphere or is not moving towards it
+		return false;
+	}
+
+	float discriminant = (b * b) - (a * c);
+	if (discriminant < 0.0f)
+	{
+		// The line misses the sphere
+		return false;
+	}
+
+	float time = (-b - sqrt(discriminant)) / a;
+	if (time > 1.0f)
+	{
+		// The segment ends before reaching the sphere
+		return false;
+	}
+
+	_prTime = time;
+	_prNormal = (centreToStart + segLine * time) / _radius;
+	return true;
+}
+
+/***********************
+* SegmentCapsuleFirstHit: Calculate where a segment starting outside a capsule first enters it
+* @author: Callan Moore
+* @parameter: v3float _segStart: The start point of the segment
+* @parameter: v3float _segEnd: The end point of the segment
+* @parameter: v3float _capsuleA: The centre of the first sphere of the capsule
+* @parameter: v3float _capsuleB: The centre of the second sphere of the capsule
+* @parameter: float _radius: The radius of the capsule
+* @parameter: float & _prTime: Storage variable for the ratio along the segment of the first hit
+* @parameter: v3float & _prNormal: Storage variable for the surface normal at the first hit
+* @return: bool: True if the segment starts outside the capsule and enters it
+********************/
+inline bool SegmentCapsuleFirstHit(v3float _segStart, v3float _segEnd, v3float _capsuleA, v3float _capsuleB, float _radius, float& _prTime, v3float& _prNormal)
+{
+	v3float capsuleLine = _capsuleB - _capsuleA;
+	float capsuleLengthSq = capsuleLine.Dot(capsuleLine);
+	v3float segLine = _segEnd - _segStart;
+	v3float capsuleToStart = _segStart - _capsuleA;
+
+	// Check the segment does not start inside the capsule
+	float startRatio = (capsuleLengthSq > FLT_EPSILON) ? min(max(capsuleToStart.Dot(capsuleLine) / capsuleLengthSq, 0.0f), 1.0f) : 0.0f;
+	v3float startOffset = capsuleToStart - capsuleLine * startRatio;
+	if (startOffset.Dot(startOffset) <= _radius * _radius)
+	{
+		return false;
+	}
+
+	// The capsule is the union of a cylinder and two spheres so the first entry into any of them is the hit
+	bool hit = false;
+	float time = 0.0f;
+	v3float normal;
+	if (SegmentSphereFirstHit(_segStart, _segEnd, _capsuleA, _radius, time, normal) == true)
+	{
+		hit = true;
+		_prTime = time;
+		_prNormal = normal;
+	}
+	if (SegmentSphereFirstHit(_segStart, _segEnd, _capsuleB, _radius, time, normal) == true && (hit == false || time < _prTime))
+	{
+		hit = true;
+		_prTime = time;
+		_prNormal = normal;
+	}
+
+	if (capsuleLengthSq > FLT_EPSILON)
+	{
+		// Remove the components along the capsule to test against the infinite cylinder
+		v3float radialLine = segLine - capsuleLine * (segLine.Dot(capsuleLine) / capsuleLengthSq);
+		v3float radialStart = capsuleToStart - capsuleLine * (capsuleToStart.Dot(capsuleLine) / capsuleLengthSq);
+
+		float a = radialLine.Dot(radialLine);
+		float b = radialStart.Dot(radialLine);
+		float c = radialStart.Dot(radialStart) - (_radius * _radius);
+		float discriminant = (b * b) - (a * c);
+
+		if (c > 0.0f && b < 0.0f && a > FLT_EPSILON && discriminant >= 0.0f)
+		{
+			time = (-b - sqrt(discriminant)) / a;
+
+			// The cylinder is only part of the capsule between the two spheres
+			float ratio = (capsuleToStart + segLine * time).Dot(capsuleLine) / capsuleLengthSq;
+			if (time <= 1.0f && ratio >= 0.0f && ratio <= 1.0f && (hit == false || time < _prTime))
+			{
+				hit = true;
+				_prTime = time;
+				_prNormal = (radialStart + radialLine * time) / _radius;
+			}
+		}
+	}
+
+	return hit;
+}
+
+/***********************
+* SegmentTetrahedronFirstHit: Calculate where a segment starting outside a tetrahedron grown by a margin first enters it
+* @author: Callan Moore
+* @parameter: v3float _segStart: The start point of the segment
+* @parameter: v3float _segEnd: The end point of the segment
+* @parameter: v3float _pointA: The first point of the tetrahedron
+* @parameter: v3float _pointB: The second point of the tetrahedron
+* @parameter: v3float _pointC: The third point of the tetrahedron
+* @parameter: v3float _pointD: The fourth point of the tetrahedron
+* @parameter: float _margin: Distance to push each face out by
+* @parameter: float & _prTime: Storage variable for the ratio along the segment of the first hit
+* @parameter: v3float & _prNormal: Storage variable for the surface normal at the first hit
+* @return: bool: True if the segment starts outside the tetrahedron and enters it
+********************/
+inline bool SegmentTetrahedronFirstHit(v3float _segStart, v3float _segEnd, v3float _pointA, v3float _pointB, v3float _pointC, v3float _pointD, float _margin, float& _prTime, v3float& _prNormal)
+{
+	// Faces wound the same way as the pyramid collision so the cross product points inwards
+	v3float faces[4][3] = {
+		{ _pointA, _pointB, _pointC },
+		{ _pointA, _pointC, _pointD },
+		{ _pointA, _pointD, _pointB },
+		{ _pointB, _pointD, _pointC } };
+
+	v3float segLine = _segEnd - _segStart;
+	float timeEnter = 0.0f;
+	float timeExit = 1.0f;
+	int enterFace = -1;
+	v3float enterNormal;
+
+	// Clip the segment against the inside of every face plane
+	for (int i = 0; i < 4; i++)
+	{
+		v3float normal = (faces[i][1] - faces[i][0]).Cross(faces[i][2] - faces[i][0]);
+		normal.Normalise();
+
+		float distance = (_segStart - faces[i][0]).Dot(normal) + _margin;
+		float approach = segLine.Dot(normal);
+
+		if (abs(approach) <= FLT_EPSILON)
+		{
+			if (distance < 0.0f)
+			{
+				// Moving parallel to the face on the outside of it
+				return false;
+			}
+			continue;
+		}
+
+		float time = -distance / approach;
+		if (approach > 0.0f)
+		{
+			// Moving into the face
+			if (time > timeEnter)
+			{
+				timeEnter = time;
+				enterFace = i;
+				enterNormal = -normal;
+			}
+		}
+		else
+		{
+			// Moving out of the face
+			timeExit = min(timeExit, time);
+		}
+
+		if (timeEnter > timeExit)
+		{
+			return false;
+		}
+	}
+
+	if (enterFace == -1)
+	{
+		// The segment starts inside
+		return false;
+	}
+
+	_prTime = timeEnter;
+	_prNormal = enterNormal;
+	return true;
+}
+
 #endif	// __UTILITY_MATH_H__
\ No newline at end of file
@@ -0,0 +1,812 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Utility_Matrix.h
+* Description : SSE backed matrices and quaternions for CPU side transforms without D3DX
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+//Inclusion Guards
+#pragma once
+#ifndef __UTILITY_MATRIX_H__
+#define __UTILITY_MATRIX_H__
+
+// Local Includes
+#include "Utility_SIMD.h"
+
+// Library Includes
+#include <emmintrin.h>
+#include <math.h>
+
+// Matrices follow the D3DX conventions so they can be stored straight into a D3DXMATRIX:
+// row major memory, row vectors (v' = v * M) and left handed view and projection matrices
+
+/***********************
+* m4simd: Struct to hold a 4x4 matrix as four SSE rows
+* @author: Callan Moore
+********************/
+struct SIMD_ALIGN m4simd
+{
+	__m128 r[4];
+
+	/***********************
+	* m4simd: Default Constructor for the m4simd struct. Sets the matrix to identity
+	* @author: Callan Moore
+	********************/
+	SIMD_INLINE m4simd()
+	{
+		r[0] = _mm_setr_ps(1.0f, 0.0f, 0.0f, 0.0f);
+		r[1] = _mm_setr_ps(0.0f, 1.0f, 0.0f, 0.0f);
+		r[2] = _mm_setr_ps(0.0f, 0.0f, 1.0f, 0.0f);
+		r[3] = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+	}
+
+	/***********************
+	* m4simd: Constructor for the m4simd struct from four rows
+	* @author: Callan Moore
+	* @parameter: _r0: The first row
+	* @parameter: _r1: The second row
+	* @parameter: _r2: The third row
+	* @parameter: _r3: The fourth row
+	********************/
+	SIMD_INLINE m4simd(__m128 _r0, __m128 _r1, __m128 _r2, __m128 _r3)
+	{
+		r[0] = _r0;
+		r[1] = _r1;
+		r[2] = _r2;
+		r[3] = _r3;
+	}
+
+	/***********************
+	* m4simd: Constructor for the m4simd struct from sixteen row major floats, such as a D3DXMATRIX
+	* @author: Callan Moore
+	* @parameter: _pFloats: The floats to load. Need not be aligned
+	********************/
+	SIMD_INLINE explicit m4simd(const float* _pFloats)
+	{
+		r[0] = _mm_loadu_ps(_pFloats);
+		r[1] = _mm_loadu_ps(_pFloats + 4);
+		r[2] = _mm_loadu_ps(_pFloats + 8);
+		r[3] = _mm_loadu_ps(_pFloats + 12);
+	}
+
+	/***********************
+	* Store: Write the matrix as sixteen row major floats, such as a D3DXMATRIX
+	* @author: Callan Moore
+	* @parameter: _pFloats: Storage for the floats. Need not be aligned
+	* @return: void
+	********************/
+	SIMD_INLINE void Store(float* _pFloats) const
+	{
+		_mm_storeu_ps(_pFloats, r[0]);
+		_mm_storeu_ps(_pFloats + 4, r[1]);
+		_mm_storeu_ps(_pFloats + 8, r[2]);
+		_mm_storeu_ps(_pFloats + 12, r[3]);
+	}
+};
+
+/***********************
+* q4simd: Struct to hold a quaternion in a single SSE register, ordered X, Y, Z, W like a D3DXQUATERNION
+* @author: Callan Moore
+********************/
+struct SIMD_ALIGN q4simd
+{
+	__m128 m;
+
+	/***********************
+	* q4simd: Default Constructor for the q4simd struct. Sets the quaternion to identity
+	* @author: Callan Moore
+	********************/
+	SIMD_INLINE q4simd()
+	{
+		m = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+	}
+
+	/***********************
+	* q4simd: Constructor for the q4simd struct from an SSE register
+	* @author: Callan Moore
+	* @parameter: _m: The register to copy
+	********************/
+	SIMD_INLINE explicit q4simd(__m128 _m)
+	{
+		m = _m;
+	}
+
+	/***********************
+	* q4simd: Constructor for the q4simd struct
+	* @author: Callan Moore
+	* @parameter: _x: X component
+	* @parameter: _y: Y component
+	* @parameter: _z: Z component
+	* @parameter: _w: W component
+	********************/
+	SIMD_INLINE q4simd(float _x, float _y, float _z, float _w)
+	{
+		m = _mm_setr_ps(_x, _y, _z, _w);
+	}
+};
+
+/***********************
+* LoadFloat3: Load three consecutive floats, such as a D3DXVECTOR3, into a v4simd with a W of zero
+* @author: Callan Moore
+* @parameter: _pFloats: The floats to load
+* @return: v4simd: The loaded vector
+********************/
+SIMD_INLINE v4simd LoadFloat3(const float* _pFloats)
+{
+	return v4simd(_pFloats[0], _pFloats[1], _pFloats[2], 0.0f);
+}
+
+/***********************
+* StoreFloat3: Write the XYZ of a v4simd to three consecutive floats, such as a D3DXVECTOR3
+* @author: Callan Moore
+* @parameter: _pFloats: Storage for the floats
+* @parameter: _v4: The vector to store
+* @return: void
+********************/
+SIMD_INLINE void StoreFloat3(float* _pFloats, const v4simd& _v4)
+{
+	SIMD_ALIGN float stored[4];
+	_mm_store_ps(stored, _v4.m);
+	_pFloats[0] = stored[0];
+	_pFloats[1] = stored[1];
+	_pFloats[2] = stored[2];
+}
+
+/***********************
+* SplatLane: Copy one lane of a register into every lane
+* @author: Callan Moore
+* @parameter: _m: The register
+* @parameter: LANE: The lane to copy
+* @return: __m128: The lane in all four lanes
+********************/
+#define SplatLane(_m, LANE) _mm_shuffle_ps((_m), (_m), _MM_SHUFFLE(LANE, LANE, LANE, LANE))
+
+/***********************
+* TransformRow: Multiply a row vector by a matrix using all four components
+* @author: Callan Moore
+* @parameter: _v: The row vector
+* @parameter: _m: The matrix
+* @return: __m128: The transformed vector
+********************/
+SIMD_INLINE __m128 TransformRow(__m128 _v, const m4simd& _m)
+{
+	__m128 result = _mm_mul_ps(SplatLane(_v, 0), _m.r[0]);
+	result = _mm_add_ps(result, _mm_mul_ps(SplatLane(_v, 1), _m.r[1]));
+	result = _mm_add_ps(result, _mm_mul_ps(SplatLane(_v, 2), _m.r[2]));
+	return _mm_add_ps(result, _mm_mul_ps(SplatLane(_v, 3), _m.r[3]));
+}
+
+/***********************
+* MatrixMultiply: Multiply two matrices. The result applies the first then the second, like D3DXMatrixMultiply
+* @author: Callan Moore
+* @parameter: _a: The first matrix
+* @parameter: _b: The second matrix
+* @return: m4simd: The product
+********************/
+SIMD_INLINE m4simd MatrixMultiply(const m4simd& _a, const m4simd& _b)
+{
+	return m4simd(TransformRow(_a.r[0], _b), TransformRow(_a.r[1], _b), TransformRow(_a.r[2], _b), TransformRow(_a.r[3], _b));
+}
+
+/***********************
+* operator*: Multiplication Operator for a m4simd times a m4simd
+* @author: Callan Moore
+* @parameter: _a: Left hand side of the multiplication
+* @parameter: _b: Right hand side of the multiplication
+* @return: m4simd: The product
+********************/
+SIMD_INLINE m4simd operator* (const m4simd& _a, const m4simd& _b)
+{
+	return MatrixMultiply(_a, _b);
+}
+
+/***********************
+* MatrixTranspose: Transpose a matrix
+* @author: Callan Moore
+* @parameter: _m: The matrix
+* @return: m4simd: The transposed matrix
+********************/
+SIMD_INLINE m4simd MatrixTranspose(const m4simd& _m)
+{
+	m4simd result = _m;
+	_MM_TRANSPOSE4_PS(result.r[0], result.r[1], result.r[2], result.r[3]);
+	return result;
+}
+
+/***********************
+* MatrixTranslation: Create a translation matrix
+* @author: Callan Moore
+* @parameter: _translation: The translation. W is ignored
+* @return: m4simd: The translation matrix
+********************/
+SIMD_INLINE m4simd MatrixTranslation(const v4simd& _translation)
+{
+	m4simd result;
+	result.r[3] = _mm_or_ps(_mm_and_ps(_translation.m, _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0))), _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f));
+	return result;
+}
+
+/***********************
+* MatrixScaling: Create a scaling matrix
+* @author: Callan Moore
+* @parameter: _scale: The scale along each axis. W is ignored
+* @return: m4simd: The scaling matrix
+********************/
+SIMD_INLINE m4simd MatrixScaling(const v4simd& _scale)
+{
+	m4simd result;
+	result.r[0] = _mm_mul_ps(result.r[0], _scale.m);
+	result.r[1] = _mm_mul_ps(result.r[1], _scale.m);
+	result.r[2] = _mm_mul_ps(result.r[2], _scale.m);
+	return result;
+}
+
+/***********************
+* MatrixRotationX: Create a matrix that rotates around the X axis
+* @author: Callan Moore
+* @parameter: _angle: The angle in radians
+* @return: m4simd: The rotation matrix
+********************/
+inline m4simd MatrixRotationX(float _angle)
+{
+	float sine = sinf(_angle);
+	float cosine = cosf(_angle);
+	m4simd result;
+	result.r[1] = _mm_setr_ps(0.0f, cosine, sine, 0.0f);
+	result.r[2] = _mm_setr_ps(0.0f, -sine, cosine, 0.0f);
+	return result;
+}
+
+/***********************
+* MatrixRotationY: Create a matrix that rotates around the Y axis
+* @author: Callan Moore
+* @parameter: _angle: The angle in radians
+* @return: m4simd: The rotation matrix
+********************/
+inline m4simd MatrixRotationY(float _angle)
+{
+	float sine = sinf(_angle);
+	float cosine = cosf(_angle);
+	m4simd result;
+	result.r[0] = _mm_setr_ps(cosine, 0.0f, -sine, 0.0f);
+	result.r[2] = _mm_setr_ps(sine, 0.0f, cosine, 0.0f);
+	return result;
+}
+
+/***********************
+* MatrixRotationZ: Create a matrix that rotates around the Z axis
+* @author: Callan Moore
+* @parameter: _angle: The angle in radians
+* @return: m4simd: The rotation matrix
+********************/
+inline m4simd MatrixRotationZ(float _angle)
+{
+	float sine = sinf(_angle);
+	float cosine = cosf(_angle);
+	m4simd result;
+	result.r[0] = _mm_setr_ps(cosine, sine, 0.0f, 0.0f);
+	result.r[1] = _mm_setr_ps(-sine, cosine, 0.0f, 0.0f);
+	return result;
+}
+
+/***********************
+* MatrixRotationAxis: Create a matrix that rotates around an arbitrary axis
+* @author: Callan Moore
+* @parameter: _axis: The axis to rotate around. Need not be unit length
+* @parameter: _angle: The angle in radians
+* @return: m4simd: The rotation matrix
+********************/
+inline m4simd MatrixRotationAxis(const v4simd& _axis, float _angle)
+{
+	v3float axis = Normalised(_axis, NA_EXACT).ToV3float();
+	float sine = sinf(_angle);
+	float cosine = cosf(_angle);
+	float inverse = 1.0f - cosine;
+
+	m4simd result;
+	result.r[0] = _mm_setr_ps(inverse * axis.x * axis.x + cosine, inverse * axis.x * axis.y + sine * axis.z, inverse * axis.x * axis.z - sine * axis.y, 0.0f);
+	result.r[1] = _mm_setr_ps(inverse * axis.x * axis.y - sine * axis.z, inverse * axis.y * axis.y + cosine, inverse * axis.y * axis.z + sine * axis.x, 0.0f);
+	result.r[2] = _mm_setr_ps(inverse * axis.x * axis.z + sine * axis.y, inverse * axis.y * axis.z - sine * axis.x, inverse * axis.z * axis.z + cosine, 0.0f);
+	return result;
+}
+
+/***********************
+* MatrixRotationYawPitchRoll: Create a matrix that rolls around Z, then pitches around X, then yaws around Y
+* @author: Callan Moore
+* @parameter: _yaw: The rotation around the Y axis in radians
+* @parameter: _pitch: The rotation around the X axis in radians
+* @parameter: _roll: The rotation around the Z axis in radians
+* @return: m4simd: The rotation matrix
+********************/
+inline m4simd MatrixRotationYawPitchRoll(float _yaw, float _pitch, float _roll)
+{
+	return MatrixRotationZ(_roll) * MatrixRotationX(_pitch) * MatrixRotationY(_yaw);
+}
+
+/***********************
+* MatrixRotationQuaternion: Create a rotation matrix from a unit quaternion
+* @author: Callan Moore
+* @parameter: _q: The quaternion
+* @return: m4simd: The rotation matrix
+********************/
+SIMD_INLINE m4simd MatrixRotationQuaternion(const q4simd& _q)
+{
+	// Each row is built from the doubled products (xx yy zz), (xy xz yz) and (xw yw zw)
+	__m128 doubled = _mm_add_ps(_q.m, _q.m);
+	__m128 squares = _mm_mul_ps(_q.m, doubled);
+	__m128 wProducts = _mm_mul_ps(SplatLane(_q.m, 3), doubled);
+	__m128 crossProducts = _mm_mul_ps(_mm_shuffle_ps(_q.m, _q.m, _MM_SHUFFLE(3, 1, 0, 0)), _mm_shuffle_ps(doubled, doubled, _MM_SHUFFLE(3, 2, 2, 1)));
+
+	SIMD_ALIGN float sq[4];
+	SIMD_ALIGN float wp[4];
+	SIMD_ALIGN float cp[4];
+	_mm_store_ps(sq, squares);
+	_mm_store_ps(wp, wProducts);
+	_mm_store_ps(cp, crossProducts);
+
+	m4simd result;
+	result.r[0] = _mm_setr_ps(1.0f - sq[1] - sq[2], cp[0] + wp[2], cp[1] - wp[1], 0.0f);
+	result.r[1] = _mm_setr_ps(cp[0] - wp[2], 1.0f - sq[0] - sq[2], cp[2] + wp[0], 0.0f);
+	result.r[2] = _mm_setr_ps(cp[1] + wp[1], cp[2] - wp[0], 1.0f - sq[0] - sq[1], 0.0f);
+	return result;
+}
+
+/***********************
+* MatrixCompose: Create a matrix that scales, then rotates, then translates
+* @author: Callan Moore
+* @parameter: _scale: The scale along each axis
+* @parameter: _rotation: The rotation as a unit quaternion
+* @parameter: _translation: The translation
+* @return: m4simd: The composed matrix
+********************/
+SIMD_INLINE m4simd MatrixCompose(const v4simd& _scale, const q4simd& _rotation, const v4simd& _translation)
+{
+	// Scaling first only scales the rows of the rotation, and translating last only fills the fourth row
+	m4simd result = MatrixRotationQuaternion(_rotation);
+	result.r[0] = _mm_mul_ps(result.r[0], SplatLane(_scale.m, 0));
+	result.r[1] = _mm_mul_ps(result.r[1], SplatLane(_scale.m, 1));
+	result.r[2] = _mm_mul_ps(result.r[2], SplatLane(_scale.m, 2));
+	result.r[3] = MatrixTranslation(_translation).r[3];
+	return result;
+}
+
+/***********************
+* MatrixLookAtLH: Create a left handed view matrix
+* @author: Callan Moore
+* @parameter: _eye: The position of the viewer
+* @parameter: _target: The point being looked at
+* @parameter: _up: The up direction of the viewer
+* @return: m4simd: The view matrix
+********************/
+SIMD_INLINE m4simd MatrixLookAtLH(const v4simd& _eye, const v4simd& _target, const v4simd& _up)
+{
+	v4simd zAxis = Normalised(_target - _eye, NA_EXACT);
+	v4simd xAxis = Normalised(Cross(_up, zAxis), NA_EXACT);
+	v4simd yAxis = Cross(zAxis, xAxis);
+
+	// The axes become the columns and the eye is moved back to the origin
+	m4simd result = MatrixTranspose(m4simd(xAxis.m, yAxis.m, zAxis.m, _mm_setzero_ps()));
+	result.r[3] = _mm_setr_ps(-Dot3(xAxis, _eye), -Dot3(yAxis, _eye), -Dot3(zAxis, _eye), 1.0f);
+	return result;
+}
+
+/***********************
+* MatrixPerspectiveFovLH: Create a left handed perspective projection matrix
+* @author: Callan Moore
+* @parameter: _fovY: The vertical field of view in radians
+* @parameter: _aspect: The width divided by the height of the view
+* @parameter: _nearZ: The distance to the near plane
+* @parameter: _farZ: The distance to the far plane
+* @return: m4simd: The projection matrix
+********************/
+inline m4simd MatrixPerspectiveFovLH(float _fovY, float _aspect, float _nearZ, float _farZ)
+{
+	float yScale = 1.0f / tanf(_fovY * 0.5f);
+	float xScale = yScale / _aspect;
+	float depthScale = _farZ / (_farZ - _nearZ);
+
+	return m4simd(
+		_mm_setr_ps(xScale, 0.0f, 0.0f, 0.0f),
+		_mm_setr_ps(0.0f, yScale, 0.0f, 0.0f),
+		_mm_setr_ps(0.0f, 0.0f, depthScale, 1.0f),
+		_mm_setr_ps(0.0f, 0.0f, -_nearZ * depthScale, 0.0f));
+}
+
+/***********************
+* MatrixOrthoLH: Create a left handed orthographic projection matrix
+* @author: Callan Moore
+* @parameter: _width: The width of the view volume
+* @parameter: _height: The height of the view volume
+* @parameter: _nearZ: The distance to the near plane
+* @parameter: _farZ: The distance to the far plane
+* @return: m4simd: The projection matrix
+********************/
+inline m4simd MatrixOrthoLH(float _width, float _height, float _nearZ, float _farZ)
+{
+	float depthScale = 1.0f / (_farZ - _nearZ);
+
+	return m4simd(
+		_mm_setr_ps(2.0f / _width, 0.0f, 0.0f, 0.0f),
+		_mm_setr_ps(0.0f, 2.0f / _height, 0.0f, 0.0f),
+		_mm_setr_ps(0.0f, 0.0f, depthScale, 0.0f),
+		_mm_setr_ps(0.0f, 0.0f, -_nearZ * depthScale, 1.0f));
+}
+
+/***********************
+* MatrixReflect: Create a matrix that reflects across a plane
+* @author: Callan Moore
+* @parameter: _plane: The plane as (a, b, c, d) for ax + by + cz + d = 0. Need not be normalised
+* @return: m4simd: The reflection matrix
+********************/
+SIMD_INLINE m4simd MatrixReflect(const v4simd& _plane)
+{
+	// Normalise the whole plane by the length of its normal
+	__m128 plane = _mm_mul_ps(_plane.m, ReciprocalSqrt(SplatDot3(_plane, _plane), NA_EXACT));
+	__m128 minusTwoPlane = _mm_mul_ps(plane, _mm_set1_ps(-2.0f));
+	__m128 normal = _mm_and_ps(plane, _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0)));
+
+	// Each row is the identity row minus twice the normal scaled by one component of the plane
+	m4simd result;
+	result.r[0] = _mm_add_ps(result.r[0], _mm_mul_ps(SplatLane(minusTwoPlane, 0), normal));
+	result.r[1] = _mm_add_ps(result.r[1], _mm_mul_ps(SplatLane(minusTwoPlane, 1), normal));
+	result.r[2] = _mm_add_ps(result.r[2], _mm_mul_ps(SplatLane(minusTwoPlane, 2), normal));
+	result.r[3] = _mm_add_ps(result.r[3], _mm_mul_ps(SplatLane(minusTwoPlane, 3), normal));
+	return result;
+}
+
+/***********************
+* MatrixInverse: Calculate the inverse of any invertible matrix
+* @author: Callan Moore
+* @parameter: _m: The matrix
+* @parameter: _prOut: Storage for the inverse. Unchanged if the matrix is singular
+* @parameter: _pDeterminant: Optional storage for the determinant
+* @return: bool: False if the matrix is singular
+********************/
+inline bool MatrixInverse(const m4simd& _m, m4simd& _prOut, float* _pDeterminant = 0)
+{
+	// Split the matrix into four 2x2 blocks, each held row major in one register
+	//	| A B |
+	//	| C D |
+	__m128 blockA = _mm_movelh_ps(_m.r[0], _m.r[1]);
+	__m128 blockB = _mm_movehl_ps(_m.r[1], _m.r[0]);
+	__m128 blockC = _mm_movelh_ps(_m.r[2], _m.r[3]);
+	__m128 blockD = _mm_movehl_ps(_m.r[3], _m.r[2]);
+
+	// Determinants of the four blocks as (|A| |B| |C| |D|)
+	__m128 blockDets = _mm_sub_ps(
+		_mm_mul_ps(_mm_shuffle_ps(_m.r[0], _m.r[2], _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(_m.r[1], _m.r[3], _MM_SHUFFLE(3, 1, 3, 1))),
+		_mm_mul_ps(_mm_shuffle_ps(_m.r[0], _m.r[2], _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(_m.r[1], _m.r[3], _MM_SHUFFLE(2, 0, 2, 0))));
+	__m128 detA = SplatLane(blockDets, 0);
+	__m128 detB = SplatLane(blockDets, 1);
+	__m128 detC = SplatLane(blockDets, 2);
+	__m128 detD = SplatLane(blockDets, 3);
+
+	// 2x2 helpers, where X# is the adjugate of X
+	//	Mul(X, Y) = X * Y
+	//	AdjMul(X, Y) = X# * Y
+	//	MulAdj(X, Y) = X * Y#
+	#define Mat2Mul(X, Y) _mm_add_ps(_mm_mul_ps((X), _mm_shuffle_ps((Y), (Y), _MM_SHUFFLE(3, 0, 3, 0))), _mm_mul_ps(_mm_shuffle_ps((X), (X), _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps((Y), (Y), _MM_SHUFFLE(1, 2, 1, 2))))
+	#define Mat2AdjMul(X, Y) _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps((X), (X), _MM_SHUFFLE(0, 0, 3, 3)), (Y)), _mm_mul_ps(_mm_shuffle_ps((X), (X), _MM_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_ps((Y), (Y), _MM_SHUFFLE(1, 0, 3, 2))))
+	#define Mat2MulAdj(X, Y) _mm_sub_ps(_mm_mul_ps((X), _mm_shuffle_ps((Y), (Y), _MM_SHUFFLE(0, 3, 0, 3))), _mm_mul_ps(_mm_shuffle_ps((X), (X), _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps((Y), (Y), _MM_SHUFFLE(1, 2, 1, 2))))
+
+	__m128 adjDC = Mat2AdjMul(blockD, blockC);
+	__m128 adjAB = Mat2AdjMul(blockA, blockB);
+
+	// Adjugates of the four blocks of the inverse
+	__m128 adjX = _mm_sub_ps(_mm_mul_ps(detD, blockA), Mat2Mul(blockB, adjDC));
+	__m128 adjW = _mm_sub_ps(_mm_mul_ps(detA, blockD), Mat2Mul(blockC, adjAB));
+	__m128 adjY = _mm_sub_ps(_mm_mul_ps(detB, blockC), Mat2MulAdj(blockD, adjAB));
+	__m128 adjZ = _mm_sub_ps(_mm_mul_ps(detC, blockB), Mat2MulAdj(blockA, adjDC));
+
+	#undef Mat2Mul
+	#undef Mat2AdjMul
+	#undef Mat2MulAdj
+
+	// |M| = |A||D| + |B||C| - trace((A# B)(D# C))
+	__m128 trace = _mm_mul_ps(adjAB, _mm_shuffle_ps(adjDC, adjDC, _MM_SHUFFLE(3, 1, 2, 0)));
+	trace = _mm_add_ps(trace, _mm_movehl_ps(trace, trace));
+	trace = _mm_add_ss(trace, _mm_shuffle_ps(trace, trace, _MM_SHUFFLE(1, 1, 1, 1)));
+	__m128 det = _mm_sub_ss(_mm_add_ss(_mm_mul_ss(detA, detD), _mm_mul_ss(detB, detC)), trace);
+	float determinant = _mm_cvtss_f32(det);
+
+	if (_pDeterminant != 0)
+	{
+		*_pDeterminant = determinant;
+	}
+	if (determinant == 0.0f)
+	{
+		// Singular matrices have no inverse
+		return false;
+	}
+
+	// Divide by the determinant, flipping the signs that the adjugate needs
+	__m128 reciprocal = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), SplatLane(det, 0));
+	adjX = _mm_mul_ps(adjX, reciprocal);
+	adjY = _mm_mul_ps(adjY, reciprocal);
+	adjZ = _mm_mul_ps(adjZ, reciprocal);
+	adjW = _mm_mul_ps(adjW, reciprocal);
+
+	// Finish each adjugate while gathering the blocks back into rows
+	_prOut.r[0] = _mm_shuffle_ps(adjX, adjY, _MM_SHUFFLE(1, 3, 1, 3));
+	_prOut.r[1] = _mm_shuffle_ps(adjX, adjY, _MM_SHUFFLE(0, 2, 0, 2));
+	_prOut.r[2] = _mm_shuffle_ps(adjZ, adjW, _MM_SHUFFLE(1, 3, 1, 3));
+	_prOut.r[3] = _mm_shuffle_ps(adjZ, adjW, _MM_SHUFFLE(0, 2, 0, 2));
+	return true;
+}
+
+/***********************
+* MatrixInverseAffine: Calculate the inverse of a matrix whose fourth column is (0, 0, 0, 1), such as a world or view matrix.
+*	Handles rotation, translation, scale and shear for much less work than MatrixInverse
+* @author: Callan Moore
+* @parameter: _m: The affine matrix
+* @parameter: _prOut: Storage for the inverse. Unchanged if the matrix is singular
+* @return: bool: False if the matrix is singular
+********************/
+SIMD_INLINE bool MatrixInverseAffine(const m4simd& _m, m4simd& _prOut)
+{
+	// The columns of the inverse 3x3 are the cross products of its rows over the determinant
+	v4simd row0(_m.r[0]);
+	v4simd row1(_m.r[1]);
+	v4simd row2(_m.r[2]);
+	v4simd column0 = Cross(row1, row2);
+	v4simd column1 = Cross(row2, row0);
+	v4simd column2 = Cross(row0, row1);
+
+	__m128 det = SplatDot3(row0, column0);
+	if (_mm_cvtss_f32(det) == 0.0f)
+	{
+		// Singular matrices have no inverse
+		return false;
+	}
+	__m128 reciprocal = _mm_div_ps(_mm_set1_ps(1.0f), det);
+
+	__m128 inv0 = _mm_mul_ps(column0.m, reciprocal);
+	__m128 inv1 = _mm_mul_ps(column1.m, reciprocal);
+	__m128 inv2 = _mm_mul_ps(column2.m, reciprocal);
+	__m128 inv3 = _mm_setzero_ps();
+	_MM_TRANSPOSE4_PS(inv0, inv1, inv2, inv3);
+
+	// The translation is undone by moving back through the inverse 3x3
+	__m128 translation = _mm_mul_ps(SplatLane(_m.r[3], 0), inv0);
+	translation = _mm_add_ps(translation, _mm_mul_ps(SplatLane(_m.r[3], 1), inv1));
+	translation = _mm_add_ps(translation, _mm_mul_ps(SplatLane(_m.r[3], 2), inv2));
+
+	_prOut.r[0] = inv0;
+	_prOut.r[1] = inv1;
+	_prOut.r[2] = inv2;
+	_prOut.r[3] = _mm_sub_ps(_mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f), translation);
+	return true;
+}
+
+/***********************
+* Transform: Transform a vector by a matrix using all four components
+* @author: Callan Moore
+* @parameter: _m: The matrix
+* @parameter: _v4: The vector
+* @return: v4simd: The transformed vector
+********************/
+SIMD_INLINE v4simd Transform(const m4simd& _m, const v4simd& _v4)
+{
+	return v4simd(TransformRow(_v4.m, _m));
+}
+
+/***********************
+* TransformCoord: Transform a point by a matrix, treating W as one and projecting the result back to W = 1
+* @author: Callan Moore
+* @parameter: _m: The matrix
+* @parameter: _v4: The point. W is ignored
+* @return: v4simd: The transformed point with a W of one
+********************/
+SIMD_INLINE v4simd TransformCoord(const m4simd& _m, const v4simd& _v4)
+{
+	__m128 result = _mm_mul_ps(SplatLane(_v4.m, 0), _m.r[0]);
+	result = _mm_add_ps(result, _mm_mul_ps(SplatLane(_v4.m, 1), _m.r[1]));
+	result = _mm_add_ps(result, _mm_mul_ps(SplatLane(_v4.m, 2), _m.r[2]));
+	result = _mm_add_ps(result, _m.r[3]);
+	return v4simd(_mm_div_ps(result, SplatLane(result, 3)));
+}
+
+/***********************
+* TransformNormal: Transform a direction by a matrix, ignoring the translation
+* @author: Callan Moore
+* @parameter: _m: The matrix
+* @parameter: _v4: The direction. W is ignored
+* @return: v4simd: The transformed direction with a W of zero
+********************/
+SIMD_INLINE v4simd TransformNormal(const m4simd& _m, const v4simd& _v4)
+{
+	__m128 result = _mm_mul_ps(SplatLane(_v4.m, 0), _m.r[0]);
+	result = _mm_add_ps(result, _mm_mul_ps(SplatLane(_v4.m, 1), _m.r[1]));
+	result = _mm_add_ps(result, _mm_mul_ps(SplatLane(_v4.m, 2), _m.r[2]));
+	return v4simd(_mm_and_ps(result, _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0))));
+}
+
+/***********************
+* BatchTransformCoord: Transform an array of points by a matrix, projecting each back to W = 1. The output may be the input
+* @author: Callan Moore
+* @parameter: _m: The matrix
+* @parameter: _pV3: The array
+* @parameter: _pOut: Storage for the transformed points
+* @parameter: _count: The number of points
+* @return: void
+********************/
+inline void BatchTransformCoord(const m4simd& _m, const v3float* _pV3, v3float* _pOut, int _count)
+{
+	// Splat every element once so each group of four points is a straight run of multiply adds
+	SIMD_ALIGN float e[16];
+	_m.Store(e);
+	__m128 m00 = _mm_set1_ps(e[0]), m01 = _mm_set1_ps(e[1]), m02 = _mm_set1_ps(e[2]), m03 = _mm_set1_ps(e[3]);
+	__m128 m10 = _mm_set1_ps(e[4]), m11 = _mm_set1_ps(e[5]), m12 = _mm_set1_ps(e[6]), m13 = _mm_set1_ps(e[7]);
+	__m128 m20 = _mm_set1_ps(e[8]), m21 = _mm_set1_ps(e[9]), m22 = _mm_set1_ps(e[10]), m23 = _mm_set1_ps(e[11]);
+	__m128 m30 = _mm_set1_ps(e[12]), m31 = _mm_set1_ps(e[13]), m32 = _mm_set1_ps(e[14]), m33 = _mm_set1_ps(e[15]);
+
+	int i = 0;
+	for (; i + 4 <= _count; i += 4)
+	{
+		__m128 x, y, z;
+		LoadV3float4(_pV3 + i, x, y, z);
+		__m128 outX = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m00), _mm_mul_ps(y, m10)), _mm_add_ps(_mm_mul_ps(z, m20), m30));
+		__m128 outY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m01), _mm_mul_ps(y, m11)), _mm_add_ps(_mm_mul_ps(z, m21), m31));
+		__m128 outZ = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m02), _mm_mul_ps(y, m12)), _mm_add_ps(_mm_mul_ps(z, m22), m32));
+		__m128 outW = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m03), _mm_mul_ps(y, m13)), _mm_add_ps(_mm_mul_ps(z, m23), m33));
+		__m128 reciprocalW = _mm_div_ps(_mm_set1_ps(1.0f), outW);
+		StoreV3float4(_pOut + i, _mm_mul_ps(outX, reciprocalW), _mm_mul_ps(outY, reciprocalW), _mm_mul_ps(outZ, reciprocalW));
+	}
+	for (; i < _count; i++)
+	{
+		_pOut[i] = TransformCoord(_m, v4simd(_pV3[i])).ToV3float();
+	}
+}
+
+/***********************
+* BatchTransformNormal: Transform an array of directions by a matrix, ignoring the translation. The output may be the input
+* @author: Callan Moore
+* @parameter: _m: The matrix
+* @parameter: _pV3: The array
+* @parameter: _pOut: Storage for the transformed directions
+* @parameter: _count: The number of directions
+* @return: void
+********************/
+inline void BatchTransformNormal(const m4simd& _m, const v3float* _pV3, v3float* _pOut, int _count)
+{
+	SIMD_ALIGN float e[16];
+	_m.Store(e);
+	__m128 m00 = _mm_set1_ps(e[0]), m01 = _mm_set1_ps(e[1]), m02 = _mm_set1_ps(e[2]);
+	__m128 m10 = _mm_set1_ps(e[4]), m11 = _mm_set1_ps(e[5]), m12 = _mm_set1_ps(e[6]);
+	__m128 m20 = _mm_set1_ps(e[8]), m21 = _mm_set1_ps(e[9]), m22 = _mm_set1_ps(e[10]);
+
+	int i = 0;
+	for (; i + 4 <= _count; i += 4)
+	{
+		__m128 x, y, z;
+		LoadV3float4(_pV3 + i, x, y, z);
+		__m128 outX = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m00), _mm_mul_ps(y, m10)), _mm_mul_ps(z, m20));
+		__m128 outY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m01), _mm_mul_ps(y, m11)), _mm_mul_ps(z, m21));
+		__m128 outZ = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m02), _mm_mul_ps(y, m12)), _mm_mul_ps(z, m22));
+		StoreV3float4(_pOut + i, outX, outY, outZ);
+	}
+	for (; i < _count; i++)
+	{
+		_pOut[i] = TransformNormal(_m, v4simd(_pV3[i])).ToV3float();
+	}
+}
+
+/***********************
+* SplatDot4: Calculate the dot product of all four components of two registers into every lane
+* @author: Callan Moore
+* @parameter: _a: The first register
+* @parameter: _b: The second register
+* @return: __m128: The dot product in all four lanes
+********************/
+SIMD_INLINE __m128 SplatDot4(__m128 _a, __m128 _b)
+{
+	__m128 product = _mm_mul_ps(_a, _b);
+	__m128 sum = _mm_add_ps(product, _mm_shuffle_ps(product, product, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_add_ps(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 0, 3, 2)));
+}
+
+/***********************
+* QuaternionRotationAxis: Create a quaternion that rotates around an arbitrary axis
+* @author: Callan Moore
+* @parameter: _axis: The axis to rotate around. Need not be unit length
+* @parameter: _angle: The angle in radians
+* @return: q4simd: The rotation quaternion
+********************/
+inline q4simd QuaternionRotationAxis(const v4simd& _axis, float _angle)
+{
+	v4simd axis = Normalised(_axis, NA_EXACT) * sinf(_angle * 0.5f);
+	__m128 w = _mm_set1_ps(cosf(_angle * 0.5f));
+
+	// Keep XYZ of the axis and take W from the cosine
+	__m128 zw = _mm_shuffle_ps(axis.m, w, _MM_SHUFFLE(0, 0, 2, 2));
+	return q4simd(_mm_shuffle_ps(axis.m, zw, _MM_SHUFFLE(2, 0, 1, 0)));
+}
+
+/***********************
+* QuaternionMultiply: Multiply two quaternions. The result applies the first then the second, like D3DXQuaternionMultiply
+* @author: Callan Moore
+* @parameter: _q1: The first rotation
+* @parameter: _q2: The second rotation
+* @return: q4simd: The combined rotation
+********************/
+SIMD_INLINE q4simd QuaternionMultiply(const q4simd& _q1, const q4simd& _q2)
+{
+	// Hamilton product _q2 * _q1, one splatted component of _q2 at a time
+	__m128 a = _q2.m;
+	__m128 b = _q1.m;
+	__m128 result = _mm_mul_ps(SplatLane(a, 3), b);
+	result = _mm_add_ps(result, _mm_mul_ps(_mm_mul_ps(SplatLane(a, 0), _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 1, 2, 3))), _mm_setr_ps(1.0f, -1.0f, 1.0f, -1.0f)));
+	result = _mm_add_ps(result, _mm_mul_ps(_mm_mul_ps(SplatLane(a, 1), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2))), _mm_setr_ps(1.0f, 1.0f, -1.0f, -1.0f)));
+	result = _mm_add_ps(result, _mm_mul_ps(_mm_mul_ps(SplatLane(a, 2), _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 0, 1))), _mm_setr_ps(-1.0f, 1.0f, 1.0f, -1.0f)));
+	return q4simd(result);
+}
+
+/***********************
+* QuaternionRotationYawPitchRoll: Create a quaternion that rolls around Z, then pitches around X, then yaws around Y
+* @author: Callan Moore
+* @parameter: _yaw: The rotation around the Y axis in radians
+* @parameter: _pitch: The rotation around the X axis in radians
+* @parameter: _roll: The rotation around the Z axis in radians
+* @return: q4simd: The rotation quaternion
+********************/
+inline q4simd QuaternionRotationYawPitchRoll(float _yaw, float _pitch, float _roll)
+{
+	q4simd roll(0.0f, 0.0f, sinf(_roll * 0.5f), cosf(_roll * 0.5f));
+	q4simd pitch(sinf(_pitch * 0.5f), 0.0f, 0.0f, cosf(_pitch * 0.5f));
+	q4simd yaw(0.0f, sinf(_yaw * 0.5f), 0.0f, cosf(_yaw * 0.5f));
+	return QuaternionMultiply(QuaternionMultiply(roll, pitch), yaw);
+}
+
+/***********************
+* QuaternionNormalised: Calculate a unit length copy of a quaternion
+* @author: Callan Moore
+* @parameter: _q: The quaternion
+* @return: q4simd: The normalised quaternion
+********************/
+SIMD_INLINE q4simd QuaternionNormalised(const q4simd& _q)
+{
+	return q4simd(_mm_mul_ps(_q.m, ReciprocalSqrt(SplatDot4(_q.m, _q.m), NA_EXACT)));
+}
+
+/***********************
+* QuaternionSlerp: Spherically interpolate between two unit quaternions along the shortest arc
+* @author: Callan Moore
+* @parameter: _q1: The quaternion at zero
+* @parameter: _q2: The quaternion at one
+* @parameter: _t: The interpolation amount
+* @return: q4simd: The interpolated quaternion
+********************/
+inline q4simd QuaternionSlerp(const q4simd& _q1, const q4simd& _q2, float _t)
+{
+	__m128 target = _q2.m;
+	float cosTheta = _mm_cvtss_f32(SplatDot4(_q1.m, target));
+	if (cosTheta < 0.0f)
+	{
+		// Both signs give the same rotation, flip to take the shorter way around
+		target = _mm_sub_ps(_mm_setzero_ps(), target);
+		cosTheta = -cosTheta;
+	}
+
+	float weight1 = 1.0f - _t;
+	float weight2 = _t;
+	if (cosTheta < 0.9995f)
+	{
+		// Nearly parallel quaternions fall back to a linear blend to avoid dividing by a tiny sine
+		float theta = acosf(cosTheta);
+		float reciprocalSine = 1.0f / sinf(theta);
+		weight1 = sinf(weight1 * theta) * reciprocalSine;
+		weight2 = sinf(weight2 * theta) * reciprocalSine;
+	}
+
+	__m128 result = _mm_add_ps(_mm_mul_ps(_q1.m, _mm_set1_ps(weight1)), _mm_mul_ps(target, _mm_set1_ps(weight2)));
+	return QuaternionNormalised(q4simd(result));
+}
+
+#endif	// __UTILITY_MATRIX_H__
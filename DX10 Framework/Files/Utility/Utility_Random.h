@@ -0,0 +1,281 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Utility_Random.h
+* Description : Counter based random numbers. Each value depends only on its seed, stream and index so any thread can draw any value
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+//Inclusion Guards
+#pragma once
+#ifndef __UTILITY_RANDOM_H__
+#define __UTILITY_RANDOM_H__
+
+// Local Includes
+#include "Utility_SIMD.h"
+
+// Library Includes
+#include <emmintrin.h>
+
+// Defines
+// Philox 4x32 constants. Every value is the output of 10 rounds over a 128 bit counter with a 64 bit key
+#define RANDOM_ROUNDS 10
+#define RANDOM_MULTIPLIER_0 0xD2511F53
+#define RANDOM_MULTIPLIER_1 0xCD9E8D57
+#define RANDOM_KEY_STEP_0 0x9E3779B9
+#define RANDOM_KEY_STEP_1 0xBB67AE85
+// Scale from the top 24 bits of a value to a float in [0, 1)
+#define RANDOM_FLOAT_SCALE (1.0f / 16777216.0f)
+
+/***********************
+* eRandomStream: Enum for the independent streams of random numbers. Each user has its own so they never share values
+* @author: Callan Moore
+********************/
+enum eRandomStream
+{
+	RS_TERRAIN,
+	RS_BURN,
+	RS_EFFECTS
+};
+
+/***********************
+* RandomSeed: Retrieve the storage for the seed shared by every stream. Zero until SetRandomSeed is called
+* @author: Callan Moore
+* @return: UINT&: The seed
+********************/
+inline UINT& RandomSeed()
+{
+	// Constant initialised so it is set before any thread can ask for it
+	static UINT s_seed = 0;
+	return s_seed;
+}
+
+/***********************
+* SetRandomSeed: Set the seed shared by every stream. Call once at start up before anything draws numbers
+* @author: Callan Moore
+* @parameter: _seed: The new seed
+* @return: void
+********************/
+inline void SetRandomSeed(UINT _seed)
+{
+	RandomSeed() = _seed;
+}
+
+/***********************
+* GetRandomSeed: Retrieve the seed shared by every stream
+* @author: Callan Moore
+* @return: UINT: The seed
+********************/
+inline UINT GetRandomSeed()
+{
+	return RandomSeed();
+}
+
+/***********************
+* RandomBlock: Generate the four values for one counter of a stream
+* @author: Callan Moore
+* @parameter: _seed: The seed
+* @parameter: _stream: The stream
+* @parameter: _counter: The counter. Values _counter * 4 to _counter * 4 + 3 of the stream
+* @parameter: _pOut: Storage for the four values
+* @return: void
+********************/
+inline void RandomBlock(UINT _seed, UINT _stream, UINT64 _counter, UINT* _pOut)
+{
+	UINT x0 = (UINT)_counter;
+	UINT x1 = (UINT)(_counter >> 32);
+	UINT x2 = 0;
+	UINT x3 = 0;
+	UINT key0 = _seed;
+	UINT key1 = _stream;
+
+	for (int round = 0; round < RANDOM_ROUNDS; round++)
+	{
+		UINT64 product0 = (UINT64)RANDOM_MULTIPLIER_0 * x0;
+		UINT64 product1 = (UINT64)RANDOM_MULTIPLIER_1 * x2;
+		x0 = (UINT)(product1 >> 32) ^ x1 ^ key0;
+		x1 = (UINT)product1;
+		x2 = (UINT)(product0 >> 32) ^ x3 ^ key1;
+		x3 = (UINT)product0;
+
+		key0 += RANDOM_KEY_STEP_0;
+		key1 += RANDOM_KEY_STEP_1;
+	}
+
+	_pOut[0] = x0;
+	_pOut[1] = x1;
+	_pOut[2] = x2;
+	_pOut[3] = x3;
+}
+
+/***********************
+* RandomUint: Retrieve one value of a stream
+* @author: Callan Moore
+* @parameter: _seed: The seed
+* @parameter: _stream: The stream
+* @parameter: _index: The index of the value
+* @return: UINT: The random value
+********************/
+inline UINT RandomUint(UINT _seed, UINT _stream, UINT64 _index)
+{
+	UINT block[4];
+	RandomBlock(_seed, _stream, _index >> 2, block);
+	return block[_index & 3];
+}
+
+/***********************
+* RandomRange: Retrieve one value of a stream as a float within a range
+* @author: Callan Moore
+* @parameter: _seed: The seed
+* @parameter: _stream: The stream
+* @parameter: _index: The index of the value
+* @parameter: _min: The lowest number
+* @parameter: _max: The highest number. Never returned
+* @return: float: The random number
+********************/
+inline float RandomRange(UINT _seed, UINT _stream, UINT64 _index, float _min, float _max)
+{
+	float unit = (float)(RandomUint(_seed, _stream, _index) >> 8) * RANDOM_FLOAT_SCALE;
+	return _min + (unit * (_max - _min));
+}
+
+/***********************
+* MulHiLo4: Multiply four unsigned 32 bit values by a constant and split each 64 bit product into its high and low halves
+* @author: Callan Moore
+* @parameter: _a: The values
+* @parameter: _multiplier: The constant in every lane
+* @parameter: _prHi: Storage for the high halves
+* @parameter: _prLo: Storage for the low halves
+* @return: void
+********************/
+SIMD_INLINE void MulHiLo4(__m128i _a, __m128i _multiplier, __m128i& _prHi, __m128i& _prLo)
+{
+	// SSE2 only multiplies lanes 0 and 2, so lanes 1 and 3 are shifted down for a second multiply
+	__m128i even = _mm_mul_epu32(_a, _multiplier);
+	__m128i odd = _mm_mul_epu32(_mm_srli_epi64(_a, 32), _multiplier);
+	_prLo = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+	_prHi = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 3, 1)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 3, 1)));
+}
+
+/***********************
+* RandomBlocks4: Generate the values for four consecutive counters at once, the same as four calls to RandomBlock
+* @author: Callan Moore
+* @parameter: _seed: The seed
+* @parameter: _stream: The stream
+* @parameter: _counter: The first counter. Must be a multiple of four
+* @parameter: _pOut: Storage for the sixteen values. Need not be aligned
+* @return: void
+********************/
+SIMD_INLINE void RandomBlocks4(UINT _seed, UINT _stream, UINT64 _counter, UINT* _pOut)
+{
+	// One register per word of the counter, one lane per counter. The low words can not carry as the first is a multiple of four
+	__m128i x0 = _mm_add_epi32(_mm_set1_epi32((int)(UINT)_counter), _mm_set_epi32(3, 2, 1, 0));
+	__m128i x1 = _mm_set1_epi32((int)(UINT)(_counter >> 32));
+	__m128i x2 = _mm_setzero_si128();
+	__m128i x3 = _mm_setzero_si128();
+	__m128i multiplier0 = _mm_set1_epi32((int)RANDOM_MULTIPLIER_0);
+	__m128i multiplier1 = _mm_set1_epi32((int)RANDOM_MULTIPLIER_1);
+	UINT key0 = _seed;
+	UINT key1 = _stream;
+
+	for (int round = 0; round < RANDOM_ROUNDS; round++)
+	{
+		__m128i hi0, lo0, hi1, lo1;
+		MulHiLo4(x0, multiplier0, hi0, lo0);
+		MulHiLo4(x2, multiplier1, hi1, lo1);
+		x0 = _mm_xor_si128(_mm_xor_si128(hi1, x1), _mm_set1_epi32((int)key0));
+		x1 = lo1;
+		x2 = _mm_xor_si128(_mm_xor_si128(hi0, x3), _mm_set1_epi32((int)key1));
+		x3 = lo0;
+
+		key0 += RANDOM_KEY_STEP_0;
+		key1 += RANDOM_KEY_STEP_1;
+	}
+
+	// Transpose so each counter's four words are stored together
+	__m128i low01 = _mm_unpacklo_epi32(x0, x1);
+	__m128i low23 = _mm_unpacklo_epi32(x2, x3);
+	__m128i high01 = _mm_unpackhi_epi32(x0, x1);
+	__m128i high23 = _mm_unpackhi_epi32(x2, x3);
+	_mm_storeu_si128((__m128i*)(_pOut), _mm_unpacklo_epi64(low01, low23));
+	_mm_storeu_si128((__m128i*)(_pOut + 4), _mm_unpackhi_epi64(low01, low23));
+	_mm_storeu_si128((__m128i*)(_pOut + 8), _mm_unpacklo_epi64(high01, high23));
+	_mm_storeu_si128((__m128i*)(_pOut + 12), _mm_unpackhi_epi64(high01, high23));
+}
+
+/***********************
+* FillRandomUints: Fill an array with consecutive values of a stream, sixteen at a time where possible
+* @author: Callan Moore
+* @parameter: _seed: The seed
+* @parameter: _stream: The stream
+* @parameter: _firstIndex: The index of the first value
+* @parameter: _pOut: Storage for the values
+* @parameter: _count: The number of values
+* @return: void
+********************/
+inline void FillRandomUints(UINT _seed, UINT _stream, UINT64 _firstIndex, UINT* _pOut, int _count)
+{
+	int i = 0;
+
+	// Draw single values until the index lines up with a group of four counters
+	while (i < _count && ((_firstIndex + i) & 15) != 0)
+	{
+		_pOut[i] = RandomUint(_seed, _stream, _firstIndex + i);
+		i++;
+	}
+	for (; i + 16 <= _count; i += 16)
+	{
+		RandomBlocks4(_seed, _stream, (_firstIndex + i) >> 2, _pOut + i);
+	}
+	for (; i < _count; i++)
+	{
+		_pOut[i] = RandomUint(_seed, _stream, _firstIndex + i);
+	}
+}
+
+/***********************
+* FillRandomRange: Fill an array with consecutive values of a stream as floats within a range. Matches RandomRange for each index
+* @author: Callan Moore
+* @parameter: _seed: The seed
+* @parameter: _stream: The stream
+* @parameter: _firstIndex: The index of the first value
+* @parameter: _pOut: Storage for the numbers
+* @parameter: _count: The number of numbers
+* @parameter: _min: The lowest number
+* @parameter: _max: The highest number. Never returned
+* @return: void
+********************/
+inline void FillRandomRange(UINT _seed, UINT _stream, UINT64 _firstIndex, float* _pOut, int _count, float _min, float _max)
+{
+	__m128 scale = _mm_set1_ps(RANDOM_FLOAT_SCALE);
+	__m128 lowest = _mm_set1_ps(_min);
+	__m128 range = _mm_set1_ps(_max - _min);
+
+	// Generate sixteen values at a time then convert them four at a time
+	SIMD_ALIGN UINT values[16];
+	for (int first = 0; first < _count; first += 16)
+	{
+		int chunk = min(_count - first, 16);
+		FillRandomUints(_seed, _stream, _firstIndex + first, values, chunk);
+
+		int i = 0;
+		for (; i + 4 <= chunk; i += 4)
+		{
+			__m128 unit = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(_mm_load_si128((__m128i*)(values + i)), 8)), scale);
+			_mm_storeu_ps(_pOut + first + i, _mm_add_ps(lowest, _mm_mul_ps(unit, range)));
+		}
+		for (; i < chunk; i++)
+		{
+			float unit = (float)(values[i] >> 8) * RANDOM_FLOAT_SCALE;
+			_pOut[first + i] = _min + (unit * (_max - _min));
+		}
+	}
+}
+
+#endif	// __UTILITY_RANDOM_H__
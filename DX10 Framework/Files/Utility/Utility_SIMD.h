@@ -0,0 +1,490 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Utility_SIMD.h
+* Description : SSE backed vectors and batch functions to sit beside the scalar v3float
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+//Inclusion Guards
+#pragma once
+#ifndef __UTILITY_SIMD_H__
+#define __UTILITY_SIMD_H__
+
+// Local Includes
+#include "Utility_Math.h"
+
+// Library Includes
+#include <xmmintrin.h>
+
+// Defines
+#ifdef _MSC_VER
+	#define SIMD_ALIGN __declspec(align(16))
+	#define SIMD_INLINE __forceinline
+#else
+	#define SIMD_ALIGN __attribute__((aligned(16)))
+	#define SIMD_INLINE inline __attribute__((always_inline))
+#endif
+
+/***********************
+* eNormaliseAccuracy: Enum for how accurately vectors are normalised
+* @author: Callan Moore
+********************/
+enum eNormaliseAccuracy
+{
+	NA_EXACT,		// Square root and divide. Matches v3float::Normalise
+	NA_REFINED,		// Reciprocal square root estimate with one Newton-Raphson step. Relative error about 1e-6
+	NA_FAST			// Reciprocal square root estimate only. Relative error about 4e-4
+};
+
+/***********************
+* v4simd: Struct to hold 4 float values in a single SSE register. Used as a 3D vector with a spare W
+* @author: Callan Moore
+********************/
+struct SIMD_ALIGN v4simd
+{
+	__m128 m;
+
+	/***********************
+	* v4simd: Default Constructor for the v4simd struct. Sets every component to zero
+	* @author: Callan Moore
+	********************/
+	SIMD_INLINE v4simd()
+	{
+		m = _mm_setzero_ps();
+	}
+
+	/***********************
+	* v4simd: Constructor for the v4simd struct from an SSE register
+	* @author: Callan Moore
+	* @parameter: _m: The register to copy
+	********************/
+	SIMD_INLINE v4simd(__m128 _m)
+	{
+		m = _m;
+	}
+
+	/***********************
+	* v4simd: Constructor for the v4simd struct
+	* @author: Callan Moore
+	* @parameter: _x: X coordinate
+	* @parameter: _y: Y coordinate
+	* @parameter: _z: Z coordinate
+	* @parameter: _w: W coordinate
+	********************/
+	SIMD_INLINE v4simd(float _x, float _y, float _z, float _w = 0.0f)
+	{
+		m = _mm_set_ps(_w, _z, _y, _x);
+	}
+
+	/***********************
+	* v4simd: Constructor for the v4simd struct from a v3float. W is set to zero
+	* @author: Callan Moore
+	* @parameter: _v3: The v3float to convert
+	********************/
+	SIMD_INLINE v4simd(const v3float& _v3)
+	{
+		m = _mm_set_ps(0.0f, _v3.z, _v3.y, _v3.x);
+	}
+
+	/***********************
+	* ToV3float: Convert back to a v3float, dropping W
+	* @author: Callan Moore
+	* @return: v3float: The converted vector
+	********************/
+	SIMD_INLINE v3float ToV3float() const
+	{
+		SIMD_ALIGN float stored[4];
+		_mm_store_ps(stored, m);
+		return v3float(stored[0], stored[1], stored[2]);
+	}
+
+	/***********************
+	* GetX: Retrieve the X component
+	* @author: Callan Moore
+	* @return: float: The X component
+	********************/
+	SIMD_INLINE float GetX() const { return _mm_cvtss_f32(m); };
+
+	/***********************
+	* operator+: Addition Operator for the v4simd struct plus a v4simd
+	* @author: Callan Moore
+	* @parameter: _v4: Right hand side of the addition
+	* @return: v4simd: The result of the addition
+	********************/
+	SIMD_INLINE v4simd operator+ (const v4simd& _v4) const { return v4simd(_mm_add_ps(m, _v4.m)); };
+
+	/***********************
+	* operator-: Subtraction Operator for the v4simd struct minus a v4simd
+	* @author: Callan Moore
+	* @parameter: _v4: Right hand side of the subtraction
+	* @return: v4simd: The result of the subtraction
+	********************/
+	SIMD_INLINE v4simd operator- (const v4simd& _v4) const { return v4simd(_mm_sub_ps(m, _v4.m)); };
+
+	/***********************
+	* operator-: Negate the v4simd
+	* @author: Callan Moore
+	* @return: v4simd: The result of the negation
+	********************/
+	SIMD_INLINE v4simd operator- () const { return v4simd(_mm_sub_ps(_mm_setzero_ps(), m)); };
+
+	/***********************
+	* operator*: Component wise Multiplication Operator for a v4simd times a v4simd
+	* @author: Callan Moore
+	* @parameter: _v4: Right hand side of the multiplication
+	* @return: v4simd: The result of the multiplication
+	********************/
+	SIMD_INLINE v4simd operator* (const v4simd& _v4) const { return v4simd(_mm_mul_ps(m, _v4.m)); };
+
+	/***********************
+	* operator*: Multiplication Operator for a v4simd times a float
+	* @author: Callan Moore
+	* @parameter: _f: Right hand side of the multiplication
+	* @return: v4simd: The result of the multiplication
+	********************/
+	SIMD_INLINE v4simd operator* (float _f) const { return v4simd(_mm_mul_ps(m, _mm_set1_ps(_f))); };
+
+	/***********************
+	* operator/: Division Operator for a v4simd divided by a float
+	* @author: Callan Moore
+	* @parameter: _f: Right hand side of the division
+	* @return: v4simd: The result of the division
+	********************/
+	SIMD_INLINE v4simd operator/ (float _f) const { return v4simd(_mm_div_ps(m, _mm_set1_ps(_f))); };
+
+	/***********************
+	* operator+=: Addition Assignment Operator for the v4simd struct
+	* @author: Callan Moore
+	* @parameter: _v4: Right hand side of the addition
+	* @return: v4simd&: This vector after the addition
+	********************/
+	SIMD_INLINE v4simd& operator+= (const v4simd& _v4) { m = _mm_add_ps(m, _v4.m); return *this; };
+
+	/***********************
+	* operator-=: Subtraction Assignment Operator for the v4simd struct
+	* @author: Callan Moore
+	* @parameter: _v4: Right hand side of the subtraction
+	* @return: v4simd&: This vector after the subtraction
+	********************/
+	SIMD_INLINE v4simd& operator-= (const v4simd& _v4) { m = _mm_sub_ps(m, _v4.m); return *this; };
+
+	/***********************
+	* operator*=: Multiplication Assignment Operator for a v4simd times a float
+	* @author: Callan Moore
+	* @parameter: _f: Right hand side of the multiplication
+	* @return: v4simd&: This vector after the multiplication
+	********************/
+	SIMD_INLINE v4simd& operator*= (float _f) { m = _mm_mul_ps(m, _mm_set1_ps(_f)); return *this; };
+};
+
+/***********************
+* SplatDot3: Calculate the dot product of the XYZ of two vectors into every lane
+* @author: Callan Moore
+* @parameter: _a: The first vector
+* @parameter: _b: The second vector
+* @return: __m128: The dot product in all four lanes
+********************/
+SIMD_INLINE __m128 SplatDot3(const v4simd& _a, const v4simd& _b)
+{
+	__m128 product = _mm_mul_ps(_a.m, _b.m);
+	__m128 sum = _mm_add_ss(product, _mm_shuffle_ps(product, product, _MM_SHUFFLE(1, 1, 1, 1)));
+	sum = _mm_add_ss(sum, _mm_shuffle_ps(product, product, _MM_SHUFFLE(2, 2, 2, 2)));
+	return _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(0, 0, 0, 0));
+}
+
+/***********************
+* Dot3: Calculate the dot product of the XYZ of two vectors
+* @author: Callan Moore
+* @parameter: _a: The first vector
+* @parameter: _b: The second vector
+* @return: float: The dot product
+********************/
+SIMD_INLINE float Dot3(const v4simd& _a, const v4simd& _b)
+{
+	return _mm_cvtss_f32(SplatDot3(_a, _b));
+}
+
+/***********************
+* LengthSq: Calculate the squared length of a vector. Avoids the square root when only comparing lengths
+* @author: Callan Moore
+* @parameter: _v4: The vector
+* @return: float: The squared length
+********************/
+SIMD_INLINE float LengthSq(const v4simd& _v4)
+{
+	return Dot3(_v4, _v4);
+}
+
+/***********************
+* Length: Calculate the length of a vector
+* @author: Callan Moore
+* @parameter: _v4: The vector
+* @return: float: The length
+********************/
+SIMD_INLINE float Length(const v4simd& _v4)
+{
+	return _mm_cvtss_f32(_mm_sqrt_ss(SplatDot3(_v4, _v4)));
+}
+
+/***********************
+* Cross: Calculate the cross product of two vectors. W of the result is zero
+* @author: Callan Moore
+* @parameter: _a: The first vector
+* @parameter: _b: The second vector
+* @return: v4simd: The cross product
+********************/
+SIMD_INLINE v4simd Cross(const v4simd& _a, const v4simd& _b)
+{
+	__m128 aYZX = _mm_shuffle_ps(_a.m, _a.m, _MM_SHUFFLE(3, 0, 2, 1));
+	__m128 bYZX = _mm_shuffle_ps(_b.m, _b.m, _MM_SHUFFLE(3, 0, 2, 1));
+	__m128 result = _mm_sub_ps(_mm_mul_ps(_a.m, bYZX), _mm_mul_ps(aYZX, _b.m));
+	return v4simd(_mm_shuffle_ps(result, result, _MM_SHUFFLE(3, 0, 2, 1)));
+}
+
+/***********************
+* ReciprocalSqrt: Calculate one over the square root of four values. Lanes that are zero give zero
+* @author: Callan Moore
+* @parameter: _values: The values
+* @parameter: _accuracy: How accurately to calculate the result
+* @return: __m128: The reciprocal square roots
+********************/
+SIMD_INLINE __m128 ReciprocalSqrt(__m128 _values, eNormaliseAccuracy _accuracy)
+{
+	__m128 nonZero = _mm_cmpgt_ps(_values, _mm_setzero_ps());
+	__m128 result;
+
+	switch (_accuracy)
+	{
+		case NA_EXACT:
+		{
+			result = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(_values));
+		}
+		break;
+		case NA_REFINED:
+		{
+			// One Newton-Raphson step: r' = r * (1.5 - 0.5 * v * r * r)
+			__m128 estimate = _mm_rsqrt_ps(_values);
+			__m128 halfValues = _mm_mul_ps(_values, _mm_set1_ps(0.5f));
+			__m128 correction = _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(halfValues, _mm_mul_ps(estimate, estimate)));
+			result = _mm_mul_ps(estimate, correction);
+		}
+		break;
+		case NA_FAST:	// Fall Through
+		default:
+		{
+			result = _mm_rsqrt_ps(_values);
+		}
+		break;
+	}	// End Switch
+
+	return _mm_and_ps(result, nonZero);
+}
+
+/***********************
+* Normalised: Calculate a unit length copy of a vector. A zero vector stays zero
+* @author: Callan Moore
+* @parameter: _v4: The vector
+* @parameter: _accuracy: How accurately to normalise
+* @return: v4simd: The normalised vector
+********************/
+SIMD_INLINE v4simd Normalised(const v4simd& _v4, eNormaliseAccuracy _accuracy = NA_REFINED)
+{
+	return v4simd(_mm_mul_ps(_v4.m, ReciprocalSqrt(SplatDot3(_v4, _v4), _accuracy)));
+}
+
+/***********************
+* LoadV3float4: Load four consecutive v3floats and transpose them into one register per component
+* @author: Callan Moore
+* @parameter: _pV3: The first of the four vectors
+* @parameter: _prX: Storage for the four X components
+* @parameter: _prY: Storage for the four Y components
+* @parameter: _prZ: Storage for the four Z components
+* @return: void
+********************/
+SIMD_INLINE void LoadV3float4(const v3float* _pV3, __m128& _prX, __m128& _prY, __m128& _prZ)
+{
+	// The twelve floats arrive as [x0 y0 z0 x1] [y1 z1 x2 y2] [z2 x3 y3 z3]
+	const float* pFloats = (const float*)_pV3;
+	__m128 a = _mm_loadu_ps(pFloats);
+	__m128 b = _mm_loadu_ps(pFloats + 4);
+	__m128 c = _mm_loadu_ps(pFloats + 8);
+
+	__m128 bc = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2));
+	_prX = _mm_shuffle_ps(a, bc, _MM_SHUFFLE(2, 0, 3, 0));
+
+	__m128 ab = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1));
+	bc = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3));
+	_prY = _mm_shuffle_ps(ab, bc, _MM_SHUFFLE(2, 0, 2, 0));
+
+	ab = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2));
+	_prZ = _mm_shuffle_ps(ab, c, _MM_SHUFFLE(3, 0, 2, 0));
+}
+
+/***********************
+* StoreV3float4: Transpose one register per component back into four consecutive v3floats
+* @author: Callan Moore
+* @parameter: _pV3: The first of the four vectors to write
+* @parameter: _x: The four X components
+* @parameter: _y: The four Y components
+* @parameter: _z: The four Z components
+* @return: void
+********************/
+SIMD_INLINE void StoreV3float4(v3float* _pV3, __m128 _x, __m128 _y, __m128 _z)
+{
+	float* pFloats = (float*)_pV3;
+
+	__m128 xy = _mm_shuffle_ps(_x, _y, _MM_SHUFFLE(0, 0, 0, 0));
+	__m128 zx = _mm_shuffle_ps(_z, _x, _MM_SHUFFLE(1, 1, 0, 0));
+	_mm_storeu_ps(pFloats, _mm_shuffle_ps(xy, zx, _MM_SHUFFLE(2, 0, 2, 0)));
+
+	__m128 yz = _mm_shuffle_ps(_y, _z, _MM_SHUFFLE(1, 1, 1, 1));
+	xy = _mm_shuffle_ps(_x, _y, _MM_SHUFFLE(2, 2, 2, 2));
+	_mm_storeu_ps(pFloats + 4, _mm_shuffle_ps(yz, xy, _MM_SHUFFLE(2, 0, 2, 0)));
+
+	zx = _mm_shuffle_ps(_z, _x, _MM_SHUFFLE(3, 3, 2, 2));
+	yz = _mm_shuffle_ps(_y, _z, _MM_SHUFFLE(3, 3, 3, 3));
+	_mm_storeu_ps(pFloats + 8, _mm_shuffle_ps(zx, yz, _MM_SHUFFLE(2, 0, 2, 0)));
+}
+
+/***********************
+* BatchAdd: Add two arrays of vectors. The output may be one of the inputs
+* @author: Callan Moore
+* @parameter: _pA: The first array
+* @parameter: _pB: The second array
+* @parameter: _pOut: Storage for the sums
+* @parameter: _count: The number of vectors
+* @return: void
+********************/
+inline void BatchAdd(const v3float* _pA, const v3float* _pB, v3float* _pOut, int _count)
+{
+	// The arrays are treated as flat floats so no transposing is needed
+	const float* pA = (const float*)_pA;
+	const float* pB = (const float*)_pB;
+	float* pOut = (float*)_pOut;
+	int floatCount = _count * 3;
+	int i = 0;
+	for (; i + 4 <= floatCount; i += 4)
+	{
+		_mm_storeu_ps(pOut + i, _mm_add_ps(_mm_loadu_ps(pA + i), _mm_loadu_ps(pB + i)));
+	}
+	for (; i < floatCount; i++)
+	{
+		pOut[i] = pA[i] + pB[i];
+	}
+}
+
+/***********************
+* BatchScale: Multiply an array of vectors by a scalar. The output may be the input
+* @author: Callan Moore
+* @parameter: _pV3: The array
+* @parameter: _scale: The scalar
+* @parameter: _pOut: Storage for the scaled vectors
+* @parameter: _count: The number of vectors
+* @return: void
+********************/
+inline void BatchScale(const v3float* _pV3, float _scale, v3float* _pOut, int _count)
+{
+	const float* pIn = (const float*)_pV3;
+	float* pOut = (float*)_pOut;
+	__m128 scale = _mm_set1_ps(_scale);
+	int floatCount = _count * 3;
+	int i = 0;
+	for (; i + 4 <= floatCount; i += 4)
+	{
+		_mm_storeu_ps(pOut + i, _mm_mul_ps(_mm_loadu_ps(pIn + i), scale));
+	}
+	for (; i < floatCount; i++)
+	{
+		pOut[i] = pIn[i] * _scale;
+	}
+}
+
+/***********************
+* BatchDot: Calculate the dot products of two arrays of vectors
+* @author: Callan Moore
+* @parameter: _pA: The first array
+* @parameter: _pB: The second array
+* @parameter: _pOut: Storage for the dot products
+* @parameter: _count: The number of vectors
+* @return: void
+********************/
+inline void BatchDot(const v3float* _pA, const v3float* _pB, float* _pOut, int _count)
+{
+	int i = 0;
+	for (; i + 4 <= _count; i += 4)
+	{
+		__m128 ax, ay, az, bx, by, bz;
+		LoadV3float4(_pA + i, ax, ay, az);
+		LoadV3float4(_pB + i, bx, by, bz);
+		__m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_mul_ps(az, bz));
+		_mm_storeu_ps(_pOut + i, dot);
+	}
+	for (; i < _count; i++)
+	{
+		_pOut[i] = _pA[i].x * _pB[i].x + _pA[i].y * _pB[i].y + _pA[i].z * _pB[i].z;
+	}
+}
+
+/***********************
+* BatchCross: Calculate the cross products of two arrays of vectors. The output may be one of the inputs
+* @author: Callan Moore
+* @parameter: _pA: The first array
+* @parameter: _pB: The second array
+* @parameter: _pOut: Storage for the cross products
+* @parameter: _count: The number of vectors
+* @return: void
+********************/
+inline void BatchCross(const v3float* _pA, const v3float* _pB, v3float* _pOut, int _count)
+{
+	int i = 0;
+	for (; i + 4 <= _count; i += 4)
+	{
+		__m128 ax, ay, az, bx, by, bz;
+		LoadV3float4(_pA + i, ax, ay, az);
+		LoadV3float4(_pB + i, bx, by, bz);
+		__m128 x = _mm_sub_ps(_mm_mul_ps(ay, bz), _mm_mul_ps(az, by));
+		__m128 y = _mm_sub_ps(_mm_mul_ps(az, bx), _mm_mul_ps(ax, bz));
+		__m128 z = _mm_sub_ps(_mm_mul_ps(ax, by), _mm_mul_ps(ay, bx));
+		StoreV3float4(_pOut + i, x, y, z);
+	}
+	for (; i < _count; i++)
+	{
+		v3float a = _pA[i];
+		_pOut[i] = a.Cross(_pB[i]);
+	}
+}
+
+/***********************
+* BatchNormalise: Normalise an array of vectors. Zero vectors stay zero. The output may be the input
+* @author: Callan Moore
+* @parameter: _pV3: The array
+* @parameter: _pOut: Storage for the normalised vectors
+* @parameter: _count: The number of vectors
+* @parameter: _accuracy: How accurately to normalise
+* @return: void
+********************/
+inline void BatchNormalise(const v3float* _pV3, v3float* _pOut, int _count, eNormaliseAccuracy _accuracy = NA_REFINED)
+{
+	int i = 0;
+	for (; i + 4 <= _count; i += 4)
+	{
+		__m128 x, y, z;
+		LoadV3float4(_pV3 + i, x, y, z);
+		__m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+		__m128 scale = ReciprocalSqrt(lengthSq, _accuracy);
+		StoreV3float4(_pOut + i, _mm_mul_ps(x, scale), _mm_mul_ps(y, scale), _mm_mul_ps(z, scale));
+	}
+	for (; i < _count; i++)
+	{
+		_pOut[i] = Normalised(v4simd(_pV3[i]), _accuracy).ToV3float();
+	}
+}
+
+#endif	// __UTILITY_SIMD_H__
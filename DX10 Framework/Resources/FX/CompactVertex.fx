@@ -0,0 +1,26 @@
+//=============================================================================
+// CompactVertex.fx                                                                                                   
+//
+// Input structure and decoding for the compact vertex (TVertexCompactNormalUV)
+//=============================================================================
+
+// Structure for the Vertex Shader Input of a compact vertex. The normal is octahedral encoded
+struct VS_IN_COMPACT
+{
+	float3 position		: POSITION;
+	float2 normal		: NORMAL;
+	float2 texCoord		: TEXCOORD;
+};
+
+float3 DecodeOctahedral(float2 _encoded)
+{
+	// Unfold the lower half of the octahedron
+	float3 normal = float3(_encoded.x, _encoded.y, 1.0f - abs(_encoded.x) - abs(_encoded.y));
+	if (normal.z < 0.0f)
+	{
+		float2 signs = float2((normal.x >= 0.0f) ? 1.0f : -1.0f, (normal.y >= 0.0f) ? 1.0f : -1.0f);
+		normal.xy = (1.0f - abs(normal.yx)) * signs;
+	}
+
+	return normalize(normal);
+}
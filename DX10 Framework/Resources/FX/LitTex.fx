@@ -6,6 +6,7 @@
 
 // Local Includes
 #include "LightStructures.fx"
+#include "CompactVertex.fx"
 
 // Defines
 #define MAX_LIGHTS 5
@@ -579,4 +580,28 @@ technique10 NoCullTech
 		SetGeometryShader(NULL);
 		SetPixelShader(CompileShader(ps_4_0, PS_NoCull()));
 	}
-}
\ No newline at end of file
+}
+//--------------------------------------------------------------
+// Compact (Terrain)
+//--------------------------------------------------------------
+
+VS_OUT VS_Compact(VS_IN_COMPACT _inputVS)
+{
+	// Expand the compact vertex and transform it as a standard vertex
+	VS_IN inputVS;
+	inputVS.position = _inputVS.position;
+	inputVS.normal = DecodeOctahedral(_inputVS.normal);
+	inputVS.texCoord = _inputVS.texCoord;
+
+	return VS_Standard(inputVS);
+}
+
+technique10 CompactTech
+{
+	pass P0
+	{
+		SetVertexShader(CompileShader(vs_4_0, VS_Compact()));
+		SetGeometryShader(NULL);
+		SetPixelShader(CompileShader(ps_4_0, PS_Standard()));
+	}
+}
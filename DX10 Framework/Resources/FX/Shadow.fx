@@ -5,6 +5,7 @@
 //=============================================================================
 
 #include "LightStructures.fx"
+#include "CompactVertex.fx"
  
  
 cbuffer cbPerFrame
@@ -91,6 +92,17 @@ PixelInputType ShadowVertexShader(VS_IN input)
 	return output;
 }
 
+PixelInputType ShadowVertexShaderCompact(VS_IN_COMPACT input)
+{
+	// Expand the compact vertex and transform it as a standard vertex
+	VS_IN expanded;
+	expanded.posL = input.position;
+	expanded.normalL = DecodeOctahedral(input.normal);
+	expanded.texC = input.texCoord;
+
+	return ShadowVertexShader(expanded);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Pixel Shader
 ////////////////////////////////////////////////////////////////////////////////
@@ -154,4 +166,14 @@ technique10 BlackWhiteShadowTech
 		SetPixelShader(CompileShader(ps_4_0, ShadowPixelShader()));
 		SetGeometryShader(NULL);
 	}
+}
+
+technique10 BlackWhiteShadowCompactTech
+{
+	pass pass0
+	{
+		SetVertexShader(CompileShader(vs_4_0, ShadowVertexShaderCompact()));
+		SetPixelShader(CompileShader(ps_4_0, ShadowPixelShader()));
+		SetGeometryShader(NULL);
+	}
 }
\ No newline at end of file
@@ -4,6 +4,9 @@
 // Creates a Shadow Map
 //=============================================================================
 
+// Local Includes
+#include "CompactVertex.fx"
+
 cbuffer cbPerFrame
 {
 	float4x4 g_matLightWVP;
@@ -43,6 +46,16 @@ VS_OUT VS_Standard(VS_IN _inputVS)
 	return outputVS;
 }
 
+VS_OUT VS_Compact(VS_IN_COMPACT _inputVS)
+{
+	// The shadow map only needs the position and texture coordinates, so the normal is never decoded
+	VS_OUT outputVS;
+	outputVS.positionH = mul(float4(_inputVS.position, 1.0f), g_matLightWVP);
+	outputVS.texCoord = _inputVS.texCoord;
+
+	return outputVS;
+}
+
 void PS_Standard(VS_OUT _inputPS)
 {
 	float4 diffuse = g_mapDiffuse.Sample(g_triLinearSam, _inputPS.texCoord);
@@ -64,3 +77,13 @@ technique10 CreateShadowMapTech
 		SetPixelShader(CompileShader(ps_4_0, PS_Standard()));
 	}
 }
+
+technique10 CreateShadowMapCompactTech
+{
+	pass P0
+	{
+		SetVertexShader(CompileShader(vs_4_0, VS_Compact()));
+		SetGeometryShader(NULL);
+		SetPixelShader(CompileShader(ps_4_0, PS_Standard()));
+	}
+}
@@ -4,6 +4,7 @@
 
 // Local Includes
 #include "LightStructures.fx"
+#include "CompactVertex.fx"
 
 // Defines
 #define MAX_LIGHTS 2
@@ -114,6 +115,17 @@ PixelInputType SoftShadowVertexShader(VertexInputType input)
 	return output;
 }
 
+PixelInputType SoftShadowVertexShaderCompact(VS_IN_COMPACT input)
+{
+	// Expand the compact vertex and transform it as a standard vertex
+	VertexInputType expanded;
+	expanded.position = input.position;
+	expanded.normal = DecodeOctahedral(input.normal);
+	expanded.tex = input.texCoord;
+
+	return SoftShadowVertexShader(expanded);
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 // Pixel Shader
@@ -190,4 +202,14 @@ technique10 SoftShadowTech
 		SetPixelShader(CompileShader(ps_4_0, SoftShadowPixelShader()));
 		SetGeometryShader(NULL);
 	}
+}
+
+technique10 SoftShadowCompactTech
+{
+	pass pass0
+	{
+		SetVertexShader(CompileShader(vs_4_0, SoftShadowVertexShaderCompact()));
+		SetPixelShader(CompileShader(ps_4_0, SoftShadowPixelShader()));
+		SetGeometryShader(NULL);
+	}
 }
\ No newline at end of file
@@ -4,6 +4,9 @@
 // Renders scrolling water with refraction and reflection
 //=============================================================================
 
+// Local Includes
+#include "CompactVertex.fx"
+
 cbuffer cbPerFrame
 {
 	float4x4 g_matProj;
@@ -73,6 +76,17 @@ VS_OUT VS_Standard(VS_IN _inputVS)
 	return outputVS;
 }
 
+VS_OUT VS_Compact(VS_IN_COMPACT _inputVS)
+{
+	// Expand the compact vertex and transform it as a standard vertex
+	VS_IN inputVS;
+	inputVS.position = float4(_inputVS.position, 1.0f);
+	inputVS.normal = DecodeOctahedral(_inputVS.normal);
+	inputVS.texCoord = _inputVS.texCoord;
+
+	return VS_Standard(inputVS);
+}
+
 float4 PS_Standard(VS_OUT _inputPS) : SV_Target
 {
 	// Translate the Texture coord by the current translation for the animated scrolling effect
@@ -112,4 +126,14 @@ technique10 StandardTech
 		SetPixelShader(CompileShader(ps_4_0, PS_Standard()));
 	}
 }
+
+technique10 CompactTech
+{
+	pass P0
+	{	
+		SetVertexShader(CompileShader(vs_4_0, VS_Compact()));
+		SetGeometryShader(NULL);
+		SetPixelShader(CompileShader(ps_4_0, PS_Standard()));
+	}
+}
 	
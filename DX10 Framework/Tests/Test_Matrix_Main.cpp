@@ -0,0 +1,31 @@
+/*
+* Bachelor of Software Engineering
+* Media Design School
+* Auckland
+* New Zealand
+*
+* (c) 2005 - 2015 Media Design School
+*
+* File Name : Test_Matrix_Main.cpp
+* Description : Console entry point to run the SIMD matrix test away from the framework, on any compiler with SSE2.
+*	Not part of the Visual Studio project, which runs the same test with -matrixtest. From this folder on Linux:
+*	g++ -std=c++11 -msse2 -O2 -I"../Files/Utility" Test_Matrix_Main.cpp "../Files/Utility/Test_Matrix.cpp" -o MatrixTest && ./MatrixTest
+* Author :	Callan Moore
+* Mail :	Callan.Moore@mediadesign.school.nz
+*/
+
+// Library Includes
+#include <iostream>
+
+// Local Includes
+#include "Test_Matrix.h"
+
+/***********************
+* main: Run the matrix test and write the report to the console
+* @author: Callan Moore
+* @return: int: Zero if every result matches, one otherwise
+********************/
+int main()
+{
+	return (Test_Matrix::Run(std::cout) == true) ? 0 : 1;
+}